@@ -1561,7 +1561,8 @@ void ChatManager::_processEnterRoomById(Message* message,DispatchClient* client)
 
 void ChatManager::_processSendToRoom(Message* message,DispatchClient* client)
 {
-	gLogger->log(LogManager::DEBUG,"_processSendToRoom");
+	if(gLogger->isLogged(LogManager::DEBUG))
+		gLogger->log(LogManager::DEBUG,"_processSendToRoom");
 
 	Player*	player = getPlayerByAccId(client->getAccountId());
 
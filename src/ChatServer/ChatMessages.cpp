@@ -1311,6 +1311,11 @@ void ChatMessageLib::sendChatRoomMessage(Channel* channel, string galaxy, string
 	loweredName.toLower();
 	uint32 loweredNameCrc = loweredName.getCrc();
 
+	AccountIdList	recipients;
+	DispatchClient*	route = NULL;
+
+	recipients.reserve(channel->getUserList()->size());
+
 	while (iter != channel->getUserList()->end())
 	{
 		// If sender present at recievers ignore list, don't send.
@@ -1329,23 +1334,30 @@ void ChatMessageLib::sendChatRoomMessage(Channel* channel, string galaxy, string
 			}
 			else
 			{
-				gMessageFactory->StartMessage();
-				gMessageFactory->addUint32(opChatRoomMessage);
-
-				gMessageFactory->addString(SWG);
-				gMessageFactory->addString(galaxy);
-				gMessageFactory->addString(sender);
-
-				gMessageFactory->addUint32(channel->getId());
-				gMessageFactory->addString(message);
-				gMessageFactory->addUint32(0);
-				Message* response = gMessageFactory->EndMessage();
-				client->SendChannelA(response, client->getAccountId(), CR_Client, 5);
-
+				recipients.push_back(client->getAccountId());
+				route = client;
 			}
 		}
 		++iter;
 	}
+
+	if(!route)
+		return;
+
+	// every member gets the same body, the connection server hands out the copies
+	gMessageFactory->StartMessage();
+	gMessageFactory->addUint32(opChatRoomMessage);
+
+	gMessageFactory->addString(SWG);
+	gMessageFactory->addString(galaxy);
+	gMessageFactory->addString(sender);
+
+	gMessageFactory->addUint32(channel->getId());
+	gMessageFactory->addString(message);
+	gMessageFactory->addUint32(0);
+	Message* response = gMessageFactory->EndMessage();
+
+	route->SendChannelAMulticast(response, recipients, 5);
 }
 
 //======================================================================================================================
@@ -32,9 +32,11 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "ZoneServer/TangibleEnums.h"
 
+#include "ConfigManager/ConfigManager.h"
 #include "LogManager/LogManager.h"
 #include "DatabaseManager/Database.h"
 #include "DatabaseManager/DataBinding.h"
+#include "DatabaseManager/DatabaseJob.h"
 #include "DatabaseManager/DatabaseResult.h"
 
 #include "Common/atMacroString.h"
@@ -43,6 +45,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Common/MessageDispatch.h"
 #include "Common/MessageFactory.h"
 
+#include "Utils/clock.h"
 #include "Utils/utils.h"
 #include "Utils/Timer.h"
 
@@ -95,6 +98,7 @@ StructureManagerChatHandler::StructureManagerChatHandler(Database* database, Mes
     std::tr1::shared_ptr<Timer> hopper_timer(new Timer(SRMTimer_CheckHarvesterHopper,this,1000,NULL));
 	std::tr1::shared_ptr<Timer> maintenance_timer(new Timer(SRMTimer_CheckHarvesterMaintenance,this,3600*1000,NULL));
 	std::tr1::shared_ptr<Timer> power_timer(new Timer(SRMTimer_CheckHarvesterPower,this,3600*1000,NULL));
+	std::tr1::shared_ptr<Timer> reload_timer(new Timer(SRMTimer_ReloadSimulation,this,gConfig->read<uint32>("StructureSimulationReload",60)*1000,NULL));
     //std::tr1::shared_ptr<Timer> tick_preserve_timer(new Timer(CMTimer_TickPreserve,this,ServerTimeInterval*10000,NULL));
     //std::tr1::shared_ptr<Timer> check_auctions_timer(new Timer(CMTimer_CheckAuctions,this,ServerTimeInterval*10000,NULL));
 
@@ -102,7 +106,18 @@ StructureManagerChatHandler::StructureManagerChatHandler(Database* database, Mes
     mTimers.push_back(hopper_timer);
     mTimers.push_back(maintenance_timer);
     mTimers.push_back(power_timer);
-    
+	mTimers.push_back(reload_timer);
+
+	uint64 now = Anh_Utils::Clock::getSingleton()->getLocalTime();
+
+	mLastHarvestTime		= now;
+	mLastPowerTime			= now;
+	mLastMaintenanceTime	= now;
+	mSimulationLoaded		= false;
+	mSimulationLoading		= false;
+	mSimulationSettling		= false;
+
+	_loadSimulation();
 }
 
 
@@ -383,330 +398,115 @@ void StructureManagerChatHandler::handleDatabaseJobComplete(void* ref,DatabaseRe
 
 		//=================================================
 		//
-		//we deducted the maintenance - or tried too
-		//read out the answer and proceed
-		case STRMQuery_DoneStructureMaintenance:
+		//the state of every structure, the simulation starts over with it
+		//
+		case STRMQuery_SimulationLoad:
 		{
-			uint32 exitCode;
-			DataBinding* binding = mDatabase->CreateDataBinding(1);
-			binding->addField(DFT_uint32,0,4);
-
-			uint64 count;
-			count = result->getRowCount();
-
-			//return codes :
-			// 0 everything ok
-			// 1 structure is out of maintenance  - taking maint out of the bank
-			// 2 structure got damaged
-			// 3 condition is zero
-
-
-			result->GetNextRow(binding,&exitCode);
-
-			if(exitCode == 1)// 1 structure is out of maintenance
-			{
-				// get the Owners ID
-				int8 sql[500];
-
-				//inform the owner on the maintenance issue
-				sprintf(sql,"SELECT s.owner, st.stf_file, st.stf_name, s.x, s.z, p.name, s.lastMail FROM structures s INNER JOIN structure_type_data st ON (s.type = st.type) INNER JOIN planet p ON (p.planet_id = s.zone)WHERE ID = %I64u",asynContainer->harvesterID);
-				StructureManagerAsyncContainer* asyncContainer = new StructureManagerAsyncContainer(STRMQuery_StructureMailOOFMaint,0);
-				asyncContainer->harvesterID = asynContainer->harvesterID;
-				
-				mDatabase->ExecuteSqlAsync(this,asyncContainer,sql);
-
-			}
-
-			if(exitCode == 2)// 2 structure got damaged
-			{
-				// get the Owners ID
-				int8 sql[500];
-
-				//start by using power
-				sprintf(sql,"SELECT s.owner, st.stf_file, st.stf_name, s.x, s.z, p.name, st.max_condition, s.condition, s.lastMail FROM structures s INNER JOIN structure_type_data st ON (s.type = st.type) INNER JOIN planet p ON (p.planet_id = s.zone)WHERE ID = %I64u",asynContainer->harvesterID);
-				StructureManagerAsyncContainer* asyncContainer = new StructureManagerAsyncContainer(STRMQuery_StructureMailDamage,0);
-				asyncContainer->harvesterID = asynContainer->harvesterID;
-				
-				mDatabase->ExecuteSqlAsync(this,asyncContainer,sql);
-
-			}
-
-			if(exitCode == 3)// 1 structure is out of maintenance
+			uint64 startTime = Anh_Utils::Clock::getSingleton()->getLocalTime();
+
+			DataBinding* binding = mDatabase->CreateDataBinding(12);
+			binding->addField(DFT_uint64,offsetof(StructureSimState,mId),8,0);
+			binding->addField(DFT_uint64,offsetof(StructureSimState,mOwner),8,1);
+			binding->addField(DFT_uint64,offsetof(StructureSimState,mResourceId),8,2);
+			binding->addField(DFT_float,offsetof(StructureSimState,mMaintenanceReserve),4,3);
+			binding->addField(DFT_float,offsetof(StructureSimState,mMaintenancePerHour),4,4);
+			binding->addField(DFT_float,offsetof(StructureSimState,mPowerReserve),4,5);
+			binding->addField(DFT_float,offsetof(StructureSimState,mPowerPerHour),4,6);
+			binding->addField(DFT_float,offsetof(StructureSimState,mExtractionRate),4,7);
+			binding->addField(DFT_float,offsetof(StructureSimState,mHopperSize),4,8);
+			binding->addField(DFT_float,offsetof(StructureSimState,mHopperFill),4,9);
+			binding->addField(DFT_int32,offsetof(StructureSimState,mCondition),4,10);
+			binding->addField(DFT_uint32,offsetof(StructureSimState,mFlags),4,11);
+
+			uint64 count = result->getRowCount();
+
+			mSimulation.clear();
+			mSimulation.reserve(static_cast<uint32>(count));
+
+			for(uint64 i = 0;i < count;i++)
 			{
-				// get the Owners ID
-				int8 sql[500];
-
-				//start by using power
-				sprintf(sql,"SELECT s.owner, st.stf_file, st.stf_name, s.x, s.z, p.name, st.max_condition, st.maint_cost_wk, s.lastMail FROM structures s INNER JOIN structure_type_data st ON (s.type = st.type) INNER JOIN planet p ON (p.planet_id = s.zone)WHERE ID = %I64u",asynContainer->harvesterID);
-				StructureManagerAsyncContainer* asyncContainer = new StructureManagerAsyncContainer(STRMQuery_StructureMailCondZero,0);
-				asyncContainer->harvesterID = asynContainer->harvesterID;
-				
-				mDatabase->ExecuteSqlAsync(this,asyncContainer,sql);
-
-			}
-
+				StructureSimState state;
+				result->GetNextRow(binding,&state);
 
-			if(exitCode > 3)
-			{
-				//unspecified db error
-				
-				//most likely the structure reached condition zero and awaits destruction
+				mSimulation.addStructure(state);
 			}
-			
 
 			mDatabase->DestroyDataBinding(binding);
 
-		}
-		break;
-
-		case STRMQuery_DoneHarvesterUsePower:
-		{
-			uint32 exitCode;
-			DataBinding* binding = mDatabase->CreateDataBinding(1);
-			binding->addField(DFT_uint32,0,4);
-
-			uint64 count;
-			count = result->getRowCount();
-
-			//return codes :
-			// 0 everything ok
-			// 1 structure is out of power
-			// 2 
-			// 3 unspecified db error
-
+			mSimulationLoading	= false;
+			mSimulationLoaded	= true;
 
-			result->GetNextRow(binding,&exitCode);
-
-			// cant notify zone when no player is online
-			// zone will update harvesterstatus once per hour
-				
-			// only reason for us tzo handle this event here  would be if we wanted to inform the player
-
-			if(exitCode == 3)
-			{
-				//unspecified db error
-				gLogger->log(LogManager::NOTICE,"StructureManagerChat::HarvesterPowerUsage %I64u unspecified db error",asynContainer->harvesterID);
-			}
-			
-
-			mDatabase->DestroyDataBinding(binding);
+			gLogger->log(LogManager::DEBUG,"StructureManagerChat::loaded %u structures in %"PRIu64"ms",mSimulation.getStructureCount(),Anh_Utils::Clock::getSingleton()->getLocalTime() - startTime);
 
+			// harvesters whose resource went away shut down right on load
+			_persistSimulation();
+			_processSimulationEvents();
 		}
 		break;
 
-		case STRMQuery_DoneFactoryUpdate:
+		//=================================================
+		//
+		//the owners bank balances, settle the maintenance the reserves couldnt cover
+		//
+		case STRMQuery_SimulationBanks:
 		{
-				uint32 exitCode;
-			DataBinding* binding = mDatabase->CreateDataBinding(1);
-			binding->addField(DFT_uint32,0,4);
+			StructureSimDelta bank;
 
-			uint64 count;
-			count = result->getRowCount();
-
-			//return codes :
-			// 0 everything ok
-			// 1 
-			// 2 
-			// 3 
+			DataBinding* binding = mDatabase->CreateDataBinding(2);
+			binding->addField(DFT_uint64,offsetof(StructureSimDelta,mId),8,0);
+			binding->addField(DFT_uint32,offsetof(StructureSimDelta,mAmount),4,1);
 
+			OwnerCreditMap credits;
+			uint64 count = result->getRowCount();
 
-			for(uint64 i=0;i <count;i++)
+			for(uint64 i = 0;i < count;i++)
 			{
-				result->GetNextRow(binding,&exitCode);
-
-				if(exitCode == 1)
-				{
-					//resource never existed in the first place
-				}
-				if(exitCode == 2)
-				{
-					//resource never existed in the first place
-				}
-				if(exitCode == 3)
-				{
-					//resource never existed in the first place
-					gLogger->log(LogManager::DEBUG,"StructureMabagerChat::Factory %I64u general error",asynContainer->harvesterID);
-				}
-
+				result->GetNextRow(binding,&bank);
+				credits[bank.mId] = bank.mAmount;
 			}
 
 			mDatabase->DestroyDataBinding(binding);
 
+			mSimulationSettling = false;
 
+			mSimulation.settleMaintenance(&credits);
+
+			_persistSimulation();
+			_processSimulationEvents();
 		}
 		break;
-		
-		case STRMQuery_DoneHarvestUpdate:
+
+		case STRMQuery_DoneFactoryUpdate:
 		{
-			uint32 exitCode;
-			DataBinding* binding = mDatabase->CreateDataBinding(1);
-			binding->addField(DFT_uint32,0,4);
+			StructureSimDelta factory;
+			DataBinding* binding = mDatabase->CreateDataBinding(2);
+			binding->addField(DFT_uint64,offsetof(StructureSimDelta,mId),8,0);
+			binding->addField(DFT_uint32,offsetof(StructureSimDelta,mAmount),4,1);
 
 			uint64 count;
 			count = result->getRowCount();
 
 			//return codes :
 			// 0 everything ok
-			// 1 hopper full harvester turned of
-			// 2 resource isnt active anymore
-			// 3 resource doesnt exist in the first place
+			// 1 single item created no crate
+			// 2 hopper full
+			// 3 other fault - attrib / table not found
 
 
+			// one row per factory of the batch
 			for(uint64 i=0;i <count;i++)
 			{
-				result->GetNextRow(binding,&exitCode);
+				result->GetNextRow(binding,&factory);
 
-				if(exitCode == 1)
+				if(factory.mAmount == 3)
 				{
-					//resource never existed in the first place
-					gLogger->log(LogManager::DEBUG,"StructureMabagerChat::Harvester %I64u hopper full",asynContainer->harvesterID);
+					gLogger->log(LogManager::DEBUG,"StructureMabagerChat::Factory %"PRIu64" general error",factory.mId);
 				}
-				if(exitCode == 2)
-				{
-					//resource never existed in the first place
-					gLogger->log(LogManager::DEBUG,"StructureMabagerChat::Harvester %I64u resourcechange",asynContainer->harvesterID);
-				}
-				if(exitCode == 3)
-				{
-					//resource never existed in the first place
-					gLogger->log(LogManager::DEBUG,"StructureMabagerChat::Harvester %I64u harvested an invalid resource",asynContainer->harvesterID);
-				}
-
-			}
-
-			mDatabase->DestroyDataBinding(binding);
-
-		}
-		break;
-
-		case STRMQuery_MaintenanceUpdate:
-		{
-			uint64 harvesterID;
-			DataBinding* binding = mDatabase->CreateDataBinding(1);
-			binding->addField(DFT_uint64,0,8);
-
-			uint64 count;
-			count = result->getRowCount();
-
-			for(uint64 i=0;i <count;i++)
-			{
-				result->GetNextRow(binding,&harvesterID);
-
-				int8 sql[100];
-
-				// then use maintenance
-				sprintf(sql,"SELECT sf_HarvesterUseMaintenance(%I64u)",harvesterID);
-				StructureManagerAsyncContainer* asyncContainer = new StructureManagerAsyncContainer(STRMQuery_DoneStructureMaintenance,0);
-				asyncContainer->harvesterID = harvesterID;
-				
-				mDatabase->ExecuteSqlAsync(this,asyncContainer,sql);
 
 			}
-			
-			mDatabase->DestroyDataBinding(binding);
-		}
-		break;
-
-		case STRMQuery_PowerUpdate:
-		{
-				uint64 harvesterID;
-			DataBinding* binding = mDatabase->CreateDataBinding(1);
-			binding->addField(DFT_uint64,0,8);
-
-			uint64 count;
-			count = result->getRowCount();
 
-			for(uint64 i=0;i <count;i++)
-			{
-				result->GetNextRow(binding,&harvesterID);
-
-				int8 sql[100];
-
-				//start by using power
-				sprintf(sql,"SELECT sf_HarvesterUsePower(%I64u)",harvesterID);
-				StructureManagerAsyncContainer* asyncContainer = new StructureManagerAsyncContainer(STRMQuery_DoneHarvesterUsePower,0);
-				asyncContainer->harvesterID = harvesterID;
-				
-				mDatabase->ExecuteSqlAsync(this,asyncContainer,sql);
-
-				//return codes :
-				// 0 everything ok
-				// 1 hopper full harvester turned of
-				// 2 resource isnt active anymore
-				// 3 resource doesnt exist in the first place
-
-			}
-			
 			mDatabase->DestroyDataBinding(binding);
 
-		}
-		break;
-
-		case STRMQuery_FactoryUpdate:
-		{
-			uint64 factoryID;
-			DataBinding* binding = mDatabase->CreateDataBinding(1);
-			binding->addField(DFT_uint64,0,8);
-
-			uint64 count;
-			count = result->getRowCount();
-
-			for(uint64 i=0;i <count;i++)
-			{
-				result->GetNextRow(binding,&factoryID);
-
-				int8 sql[100];
-
-				//now harvest
-				sprintf(sql,"SELECT sf_FactoryProduce(%I64u)",factoryID);
-				StructureManagerAsyncContainer* asyncContainer = new StructureManagerAsyncContainer(STRMQuery_DoneFactoryUpdate,0);
-				asyncContainer->harvesterID = factoryID;
-				
-				mDatabase->ExecuteSqlAsync(this,asyncContainer,sql);
-
-				//return codes :
-				// 0 everything ok
-				// 1 single item created no crate
-				// 2 hopper full
-				// 3 other fault - attrib / table not found
-
-			}
-			
-			mDatabase->DestroyDataBinding(binding);
-
-		}
-
-		case STRMQuery_HopperUpdate:
-		{
-			uint64 harvesterID;
-			DataBinding* binding = mDatabase->CreateDataBinding(1);
-			binding->addField(DFT_uint64,0,8);
-
-			uint64 count;
-			count = result->getRowCount();
-
-			for(uint64 i=0;i <count;i++)
-			{
-				result->GetNextRow(binding,&harvesterID);
-
-				int8 sql[100];
-
-				//now harvest
-				sprintf(sql,"SELECT sf_HarvestResource(%I64u)",harvesterID);
-				StructureManagerAsyncContainer* asyncContainer = new StructureManagerAsyncContainer(STRMQuery_DoneHarvestUpdate,0);
-				asyncContainer->harvesterID = harvesterID;
-				
-				mDatabase->ExecuteSqlAsync(this,asyncContainer,sql);
-
-				//return codes :
-				// 0 everything ok
-				// 1 hopper full harvester turned of
-				// 2 resource isnt active anymore
-				// 3 resource doesnt exist in the first place
-
-			}
-			
-			mDatabase->DestroyDataBinding(binding);
 
 		}
 		break;
@@ -769,6 +569,12 @@ void StructureManagerChatHandler::processTimerEvents()
 			}
 			break;
 
+			case SRMTimer_ReloadSimulation:
+			{
+				_loadSimulation();
+			}
+			break;
+
 			default:
 				gLogger->log(LogManager::DEBUG,"WorldManager::processTimerEvents: Unknown Timer %u",id);
 			break;
@@ -780,73 +586,423 @@ void StructureManagerChatHandler::processTimerEvents()
 
 //=======================================================================================================================
 //
-// iterates through the list of hoppers we need to update on a regular basis
-// and reads the relevant resource data - then sends it to the client
+// drains the harvesters power reserves
 //
 void StructureManagerChatHandler::handleCheckHarvesterPower()
 {
+	if(!mSimulationLoaded || mSimulationLoading)
+		return;
 
-	StructureManagerAsyncContainer* asyncContainer = new StructureManagerAsyncContainer(STRMQuery_PowerUpdate,0);
-
-	int8 sql[100];
-	sprintf(sql,"SELECT h.ID FROM harvesters h WHERE h.active > 0 ");
-	
-	mDatabase->ExecuteSqlAsync(this,asyncContainer,sql);
+	mSimulation.usePower(_elapsed(&mLastPowerTime,3600000));
 
+	_persistSimulation();
+	_processSimulationEvents();
 }
 
 
 //=======================================================================================================================
 //
-// iterates through the list of hoppers we need to update on a regular basis
-// and reads the relevant resource data - then sends it to the client
+// fills the hoppers of all running harvesters
 //
 void StructureManagerChatHandler::handleCheckHarvesterHopper()
 {
+	if(!mSimulationLoaded || mSimulationLoading)
+		return;
 
-	StructureManagerAsyncContainer* asyncContainer = new StructureManagerAsyncContainer(STRMQuery_HopperUpdate,0);
-
-	int8 sql[100];
-	sprintf(sql,"SELECT h.ID FROM harvesters h WHERE h.active > 0 ");
-	
-	mDatabase->ExecuteSqlAsync(this,asyncContainer,sql);
+	mSimulation.harvest(_elapsed(&mLastHarvestTime,60000));
 
+	_persistSimulation();
+	_processSimulationEvents();
 }
 
 //=======================================================================================================================
 //
-// iterates through the list of hoppers we need to update on a regular basis
-// and reads the relevant resource data - then sends it to the client
+// the production needs the schematic and the ingredients, so that stays with sf_FactoryProduce
+// all active factories produce with a single query though
 //
 void StructureManagerChatHandler::handleFactoryUpdate()
 {
 
-	StructureManagerAsyncContainer* asyncContainer = new StructureManagerAsyncContainer(STRMQuery_FactoryUpdate,0);
+	StructureManagerAsyncContainer* asyncContainer = new StructureManagerAsyncContainer(STRMQuery_DoneFactoryUpdate,0);
 
-	int8 sql[100];
-	sprintf(sql,"SELECT f.ID FROM factories f WHERE f.active > 0 ");
-	
-	mDatabase->ExecuteSqlAsync(this,asyncContainer,sql);
+	mDatabase->ExecuteSqlAsync(this,asyncContainer,"SELECT f.ID, sf_FactoryProduce(f.ID) FROM factories f INNER JOIN structures s ON (s.ID = f.ID) WHERE f.active > 0 AND s.condition > 0");
 
 }
 
 
 //=======================================================================================================================
 //
-// iterates through all structures in structures.sql to take off maintenance
+// takes off maintenance of all structures, what the reserves cant cover is settled with the owners banks
 //
 void StructureManagerChatHandler::handleCheckHarvesterMaintenance()
 {
+	if(!mSimulationLoaded || mSimulationLoading || mSimulationSettling)
+		return;
 
-	StructureManagerAsyncContainer* asyncContainer = new StructureManagerAsyncContainer(STRMQuery_MaintenanceUpdate,0);
+	mSimulation.useMaintenance(_elapsed(&mLastMaintenanceTime,3600000));
 
-	int8 sql[100];
-	sprintf(sql,"SELECT s.ID FROM structures s");
-	
-	mDatabase->ExecuteSqlAsync(this,asyncContainer,sql);
+	_persistSimulation();
+
+	if(!mSimulation.hasArrears())
+		return;
+
+	// a reload would drop the arrears, it has to wait for the banks
+	mSimulationSettling = true;
+
+	StructureManagerAsyncContainer* asyncContainer = new StructureManagerAsyncContainer(STRMQuery_SimulationBanks,0);
 
+	mDatabase->ExecuteSqlAsyncOrdered(STRUCTURE_SIM_DB_KEY,this,asyncContainer,"SELECT b.id, b.credits FROM banks b INNER JOIN (SELECT DISTINCT owner FROM structures) s ON (s.owner = b.id)");
 }
 
+//=======================================================================================================================
+//
+// (re)reads the state of every structure, picks up whatever the zones changed since the last load
+// (harvesters turned on or off, reserves deposited, hoppers emptied)
+//
+void StructureManagerChatHandler::_loadSimulation()
+{
+	if(mSimulationLoading || mSimulationSettling)
+		return;
+
+	mSimulationLoading = true;
+
+	StructureManagerAsyncContainer* asyncContainer = new StructureManagerAsyncContainer(STRMQuery_SimulationLoad,0);
+
+	mDatabase->ExecuteSqlAsyncOrdered(STRUCTURE_SIM_DB_KEY,this,asyncContainer,
+		"SELECT s.ID, s.owner, IFNULL(h.ResourceID,0), IFNULL(maint.value,0), std.maint_cost_wk / 168, IFNULL(pow.value,0), std.power_used,"
+		" IFNULL(h.rate,0), IFNULL(hop.value,3000), IFNULL(hr.quantity,0), s.condition,"
+		" IF(h.ID IS NULL,0,%u) | IF(h.active > 0,%u,0) | IF(r.active > 0,%u,0)"
+		" FROM structures s INNER JOIN structure_type_data std ON (s.type = std.type)"
+		" LEFT JOIN harvesters h ON (h.ID = s.ID)"
+		" LEFT JOIN resources r ON (r.id = h.ResourceID)"
+		" LEFT JOIN (SELECT ID, SUM(quantity) AS quantity FROM harvester_resources GROUP BY ID) hr ON (hr.ID = s.ID)"
+		" LEFT JOIN structure_attributes maint ON (maint.structure_id = s.ID AND maint.attribute_id = 382)"
+		" LEFT JOIN structure_attributes pow ON (pow.structure_id = s.ID AND pow.attribute_id = 384)"
+		" LEFT JOIN structure_attributes hop ON (hop.structure_id = s.ID AND hop.attribute_id = 381)",
+		StructureSimFlag_Harvester,StructureSimFlag_Active,StructureSimFlag_ResourceActive);
+}
+
+//=======================================================================================================================
+//
+// writes what the passes changed, the amounts are deltas so changes the zones made in between survive
+//
+void StructureManagerChatHandler::_persistSimulation()
+{
+	StructureSimDeltaList deltas;
+
+	mSimulation.collectHarvested(&deltas);
+	_persistHarvested(&deltas);
+
+	// only while the harvester is still on, the zone may have turned it off since the last load
+	deltas.clear();
+	mSimulation.collectPowerUsed(&deltas);
+	_persistDeltas("structure_attributes","value","structure_id",
+		"attribute_id = 384 AND EXISTS (SELECT 1 FROM harvesters WHERE harvesters.ID = structure_attributes.structure_id AND harvesters.active > 0) AND ",&deltas);
+
+	deltas.clear();
+	mSimulation.collectMaintenanceUsed(&deltas);
+	_persistDeltas("structure_attributes","value","structure_id","attribute_id = 382 AND ",&deltas);
+
+	deltas.clear();
+	mSimulation.collectConditionLost(&deltas);
+	_persistDeltas("structures","structures.condition","ID","",&deltas);
+
+	deltas.clear();
+	mSimulation.collectBankDebits(&deltas);
+	_persistDeltas("banks","credits","id","",&deltas);
+
+	StructureSimEventList harvesters;
+	mSimulation.collectDeactivated(&harvesters);
+	_persistDeactivated(&harvesters);
+}
+
+//=======================================================================================================================
+
+void StructureManagerChatHandler::_persistDeltas(const int8* table,const int8* column,const int8* idColumn,const int8* filter,StructureSimDeltaList* deltas)
+{
+	int8	cases[DATABASE_JOB_MAX_SQL];
+	int8	ids[DATABASE_JOB_MAX_SQL];
+	int8	sql[DATABASE_JOB_MAX_SQL];
+	int8	row[64];
+
+	// the statement without any rows
+	uint32	overhead	= snprintf(sql,sizeof(sql),"UPDATE %s SET %s=%s-CASE %s ELSE 0 END WHERE %s%s IN ()",table,column,column,idColumn,filter,idColumn);
+	uint32	casesLength	= 0;
+	uint32	idsLength	= 0;
+	uint32	rows		= 0;
+
+	StructureSimDeltaList::iterator it = deltas->begin();
+
+	while(it != deltas->end())
+	{
+		uint32 caseLength	= sprintf(row," WHEN %"PRIu64" THEN %u",(*it).mId,(*it).mAmount);
+		uint32 idLength		= sprintf(&row[caseLength],",%"PRIu64"",(*it).mId);
+
+		// flush first if this row would overflow the job
+		if(rows && overhead + casesLength + idsLength + caseLength + idLength >= DATABASE_JOB_MAX_SQL)
+		{
+			sprintf(sql,"UPDATE %s SET %s=%s-CASE %s%s ELSE 0 END WHERE %s%s IN (%s)",table,column,column,idColumn,cases,filter,idColumn,ids);
+			_sendSimulationWrite(sql);
+
+			casesLength	= 0;
+			idsLength	= 0;
+			rows		= 0;
+		}
+
+		memcpy(&cases[casesLength],row,caseLength);
+		casesLength += caseLength;
+		cases[casesLength] = 0;
+
+		// the first id goes without its comma
+		idsLength += sprintf(&ids[idsLength],"%s",&row[caseLength + (rows ? 0 : 1)]);
+
+		rows++;
+		++it;
+
+		if(rows == STRUCTURE_SIM_BATCH_ROWS || it == deltas->end())
+		{
+			sprintf(sql,"UPDATE %s SET %s=%s-CASE %s%s ELSE 0 END WHERE %s%s IN (%s)",table,column,column,idColumn,cases,filter,idColumn,ids);
+			_sendSimulationWrite(sql);
+
+			casesLength	= 0;
+			idsLength	= 0;
+			rows		= 0;
+		}
+	}
+}
+
+//=======================================================================================================================
+//
+// harvested resources are added to the hopper, a resource the hopper didnt hold yet gets its row.
+// the simulation ran on state up to a reload old, only harvesters still extracting that resource get it
+//
+void StructureManagerChatHandler::_persistHarvested(StructureSimDeltaList* deltas)
+{
+	static const int8 harvestedSql[] = "INSERT INTO harvester_resources (ID,resourceID,quantity)"
+		" SELECT h.ID, h.ResourceID, d.amount FROM harvesters h INNER JOIN (%s) d ON (d.harvester = h.ID AND d.resource = h.ResourceID)"
+		" WHERE h.active > 0 ON DUPLICATE KEY UPDATE quantity=harvester_resources.quantity+VALUES(quantity)";
+
+	int8	values[DATABASE_JOB_MAX_SQL];
+	int8	sql[DATABASE_JOB_MAX_SQL];
+	int8	row[80];
+
+	// the statement without any rows, the first one is longer than the rest by its column names
+	uint32	overhead		= snprintf(sql,sizeof(sql),harvestedSql,"") + 40;
+	uint32	valuesLength	= 0;
+	uint32	rows			= 0;
+
+	StructureSimDeltaList::iterator it = deltas->begin();
+
+	while(it != deltas->end())
+	{
+		uint32 rowLength = sprintf(row," UNION ALL SELECT %"PRIu64",%"PRIu64",%u",(*it).mId,(*it).mKey,(*it).mAmount);
+
+		if(rows && overhead + valuesLength + rowLength >= DATABASE_JOB_MAX_SQL)
+		{
+			sprintf(sql,harvestedSql,values);
+			_sendSimulationWrite(sql);
+
+			valuesLength	= 0;
+			rows			= 0;
+		}
+
+		// the first row names the columns of the derived table
+		if(rows)
+			valuesLength += sprintf(&values[valuesLength],"%s",row);
+		else
+			valuesLength += sprintf(&values[valuesLength],"SELECT %"PRIu64" AS harvester,%"PRIu64" AS resource,%u AS amount",(*it).mId,(*it).mKey,(*it).mAmount);
+
+		rows++;
+		++it;
+
+		if(rows == STRUCTURE_SIM_BATCH_ROWS || it == deltas->end())
+		{
+			sprintf(sql,harvestedSql,values);
+			_sendSimulationWrite(sql);
+
+			valuesLength	= 0;
+			rows			= 0;
+		}
+	}
+}
+
+//=======================================================================================================================
+//
+// the simulation decided from state up to a reload old, meanwhile the zone may have emptied the hopper, deposited power
+// or the like. So every shut down checks its reason again against the tables, the writes before it already went in
+//
+void StructureManagerChatHandler::_persistDeactivated(StructureSimEventList* harvesters)
+{
+	std::vector<uint64> hopperFull;
+	std::vector<uint64> outOfPower;
+	std::vector<uint64> resourceInactive;
+	std::vector<uint64> condemned;
+
+	StructureSimEventList::iterator it = harvesters->begin();
+
+	while(it != harvesters->end())
+	{
+		switch((*it).mEvent)
+		{
+			case StructureSimEvent_HopperFull:			hopperFull.push_back((*it).mStructureId);		break;
+			case StructureSimEvent_OutOfPower:			outOfPower.push_back((*it).mStructureId);		break;
+			case StructureSimEvent_ResourceInactive:	resourceInactive.push_back((*it).mStructureId);	break;
+			case StructureSimEvent_Condemned:			condemned.push_back((*it).mStructureId);		break;
+
+			default:break;
+		}
+
+		++it;
+	}
+
+	_persistShutDowns("(SELECT IFNULL(SUM(quantity),0) FROM harvester_resources WHERE harvester_resources.ID = harvesters.ID)"
+		" >= IFNULL((SELECT value FROM structure_attributes WHERE structure_id = harvesters.ID AND attribute_id = 381),3000)",&hopperFull);
+
+	_persistShutDowns("IFNULL((SELECT value FROM structure_attributes WHERE structure_id = harvesters.ID AND attribute_id = 384),0) <= 0",&outOfPower);
+
+	_persistShutDowns("NOT EXISTS (SELECT 1 FROM resources WHERE resources.id = harvesters.ResourceID AND resources.active > 0)",&resourceInactive);
+
+	_persistShutDowns("(SELECT structures.condition FROM structures WHERE structures.ID = harvesters.ID) <= 0",&condemned);
+}
+
+//=======================================================================================================================
+
+void StructureManagerChatHandler::_persistShutDowns(const int8* recheck,std::vector<uint64>* harvesters)
+{
+	int8	ids[DATABASE_JOB_MAX_SQL];
+	int8	sql[DATABASE_JOB_MAX_SQL];
+	int8	row[32];
+
+	uint32	overhead	= snprintf(sql,sizeof(sql),"UPDATE harvesters SET active=0 WHERE ID IN () AND %s",recheck);
+	uint32	idsLength	= 0;
+	uint32	rows		= 0;
+
+	std::vector<uint64>::iterator it = harvesters->begin();
+
+	while(it != harvesters->end())
+	{
+		uint32 rowLength = sprintf(row,",%"PRIu64"",(*it));
+
+		if(rows && overhead + idsLength + rowLength >= DATABASE_JOB_MAX_SQL)
+		{
+			sprintf(sql,"UPDATE harvesters SET active=0 WHERE ID IN (%s) AND %s",ids,recheck);
+			_sendSimulationWrite(sql);
+
+			idsLength	= 0;
+			rows		= 0;
+		}
+
+		idsLength += sprintf(&ids[idsLength],"%s",&row[rows ? 0 : 1]);
+
+		rows++;
+		++it;
+
+		if(rows == STRUCTURE_SIM_BATCH_ROWS || it == harvesters->end())
+		{
+			sprintf(sql,"UPDATE harvesters SET active=0 WHERE ID IN (%s) AND %s",ids,recheck);
+			_sendSimulationWrite(sql);
+
+			idsLength	= 0;
+			rows		= 0;
+		}
+	}
+}
+
+//=======================================================================================================================
+//
+// writes share the ordering key of the load, so the next load sees them
+//
+void StructureManagerChatHandler::_sendSimulationWrite(const int8* sql)
+{
+	mDatabase->ExecuteSqlAsyncOrdered(STRUCTURE_SIM_DB_KEY,0,0,"%s",sql);
+}
+
+//=======================================================================================================================
+//
+// the owners get mailed about maintenance trouble, shut downs the zone picks up on its own
+//
+void StructureManagerChatHandler::_processSimulationEvents()
+{
+	StructureSimEventList* events = mSimulation.getEvents();
+	StructureSimEventList::iterator it = events->begin();
+
+	while(it != events->end())
+	{
+		switch((*it).mEvent)
+		{
+			case StructureSimEvent_MaintenanceFromBank:
+				_requestStructureMail(STRMQuery_StructureMailOOFMaint,(*it).mStructureId);
+			break;
+
+			case StructureSimEvent_Damaged:
+				_requestStructureMail(STRMQuery_StructureMailDamage,(*it).mStructureId);
+			break;
+
+			case StructureSimEvent_Condemned:
+				_requestStructureMail(STRMQuery_StructureMailCondZero,(*it).mStructureId);
+			break;
+
+			case StructureSimEvent_OutOfPower:
+				gLogger->log(LogManager::DEBUG,"StructureMabagerChat::Harvester %"PRIu64" out of power",(*it).mStructureId);
+			break;
+
+			case StructureSimEvent_HopperFull:
+				gLogger->log(LogManager::DEBUG,"StructureMabagerChat::Harvester %"PRIu64" hopper full",(*it).mStructureId);
+			break;
+
+			case StructureSimEvent_ResourceInactive:
+				gLogger->log(LogManager::DEBUG,"StructureMabagerChat::Harvester %"PRIu64" resourcechange",(*it).mStructureId);
+			break;
+
+			default:break;
+		}
+
+		++it;
+	}
+
+	events->clear();
+}
+
+//=======================================================================================================================
+
+void StructureManagerChatHandler::_requestStructureMail(STRMQueryType type,uint64 structureId)
+{
+	StructureManagerAsyncContainer* asyncContainer = new StructureManagerAsyncContainer(type,0);
+	asyncContainer->harvesterID = structureId;
+
+	switch(type)
+	{
+		case STRMQuery_StructureMailOOFMaint:
+			mDatabase->ExecuteSqlAsync(this,asyncContainer,"SELECT s.owner, st.stf_file, st.stf_name, s.x, s.z, p.name, s.lastMail FROM structures s INNER JOIN structure_type_data st ON (s.type = st.type) INNER JOIN planet p ON (p.planet_id = s.zone)WHERE ID = %"PRIu64"",structureId);
+		break;
+
+		case STRMQuery_StructureMailDamage:
+			mDatabase->ExecuteSqlAsync(this,asyncContainer,"SELECT s.owner, st.stf_file, st.stf_name, s.x, s.z, p.name, st.max_condition, s.condition, s.lastMail FROM structures s INNER JOIN structure_type_data st ON (s.type = st.type) INNER JOIN planet p ON (p.planet_id = s.zone)WHERE ID = %"PRIu64"",structureId);
+		break;
+
+		case STRMQuery_StructureMailCondZero:
+			mDatabase->ExecuteSqlAsync(this,asyncContainer,"SELECT s.owner, st.stf_file, st.stf_name, s.x, s.z, p.name, st.max_condition, st.maint_cost_wk, s.lastMail FROM structures s INNER JOIN structure_type_data st ON (s.type = st.type) INNER JOIN planet p ON (p.planet_id = s.zone)WHERE ID = %"PRIu64"",structureId);
+		break;
+
+		default:
+			SAFE_DELETE(asyncContainer);
+		break;
+	}
+}
+
+//=======================================================================================================================
+//
+// time passed since the last pass in the given unit (ms)
+//
+float StructureManagerChatHandler::_elapsed(uint64* lastTime,uint64 unit)
+{
+	uint64 now		= Anh_Utils::Clock::getSingleton()->getLocalTime();
+	float elapsed	= static_cast<float>(now - *lastTime) / static_cast<float>(unit);
+
+	*lastTime = now;
+
+	return elapsed;
+}
 //=======================================================================================================================
 void StructureManagerChatHandler::Process()
 {
@@ -30,6 +30,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "ChatManager.h"
 #include "ChatMessageLib.h"
+#include "StructureSimulation.h"
 //#include "TradeManagerHelp.h"
 
 #include "DatabaseManager/DatabaseCallback.h"
@@ -53,6 +54,11 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #define	gStructureManager	StructureManager::getSingletonPtr()
 
+// all simulation queries share this ordering key, a reload can't overtake the writes queued before it
+#define STRUCTURE_SIM_DB_KEY		0x5354524d
+// most rows per batched write, a batch is cut earlier when its statement would not fit a database job
+#define STRUCTURE_SIM_BATCH_ROWS	150
+
 //======================================================================================================================
 
 typedef std::queue<uint32> TimerEventQueue;
@@ -77,12 +83,25 @@ typedef std::vector<std::tr1::shared_ptr<Timer> >	TimerList;
 //typedef std::vector<HarvesterHopperItem*>			HopperResourceList;
 
 
+enum STRMQueryType
+{
+	STRMQuery_NULL						=	0,
+	STRMQuery_StructureMailOOFMaint		=	5,
+	STRMQuery_StructureMailDamage		=	6,
+	STRMQuery_StructureMailCondZero		=	7,
+	STRMQuery_DoneFactoryUpdate			=	11,
+	STRMQuery_SimulationLoad			=	12,
+	STRMQuery_SimulationBanks			=	13
+
+};
+
 enum SRMTimer
 {
 	SRMTimer_CheckHarvesterHopper		=	1,
 	SRMTimer_CheckHarvesterMaintenance	=	2,
 	SRMTimer_CheckHarvesterPower		=	3,
-	SRMTimer_CheckFactory				=	4
+	SRMTimer_CheckFactory				=	4,
+	SRMTimer_ReloadSimulation			=	5
 };
 
 
@@ -136,6 +155,18 @@ class StructureManagerChatHandler : public MessageDispatchCallback, public Datab
 
 		void				handleFactoryUpdate();
 
+		// the in memory simulation
+		void				_loadSimulation();
+		void				_persistSimulation();
+		void				_persistDeltas(const int8* table,const int8* column,const int8* idColumn,const int8* filter,StructureSimDeltaList* deltas);
+		void				_persistHarvested(StructureSimDeltaList* deltas);
+		void				_persistDeactivated(StructureSimEventList* harvesters);
+		void				_persistShutDowns(const int8* recheck,std::vector<uint64>* harvesters);
+		void				_sendSimulationWrite(const int8* sql);
+		void				_processSimulationEvents();
+		void				_requestStructureMail(STRMQueryType type,uint64 structureId);
+		float				_elapsed(uint64* lastTime,uint64 unit);
+
 
 		HarvesterList*		getHarvesterList(){return &mHarvesterList;}
 
@@ -157,22 +188,13 @@ class StructureManagerChatHandler : public MessageDispatchCallback, public Datab
 
 		HarvesterList				mHarvesterList;
 
-};
-
-enum STRMQueryType
-{
-	STRMQuery_NULL						=	0,
-	STRMQuery_HopperUpdate				=	1,
-	STRMQuery_DoneHarvestUpdate			=	2,
-	STRMQuery_DoneHarvesterUsePower		=	3,
-	STRMQuery_DoneStructureMaintenance	=	4,
-	STRMQuery_StructureMailOOFMaint		=	5,
-	STRMQuery_StructureMailDamage		=	6,
-	STRMQuery_StructureMailCondZero		=	7,
-	STRMQuery_MaintenanceUpdate			=	8,
-	STRMQuery_PowerUpdate				=	9,
-	STRMQuery_FactoryUpdate				=	10,
-	STRMQuery_DoneFactoryUpdate			=	11,
+		StructureSimulation			mSimulation;
+		uint64						mLastHarvestTime;
+		uint64						mLastPowerTime;
+		uint64						mLastMaintenanceTime;
+		bool						mSimulationLoaded;
+		bool						mSimulationLoading;
+		bool						mSimulationSettling;
 
 };
 
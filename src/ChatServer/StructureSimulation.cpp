@@ -0,0 +1,424 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#include "StructureSimulation.h"
+
+#include <cmath>
+
+//======================================================================================================================
+
+StructureSimulation::StructureSimulation()
+{
+}
+
+//======================================================================================================================
+
+StructureSimulation::~StructureSimulation()
+{
+}
+
+//======================================================================================================================
+//
+// the whole units were written, the tables we reload from don't have the fractions. A harvester making less than a
+// unit per reload would never produce anything if we dropped them
+//
+
+void StructureSimulation::clear()
+{
+	mCarried.clear();
+
+	uint32 count = getStructureCount();
+
+	for(uint32 i = 0; i < count; i++)
+	{
+		if(mPendingHarvest[i] <= 0.0f && mPendingPower[i] <= 0.0f && mPendingMaintenance[i] <= 0.0f)
+			continue;
+
+		StructureSimCarry carry = { mResources[i], mPendingHarvest[i], mPendingPower[i], mPendingMaintenance[i] };
+		mCarried[mIds[i]] = carry;
+	}
+
+	mIds.clear();
+	mOwners.clear();
+	mResources.clear();
+	mFlags.clear();
+	mRunning.clear();
+	mExtractionRate.clear();
+	mHopperSize.clear();
+	mHopperFill.clear();
+	mPowerPerHour.clear();
+	mPowerReserve.clear();
+	mMaintenancePerHour.clear();
+	mMaintenanceReserve.clear();
+	mArrears.clear();
+	mCondition.clear();
+	mPendingHarvest.clear();
+	mPendingPower.clear();
+	mPendingMaintenance.clear();
+	mPendingCondition.clear();
+}
+
+//======================================================================================================================
+
+void StructureSimulation::reserve(uint32 count)
+{
+	mIds.reserve(count);
+	mOwners.reserve(count);
+	mResources.reserve(count);
+	mFlags.reserve(count);
+	mRunning.reserve(count);
+	mExtractionRate.reserve(count);
+	mHopperSize.reserve(count);
+	mHopperFill.reserve(count);
+	mPowerPerHour.reserve(count);
+	mPowerReserve.reserve(count);
+	mMaintenancePerHour.reserve(count);
+	mMaintenanceReserve.reserve(count);
+	mArrears.reserve(count);
+	mCondition.reserve(count);
+	mPendingHarvest.reserve(count);
+	mPendingPower.reserve(count);
+	mPendingMaintenance.reserve(count);
+	mPendingCondition.reserve(count);
+}
+
+//======================================================================================================================
+
+void StructureSimulation::addStructure(const StructureSimState& state)
+{
+	bool running = (state.mFlags & StructureSimFlag_Harvester) && (state.mFlags & StructureSimFlag_Active) && state.mCondition > 0;
+
+	mIds.push_back(state.mId);
+	mOwners.push_back(state.mOwner);
+	mResources.push_back(state.mResourceId);
+	mFlags.push_back(state.mFlags);
+	mRunning.push_back(running ? 1.0f : 0.0f);
+	mExtractionRate.push_back(state.mExtractionRate);
+	mHopperSize.push_back(state.mHopperSize);
+	mHopperFill.push_back(state.mHopperFill);
+	mPowerPerHour.push_back(state.mPowerPerHour);
+	mPowerReserve.push_back(state.mPowerReserve);
+	mMaintenancePerHour.push_back(state.mMaintenancePerHour);
+	mMaintenanceReserve.push_back(state.mMaintenanceReserve);
+	mArrears.push_back(0.0f);
+	mCondition.push_back(state.mCondition);
+	mPendingHarvest.push_back(0.0f);
+	mPendingPower.push_back(0.0f);
+	mPendingMaintenance.push_back(0.0f);
+	mPendingCondition.push_back(0.0f);
+
+	StructureSimCarryMap::iterator it = mCarried.find(state.mId);
+
+	if(it != mCarried.end())
+	{
+		uint32 index = static_cast<uint32>(mIds.size() - 1);
+
+		// the harvest of a resource the hopper no longer gets is lost
+		if(it->second.mResourceId == state.mResourceId)
+		{
+			mHopperFill[index]		+= it->second.mHarvest;
+			mPendingHarvest[index]	= it->second.mHarvest;
+		}
+
+		float power			= mPowerReserve[index] - it->second.mPower;
+		float maintenance	= mMaintenanceReserve[index] - it->second.mMaintenance;
+
+		mPowerReserve[index]		= power > 0.0f ? power : 0.0f;
+		mPendingPower[index]		= it->second.mPower;
+		mMaintenanceReserve[index]	= maintenance > 0.0f ? maintenance : 0.0f;
+		mPendingMaintenance[index]	= it->second.mMaintenance;
+
+		mCarried.erase(it);
+	}
+
+	// the resource despawned while the harvester was running
+	if(running && !(state.mFlags & StructureSimFlag_ResourceActive))
+	{
+		_shutDown(static_cast<uint32>(mIds.size() - 1),StructureSimEvent_ResourceInactive);
+	}
+}
+
+//======================================================================================================================
+
+void StructureSimulation::harvest(float minutes)
+{
+	uint32 count = getStructureCount();
+
+	if(!count)
+		return;
+
+	const float*	running	= &mRunning[0];
+	const float*	rate	= &mExtractionRate[0];
+	const float*	size	= &mHopperSize[0];
+	float*			fill	= &mHopperFill[0];
+	float*			pending	= &mPendingHarvest[0];
+
+	for(uint32 i = 0; i < count; i++)
+	{
+		float amount	= running[i] * rate[i] * minutes;
+		float room		= size[i] - fill[i];
+
+		room	= room > 0.0f ? room : 0.0f;
+		amount	= amount < room ? amount : room;
+
+		fill[i]		+= amount;
+		pending[i]	+= amount;
+	}
+
+	// harvesters that topped out their hopper shut down
+	for(uint32 i = 0; i < count; i++)
+	{
+		if(running[i] > 0.0f && fill[i] >= size[i])
+		{
+			_shutDown(i,StructureSimEvent_HopperFull);
+		}
+	}
+}
+
+//======================================================================================================================
+
+void StructureSimulation::usePower(float hours)
+{
+	uint32 count = getStructureCount();
+
+	if(!count)
+		return;
+
+	const float*	running	= &mRunning[0];
+	const float*	rate	= &mPowerPerHour[0];
+	float*			power	= &mPowerReserve[0];
+	float*			pending	= &mPendingPower[0];
+
+	for(uint32 i = 0; i < count; i++)
+	{
+		float used = running[i] * rate[i] * hours;
+
+		used = used < power[i] ? used : power[i];
+		used = used > 0.0f ? used : 0.0f;
+
+		power[i]	-= used;
+		pending[i]	+= used;
+	}
+
+	for(uint32 i = 0; i < count; i++)
+	{
+		if(running[i] > 0.0f && rate[i] > 0.0f && power[i] <= 0.0f)
+		{
+			_shutDown(i,StructureSimEvent_OutOfPower);
+		}
+	}
+}
+
+//======================================================================================================================
+//
+// what the reserve can't cover goes into arrears, see settleMaintenance()
+//
+
+void StructureSimulation::useMaintenance(float hours)
+{
+	uint32 count = getStructureCount();
+
+	if(!count)
+		return;
+
+	const float*	rate	= &mMaintenancePerHour[0];
+	float*			reserve	= &mMaintenanceReserve[0];
+	float*			arrears	= &mArrears[0];
+	float*			pending	= &mPendingMaintenance[0];
+
+	for(uint32 i = 0; i < count; i++)
+	{
+		float cost = rate[i] * hours;
+		float paid = cost < reserve[i] ? cost : reserve[i];
+
+		paid = paid > 0.0f ? paid : 0.0f;
+
+		reserve[i]	-= paid;
+		pending[i]	+= paid;
+		arrears[i]	+= cost - paid;
+	}
+}
+
+//======================================================================================================================
+
+bool StructureSimulation::hasArrears() const
+{
+	uint32 count = getStructureCount();
+
+	for(uint32 i = 0; i < count; i++)
+	{
+		if(mArrears[i] > 0.0f)
+			return true;
+	}
+
+	return false;
+}
+
+//======================================================================================================================
+//
+// the bank pays the arrears in full or not at all, unpaid maintenance is taken out of the condition
+//
+
+void StructureSimulation::settleMaintenance(OwnerCreditMap* credits)
+{
+	uint32 count = getStructureCount();
+
+	for(uint32 i = 0; i < count; i++)
+	{
+		if(mArrears[i] <= 0.0f)
+			continue;
+
+		// condemned structures only wait for their destruction
+		if(mCondition[i] <= 0)
+		{
+			mArrears[i] = 0.0f;
+			continue;
+		}
+
+		uint32 owed = static_cast<uint32>(ceil(mArrears[i]));
+		mArrears[i] = 0.0f;
+
+		OwnerCreditMap::iterator it = credits->find(mOwners[i]);
+
+		if(it != credits->end() && it->second >= owed)
+		{
+			it->second				-= owed;
+			mBankDebits[mOwners[i]]	+= owed;
+
+			StructureSimEventItem item = { mIds[i], StructureSimEvent_MaintenanceFromBank };
+			mEvents.push_back(item);
+			continue;
+		}
+
+		int32 damage = owed < static_cast<uint32>(mCondition[i]) ? static_cast<int32>(owed) : mCondition[i];
+
+		mCondition[i]			-= damage;
+		mPendingCondition[i]	+= static_cast<float>(damage);
+
+		if(mCondition[i] > 0)
+		{
+			StructureSimEventItem item = { mIds[i], StructureSimEvent_Damaged };
+			mEvents.push_back(item);
+			continue;
+		}
+
+		StructureSimEventItem item = { mIds[i], StructureSimEvent_Condemned };
+		mEvents.push_back(item);
+
+		if(mRunning[i] > 0.0f)
+		{
+			mRunning[i]	= 0.0f;
+			mFlags[i]	&= ~StructureSimFlag_Active;
+			mDeactivated.push_back(item);
+		}
+	}
+}
+
+//======================================================================================================================
+
+void StructureSimulation::collectHarvested(StructureSimDeltaList* deltas)
+{
+	_collect(&mPendingHarvest,deltas,true);
+}
+
+//======================================================================================================================
+
+void StructureSimulation::collectPowerUsed(StructureSimDeltaList* deltas)
+{
+	_collect(&mPendingPower,deltas,false);
+}
+
+//======================================================================================================================
+
+void StructureSimulation::collectMaintenanceUsed(StructureSimDeltaList* deltas)
+{
+	_collect(&mPendingMaintenance,deltas,false);
+}
+
+//======================================================================================================================
+
+void StructureSimulation::collectConditionLost(StructureSimDeltaList* deltas)
+{
+	_collect(&mPendingCondition,deltas,false);
+}
+
+//======================================================================================================================
+
+void StructureSimulation::collectBankDebits(StructureSimDeltaList* deltas)
+{
+	OwnerCreditMap::iterator it = mBankDebits.begin();
+
+	while(it != mBankDebits.end())
+	{
+		StructureSimDelta delta = { it->first, it->first, it->second };
+		deltas->push_back(delta);
+
+		++it;
+	}
+
+	mBankDebits.clear();
+}
+
+//======================================================================================================================
+
+void StructureSimulation::collectDeactivated(StructureSimEventList* harvesters)
+{
+	harvesters->insert(harvesters->end(),mDeactivated.begin(),mDeactivated.end());
+	mDeactivated.clear();
+}
+
+//======================================================================================================================
+
+void StructureSimulation::_shutDown(uint32 index,uint32 event)
+{
+	mRunning[index]	= 0.0f;
+	mFlags[index]	&= ~StructureSimFlag_Active;
+
+	StructureSimEventItem item = { mIds[index], event };
+	mDeactivated.push_back(item);
+	mEvents.push_back(item);
+}
+
+//======================================================================================================================
+
+void StructureSimulation::_collect(std::vector<float>* pending,StructureSimDeltaList* deltas,bool withResource)
+{
+	uint32 count = getStructureCount();
+
+	for(uint32 i = 0; i < count; i++)
+	{
+		float whole = floor((*pending)[i]);
+
+		if(whole < 1.0f)
+			continue;
+
+		(*pending)[i] -= whole;
+
+		StructureSimDelta delta = { mIds[i], withResource ? mResources[i] : 0, static_cast<uint32>(whole) };
+		deltas->push_back(delta);
+	}
+}
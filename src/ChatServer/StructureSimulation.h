@@ -0,0 +1,187 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#ifndef ANH_CHATSERVER_STRUCTURESIMULATION_H
+#define ANH_CHATSERVER_STRUCTURESIMULATION_H
+
+#include "Utils/typedefs.h"
+
+#include <map>
+#include <vector>
+
+//======================================================================================================================
+
+enum StructureSimFlag
+{
+	StructureSimFlag_Harvester		=	1,
+	StructureSimFlag_Active			=	2,
+	StructureSimFlag_ResourceActive	=	4
+};
+
+enum StructureSimEvent
+{
+	StructureSimEvent_MaintenanceFromBank	=	1,	// the reserve ran dry, the owners bank paid
+	StructureSimEvent_Damaged				=	2,	// nobody paid, the structure lost condition
+	StructureSimEvent_Condemned				=	3,	// condition reached zero
+	StructureSimEvent_OutOfPower			=	4,
+	StructureSimEvent_HopperFull			=	5,
+	StructureSimEvent_ResourceInactive		=	6
+};
+
+// one row of the load query
+struct StructureSimState
+{
+	uint64	mId;
+	uint64	mOwner;
+	uint64	mResourceId;
+
+	float	mMaintenanceReserve;
+	float	mMaintenancePerHour;
+	float	mPowerReserve;
+	float	mPowerPerHour;
+	float	mExtractionRate;		// units per minute
+	float	mHopperSize;
+	float	mHopperFill;
+
+	int32	mCondition;
+	uint32	mFlags;
+};
+
+struct StructureSimEventItem
+{
+	uint64	mStructureId;
+	uint32	mEvent;
+};
+
+// a change to write back, mKey is the resource for hopper deltas and the bank for credit deltas
+struct StructureSimDelta
+{
+	uint64	mId;
+	uint64	mKey;
+	uint32	mAmount;
+};
+
+// what a structure had pending below a whole unit when the state got reloaded
+struct StructureSimCarry
+{
+	uint64	mResourceId;
+	float	mHarvest;
+	float	mPower;
+	float	mMaintenance;
+};
+
+typedef std::vector<StructureSimEventItem>	StructureSimEventList;
+typedef std::vector<StructureSimDelta>		StructureSimDeltaList;
+typedef std::map<uint64,uint32>				OwnerCreditMap;
+typedef std::map<uint64,StructureSimCarry>	StructureSimCarryMap;
+
+//======================================================================================================================
+//
+// Harvesters and every other player structure of the galaxy, simulated in memory.
+// The state is loaded in one go and kept as parallel arrays, each pass runs straight over them.
+// Whatever a pass used up or produced piles up as pending delta and is handed out in whole units by the
+// collect functions, the fractions carry over to the next pass and across a reload. Shut downs and maintenance trouble
+// are queued as events.
+//
+// Maintenance the reserve can't cover stays in arrears until settleMaintenance() got the owners bank balances,
+// then it is taken from the bank, or from the structures condition if the bank can't pay it either.
+//
+
+class StructureSimulation
+{
+	public:
+
+		StructureSimulation();
+		~StructureSimulation();
+
+		// keeps the pending fractions, addStructure() hands them back to the same structure
+		void					clear();
+		void					reserve(uint32 count);
+		void					addStructure(const StructureSimState& state);
+
+		uint32					getStructureCount() const { return static_cast<uint32>(mIds.size()); }
+		bool					isRunning(uint32 index) const { return mRunning[index] > 0.0f; }
+		float					getHopperFill(uint32 index) const { return mHopperFill[index]; }
+		float					getPowerReserve(uint32 index) const { return mPowerReserve[index]; }
+		float					getMaintenanceReserve(uint32 index) const { return mMaintenanceReserve[index]; }
+		int32					getCondition(uint32 index) const { return mCondition[index]; }
+
+		// the passes
+		void					harvest(float minutes);
+		void					usePower(float hours);
+		void					useMaintenance(float hours);
+		void					settleMaintenance(OwnerCreditMap* credits);
+
+		bool					hasArrears() const;
+
+		// the pending changes in whole units, collecting them resets them
+		void					collectHarvested(StructureSimDeltaList* deltas);
+		void					collectPowerUsed(StructureSimDeltaList* deltas);
+		void					collectMaintenanceUsed(StructureSimDeltaList* deltas);
+		void					collectConditionLost(StructureSimDeltaList* deltas);
+		void					collectBankDebits(StructureSimDeltaList* deltas);
+		void					collectDeactivated(StructureSimEventList* harvesters);	// with the reason of the shut down
+
+		StructureSimEventList*	getEvents(){ return &mEvents; }
+
+	private:
+
+		void					_shutDown(uint32 index,uint32 event);
+		void					_collect(std::vector<float>* pending,StructureSimDeltaList* deltas,bool withResource);
+
+		std::vector<uint64>		mIds;
+		std::vector<uint64>		mOwners;
+		std::vector<uint64>		mResources;
+		std::vector<uint32>		mFlags;
+
+		// 1.0 while a harvester extracts, 0.0 otherwise
+		std::vector<float>		mRunning;
+
+		std::vector<float>		mExtractionRate;
+		std::vector<float>		mHopperSize;
+		std::vector<float>		mHopperFill;
+		std::vector<float>		mPowerPerHour;
+		std::vector<float>		mPowerReserve;
+		std::vector<float>		mMaintenancePerHour;
+		std::vector<float>		mMaintenanceReserve;
+		std::vector<float>		mArrears;
+		std::vector<int32>		mCondition;
+
+		std::vector<float>		mPendingHarvest;
+		std::vector<float>		mPendingPower;
+		std::vector<float>		mPendingMaintenance;
+		std::vector<float>		mPendingCondition;
+
+		StructureSimCarryMap	mCarried;
+		OwnerCreditMap			mBankDebits;
+		StructureSimEventList	mDeactivated;
+		StructureSimEventList	mEvents;
+};
+
+//======================================================================================================================
+
+#endif
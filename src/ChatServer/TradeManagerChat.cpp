@@ -33,6 +33,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "DatabaseManager/Database.h"
 #include "DatabaseManager/DataBinding.h"
 #include "DatabaseManager/DatabaseResult.h"
+#include "DatabaseManager/StatementParameters.h"
 
 #include "Common/atMacroString.h"
 #include "Common/DispatchClient.h"
@@ -1601,6 +1602,7 @@ void TradeManagerChatHandler::processGetAuctionDetails(Message* message,Dispatch
 void TradeManagerChatHandler::processHandleopAuctionQueryHeadersMessage(Message* message,DispatchClient* client)
 {
 	TradeManagerAsyncContainer* asyncContainer;
+	StatementParameters			params;
 
 	//uint64 time = (getGlobalTickCount()/1000);
 
@@ -1644,7 +1646,8 @@ void TradeManagerChatHandler::processHandleopAuctionQueryHeadersMessage(Message*
 	{
 	case TRMVendor:
 		{
-			sprintf(query.RegionQuery," (c.bazaar_id = %"PRIu64")",query.vendorID);
+			sprintf(query.RegionQuery," (c.bazaar_id = ?)");
+			params.addUint64(query.vendorID);
 
 		}
 		break;
@@ -1652,13 +1655,15 @@ void TradeManagerChatHandler::processHandleopAuctionQueryHeadersMessage(Message*
 	case TRMRegion:
 		{
 			//for now Planet
-			sprintf(query.RegionQuery," (c.region_id = %"PRIu32")",TerminalRegionbyID(query.vendorID));
+			sprintf(query.RegionQuery," (c.region_id = ?)");
+			params.addUint32(TerminalRegionbyID(query.vendorID));
 		}
 		break;
 
 	case TRMPlanet:
 		{
-			sprintf(query.RegionQuery," (c.planet_id = %"PRIu32")",player->getPlanetId());
+			sprintf(query.RegionQuery," (c.planet_id = ?)");
+			params.addUint32(player->getPlanetId());
 
 		}
 		break;
@@ -1687,10 +1692,8 @@ void TradeManagerChatHandler::processHandleopAuctionQueryHeadersMessage(Message*
 
 		case TRMVendor_MySales://what Im selling at the bazaar
 		{
-			sprintf(query.WindowQuery," ((c.type = %"PRIu32") or (c.type = %"PRIu32"))AND",TRMVendor_Auction,TRMVendor_Instant);
-			int8 tmp[128];
-			sprintf(tmp," (c.owner_id = %"PRIu64")",player->getCharId());
-			strcat(query.WindowQuery,tmp);
+			sprintf(query.WindowQuery," ((c.type = %"PRIu32") or (c.type = %"PRIu32"))AND (c.owner_id = ?)",TRMVendor_Auction,TRMVendor_Instant);
+			params.addUint64(player->getCharId());
 
 		}
 		break;
@@ -1703,30 +1706,25 @@ void TradeManagerChatHandler::processHandleopAuctionQueryHeadersMessage(Message*
 			//strcat(query.WindowQuery,tmp);
 			//sprintf(sql,"SELECT c.auction_id, owner_id, c.bazaar_id, type, start, premium, category, itemtype, price, name, description, c.region_id, c.bidder_name, c.planet_id, firstname, bazaar_string, cbh.proxy_bid, cbh.max_bid FROM swganh.commerce_auction c INNER JOIN swganh.characters ch on (c.owner_id = ch.id) INNER join swganh.commerce_bazaar cb ON (cb.bazaar_id = c.bazaar_id) inner join swganh.commerce_bidhistory cbh ON (cbh.auction_id = c.auction_id) AND c.owner_id = ch.id WHERE");
 
-			sprintf(query.WindowQuery," ((c.type = %"PRIu32") or (c.type = %"PRIu32")) AND",TRMVendor_Auction,TRMVendor_Instant);
-			int8 tmp[128],end[128],*sqlPointer;
-			sprintf(tmp," (cbh.bidder_name = '");
-			sqlPointer = tmp + strlen(tmp);
-			sqlPointer += mDatabase->Escape_String(sqlPointer,player->getName().getAnsi(),player->getName().getLength());
-			*sqlPointer++ = '\'';
-			*sqlPointer++ = '\0';
-			strcat(query.WindowQuery,tmp);
-			sprintf(end," )");
-			strcat(query.WindowQuery,end);
+			sprintf(query.WindowQuery," ((c.type = %"PRIu32") or (c.type = %"PRIu32")) AND (cbh.bidder_name = ? )",TRMVendor_Auction,TRMVendor_Instant);
+			params.addString(player->getName().getAnsi());
 			sprintf(sql,"SELECT c.auction_id, owner_id, c.bazaar_id, type, start, premium, category, itemtype, price, name, description, c.region_id, c.bidder_name, c.planet_id, firstname, bazaar_string, cbh.proxy_bid, cbh.max_bid FROM swganh.commerce_auction c INNER JOIN swganh.characters ch on (c.owner_id = ch.id) INNER join swganh.commerce_bazaar cb ON (cb.bazaar_id = c.bazaar_id) inner join swganh.commerce_bidhistory cbh ON (cbh.auction_id = c.auction_id) AND c.owner_id = ch.id WHERE");
 
 		}
 		break;
 		case TRMVendor_AvailableItems:
 		{
-			sprintf(query.WindowQuery," (c.type = %"PRIu32") AND (c.owner_id = %"PRIu64") ",TRMVendor_Ended,player->getCharId());
+			sprintf(query.WindowQuery," (c.type = %"PRIu32") AND (c.owner_id = ?) ",TRMVendor_Ended);
+			params.addUint64(player->getCharId());
 
 
 		}
 		break;
 		case TRMVendor_Offers:
 		{
-			sprintf(query.WindowQuery," (c.type = %"PRIu32") AND (c.bidder_name = %s) AND (c.bazaar_id = %"PRIu64")",TRMVendor_Offer,player->getName().getAnsi(),query.vendorID);
+			sprintf(query.WindowQuery," (c.type = %"PRIu32") AND (c.bidder_name = ?) AND (c.bazaar_id = ?)",TRMVendor_Offer);
+			params.addString(player->getName().getAnsi());
+			params.addUint64(query.vendorID);
 
 
 		}
@@ -1734,19 +1732,9 @@ void TradeManagerChatHandler::processHandleopAuctionQueryHeadersMessage(Message*
 		case TRMVendor_ForSale:
 		{
 			gLogger->log(LogManager::DEBUG,"trm vendor for sale");
-			sprintf(query.WindowQuery," ((c.type = %"PRIu32") or (c.type = %"PRIu32")) AND",TRMVendor_Auction,TRMVendor_Instant);
-			int8 tmp[128],end[128],*sqlPointer;
-			sprintf(tmp," (c.bidder_name = '");
-			sqlPointer = tmp + strlen(tmp);
-			sqlPointer += mDatabase->Escape_String(sqlPointer,player->getName().getAnsi(),player->getName().getLength());
-			*sqlPointer++ = '\'';
-			*sqlPointer++ = '\0';
-			strcat(query.WindowQuery,tmp);
-			sprintf(end," ) AND");
-			strcat(query.WindowQuery,end);
-
-			sprintf(tmp," (c.bazaar_id = %"PRIu64")",query.vendorID);
-			strcat(query.WindowQuery,tmp);
+			sprintf(query.WindowQuery," ((c.type = %"PRIu32") or (c.type = %"PRIu32")) AND (c.bidder_name = ? ) AND (c.bazaar_id = ?)",TRMVendor_Auction,TRMVendor_Instant);
+			params.addString(player->getName().getAnsi());
+			params.addUint64(query.vendorID);
 
 		}
 		break;
@@ -1763,13 +1751,15 @@ void TradeManagerChatHandler::processHandleopAuctionQueryHeadersMessage(Message*
 	{
 		if ((category << 24) == 0)
 		{
-			sprintf(query.CategoryQuery," ((c.category >> 8) = %"PRIu32")",(query.Category >> 8));
+			sprintf(query.CategoryQuery," ((c.category >> 8) = ?)");
+			params.addUint32(query.Category >> 8);
 
 		}
 		else
 		{
 			//were looking for a subcategory
-			sprintf(query.CategoryQuery," ((c.category) = %"PRIu32")",query.Category );
+			sprintf(query.CategoryQuery," ((c.category) = ?)");
+			params.addUint32(query.Category);
 		}
 	}
 	else sprintf(query.CategoryQuery," ");
@@ -1777,7 +1767,8 @@ void TradeManagerChatHandler::processHandleopAuctionQueryHeadersMessage(Message*
 
 
 	if (query.ItemTyp != 0){
-		sprintf(query.ItemTypQuery," (c.itemtype = %"PRIu32")",query.ItemTyp);
+		sprintf(query.ItemTypQuery," (c.itemtype = ?)");
+		params.addUint32(query.ItemTyp);
 
 	}
 	else
@@ -1785,10 +1776,9 @@ void TradeManagerChatHandler::processHandleopAuctionQueryHeadersMessage(Message*
 
 
 
-	int8 Limit[64];
+	// the parameters go in the order of their placeholders, the limit is last
 	uint32 StopTime;
 	StopTime = (static_cast<uint32>(getGlobalTickCount()) / 1000);
-	sprintf(Limit," AND (c.start > %"PRIu32") LIMIT %u, %u",StopTime,query.start, query.start+100);
 
 	//region or bazaar id
 
@@ -1820,7 +1810,11 @@ void TradeManagerChatHandler::processHandleopAuctionQueryHeadersMessage(Message*
 	}
 
 	strcat(sql,query.ItemTypQuery); //
-	strcat(sql,Limit); //
+	strcat(sql," AND (c.start > ?) LIMIT ?, ?");
+
+	params.addUint32(StopTime);
+	params.addUint32(query.start);
+	params.addUint32(query.start + 100);
 
 	asyncContainer = new TradeManagerAsyncContainer(TRMQuery_AuctionQuery,client);
 	div_t d;
@@ -1828,8 +1822,27 @@ void TradeManagerChatHandler::processHandleopAuctionQueryHeadersMessage(Message*
 	asyncContainer->BazaarPage = d.quot+1 ;
 	asyncContainer->BazaarWindow = query.Windowtype;
 	asyncContainer->Itemsstart = query.start;
-	mDatabase->ExecuteSqlAsync(this,asyncContainer,sql);
+	mDatabase->ExecuteStatementAsync(this,asyncContainer,_getAuctionStatement(sql),&params);
+
+}
+
+//=======================================================================================================================
+//
+// the search sql depends on the filters picked, there are only so many combinations though.
+// each one gets registered the first time someone searches with it
+//
+uint32 TradeManagerChatHandler::_getAuctionStatement(const int8* sql)
+{
+	AuctionStatementMap::iterator it = mAuctionStatements.find(sql);
+
+	if(it != mAuctionStatements.end())
+		return (*it).second;
+
+	uint32 statementId = mDatabase->RegisterStatement(sql);
+
+	mAuctionStatements.insert(std::make_pair(std::string(sql),statementId));
 
+	return statementId;
 }
 //=======================================================================================================================
 void TradeManagerChatHandler::ProcessRequestTypeList(Message* message,DispatchClient* client)
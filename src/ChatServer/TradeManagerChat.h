@@ -40,7 +40,9 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include <boost/thread/mutex.hpp>
 
+#include <map>
 #include <queue>
+#include <string>
 #include <vector>
 
 #if defined(__GNUC__)
@@ -74,6 +76,7 @@ typedef std::vector<Bazaar*>		BazaarList;
 //typedef std::vector<Timer*>			TimerList;
 typedef std::vector<std::tr1::shared_ptr<Timer> > TimerList;
 typedef std::vector<AuctionItem*>	AuctionList;
+typedef std::map<std::string,uint32>	AuctionStatementMap;
 
 //======================================================================================================================
 
@@ -118,6 +121,7 @@ class TradeManagerChatHandler : public MessageDispatchCallback, public DatabaseC
 		void				ProcessCreateAuction(Message* message,DispatchClient* client);
 		void				processAuctionBid(TradeManagerAsyncContainer* asynContainer, Player* player);
 		void				ProcessRequestTypeList(Message* message,DispatchClient* client);
+		uint32				_getAuctionStatement(const int8* sql);
 
 		void				ProcessBankTip(Message* message,DispatchClient* client);
 		void				processAuctionEMails(AuctionItem* AuctionTemp);
@@ -158,6 +162,7 @@ class TradeManagerChatHandler : public MessageDispatchCallback, public DatabaseC
 		uint32						mBazaarMaxBid;
 
 		AuctionList					mAuction;
+		AuctionStatementMap			mAuctionStatements;	// search sql to its registered statement
 
 
 
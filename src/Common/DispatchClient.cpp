@@ -28,8 +28,12 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 //#include <WINSOCK2.h>
 #include "DispatchClient.h"
 #include "Message.h"
+#include "MessageFactory.h"
+#include "MessageOpcodes.h"
 #include "NetworkManager/Session.h"
 
+#include <algorithm>
+
 
 //======================================================================================================================
 
@@ -53,3 +57,53 @@ void DispatchClient::SendChannelAUnreliable(Message* message, uint32 accountId,
 
 //======================================================================================================================
 
+void DispatchClient::SendChannelAMulticast(Message* message, const AccountIdList& accountIds, uint8 priority, bool unreliable)
+{
+	// opcode, priority, unreliable, count and the body have to fit a message
+	uint32 envelopeSize	= 8 + message->getSize();
+	uint32 maxRecipients	= (envelopeSize < 0xffff) ? std::min<uint32>((0xffff - envelopeSize) / 4, MULTICAST_MAX_RECIPIENTS) : 0;
+
+	// too big to be wrapped, route it the usual way
+	if(!maxRecipients)
+	{
+		for(uint32 i = 0; i < accountIds.size(); i++)
+		{
+			if(unreliable)
+				SendChannelAUnreliable(gMessageFactory->ShareMessage(message), accountIds[i], CR_Client, priority);
+			else
+				SendChannelA(gMessageFactory->ShareMessage(message), accountIds[i], CR_Client, priority);
+		}
+
+		gMessageFactory->DestroyMessage(message);
+		return;
+	}
+
+	uint32 sent = 0;
+
+	while(sent < accountIds.size())
+	{
+		uint32 count = std::min<uint32>(static_cast<uint32>(accountIds.size()) - sent, maxRecipients);
+
+		gMessageFactory->StartMessage();
+		gMessageFactory->addUint32(opClusterMulticast);
+		gMessageFactory->addUint8(priority);
+		gMessageFactory->addUint8(unreliable);
+		gMessageFactory->addUint16(static_cast<uint16>(count));
+
+		for(uint32 i = 0; i < count; i++)
+		{
+			gMessageFactory->addUint32(accountIds[sent + i]);
+		}
+
+		gMessageFactory->addData(message->getData(), message->getSize());
+
+		// the envelope itself always travels reliable, the connection server applies the flag per client
+		SendChannelA(gMessageFactory->EndMessage(), 0, CR_Connection, priority);
+
+		sent += count;
+	}
+
+	gMessageFactory->DestroyMessage(message);
+}
+
+//======================================================================================================================
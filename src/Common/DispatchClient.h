@@ -31,6 +31,12 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "NetworkManager/NetworkClient.h"
 #include "Utils/typedefs.h"
 
+#include <vector>
+
+typedef std::vector<uint32>	AccountIdList;
+
+// upper bound of account ids carried by a single opClusterMulticast
+#define MULTICAST_MAX_RECIPIENTS	1024
 
 //======================================================================================================================
 
@@ -40,6 +46,11 @@ class DispatchClient : public NetworkClient
   
 		virtual void	SendChannelA(Message* message, uint32 accountId, uint8 serverId, uint8 priority);
 		virtual void	SendChannelAUnreliable(Message* message, uint32 accountId, uint8 serverId, uint8 priority);
+
+		// Sends one message to many clients. The connection server gets the body once along with the account ids
+		// and hands every client a share of it. Any client will do, they all sit on the same connection server link.
+		void			SendChannelAMulticast(Message* message, const AccountIdList& accountIds, uint8 priority, bool unreliable = false);
+
 		void			setAccountId(uint32 id){ mAccountId = id; };
 
 		uint32			getAccountId(void){ return mAccountId; };
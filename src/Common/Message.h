@@ -29,6 +29,10 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #define ANH_LOGINSERVER_MESSAGE_H
 
 #include "Utils/typedefs.h"
+#include "Utils/atomic.h"
+
+class MessageFactory;
+
 enum MessagePath
 {
 	MP_None = 0,
@@ -48,6 +52,8 @@ enum MessagePath
 //======================================================================================================================
 class Message
 {
+  friend class MessageFactory;
+
 public:
                               Message(void)
                               : mCreateTime(0)
@@ -64,6 +70,10 @@ public:
 							  , mLogged(false)
 							  , mLogTime(0)
 							  , mSession(NULL)
+                              , mPayloadOwner(NULL)
+                              , mRefCount(1)
+                              , mReleased(false)
+                              , mFactory(NULL)
                               {}
 
   void                        Init(int8* data, uint16 len)      { mData = data; mSize = len; mIndex = 0;}
@@ -91,7 +101,39 @@ public:
   void                        setCreateTime(uint64 time)        { mCreateTime = time; }
   void                        setQueueTime(uint64 time)         { mQueueTime = time; }
   void                        setFastpath(bool fastpath)        { mFastpath = fastpath; }
-  void                        setPendingDelete(bool pending)    { mPendingDelete = pending; }
+
+  // A shared message has no payload of its own, it points at the payload of its owner (see MessageFactory::ShareMessage).
+  // The owner only becomes deletable once it and all of its shares have been released.
+  Message*                    getPayloadOwner(void)             { return mPayloadOwner; }
+  void                        setPayloadOwner(Message* owner)   { Anh_Utils::atomicIncrement(&owner->mRefCount); mPayloadOwner = owner; mData = owner->mData; mSize = owner->mSize; }
+
+  // setPendingDelete(true) releases this message, whoever is done with it calls it exactly once
+  void                        setPendingDelete(bool pending)
+  {
+    if(!pending)
+    {
+      mPendingDelete = false;
+      return;
+    }
+
+    if(mReleased)
+    {
+      return;
+    }
+
+    mReleased = true;
+
+    // once reclaimed our factory may reuse us right away, so the owner goes first
+    if(mPayloadOwner)
+    {
+      mPayloadOwner->_releasePayload();
+      _reclaim();
+    }
+    else
+    {
+      _releasePayload();
+    }
+  }
 
   void                        getInt8(int8& data)               { data = *(int8*)&mData[mIndex]; mIndex += sizeof(int8); }
   void                        getUint8(uint8& data)             { data = *(uint8*)&mData[mIndex]; mIndex += sizeof(uint8); }
@@ -133,6 +175,11 @@ public:
   void*						  mSession;
 
 private:
+  void                        _releasePayload(void)             { if(!Anh_Utils::atomicDecrement(&mRefCount)) _reclaim(); }
+
+  // flags us deletable and hands us back to the factory we were created by (see MessageFactory.cpp)
+  void                        _reclaim(void);
+
   uint64                      mCreateTime;
   uint64                      mQueueTime;
   uint32                      mAccountId;
@@ -146,6 +193,12 @@ private:
   
   int8*                       mData;
 
+  Message*                    mPayloadOwner;
+  volatile uint32             mRefCount;
+  bool                        mReleased;
+
+  MessageFactory*             mFactory;
+
 };
 
 class CompareMsg
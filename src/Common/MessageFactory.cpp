@@ -36,7 +36,47 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include <cassert>
 #include <cstring>
 
-// TODO: There is no bounds checking on the heap yet.
+//======================================================================================================================
+//
+// Every block starts with this header, the Message follows and then its payload.
+// mNext links the block into its page's free list or the factory's released list,
+// mLivePrev / mLiveNext into the factory's list of live messages, or its list of pinned ones
+//
+
+struct MessageBlock
+{
+	MessageBlock*		mNext;
+	MessageBlock*		mLivePrev;
+	MessageBlock*		mLiveNext;
+	MessageSlabPage*	mPage;		// NULL for messages too big for our biggest size class and pinned ones
+	uint64				mSize;		// size of the own allocation, unused otherwise
+	bool				mPinned;	// linked into the pinned messages instead of the live ones
+};
+
+struct MessageSlabPage
+{
+	MessageSlabPage*	mNext;
+	MessageSlabPage*	mPrev;
+	MessageBlock*		mFreeList;
+	int8*				mMemory;
+	uint32				mSizeClass;
+	uint32				mBlocksInUse;
+	bool				mOverflow;	// not part of our heap, deleted once empty
+	bool				mPartial;	// linked into its size class
+};
+
+//======================================================================================================================
+
+static inline Message* _messageFromBlock(MessageBlock* block)
+{
+	return reinterpret_cast<Message*>(reinterpret_cast<int8*>(block) + sizeof(MessageBlock));
+}
+
+static inline MessageBlock* _blockFromMessage(Message* message)
+{
+	return reinterpret_cast<MessageBlock*>(reinterpret_cast<int8*>(message) - sizeof(MessageBlock));
+}
+
 //======================================================================================================================
 
 MessageFactory* MessageFactory::mSingleton = 0;
@@ -44,31 +84,84 @@ MessageFactory* MessageFactory::mSingleton = 0;
 //======================================================================================================================
 
 MessageFactory::MessageFactory(uint32 heapSize,uint32 serviceId)
-: mCurrentMessage(0)
+: mBuildingMessage(false)
 , mCurrentMessageEnd(0)
 , mCurrentMessageStart(0)
-, mHeapStart(0)
-, mHeapEnd(0)
-, mHeapRollover(0)
 , mMessageHeap(NULL)
 , mHeapTotalSize(heapSize)
+, mHeapPages(0)
+, mPageTable(NULL)
+, mFreePages(NULL)
+, mReleasedBlocks(NULL)
+, mLiveHead(NULL)
+, mLiveTail(NULL)
+, mPinnedHead(NULL)
 , mMessagesCreated(0)
 , mMessagesDestroyed(0)
+, mPagesInUse(0)
+, mOverflowPages(0)
+, mLargeMessages(0)
+, mLargeBytes(0)
+, mPinnedMessages(0)
+, mPinnedBytes(0)
 , mServiceId(0)
 , mHeapWarnLevel(80.0)
 , mMaxHeapUsedPercent(0)
+, mCurrentUsed(0)
 {
 	// the singleton is only for use with the zone - the services use their own instantiations as we need 1 factory per thread
 	// as the factory is not thread safe
 
-	// Allocate our message heap.
-	mMessageHeap = new int8[mHeapTotalSize];
-	memset(mMessageHeap, 0xed, mHeapTotalSize);
-	mHeapStart = mMessageHeap;
-	mHeapEnd = mMessageHeap;
+	// Allocate our message heap and cut it into pages, they get assigned to size classes on demand
+	mHeapPages = mHeapTotalSize / MESSAGE_SLAB_PAGE_SIZE;
+
+	if(!mHeapPages)
+		mHeapPages = 1;
+
+	mHeapTotalSize	= mHeapPages * MESSAGE_SLAB_PAGE_SIZE;
+	mMessageHeap	= new int8[mHeapTotalSize];
+	mPageTable		= new MessageSlabPage[mHeapPages];
+
+	for(uint32 i = mHeapPages; i > 0; i--)
+	{
+		MessageSlabPage* page = &mPageTable[i - 1];
+
+		page->mMemory		= mMessageHeap + (i - 1) * MESSAGE_SLAB_PAGE_SIZE;
+		page->mFreeList		= NULL;
+		page->mPrev			= NULL;
+		page->mSizeClass	= 0;
+		page->mBlocksInUse	= 0;
+		page->mOverflow		= false;
+		page->mPartial		= false;
+		page->mNext			= mFreePages;
+
+		mFreePages = page;
+	}
+
+	uint32 payloadSize = MESSAGE_SMALLEST_CLASS;
+
+	for(uint32 i = 0; i < MESSAGE_SIZE_CLASSES; i++)
+	{
+		MessageSizeClass* sizeClass = &mSizeClasses[i];
+
+		sizeClass->mPartialPages	= NULL;
+		sizeClass->mPayloadSize		= payloadSize;
+		sizeClass->mBlockSize		= (sizeof(MessageBlock) + sizeof(Message) + payloadSize + 7) & ~7;
+		sizeClass->mBlocksPerPage	= MESSAGE_SLAB_PAGE_SIZE / sizeClass->mBlockSize;
+		sizeClass->mPages			= 0;
+		sizeClass->mBlocksInUse		= 0;
+		sizeClass->mHighWaterMark	= 0;
+
+		payloadSize <<= 1;
+	}
+
+	// messages are put together here and copied to their block once we know their size
+	mCurrentMessageStart = new int8[MESSAGE_MAX_SIZE];
+	mCurrentMessageEnd = mCurrentMessageStart;
 
 	mLastHeapLevel = 0;
 	mLastHeapLevelTime = gClock->getSingleton()->getStoredTime();
+	mLastStatsTime = mLastHeapLevelTime;
 
 	mServiceId = serviceId;
 	mLastTime = Anh_Utils::Clock::getSingleton()->getLocalTime();
@@ -80,6 +173,18 @@ MessageFactory::~MessageFactory()
 {
 	// Here is the place for deletes of member data! Not in the Shutdown().
 	// But now start to pray that no one still uses these messages. Who knows in this mess?
+	while(mLiveHead)
+	{
+		_freeBlock(mLiveHead);
+	}
+
+	while(mPinnedHead)
+	{
+		_freeBlock(mPinnedHead);
+	}
+
+	delete[] mCurrentMessageStart;
+	delete[] mPageTable;
 	delete[] mMessageHeap;
 
 	// mSingleton = 0;
@@ -105,24 +210,16 @@ void MessageFactory::Process(void)
 }
 
 //======================================================================================================================
-// important is, that the size of the message class is not nuking our heap bounds! 
+
 void MessageFactory::StartMessage(void)
 {
 	// Do some garbage collection if we can.
 	_processGarbageCollection();
 
-	// Initialize the message start and end.
-	mCurrentMessageStart = mHeapStart;
-
-	assert(mCurrentMessage==0 && "Can't handle more than one message at once.");
+	assert(!mBuildingMessage && "Can't handle more than one message at once.");
 
+	mBuildingMessage = true;
 	mCurrentMessageEnd = mCurrentMessageStart;
-
-	// Adjust start bounds if necessary.
-	_adjustMessageStart(sizeof(Message));
-
-	mCurrentMessage = new(mCurrentMessageStart) Message();
-	mCurrentMessageEnd = mCurrentMessageStart + sizeof(Message);
 }
 
 //======================================================================================================================
@@ -153,42 +250,52 @@ uint32 MessageFactory::HeapWarningLevel(void)
 
 Message* MessageFactory::EndMessage(void)
 {
-	assert(mCurrentMessage && "Must call StartMessage before EndMessage.");
+	assert(mBuildingMessage && "Must call StartMessage before EndMessage.");
+
+	uint32 size = (uint32)(mCurrentMessageEnd - mCurrentMessageStart);
+
+	MessageBlock* block = _allocateBlock(size);
+	Message* message = new(_messageFromBlock(block)) Message();
 
-  // Do some garbage collection if we can.
-  //_processGarbageCollection();
+	int8* data = reinterpret_cast<int8*>(message) + sizeof(Message);
+	memcpy(data, mCurrentMessageStart, size);
 
-  // Just cast the message start
-  Message* message = mCurrentMessage;
+	message->Init(data, (uint16)size);
+	message->setCreateTime(gClock->getSingleton()->getStoredTime());
+	message->mFactory = this;
 
-  message->setData(mCurrentMessageStart + sizeof(Message));
-  message->setSize((uint16)(mCurrentMessageEnd - mCurrentMessageStart) - sizeof(Message));
-  message->setCreateTime(gClock->getSingleton()->getStoredTime());
-  mCurrentMessageStart = mCurrentMessageEnd;
+	// append it to our live messages, the oldest stay in front
+	block->mPinned = false;
+	block->mLiveNext = NULL;
+	block->mLivePrev = mLiveTail;
 
-  // Zero out our mCurrentMessage so we know we're not working on one.
-  mCurrentMessage = 0;
+	if(mLiveTail)
+		mLiveTail->mLiveNext = block;
+	else
+		mLiveHead = block;
 
-  //adjust heapstart to past our new message
-  mHeapStart += message->getSize() + sizeof(Message);
+	mLiveTail = block;
 
-  //Update our stats.
-  mMessagesCreated++;
-  mCurrentUsed = ((float)_getHeapSize() / (float)mHeapTotalSize)* 100.0f;
-  mMaxHeapUsedPercent = std::max<float>(mMaxHeapUsedPercent,  mCurrentUsed);
+	// We're not working on a message anymore.
+	mBuildingMessage = false;
 
+	//Update our stats.
+	mMessagesCreated++;
+	_updateHeapUsage();
+	mMaxHeapUsedPercent = std::max<float>(mMaxHeapUsedPercent,  mCurrentUsed);
 
 
-  // warn if we get near our boundaries
-  if(mCurrentUsed > mHeapWarnLevel)
-  {
-	  mHeapWarnLevel = static_cast<float>(mCurrentUsed+1.2);
-	  gLogger->log(LogManager::EMERGENCY,"MessageFactory Heap at %2.2f usage", mCurrentUsed);
-  } else
-  if (((mCurrentUsed+2.2) < mHeapWarnLevel) && mHeapWarnLevel > 80.0)
-	  mHeapWarnLevel = mCurrentUsed;
 
-  return message;
+	// warn if we get near our boundaries
+	if(mCurrentUsed > mHeapWarnLevel)
+	{
+		mHeapWarnLevel = static_cast<float>(mCurrentUsed+1.2);
+		gLogger->log(LogManager::EMERGENCY,"MessageFactory Heap at %2.2f usage", mCurrentUsed);
+	} else
+	if (((mCurrentUsed+2.2) < mHeapWarnLevel) && mHeapWarnLevel > 80.0)
+		mHeapWarnLevel = mCurrentUsed;
+
+	return message;
 }
 
 //======================================================================================================================
@@ -199,15 +306,101 @@ void MessageFactory::DestroyMessage(Message* message)
 	message->setPendingDelete(true);
 }
 
+//======================================================================================================================
+//
+// the pinned list is not ordered, only its head is kept
+//
+
+Message* MessageFactory::PinMessage(Message* message)
+{
+	MessageBlock* block = _blockFromMessage(message);
+
+	if(block->mPinned)
+		return(message);
+
+	assert(!message->getPayloadOwner() && message->mRefCount == 1 && "Only a message not shared yet can be pinned.");
+
+	uint32			blockSize	= sizeof(MessageBlock) + sizeof(Message) + message->getSize();
+	MessageBlock*	pinned		= reinterpret_cast<MessageBlock*>(new uint64[(blockSize + 7) / 8]);
+
+	pinned->mPage = NULL;
+	pinned->mSize = blockSize;
+
+	Message* moved = new(_messageFromBlock(pinned)) Message();
+
+	int8* data = reinterpret_cast<int8*>(moved) + sizeof(Message);
+	memcpy(data, message->getData(), message->getSize());
+
+	moved->Init(data, message->getSize());
+	moved->setCreateTime(message->getCreateTime());
+	moved->setPriority(message->getPriority());
+	moved->setAccountId(message->getAccountId());
+	moved->setDestinationId(message->getDestinationId());
+	moved->setRouted(message->getRouted());
+	moved->setFastpath(message->getFastpath());
+	moved->mFactory = this;
+
+	pinned->mPinned		= true;
+	pinned->mLivePrev	= NULL;
+	pinned->mLiveNext	= mPinnedHead;
+
+	if(mPinnedHead)
+		mPinnedHead->mLivePrev = pinned;
+
+	mPinnedHead = pinned;
+
+	mPinnedMessages++;
+	mPinnedBytes += blockSize;
+
+	// no one else knows the old one, it goes right away
+	message->~Message();
+	_freeBlock(block);
+	_updateHeapUsage();
+
+	return(moved);
+}
+
+//======================================================================================================================
+
+void MessageFactory::_unlinkBlock(MessageBlock* block)
+{
+	if(block->mLivePrev)
+		block->mLivePrev->mLiveNext = block->mLiveNext;
+	else if(block->mPinned)
+		mPinnedHead = block->mLiveNext;
+	else
+		mLiveHead = block->mLiveNext;
+
+	if(block->mLiveNext)
+		block->mLiveNext->mLivePrev = block->mLivePrev;
+	else if(!block->mPinned)
+		mLiveTail = block->mLivePrev;
+}
+
+//======================================================================================================================
+
+Message* MessageFactory::ShareMessage(Message* message)
+{
+	// a share of a share points at the original payload
+	Message* owner = message->getPayloadOwner() ? message->getPayloadOwner() : message;
+
+	StartMessage();
+	Message* share = EndMessage();
+
+	share->setPayloadOwner(owner);
+
+	return share;
+}
+
 //======================================================================================================================
 
 void MessageFactory::addInt8(int8 data)
 {
 	// Make sure we've called StartMessage()
-	assert(mCurrentMessage && "Must call StartMessage before adding data");
+	assert(mBuildingMessage && "Must call StartMessage before adding data");
 
-	// Adjust start bounds if necessary.
-	_adjustHeapStartBounds(sizeof(data));
+	// Make sure it fits.
+	_checkBuildBounds(sizeof(data));
 
 	// Insert our data and move our end pointer.
 	*mCurrentMessageEnd = data;
@@ -219,10 +412,10 @@ void MessageFactory::addInt8(int8 data)
 void MessageFactory::addUint8(uint8 data)
 {
 	// Make sure we've called StartMessage()
-	assert(mCurrentMessage && "Must call StartMessage before adding data");
+	assert(mBuildingMessage && "Must call StartMessage before adding data");
 
-	// Adjust start bounds if necessary.
-	_adjustHeapStartBounds(sizeof(data));
+	// Make sure it fits.
+	_checkBuildBounds(sizeof(data));
 
 	// Insert our data and move our end pointer.
 	*mCurrentMessageEnd = (uint8)data;
@@ -234,10 +427,10 @@ void MessageFactory::addUint8(uint8 data)
 void MessageFactory::addInt16(int16 data)
 {
 	// Make sure we've called StartMessage()
-	assert(mCurrentMessage && "Must call StartMessage before adding data");
+	assert(mBuildingMessage && "Must call StartMessage before adding data");
 
-	// Adjust start bounds if necessary.
-	_adjustHeapStartBounds(sizeof(data));
+	// Make sure it fits.
+	_checkBuildBounds(sizeof(data));
 
 	// Insert our data and move our end pointer.
 	*((int16*)mCurrentMessageEnd) = data;
@@ -249,10 +442,10 @@ void MessageFactory::addInt16(int16 data)
 void MessageFactory::addUint16(uint16 data)
 {
 	// Make sure we've called StartMessage()
-	assert(mCurrentMessage);
+	assert(mBuildingMessage && "Must call StartMessage before adding data");
 
-	// Adjust start bounds if necessary.
-	_adjustHeapStartBounds(sizeof(data));
+	// Make sure it fits.
+	_checkBuildBounds(sizeof(data));
 
 	// Insert our data and move our end pointer.
 	*((uint16*)mCurrentMessageEnd) = data;
@@ -264,10 +457,10 @@ void MessageFactory::addUint16(uint16 data)
 void MessageFactory::addInt32(int32 data)
 {
 	// Make sure we've called StartMessage()
-	assert(mCurrentMessage && "Must call StartMessage before adding data");
+	assert(mBuildingMessage && "Must call StartMessage before adding data");
 
-	// Adjust start bounds if necessary.
-	_adjustHeapStartBounds(sizeof(data));
+	// Make sure it fits.
+	_checkBuildBounds(sizeof(data));
 
 	// Insert our data and move our end pointer.
 	*((int32*)mCurrentMessageEnd) = data;
@@ -279,10 +472,10 @@ void MessageFactory::addInt32(int32 data)
 void MessageFactory::addUint32(uint32 data)
 {
 	// Make sure we've called StartMessage()
-	assert(mCurrentMessage && "Must call StartMessage before adding data");
+	assert(mBuildingMessage && "Must call StartMessage before adding data");
 
-	// Adjust start bounds if necessary.
-	_adjustHeapStartBounds(sizeof(data));
+	// Make sure it fits.
+	_checkBuildBounds(sizeof(data));
 
 	// Insert our data and move our end pointer.
 	*((uint32*)mCurrentMessageEnd) = data;
@@ -294,10 +487,10 @@ void MessageFactory::addUint32(uint32 data)
 void MessageFactory::addInt64(int64 data)
 {
 	// Make sure we've called StartMessage()
-	assert(mCurrentMessage && "Must call StartMessage before adding data");
+	assert(mBuildingMessage && "Must call StartMessage before adding data");
 
-	// Adjust start bounds if necessary.
-	_adjustHeapStartBounds(sizeof(data));
+	// Make sure it fits.
+	_checkBuildBounds(sizeof(data));
 
 	// Insert our data and move our end pointer.
 	*((int64*)mCurrentMessageEnd) = data;
@@ -309,10 +502,10 @@ void MessageFactory::addInt64(int64 data)
 void MessageFactory::addUint64(uint64 data)
 {
 	// Make sure we've called StartMessage()
-	assert(mCurrentMessage && "Must call StartMessage before adding data");
+	assert(mBuildingMessage && "Must call StartMessage before adding data");
 
-	// Adjust start bounds if necessary.
-	_adjustHeapStartBounds(sizeof(data));
+	// Make sure it fits.
+	_checkBuildBounds(sizeof(data));
 
 	// Insert our data and move our end pointer.
 	*((uint64*)mCurrentMessageEnd) = data;
@@ -324,10 +517,10 @@ void MessageFactory::addUint64(uint64 data)
 void MessageFactory::addFloat(float data)
 {
 	// Make sure we've called StartMessage()
-	assert(mCurrentMessage && "Must call StartMessage before adding data");
+	assert(mBuildingMessage && "Must call StartMessage before adding data");
 
-	// Adjust start bounds if necessary.
-	_adjustHeapStartBounds(sizeof(data));
+	// Make sure it fits.
+	_checkBuildBounds(sizeof(data));
 
 	// Insert our data and move our end pointer.
 	*((float*)mCurrentMessageEnd) = data;
@@ -339,10 +532,10 @@ void MessageFactory::addFloat(float data)
 void MessageFactory::addDouble(double data)
 {
 	// Make sure we've called StartMessage()
-	assert(mCurrentMessage && "Must call StartMessage before adding data");
+	assert(mBuildingMessage && "Must call StartMessage before adding data");
 
-	// Adjust start bounds if necessary.
-	_adjustHeapStartBounds(sizeof(data));
+	// Make sure it fits.
+	_checkBuildBounds(sizeof(data));
 
 	// Insert our data and move our end pointer.
 	*((double*)mCurrentMessageEnd) = data;
@@ -380,10 +573,10 @@ void MessageFactory::addString(const wchar_t* ustring)
 void MessageFactory::addString(const string& data)
 {
 	// Make sure we've called StartMessage()
-	assert(mCurrentMessage && "Must call StartMessage before adding data");
+	assert(mBuildingMessage && "Must call StartMessage before adding data");
 
-	// Adjust start bounds if necessary.
-	_adjustHeapStartBounds(data.getDataLength());
+	// Make sure it fits.
+	_checkBuildBounds(data.getDataLength());
 
 	// Insert our data and move our end pointer.
 	switch(data.getType())
@@ -418,10 +611,10 @@ void MessageFactory::addString(const string& data)
 void MessageFactory::addData(int8* data, uint16 len)
 {
 	// Make sure we've called StartMessage()
-	assert(mCurrentMessage && "Must call StartMessage before adding data");
+	assert(mBuildingMessage && "Must call StartMessage before adding data");
 
-	// Adjust start bounds if necessary.
-	_adjustHeapStartBounds(len);
+	// Make sure it fits.
+	_checkBuildBounds(len);
 
 	// Insert our data and move our end pointer.
 	memcpy(mCurrentMessageEnd, data, len);
@@ -432,231 +625,374 @@ void MessageFactory::addData(int8* data, uint16 len)
 
 void MessageFactory::_processGarbageCollection(void)
 {
+	// take back everything released since our last visit, in one go
+	if(mReleasedBlocks)
+	{
+		MessageBlock* block = Anh_Utils::atomicExchange(&mReleasedBlocks, (MessageBlock*)0);
+
+		while(block)
+		{
+			MessageBlock* next = block->mNext;
+
+			_messageFromBlock(block)->~Message();
+			_freeBlock(block);
+
+			mMessagesDestroyed++;
+
+			block = next;
+		}
+
+		_updateHeapUsage();
+	}
+
+	uint64 now = Anh_Utils::Clock::getSingleton()->getStoredTime();
+
+	if(now - mLastStatsTime > MESSAGE_STATS_INTERVAL)
+	{
+		mLastStatsTime = now;
+		logStatistics();
+	}
+
+	// a look at the oldest messages once a second is enough to find the stuck ones
+	if(now - mLastTime < 1000)
+		return;
+
+	mLastTime = now;
+
 	uint32 mlt = 3;
-	if(_getHeapSize() > 70.0)
+	if(mCurrentUsed > 70.0)
 			mlt = 2;
 
-	// Just check to see if the oldest message is ready to be deleted yet.
-	//start with the oldest message
-	assert(mHeapEnd < mMessageHeap + mHeapTotalSize && "mHeapEnd not within mMessageHeap bounds");
-	Message* message = reinterpret_cast<Message*>(mHeapEnd);
+	MessageBlock*	block = mLiveHead;
+	uint32			count = 0;
 
-	//when the oldest Message wont get deleted No other messages get deleted from the heap !!!!!!!!
+	while(block && (count < 50))
+	{
+		Message* message = _messageFromBlock(block);
 
+		if(now - message->getCreateTime() <= MESSAGE_MAX_LIFE_TIME)
+			break;
 
-	uint32 count = 0;
-	bool further = true;
-	
-	
-    while((count < 50) && further)
-	{
-		if (mHeapEnd != mHeapStart)
+		// released messages wait on our released list, they are not stuck
+		if(!message->getPendingDelete())
 		{
-			if (message->getPendingDelete())
-			{
-
-				//uint32 size = message->getSize();
-				message->~Message();
-				//memset(mHeapEnd, 0xed, size + sizeof(Message));
-				mHeapEnd += message->getSize() + sizeof(Message);
-
-				mMessagesDestroyed++;
-
-				// If we're at the end of the queue, rollover to the front again.
-				if (mHeapEnd == mHeapRollover)
-				{
-					if (mHeapEnd == mHeapStart)
-					{
-						mHeapStart = mMessageHeap;
-					}
-
-					mHeapEnd		= mMessageHeap;
-					mHeapRollover	= 0;
-				}
-
-				message = reinterpret_cast<Message*>(mHeapEnd);
-				
-				if(!message)
-					return;
-
-				assert(mHeapEnd < mMessageHeap + mHeapTotalSize  && "mHeapEnd not within mMessageHeap bounds");
-
-				further = (mHeapEnd != mHeapStart) && message->getPendingDelete();
-
-			}//pending delete
-
-			else if(Anh_Utils::Clock::getSingleton()->getStoredTime() - message->getCreateTime() > MESSAGE_MAX_LIFE_TIME)
-			{
-				further = false;
-				if (!message->mLogged)
-				{
-					gLogger->log(LogManager::WARNING, "Garbage Collection found a new stuck message!");
-					gLogger->logCont(LogManager::INFORMATION, "age : %u ", uint32((Anh_Utils::Clock::getSingleton()->getStoredTime() - message->getCreateTime())/1000));
-					
-					message->mLogged = true;
-					message->mLogTime = Anh_Utils::Clock::getSingleton()->getStoredTime();
-
-					Session* session = (Session*)message->mSession;
-
-					if(!session)
-					{
-						gLogger->logCont(LogManager::INFORMATION, "Packet is Sessionless.");
-						message->setPendingDelete(true);
-					}
-					else if(session->getStatus() > SSTAT_Disconnected || session->getStatus() == SSTAT_Disconnecting)
-					{
-						gLogger->logCont(LogManager::INFORMATION, "Session is about to be destroyed.");
-					}
-				}
-
-				Session* session = (Session*)message->mSession;
-				
-				if(!session)
-				{
-					gLogger->log(LogManager::INFORMATION, "Garbage Collection found sessionless packet");
-					message->setPendingDelete(true);
-				}
-				else if(Anh_Utils::Clock::getSingleton()->getStoredTime() >(message->mLogTime +10000))
-				{
-					gLogger->log(LogManager::EMERGENCY, "Garbage Collection found a old stuck message!");
-					gLogger->logCont(LogManager::INFORMATION, "age : %u ", uint32((Anh_Utils::Clock::getSingleton()->getStoredTime() - message->getCreateTime())/1000));
-					gLogger->logCont(LogManager::INFORMATION, "Session status : %u ", session->getStatus());
-					message->mLogTime  = Anh_Utils::Clock::getSingleton()->getStoredTime();
-					return;
-				}
-				else if(Anh_Utils::Clock::getSingleton()->getStoredTime() - message->getCreateTime() > MESSAGE_MAX_LIFE_TIME*mlt)
-				{
-					if(session)
-					{
-						// make sure that the status is not set again from Destroy to Disconnecting
-						// otherwise we wont ever get rid of that session
-						if(session->getStatus() < SSTAT_Disconnecting)
-						{
-							session->setCommand(SCOM_Disconnect);
-						 	gLogger->log(LogManager::EMERGENCY, "Garbage Collection Message Heap Time out. Destroying Session");
-						}
-						if(session->getStatus() == SSTAT_Destroy)
-						{
-						 	gLogger->log(LogManager::EMERGENCY, "Garbage Collection Message Heap Time out. Session about to Destroyed.");
-						}
-						return;
-					}
-					else
-					{
-						message->setPendingDelete(true);
-						gLogger->log(LogManager::EMERGENCY, "Garbage Collection Message Heap Time out. Session Already Destroyed. Tagged Message as Deletable.");
-						return;
-					}
-
-				
-				}
-
-			}
-			else
-				return;
-			
-		}//Heap start != Heapend
-		else
+			_processStuckMessage(message, now, mlt);
+		}
+
+		block = block->mLiveNext;
+		count++;
+	}
+}
+
+//======================================================================================================================
+//
+// a message older than MESSAGE_MAX_LIFE_TIME, either its session never sends it or someone forgot to release it
+//
+
+void MessageFactory::_processStuckMessage(Message* message, uint64 now, uint32 lifeTimeFactor)
+{
+	Session* session = (Session*)message->mSession;
+
+	if (!message->mLogged)
+	{
+		gLogger->log(LogManager::WARNING, "Garbage Collection found a new stuck message!");
+		gLogger->logCont(LogManager::INFORMATION, "age : %u ", uint32((now - message->getCreateTime())/1000));
+		
+		message->mLogged = true;
+		message->mLogTime = now;
+
+		if(!session)
 		{
+			gLogger->logCont(LogManager::INFORMATION, "Packet is Sessionless.");
+			message->setPendingDelete(true);
 			return;
 		}
+		else if(session->getStatus() > SSTAT_Disconnected || session->getStatus() == SSTAT_Disconnecting)
+		{
+			gLogger->logCont(LogManager::INFORMATION, "Session is about to be destroyed.");
+		}
+	}
 
-		//we need to be accurate here
-		count++;
+	if(!session)
+	{
+		gLogger->log(LogManager::INFORMATION, "Garbage Collection found sessionless packet");
+		message->setPendingDelete(true);
 	}
+	else if(now >(message->mLogTime +10000))
+	{
+		gLogger->log(LogManager::EMERGENCY, "Garbage Collection found a old stuck message!");
+		gLogger->logCont(LogManager::INFORMATION, "age : %u ", uint32((now - message->getCreateTime())/1000));
+		gLogger->logCont(LogManager::INFORMATION, "Session status : %u ", session->getStatus());
+		message->mLogTime  = now;
+	}
+	else if(now - message->getCreateTime() > MESSAGE_MAX_LIFE_TIME*lifeTimeFactor)
+	{
+		// make sure that the status is not set again from Destroy to Disconnecting
+		// otherwise we wont ever get rid of that session
+		if(session->getStatus() < SSTAT_Disconnecting)
+		{
+			session->setCommand(SCOM_Disconnect);
+			gLogger->log(LogManager::EMERGENCY, "Garbage Collection Message Heap Time out. Destroying Session");
+		}
+		if(session->getStatus() == SSTAT_Destroy)
+		{
+			gLogger->log(LogManager::EMERGENCY, "Garbage Collection Message Heap Time out. Session about to Destroyed.");
+		}
+	}
+}
 
+//======================================================================================================================
+
+void MessageFactory::_checkBuildBounds(uint32 size)
+{
+	assert((uint32)(mCurrentMessageEnd - mCurrentMessageStart) + size <= MESSAGE_MAX_SIZE && "Message too big.");
 }
 
 //======================================================================================================================
 
-void MessageFactory::_adjustHeapStartBounds(uint32 size)
+void MessageFactory::_updateHeapUsage(void)
 {
-	// Are we going to overflow our heap?
-	uint32 heapSize = _getHeapSize();
+	uint64 used = (uint64)mPagesInUse * MESSAGE_SLAB_PAGE_SIZE + mLargeBytes;
 
-	// _getHeapSize() returns the size of already constructed packets,
-	// but NOT the parts we already have been added for THIS message under construction.
+	mCurrentUsed = ((float)used / (float)mHeapTotalSize) * 100.0f;
+}
 
-	uint32 messageSize = (mCurrentMessageEnd - mCurrentMessageStart);
+//======================================================================================================================
 
-	//assert(mHeapTotalSize > messageSize + heapSize + size);
- 	assert(mHeapTotalSize > messageSize + heapSize && "Message heap overflow.");
+MessageBlock* MessageFactory::_allocateBlock(uint32 payloadSize)
+{
+	uint32 sizeClass = 0;
 
-	// Check to see if this add is going to push past the heap boundry.
-	if(mCurrentMessageEnd + size > mMessageHeap + mHeapTotalSize)
+	while((sizeClass < MESSAGE_SIZE_CLASSES) && (mSizeClasses[sizeClass].mPayloadSize < payloadSize))
+		sizeClass++;
+
+	// too big for our pages, counts against our heap nonetheless
+	if(sizeClass == MESSAGE_SIZE_CLASSES)
+	{
+		uint32 blockSize = sizeof(MessageBlock) + sizeof(Message) + payloadSize;
+
+		MessageBlock* block = reinterpret_cast<MessageBlock*>(new uint64[(blockSize + 7) / 8]);
+
+		block->mPage = NULL;
+		block->mSize = blockSize;
+
+		mLargeMessages++;
+		mLargeBytes += blockSize;
+
+		return block;
+	}
+
+	MessageSizeClass* messageClass = &mSizeClasses[sizeClass];
+	MessageSlabPage* page = messageClass->mPartialPages;
+
+	if(!page)
+		page = _allocatePage(sizeClass);
+
+	MessageBlock* block = page->mFreeList;
+	page->mFreeList = block->mNext;
+	page->mBlocksInUse++;
+
+	// full pages leave the list until a block of theirs is freed
+	if(!page->mFreeList)
 	{
-		// We've gone past the end of our heap, copy this message to the front of the heap and continue
+		messageClass->mPartialPages = page->mNext;
+
+		if(page->mNext)
+			page->mNext->mPrev = NULL;
 
-		memcpy(mMessageHeap, mCurrentMessageStart, messageSize);
+		page->mNext		= NULL;
+		page->mPartial	= false;
+	}
+
+	messageClass->mBlocksInUse++;
+
+	if(messageClass->mBlocksInUse > messageClass->mHighWaterMark)
+		messageClass->mHighWaterMark = messageClass->mBlocksInUse;
+
+	return block;
+}
+
+//======================================================================================================================
+
+void MessageFactory::_freeBlock(MessageBlock* block)
+{
+	_unlinkBlock(block);
 
-		// Reset our main heap pointer(s)
-		if(mHeapStart == mHeapEnd)
+	MessageSlabPage* page = block->mPage;
+
+	if(!page)
+	{
+		if(block->mPinned)
+		{
+			mPinnedMessages--;
+			mPinnedBytes -= (uint32)block->mSize;
+		}
+		else
 		{
-			mHeapEnd = mMessageHeap;
+			mLargeMessages--;
+			mLargeBytes -= (uint32)block->mSize;
 		}
 
-		mHeapStart		= mMessageHeap;
-		mHeapRollover	= mCurrentMessageStart;
+		delete[] reinterpret_cast<uint64*>(block);
+		return;
+	}
 
-		// Reinit our message pointers.
-		mCurrentMessage			= (Message*)mMessageHeap;
-		mCurrentMessageStart	= mMessageHeap;
-		mCurrentMessageEnd		= mMessageHeap + messageSize;
+	MessageSizeClass* messageClass = &mSizeClasses[page->mSizeClass];
 
-		mCurrentMessage->setData(mMessageHeap + sizeof(Message));
+	block->mNext = page->mFreeList;
+	page->mFreeList = block;
+	page->mBlocksInUse--;
+	messageClass->mBlocksInUse--;
 
-		gLogger->log(LogManager::WARNING, "Heap Rollover Service %u STATS: MessageHeap - size: %u, maxUsed: %2.2f%, created: %u, destroyed: %u\n", mServiceId,heapSize, mMaxHeapUsedPercent, mMessagesCreated, mMessagesDestroyed);
+	if(!page->mBlocksInUse)
+	{
+		_releasePage(page);
+	}
+	else if(!page->mPartial)
+	{
+		page->mPrev		= NULL;
+		page->mNext		= messageClass->mPartialPages;
+		page->mPartial	= true;
+
+		if(page->mNext)
+			page->mNext->mPrev = page;
+
+		messageClass->mPartialPages = page;
 	}
 }
 
-// the trouble is, that if we start a new Message we need to check whether the size of the message class is still inside the heap bounds.
-// However mCurrentMessage is 0 at that point
-void MessageFactory::_adjustMessageStart(uint32 size)
+//======================================================================================================================
+
+MessageSlabPage* MessageFactory::_allocatePage(uint32 sizeClass)
 {
-	// Are we going to overflow our heap?
-	uint32 heapSize = _getHeapSize();
+	MessageSizeClass*	messageClass	= &mSizeClasses[sizeClass];
+	MessageSlabPage*	page			= mFreePages;
 
-	// _getHeapSize() returns the size of already constructed packets,
-	// but NOT the parts we already have been added for THIS message under construction.
+	if(page)
+	{
+		mFreePages = page->mNext;
+	}
+	else
+	{
+		// our heap is used up, keep going with pages from the system rather than fail
+		page = new MessageSlabPage;
+		page->mMemory	= reinterpret_cast<int8*>(new uint64[MESSAGE_SLAB_PAGE_SIZE / 8]);
+		page->mOverflow	= true;
 
-	uint32 messageSize = (mCurrentMessageEnd - mCurrentMessageStart);
+		mOverflowPages++;
 
-	//assert(mHeapTotalSize > messageSize + heapSize + size);
- 	assert(mHeapTotalSize > messageSize + heapSize && "Message heap overflow.");
+		gLogger->log(LogManager::EMERGENCY, "MessageFactory Service %u heap exhausted, %u overflow pages", mServiceId, mOverflowPages);
+	}
+
+	page->mSizeClass	= sizeClass;
+	page->mBlocksInUse	= 0;
+	page->mFreeList		= NULL;
 
-	// Check to see if this add is going to push past the heap boundry.
-	if(mCurrentMessageEnd + size > mMessageHeap + mHeapTotalSize)
+	// carve it, back to front so the free list runs in address order
+	for(uint32 i = messageClass->mBlocksPerPage; i > 0; i--)
 	{
-		// We've gone past the end of our heap, copy this message to the front of the heap and continue
+		MessageBlock* block = reinterpret_cast<MessageBlock*>(page->mMemory + (i - 1) * messageClass->mBlockSize);
+
+		block->mPage	= page;
+		block->mNext	= page->mFreeList;
+		page->mFreeList	= block;
+	}
 
-		memcpy(mMessageHeap, mCurrentMessageStart, messageSize);
+	page->mPrev		= NULL;
+	page->mNext		= messageClass->mPartialPages;
+	page->mPartial	= true;
 
-		// Reset our main heap pointer(s)
-		if(mHeapStart == mHeapEnd)
-		{
-			mHeapEnd = mMessageHeap;
-		}
+	if(page->mNext)
+		page->mNext->mPrev = page;
 
-		mHeapStart		= mMessageHeap;
-		mHeapRollover	= mCurrentMessageStart;
+	messageClass->mPartialPages = page;
+	messageClass->mPages++;
 
-		// Reinit our message pointers.
-		mCurrentMessage			= (Message*)mMessageHeap;
-		mCurrentMessageStart	= mMessageHeap;
-		mCurrentMessageEnd		= mMessageHeap + messageSize;
+	mPagesInUse++;
 
-		//mCurrentMessage->setData(mMessageHeap + sizeof(Message));
+	return page;
+}
+
+//======================================================================================================================
 
-		gLogger->log(LogManager::WARNING, "Heap Rollover Service %u STATS: MessageHeap - size: %u, maxUsed: %2.2f%, created: %u, destroyed: %u\n", mServiceId,heapSize, mMaxHeapUsedPercent, mMessagesCreated, mMessagesDestroyed);
+void MessageFactory::_releasePage(MessageSlabPage* page)
+{
+	MessageSizeClass* messageClass = &mSizeClasses[page->mSizeClass];
+
+	if(page->mPartial)
+	{
+		if(page->mPrev)
+			page->mPrev->mNext = page->mNext;
+		else
+			messageClass->mPartialPages = page->mNext;
+
+		if(page->mNext)
+			page->mNext->mPrev = page->mPrev;
+	}
+
+	messageClass->mPages--;
+	mPagesInUse--;
+
+	if(page->mOverflow)
+	{
+		mOverflowPages--;
+
+		delete[] reinterpret_cast<uint64*>(page->mMemory);
+		delete page;
+		return;
+	}
+
+	page->mPartial	= false;
+	page->mPrev		= NULL;
+	page->mNext		= mFreePages;
+	mFreePages		= page;
+}
+
+//======================================================================================================================
+//
+// any thread, the block is only touched by the factory's own thread once it got it back
+//
+
+void MessageFactory::_reclaimMessage(Message* message)
+{
+	MessageBlock* block = _blockFromMessage(message);
+	MessageBlock* head;
+
+	do
+	{
+		head = mReleasedBlocks;
+		block->mNext = head;
 	}
+	while(!Anh_Utils::atomicCompareAndSwap(&mReleasedBlocks, head, block));
 }
 
 //======================================================================================================================
 
+void MessageFactory::logStatistics(void)
+{
+	gLogger->log(LogManager::INFORMATION, "MessageFactory Service %u STATS: heap %2.2f%% (max %2.2f%%), pages %u/%u, overflow pages %u, large messages %u, pinned %u (%u bytes), created %u, destroyed %u",
+		mServiceId, mCurrentUsed, mMaxHeapUsedPercent, mPagesInUse - mOverflowPages, mHeapPages, mOverflowPages, mLargeMessages, mPinnedMessages, mPinnedBytes, mMessagesCreated, mMessagesDestroyed);
 
+	for(uint32 i = 0; i < MESSAGE_SIZE_CLASSES; i++)
+	{
+		MessageSizeClass* messageClass = &mSizeClasses[i];
 
+		if(!messageClass->mHighWaterMark)
+			continue;
 
+		gLogger->logCont(LogManager::INFORMATION, "  class %5u bytes: %u / %u blocks in use, %u pages, max %u",
+			messageClass->mPayloadSize, messageClass->mBlocksInUse, messageClass->mPages * messageClass->mBlocksPerPage, messageClass->mPages, messageClass->mHighWaterMark);
+	}
+}
 
+//======================================================================================================================
 
+void Message::_reclaim(void)
+{
+	mPendingDelete = true;
 
+	if(mFactory)
+		mFactory->_reclaimMessage(this);
+}
 
+//======================================================================================================================
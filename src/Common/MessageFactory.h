@@ -35,15 +35,57 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 class Message;
 
+struct MessageBlock;
+struct MessageSlabPage;
+
 #define gMessageFactory			MessageFactory::getSingleton()
 
 // NEVER DELETE MESSAGES THAT ARE STILL REFERENCED SOMEWHERE
 #define MESSAGE_MAX_LIFE_TIME	60000
 
+// the heap is carved into pages of this size, a page serves exactly one size class at a time
+#define MESSAGE_SLAB_PAGE_SIZE	65536
+
+// payload size classes of 32 bytes up to 8k, bigger messages get an allocation of their own
+#define MESSAGE_SIZE_CLASSES	9
+#define MESSAGE_SMALLEST_CLASS	32
+
+// a message can not be bigger than its uint16 size
+#define MESSAGE_MAX_SIZE		0xffff
+
+#define MESSAGE_STATS_INTERVAL	300000
+
+//======================================================================================================================
+//
+// Pages with free blocks are linked to their size class, full pages drop out of that list
+// and pages whose last block got freed go back to the heap for any other class to use
+//
+
+struct MessageSizeClass
+{
+	MessageSlabPage*		mPartialPages;
+	uint32					mPayloadSize;
+	uint32					mBlockSize;
+	uint32					mBlocksPerPage;
+	uint32					mPages;
+	uint32					mBlocksInUse;
+	uint32					mHighWaterMark;
+};
+
 //======================================================================================================================
+//
+// Messages are built in a scratch buffer and copied into a block of the smallest fitting size class by EndMessage.
+// Every message is freed on its own as soon as it is released, so a single long lived message no longer
+// holds up everything created after it.
+// A factory is only used by one thread (StartMessage / EndMessage and the garbage collection), but messages are
+// released on any thread. Those push their block onto the factory's released list with a single compare and swap,
+// the factory takes the whole list at once on its next garbage collection.
+//
 
 class MessageFactory
 {
+	friend class Message;
+
 	public:
 
 		MessageFactory(uint32 heapSize,uint32 serviceId = 0);
@@ -59,6 +101,17 @@ class MessageFactory
 		
 		void                    DestroyMessage(Message* message);
 
+		// Creates a message sharing the payload of the given one, only the message header goes on the heap.
+		// Used to send the same data to many sessions, every share has to be released like any other message.
+		Message*                ShareMessage(Message* message);
+
+		// Takes a message we deliberately hold on to for longer than MESSAGE_MAX_LIFE_TIME out of the stuck message
+		// detection, its holder still has to release it. Only to be called on the factory's own thread.
+		// The message moves out of the heap into an allocation of its own, so it neither keeps a page from being
+		// reused nor counts towards the heap usage. Returns the moved message, the one passed in is gone then,
+		// which is why it must not have been shared or handed out yet.
+		Message*                PinMessage(Message* message);
+
 		static MessageFactory*	getSingleton(void);
 		static void             destroySingleton(void);
 
@@ -80,30 +133,70 @@ class MessageFactory
 		void                    addData(int8* data, uint16 len);
 
 		float					getHeapsize(){return mCurrentUsed;}
+
+		// per size class occupancy, only accurate on the factory's own thread
+		uint32					getSizeClassPayloadSize(uint32 sizeClass){ return mSizeClasses[sizeClass].mPayloadSize; }
+		uint32					getSizeClassBlocksInUse(uint32 sizeClass){ return mSizeClasses[sizeClass].mBlocksInUse; }
+		uint32					getSizeClassCapacity(uint32 sizeClass){ return mSizeClasses[sizeClass].mPages * mSizeClasses[sizeClass].mBlocksPerPage; }
+		uint32					getSizeClassHighWaterMark(uint32 sizeClass){ return mSizeClasses[sizeClass].mHighWaterMark; }
+		uint32					getLargeMessages(){ return mLargeMessages; }
+		uint32					getPagesInUse(){ return mPagesInUse; }
+		uint32					getOverflowPages(){ return mOverflowPages; }
+		uint32					getPinnedMessages(){ return mPinnedMessages; }
+		uint32					getPinnedBytes(){ return mPinnedBytes; }
+
+		void					logStatistics(void);
+
 	private:
 
 		void                    _processGarbageCollection(void);
-		void                    _adjustHeapStartBounds(uint32 size);
-		//make sure our messageclass size is put inside heap bounds
-		void					_adjustMessageStart(uint32 size);
-		void                    _adjustHeapEndBounds(uint32 size);
-		uint32                  _getHeapSize(void);
+		void					_processStuckMessage(Message* message, uint64 now, uint32 lifeTimeFactor);
+		void					_checkBuildBounds(uint32 size);
+		void					_updateHeapUsage(void);
 
-		Message*                mCurrentMessage;
+		MessageBlock*			_allocateBlock(uint32 payloadSize);
+		void					_freeBlock(MessageBlock* block);
+		MessageSlabPage*		_allocatePage(uint32 sizeClass);
+		void					_unlinkBlock(MessageBlock* block);
+		void					_releasePage(MessageSlabPage* page);
+
+		// called by Message on whatever thread released it
+		void					_reclaimMessage(Message* message);
+
+		// the message under construction
+		bool					mBuildingMessage;
 		int8*                   mCurrentMessageEnd;
 		int8*                   mCurrentMessageStart;
 
-		int8*                   mHeapStart;
-		int8*                   mHeapEnd;
-		int8*                   mHeapRollover;
 		int8*                   mMessageHeap;
-		uint64									mLastTime; //last message about stuck messages
 		uint32                  mHeapTotalSize; //total heapsize used AND unused
+		uint32					mHeapPages;
+		MessageSlabPage*		mPageTable;		// one entry per heap page
+		MessageSlabPage*		mFreePages;
+
+		MessageSizeClass		mSizeClasses[MESSAGE_SIZE_CLASSES];
 
+		MessageBlock* volatile	mReleasedBlocks;	// pushed to by any thread, emptied by the garbage collection
+
+		// live messages, oldest first, to find the stuck ones
+		MessageBlock*			mLiveHead;
+		MessageBlock*			mLiveTail;
+
+		// messages held on purpose, see PinMessage
+		MessageBlock*			mPinnedHead;
+
+		uint64									mLastTime; //last message about stuck messages
+		uint64					mLastStatsTime;
 
 		// Statistics
 		uint32                  mMessagesCreated;
 		uint32                  mMessagesDestroyed;
+		uint32					mPagesInUse;		// heap pages plus overflow pages
+		uint32					mOverflowPages;		// allocated outside of the heap once it is used up
+		uint32					mLargeMessages;
+		uint32					mLargeBytes;
+		uint32					mPinnedMessages;	// not part of the heap usage
+		uint32					mPinnedBytes;
 		uint32					mServiceId;
 		float					mHeapWarnLevel;
 		float                   mMaxHeapUsedPercent;
@@ -141,19 +234,6 @@ inline void MessageFactory::destroySingleton(void)
 
 //======================================================================================================================
 
-inline uint32 MessageFactory::_getHeapSize(void)
-{
-	if (mHeapStart >= mHeapEnd)
-	{
-		return (uint32)(mHeapStart - mHeapEnd);
-	}
-
-	return (uint32)mHeapTotalSize-(mHeapEnd - mHeapStart);
-	//return (uint32)(mMessageHeap + mHeapTotalSize - mHeapEnd + mHeapStart - mMessageHeap);
-}
-
-//======================================================================================================================
-
 #endif  //MMOSERVER_LOGINSERVER_MESSAGEFACTORY_H
 
 
@@ -43,6 +43,7 @@ enum MessageOpcodes
 	opClusterZoneTransferApprovedByTicket	= 0xA608F0B2,
 	opClusterZoneTransferDenied				= 0x7B4AF214,
 	opClusterZoneTransferCharacter			= 0x74C4FC34,
+	opClusterMulticast						= 0xF1F423CD,
 	opTutorialServerStatusRequest			= 0x5E48A399,
 	opTutorialServerStatusReply				= 0x989EDF5A,
 	opSelectCharacter						= 0xb5098d76,
@@ -61,6 +61,7 @@ mConnectionDispatch(dispatch)
 	mConnectionDispatch->RegisterMessageCallback(opClientIdMsg, this);
 	mConnectionDispatch->RegisterMessageCallback(opSelectCharacter, this);
 	mConnectionDispatch->RegisterMessageCallback(opClusterZoneTransferCharacter, this);
+	mConnectionDispatch->RegisterMessageCallback(opClusterMulticast, this);
 }
 
 //======================================================================================================================
@@ -71,6 +72,7 @@ ClientManager::~ClientManager(void)
 	mConnectionDispatch->UnregisterMessageCallback(opClientIdMsg);
 	mConnectionDispatch->UnregisterMessageCallback(opSelectCharacter);
 	mConnectionDispatch->UnregisterMessageCallback(opClusterZoneTransferCharacter);
+	mConnectionDispatch->UnregisterMessageCallback(opClusterMulticast);
 }
 
 //======================================================================================================================
@@ -222,6 +224,11 @@ void ClientManager::handleDispatchMessage(uint32 opcode, Message* message, Conne
       _processClusterZoneTransferCharacter(client, message);
       break;
     }
+  case opClusterMulticast:
+    {
+      _processClusterMulticast(client, message);
+      break;
+    }
   }
 }
 
@@ -387,6 +394,48 @@ void ClientManager::_processClusterZoneTransferCharacter(ConnectionClient* clien
 }
 
 
+//======================================================================================================================
+//
+// one body for many clients, every client we still know gets a share of it
+//
+
+void ClientManager::_processClusterMulticast(ConnectionClient* client, Message* message)
+{
+	uint8	priority	= message->getUint8();
+	bool	unreliable	= (message->getUint8() != 0);
+	uint16	count		= message->getUint16();
+	uint32	bodyIndex	= message->getIndex() + count * 4;
+
+	if(bodyIndex >= message->getSize())
+	{
+		gLogger->log(LogManager::WARNING,"ClientManager::_processClusterMulticast: malformed multicast for %u clients",count);
+		return;
+	}
+
+	// the incoming message goes away with the dispatch, copy the body once
+	gMessageFactory->StartMessage();
+	gMessageFactory->addData(message->getData() + bodyIndex, static_cast<uint16>(message->getSize() - bodyIndex));
+	Message* body = gMessageFactory->EndMessage();
+
+	boost::recursive_mutex::scoped_lock lk(mServiceMutex);
+
+	for(uint16 i = 0; i < count; i++)
+	{
+		PlayerClientMap::iterator iter = mPlayerClientMap.find(message->getUint32());
+
+		// happens when the client logs out
+		if(iter == mPlayerClientMap.end())
+			continue;
+
+		if(unreliable)
+			(*iter).second->SendChannelAUnreliable(gMessageFactory->ShareMessage(body), priority);
+		else
+			(*iter).second->SendChannelA(gMessageFactory->ShareMessage(body), priority, false);
+	}
+
+	gMessageFactory->DestroyMessage(body);
+}
+
 //======================================================================================================================
 void ClientManager::_handleQueryAuth(ConnectionClient* client, DatabaseResult* result)
 {
@@ -80,6 +80,7 @@ class ClientManager : public NetworkCallback, public ConnectionDispatchCallback,
 		void						_processClientIdMsg(ConnectionClient* client, Message* message);
 		void                        _processSelectCharacter(ConnectionClient* client, Message* message);
 		void                        _processClusterZoneTransferCharacter(ConnectionClient* client, Message* message);
+		void                        _processClusterMulticast(ConnectionClient* client, Message* message);
 
 		void                        _handleQueryAuth(ConnectionClient* client, DatabaseResult* result);
 
@@ -35,6 +35,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "DatabaseJob.h"
 #include "DatabaseType.h"
 #include "DatabaseWorkerThread.h"
+#include "StatementParameters.h"
 #include "Transaction.h"
 
 #include "LogManager/LogManager.h"
@@ -49,8 +50,10 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 Database::Database(DBType type, char* host, uint16 port, char* user, char* pass, char* schema) :
 mDatabaseType(type),
 mDataBindingFactory(0),
+mExit(false),
 mDatabaseImplementation(0),
 mJobPool(sizeof(DatabaseJob)),
+mParameterPool(sizeof(StatementParameters)),
 mTransactionPool(sizeof(Transaction))
 {
   // Create and startup our factorys
@@ -69,15 +72,27 @@ mTransactionPool(sizeof(Transaction))
 		default:break;
 	}
 
-  // Create our worker threads and put them in the idle queue
+  // Create our worker threads, they start waiting for jobs right away
   mMinThreads = gConfig->read<uint32>("DBMinThreads");
   mMaxThreads = gConfig->read<uint32>("DBMaxThreads");
-  DatabaseWorkerThread* newWorker = 0;
+
+  if(!mMinThreads)
+	  mMinThreads = 1;
+
   for (uint32 i = 0; i < mMinThreads; i++)
   {
-    newWorker = new DatabaseWorkerThread(mDatabaseType, this, host, port, user, pass, schema);
+    mWorkers.push_back(new DatabaseWorkerThread(mDatabaseType, this, host, port, user, pass, schema, false));
+  }
+
+  // keyed jobs get connections of their own that never hold a multi result, so waiting on one can't stall
+  uint32 orderedThreads = gConfig->read<uint32>("DBOrderedThreads",2);
+
+  if(!orderedThreads)
+	  orderedThreads = 1;
 
-    pushIdleWorker(newWorker);
+  for (uint32 i = 0; i < orderedThreads; i++)
+  {
+    mOrderedWorkers.push_back(new DatabaseWorkerThread(mDatabaseType, this, host, port, user, pass, schema, true));
   }
 }
 
@@ -85,14 +100,34 @@ mTransactionPool(sizeof(Transaction))
 //======================================================================================================================
 Database::~Database(void)
 {
-	DatabaseWorkerThread* worker = 0;
+	// wake up everyone waiting for a job
+	{
+		boost::mutex::scoped_lock lk(mJobMutex);
+		mExit = true;
+	}
+
+	mJobCondition.notify_all();
+
+	DatabaseWorkerList::iterator it = mWorkers.begin();
 
-	while(mWorkerIdleQueue.size())
+	while(it != mWorkers.end())
 	{
-		worker = mWorkerIdleQueue.pop();
-		delete(worker);
+		delete(*it);
+		++it;
 	}
 
+	mWorkers.clear();
+
+	it = mOrderedWorkers.begin();
+
+	while(it != mOrderedWorkers.end())
+	{
+		delete(*it);
+		++it;
+	}
+
+	mOrderedWorkers.clear();
+
 	//shutdown local implementation
 	delete(mDatabaseImplementation);
 
@@ -104,21 +139,9 @@ Database::~Database(void)
 
 void Database::Process(void)
 {
-	DatabaseWorkerThread* worker = 0;
 	DatabaseJob* job = 0;
 
-	// Check to see if we have an idle worker, and a job to give it.
-	if(mWorkerIdleQueue.size() && mJobPendingQueue.size())
-	{
-		// Pop the worker and job off thier queues.
-		worker	= mWorkerIdleQueue.pop();
-		job		= mJobPendingQueue.pop();
-
-		// Hand The job to the worker.
-		worker->ExecuteJob(job);
-	}
-
-	// Now process any completed jobs.
+	// The workers fetch their jobs themselves, we only process the completed ones.
 	uint32 completedCount = mJobCompleteQueue.size();
 
 	for (uint32 i = 0; i < completedCount; i++)
@@ -126,8 +149,11 @@ void Database::Process(void)
 		// pop a job
 		job = mJobCompleteQueue.pop();
 
+		if(!job)
+			break;
+
 		// let our client handle the result, if theres a callback
-		if(job && job->getCallback())
+		if(job->getCallback())
 		{
 			job->getCallback()->handleDatabaseJobComplete(job->getClientReference(), job->getDatabaseResult());
 		}
@@ -135,7 +161,7 @@ void Database::Process(void)
 		// Free the result and the job
 		this->DestroyResult(job->getDatabaseResult());
 
-		mJobPool.ordered_free(job);
+		_destroyJob(job);
 	}
 }
 //======================================================================================================================
@@ -205,15 +231,22 @@ void Database::ExecuteSqlAsync(DatabaseCallback* callback, void* ref, const int8
 	int8    localSql[20192];
 	/*int32 len = */vsnprintf(localSql, sizeof(localSql), sql, args);
 
-	// Setup our job.
-	DatabaseJob* job = new(mJobPool.ordered_malloc()) DatabaseJob();
-	job->setCallback(callback);
-	job->setClientReference(ref);
-	job->setSql(localSql);
-	job->setMultiJob(false);
+	_queueJob(0, callback, ref, localSql, false);
+
+	va_end(args);
+}
+
+//======================================================================================================================
+
+void Database::ExecuteSqlAsyncOrdered(uint64 key, DatabaseCallback* callback, void* ref, const int8* sql, ...)
+{
+	// format our sql string
+	va_list args;
+	va_start(args, sql);
+	int8    localSql[20192];
+	/*int32 len = */vsnprintf(localSql, sizeof(localSql), sql, args);
 
-	// Add the job to our processList;
-	mJobPendingQueue.push(job);
+	_queueJob(key, callback, ref, localSql, false);
 
 	va_end(args);
 }
@@ -232,15 +265,7 @@ void Database::ExecuteSqlAsyncNoArguments(DatabaseCallback* callback, void* ref,
 
 	sprintf(localSql,"%s", sql);
 
-	// Setup our job.
-	DatabaseJob* job = new(mJobPool.ordered_malloc()) DatabaseJob();
-	job->setCallback(callback);
-	job->setClientReference(ref);
-	job->setSql(localSql);
-	job->setMultiJob(false);
-
-	// Add the job to our processList;
-	mJobPendingQueue.push(job);
+	_queueJob(0, callback, ref, localSql, false);
 }
 //======================================================================================================================
 
@@ -273,17 +298,200 @@ void Database::ExecuteProcedureAsync(DatabaseCallback* callback, void* ref, cons
 	int8    localSql[20192];
 	/*int32 len = */vsnprintf(localSql, sizeof(localSql), sql, args);
 
+	_queueJob(0, callback, ref, localSql, true);
+
+	va_end(args);
+}
+
+//======================================================================================================================
+//
+// the worker runs the keyed jobs queued before this one first, so nothing queued earlier on that key can land after it.
+// ordered workers never run multi result jobs, so none of them waits for the main thread we are blocking here
+//
+
+DatabaseResult* Database::ExecuteSynchSqlOrdered(uint64 key, const int8* sql, ...)
+{
+	// format our sql string
+	va_list args;
+	va_start(args, sql);
+	int8    localSql[20192];
+	/*int32 len = */vsnprintf(localSql, sizeof(localSql), sql, args);
+	va_end(args);
+
+	if(strlen(localSql) >= DATABASE_JOB_MAX_SQL)
+	{
+		gLogger->log(LogManager::CRITICAL,"Database::ExecuteSynchSqlOrdered: dropped statement of %u chars: %.128s",static_cast<uint32>(strlen(localSql)),localSql);
+		return NULL;
+	}
+
+	DatabaseJob* job = _createJob(NULL, NULL);
+	job->setSql(localSql);
+	job->setWaited(true);
+
+	_dispatchJob(key, job);
+
+	{
+		boost::mutex::scoped_lock lk(mWaitMutex);
+
+		while(!job->isDone())
+		{
+			mWaitCondition.wait(lk);
+		}
+	}
+
+	DatabaseResult* result = job->getDatabaseResult();
+
+	_destroyJob(job);
+
+	return result;
+}
+
+//======================================================================================================================
+
+void Database::pushDatabaseJobComplete(DatabaseJob* job)
+{
+	if(!job->isWaited())
+	{
+		mJobCompleteQueue.push(job);
+		return;
+	}
+
+	// notify while still holding the lock, the waiting thread frees the job as soon as it sees it done
+	boost::mutex::scoped_lock lk(mWaitMutex);
+	job->setDone(true);
+	mWaitCondition.notify_all();
+}
+
+//======================================================================================================================
+//
+// a keyed job always goes to the same worker, which runs its keyed jobs first and in order
+//
+
+void Database::_queueJob(uint64 key, DatabaseCallback* callback, void* ref, int8* sql, bool multiJob)
+{
+	// a job has a fixed buffer, never queue what doesnt fit it
+	if(strlen(sql) >= DATABASE_JOB_MAX_SQL)
+	{
+		gLogger->log(LogManager::CRITICAL,"Database::_queueJob: dropped statement of %u chars: %.128s",static_cast<uint32>(strlen(sql)),sql);
+		return;
+	}
+
+	DatabaseJob* job = _createJob(callback, ref);
+	job->setSql(sql);
+	job->setMultiJob(multiJob);
+
+	_dispatchJob(key, job);
+}
+
+//======================================================================================================================
+
+DatabaseJob* Database::_createJob(DatabaseCallback* callback, void* ref)
+{
 	// Setup our job.
 	DatabaseJob* job = new(mJobPool.ordered_malloc()) DatabaseJob();
 	job->setCallback(callback);
 	job->setClientReference(ref);
-	job->setSql(localSql);
-	job->setMultiJob(true);
 
-	// Add the job to our processList
-	mJobPendingQueue.push(job);
+	return job;
+}
 
-	va_end(args);
+//======================================================================================================================
+
+void Database::_destroyJob(DatabaseJob* job)
+{
+	if(job->getParameters())
+	{
+		job->getParameters()->~StatementParameters();
+		mParameterPool.ordered_free(job->getParameters());
+	}
+
+	mJobPool.ordered_free(job);
+}
+
+//======================================================================================================================
+
+void Database::_dispatchJob(uint64 key, DatabaseJob* job)
+{
+	boost::mutex::scoped_lock lk(mJobMutex);
+
+	if(key)
+	{
+		mOrderedWorkers[key % mOrderedWorkers.size()]->pushOrderedJob(job);
+
+		// we cant wake up that one worker alone, they all wait on the same condition
+		lk.unlock();
+		mJobCondition.notify_all();
+	}
+	else
+	{
+		mJobPendingQueue.push_back(job);
+
+		lk.unlock();
+		mJobCondition.notify_one();
+	}
+}
+
+//======================================================================================================================
+//
+// statements are prepared lazily by every connection that runs them, so registering is cheap
+//
+
+uint32 Database::RegisterStatement(const int8* sql)
+{
+	mStatements.push_back(sql);
+
+	return (uint32)mStatements.size();
+}
+
+//======================================================================================================================
+
+DatabaseResult* Database::ExecuteStatement(uint32 statementId, StatementParameters* parameters)
+{
+	return mDatabaseImplementation->ExecuteStatement(statementId, mStatements[statementId - 1].c_str(), parameters);
+}
+
+//======================================================================================================================
+
+void Database::ExecuteStatementAsync(DatabaseCallback* callback, void* ref, uint32 statementId, StatementParameters* parameters)
+{
+	ExecuteStatementAsyncOrdered(0, callback, ref, statementId, parameters);
+}
+
+//======================================================================================================================
+
+void Database::ExecuteStatementAsyncOrdered(uint64 key, DatabaseCallback* callback, void* ref, uint32 statementId, StatementParameters* parameters)
+{
+	DatabaseJob* job = _createJob(callback, ref);
+	job->setStatement(statementId, mStatements[statementId - 1].c_str(), new(mParameterPool.ordered_malloc()) StatementParameters(*parameters));
+
+	_dispatchJob(key, job);
+}
+
+//======================================================================================================================
+
+DatabaseJob* Database::waitForJob(DatabaseWorkerThread* worker)
+{
+	boost::mutex::scoped_lock lk(mJobMutex);
+
+	while(!mExit)
+	{
+		DatabaseJob* job = worker->popOrderedJob();
+
+		if(job)
+			return job;
+
+		if(!worker->isOrdered() && mJobPendingQueue.size())
+		{
+			job = mJobPendingQueue.front();
+			mJobPendingQueue.pop_front();
+
+			return job;
+		}
+
+		mJobCondition.wait(lk);
+	}
+
+	return NULL;
 }
 
 //======================================================================================================================
@@ -292,9 +500,10 @@ void Database::DestroyResult(DatabaseResult* result)
 {
 	DatabaseWorkerThread* worker = mDatabaseImplementation->DestroyResult(result);
 
+	// the worker had to wait for us to be done with its connection
 	if(worker)
 	{
-		pushIdleWorker(worker);
+		worker->releaseResult();
 	}
 }
 
@@ -31,9 +31,14 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "DatabaseType.h"
 #include "Utils/typedefs.h"
 #include "Utils/concurrent_queue.h"
+#include <deque>
 #include <queue>
+#include <string>
+#include <vector>
 #include "DataBindingFactory.h"
 #include <boost/pool/pool.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
 
 
 //======================================================================================================================
@@ -44,10 +49,13 @@ class DatabaseImplementation;
 class DatabaseCallback;
 class DatabaseResult;
 class DatabaseJob;
+class StatementParameters;
 class Transaction;
 
 typedef Anh_Utils::concurrent_queue<DatabaseJob*>				DatabaseJobQueue;
-typedef Anh_Utils::concurrent_queue<DatabaseWorkerThread*>		DatabaseWorkerThreadQueue;
+typedef std::deque<DatabaseJob*>								DatabaseJobList;
+typedef std::vector<DatabaseWorkerThread*>						DatabaseWorkerList;
+typedef std::deque<std::string>									StatementList;
 
 //======================================================================================================================
 
@@ -67,6 +75,21 @@ class Database
   DatabaseResult*                         ExecuteProcedure(const int8* sql, ...);
   void                                    ExecuteProcedureAsync(DatabaseCallback* callback, void* ref, const int8* sql, ...);
 
+  // jobs sharing an ordering key (a character id for example) run one after another on the same connection,
+  // in the order they were queued. Jobs without a key go to whichever worker is free first.
+  // there is no ordered procedure call, a multi result would hold the ordered connection until the main thread frees it
+  void                                    ExecuteSqlAsyncOrdered(uint64 key, DatabaseCallback* callback, void* ref, const int8* sql, ...);
+
+  // queued behind the jobs already waiting on that key, blocks until a worker ran it. the caller destroys the result
+  DatabaseResult*                         ExecuteSynchSqlOrdered(uint64 key, const int8* sql, ...);
+
+  // statements are registered once, on the main thread, and then run with bound parameters over the binary protocol.
+  // results decode straight into the DataBinding offsets. stored procedures still have to go through ExecuteProcedure
+  uint32                                  RegisterStatement(const int8* sql);
+  DatabaseResult*                         ExecuteStatement(uint32 statementId, StatementParameters* parameters);
+  void                                    ExecuteStatementAsync(DatabaseCallback* callback, void* ref, uint32 statementId, StatementParameters* parameters);
+  void                                    ExecuteStatementAsyncOrdered(uint64 key, DatabaseCallback* callback, void* ref, uint32 statementId, StatementParameters* parameters);
+
   uint32								  Escape_String(int8* target,const int8* source,uint32 length);
 
   void									  DestroyResult(DatabaseResult* result);
@@ -74,16 +97,15 @@ class Database
   DataBinding*                            CreateDataBinding(uint16 fieldCount);
   void									  DestroyDataBinding(DataBinding* binding);
 
-  DatabaseWorkerThread*                   popIdleWorker();
-  void									  pushIdleWorker(DatabaseWorkerThread* worker);
-
+  // called by the worker threads, blocks until there is a job for the worker, returns NULL once we shut down
+  DatabaseJob*                            waitForJob(DatabaseWorkerThread* worker);
   void									  pushDatabaseJobComplete(DatabaseJob* job);
 
   Transaction*							  startTransaction(DatabaseCallback* callback, void* ref);
   void									  destroyTransaction(Transaction* t);
 
   bool									  releaseResultPoolMemory();	
-  bool									  releaseJobPoolMemory(){ return(mJobPool.release_memory()); }
+  bool									  releaseJobPoolMemory(){ bool released = mJobPool.release_memory(); return(mParameterPool.release_memory() || released); }
   bool									  releaseTransactionPoolMemory(){ return(mTransactionPool.release_memory()); }
   bool									  releaseBindingPoolMemory(){ return(mDataBindingFactory->releasePoolMemory()); }
   int									  GetCount(const int8* tablename);
@@ -92,11 +114,28 @@ private:
 
   DBType                                  mDatabaseType;      // This denotes which DB implementation we are connecting to. MySQL, Postgres, etc.
 
+  void                                    _queueJob(uint64 key, DatabaseCallback* callback, void* ref, int8* sql, bool multiJob);
+  DatabaseJob*                            _createJob(DatabaseCallback* callback, void* ref);
+  void                                    _destroyJob(DatabaseJob* job);
+  void                                    _dispatchJob(uint64 key, DatabaseJob* job);
+
   DataBindingFactory*                     mDataBindingFactory;
 
-  DatabaseJobQueue                        mJobPendingQueue;
+  // the workers take their jobs themselves, the main thread only handles the completed ones
+  boost::mutex                            mJobMutex;
+  boost::condition_variable               mJobCondition;
+  DatabaseJobList                         mJobPendingQueue;		// jobs without an ordering key
+  DatabaseWorkerList                      mWorkers;
+  DatabaseWorkerList                      mOrderedWorkers;		// keyed jobs only, never a multi result
+  bool                                    mExit;
+
   DatabaseJobQueue                        mJobCompleteQueue;
-  DatabaseWorkerThreadQueue               mWorkerIdleQueue;
+
+  // signalled when a worker finished a job someone waits for
+  boost::mutex                            mWaitMutex;
+  boost::condition_variable               mWaitCondition;
+
+  StatementList                           mStatements;		// index is the statement id - 1, the strings never move
 
   DatabaseImplementation*                 mDatabaseImplementation;  // Use this implementation for any syncronous calls.
 
@@ -104,6 +143,7 @@ private:
   uint32                                  mMaxThreads;
 
   boost::pool<boost::default_user_allocator_malloc_free>							  mJobPool;
+  boost::pool<boost::default_user_allocator_malloc_free>							  mParameterPool;	// statement jobs only, plain sql jobs don't carry parameters
   boost::pool<boost::default_user_allocator_malloc_free>							  mTransactionPool;
 protected:
 	DatabaseResult*                         ExecuteSql(const int8* sql, ...);
@@ -111,31 +151,6 @@ protected:
 
 //======================================================================================================================
 
-inline DatabaseWorkerThread* Database::popIdleWorker(void)
-{
-  DatabaseWorkerThread* worker = 0;
-
-  worker = mWorkerIdleQueue.pop();
-
-  return worker;
-}
-
-//======================================================================================================================
-
-inline void Database::pushIdleWorker(DatabaseWorkerThread* worker)
-{
-  mWorkerIdleQueue.push(worker);
-}
-
-//======================================================================================================================
-
-inline void Database::pushDatabaseJobComplete(DatabaseJob* job)
-{
-  mJobCompleteQueue.push(job);
-}
-
-//======================================================================================================================
-
 #endif // ANH_DATABASEMANAGER_DATABASE_H
 
 
@@ -37,6 +37,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 class DataBinding;
 class DatabaseWorkerThread;
+class StatementParameters;
 
 typedef boost::singleton_pool<DatabaseResult,sizeof(DatabaseResult),boost::default_user_allocator_malloc_free> ResultPool;
 
@@ -49,10 +50,14 @@ public:
   
   virtual DatabaseResult*			ExecuteSql(int8* sql,bool procedure = false) = 0;
 
+  // statements are prepared on first use and kept per connection, the sql is only looked at the first time
+  virtual DatabaseResult*			ExecuteStatement(uint32 statementId, const int8* sql, StatementParameters* parameters) = 0;
+
   virtual DatabaseWorkerThread*	DestroyResult(DatabaseResult* result) = 0;
   
   virtual void						GetNextRow(DatabaseResult* result, DataBinding* binding, void* object) = 0;
   virtual void						ResetRowIndex(DatabaseResult* result, uint64 index = 0) = 0;
+  virtual bool						NextResultSet(DatabaseResult* result) = 0;
 
   virtual uint32					Escape_String(int8* target,const int8* source,uint32 length) = 0;
 
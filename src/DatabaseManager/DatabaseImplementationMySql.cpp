@@ -28,11 +28,14 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "DatabaseImplementationMySql.h"
 #include "DatabaseResult.h"
 #include "DataBinding.h"
+#include "StatementParameters.h"
 
 #include "LogManager/LogManager.h"
 
 #include <boost/lexical_cast.hpp>
 #include <mysql.h>
+#include <errmsg.h>
+#include <mysqld_error.h>
 #include <cstdlib>
 #include <cstdio>
 #include <cstring>
@@ -60,6 +63,20 @@ DatabaseImplementationMySql::DatabaseImplementationMySql(char* host, uint16 port
 //======================================================================================================================
 DatabaseImplementationMySql::~DatabaseImplementationMySql(void)
 {
+  // Close our prepared statements
+  for(uint32 i = 0; i < mStatementHandles.size(); i++)
+  {
+    for(uint32 j = 0; j < mStatementHandles[i].size(); j++)
+    {
+      mysql_stmt_close(mStatementHandles[i][j]);
+    }
+  }
+
+  for(uint32 i = 0; i < mReturnedStatements.size(); i++)
+  {
+    mysql_stmt_close(mReturnedStatements[i].second);
+  }
+
   // Close the connection and destroy our connection object.
   mysql_close(mConnection);
   mysql_thread_end();
@@ -72,6 +89,8 @@ DatabaseResult* DatabaseImplementationMySql::ExecuteSql(int8* sql,bool procedure
 
   newResult->setDatabaseImplementation(this);
 
+  _freeReturnedStatements();
+
   // Execute the statement
   uint32 len = (uint32)strlen(sql);
   mysql_real_query(mConnection, sql, len);
@@ -97,12 +116,241 @@ DatabaseResult* DatabaseImplementationMySql::ExecuteSql(int8* sql,bool procedure
 }
 
 
+//======================================================================================================================
+//
+// runs a registered statement over the binary protocol, no sql gets formatted or parsed for it
+//
+
+DatabaseResult* DatabaseImplementationMySql::ExecuteStatement(uint32 statementId, const int8* sql, StatementParameters* parameters)
+{
+  DatabaseResult* newResult = new(ResultPool::ordered_malloc()) DatabaseResult(false);
+
+  newResult->setDatabaseImplementation(this);
+  newResult->setConnectionReference((void*)mConnection);
+  newResult->setStatementId(statementId);
+
+  MYSQL_BIND    binds[STATEMENT_MAX_PARAMETERS];
+  unsigned long lengths[STATEMENT_MAX_PARAMETERS];
+  uint32        count = parameters->getCount();
+
+  memset(binds, 0, sizeof(MYSQL_BIND) * count);
+
+  for(uint32 i = 0; i < count; i++)
+  {
+    DataField* field = parameters->getField(i);
+
+    binds[i].buffer = parameters->getData(i);
+
+    switch(field->mDataType)
+    {
+      case DFT_uint8:   binds[i].is_unsigned = 1;
+      case DFT_int8:    binds[i].buffer_type = MYSQL_TYPE_TINY;     break;
+      case DFT_uint16:  binds[i].is_unsigned = 1;
+      case DFT_int16:   binds[i].buffer_type = MYSQL_TYPE_SHORT;    break;
+      case DFT_uint32:  binds[i].is_unsigned = 1;
+      case DFT_int32:   binds[i].buffer_type = MYSQL_TYPE_LONG;     break;
+      case DFT_uint64:  binds[i].is_unsigned = 1;
+      case DFT_int64:   binds[i].buffer_type = MYSQL_TYPE_LONGLONG; break;
+      case DFT_float:   binds[i].buffer_type = MYSQL_TYPE_FLOAT;    break;
+      case DFT_double:  binds[i].buffer_type = MYSQL_TYPE_DOUBLE;   break;
+
+      case DFT_raw:
+      case DFT_string:
+      {
+        binds[i].buffer_type    = (field->mDataType == DFT_raw) ? MYSQL_TYPE_BLOB : MYSQL_TYPE_STRING;
+        binds[i].buffer_length  = field->mDataSize;
+        lengths[i]              = field->mDataSize;
+        binds[i].length         = &lengths[i];
+      }
+      break;
+
+      default:          binds[i].buffer_type = MYSQL_TYPE_NULL;     break;
+    }
+  }
+
+  _freeReturnedStatements();
+
+  MYSQL_STMT* statement = 0;
+
+  // a reconnect drops all prepared statements on the server. our idle handles are all stale then, we drop
+  // them and prepare once more
+  for(uint32 attempt = 0; attempt < 2; attempt++)
+  {
+    statement = _acquireStatement(statementId, sql);
+
+    if(!statement)
+      return newResult;
+
+    if(!mysql_stmt_bind_param(statement, binds) && !mysql_stmt_execute(statement))
+      break;
+
+    uint32 error = mysql_stmt_errno(statement);
+
+    gLogger->log(LogManager::EMERGENCY, "DatabaseError: %s", mysql_stmt_error(statement));
+
+    mysql_stmt_close(statement);
+    statement = 0;
+
+    if(error != CR_SERVER_GONE_ERROR && error != CR_SERVER_LOST && error != ER_UNKNOWN_STMT_HANDLER)
+      break;
+
+    _dropStatements();
+  }
+
+  if(!statement)
+    return newResult;
+
+  // only statements returning rows keep their handle until the result gets destroyed
+  MYSQL_RES* metaData = mysql_stmt_result_metadata(statement);
+
+  if(!metaData)
+  {
+    _releaseStatement(statementId, statement);
+    return newResult;
+  }
+
+  mysql_free_result(metaData);
+
+  if(mysql_stmt_store_result(statement))
+  {
+    gLogger->log(LogManager::EMERGENCY, "DatabaseError: %s", mysql_stmt_error(statement));
+  }
+
+  newResult->setResultSetReference((void*)statement);
+  newResult->setRowCount(mysql_stmt_num_rows(statement));
+
+  return newResult;
+}
+
+//======================================================================================================================
+
+MYSQL_STMT* DatabaseImplementationMySql::_acquireStatement(uint32 statementId, const int8* sql)
+{
+  {
+    boost::mutex::scoped_lock lk(mStatementMutex);
+
+    if(statementId < mStatementHandles.size() && mStatementHandles[statementId].size())
+    {
+      MYSQL_STMT* statement = mStatementHandles[statementId].back();
+      mStatementHandles[statementId].pop_back();
+
+      return statement;
+    }
+  }
+
+  // first use on this connection, or all our handles still hold results
+  MYSQL_STMT* statement = mysql_stmt_init(mConnection);
+
+  if(!statement)
+  {
+    gLogger->log(LogManager::EMERGENCY, "DatabaseError: %s", mysql_error(mConnection));
+    return 0;
+  }
+
+  if(mysql_stmt_prepare(statement, sql, (unsigned long)strlen(sql)))
+  {
+    gLogger->log(LogManager::EMERGENCY, "DatabaseError: %s (%s)", mysql_stmt_error(statement), sql);
+
+    mysql_stmt_close(statement);
+    return 0;
+  }
+
+  return statement;
+}
+
+//======================================================================================================================
+//
+// handles still out with a result fail once they come back and get dropped then
+//
+
+void DatabaseImplementationMySql::_dropStatements(void)
+{
+  boost::mutex::scoped_lock lk(mStatementMutex);
+
+  for(uint32 i = 0; i < mStatementHandles.size(); i++)
+  {
+    for(uint32 j = 0; j < mStatementHandles[i].size(); j++)
+    {
+      mysql_stmt_close(mStatementHandles[i][j]);
+    }
+
+    mStatementHandles[i].clear();
+  }
+}
+
+//======================================================================================================================
+
+void DatabaseImplementationMySql::_releaseStatement(uint32 statementId, MYSQL_STMT* statement)
+{
+  boost::mutex::scoped_lock lk(mStatementMutex);
+
+  if(statementId >= mStatementHandles.size())
+  {
+    mStatementHandles.resize(statementId + 1);
+  }
+
+  mStatementHandles[statementId].push_back(statement);
+}
+
+//======================================================================================================================
+//
+// called from whatever thread destroys the result, the handle still holds its rows
+//
+
+void DatabaseImplementationMySql::_returnStatement(uint32 statementId, MYSQL_STMT* statement)
+{
+  boost::mutex::scoped_lock lk(mStatementMutex);
+
+  mReturnedStatements.push_back(std::make_pair(statementId, statement));
+}
+
+//======================================================================================================================
+//
+// only called by the thread running queries on our connection
+//
+
+void DatabaseImplementationMySql::_freeReturnedStatements(void)
+{
+  ReturnedStatementList returned;
+
+  {
+    boost::mutex::scoped_lock lk(mStatementMutex);
+
+    if(mReturnedStatements.empty())
+      return;
+
+    returned.swap(mReturnedStatements);
+  }
+
+  for(uint32 i = 0; i < returned.size(); i++)
+  {
+    mysql_stmt_free_result(returned[i].second);
+    _releaseStatement(returned[i].first, returned[i].second);
+  }
+}
+
 //======================================================================================================================
 
 DatabaseWorkerThread* DatabaseImplementationMySql::DestroyResult(DatabaseResult* result)
 {
 	DatabaseWorkerThread* worker = NULL;
 
+	if(result->getStatementId())
+	{
+		MYSQL_STMT* statement = (MYSQL_STMT*)result->getResultSetReference();
+
+		// the handle belongs to the connection the statement ran on, which isnt necessarily ours.
+		// the rows are buffered on our side, its thread frees them before it uses the connection again
+		if(statement)
+		{
+			static_cast<DatabaseImplementationMySql*>(result->getDatabaseImplementation())->_returnStatement(result->getStatementId(), statement);
+		}
+
+		ResultPool::ordered_free(result);
+
+		return(worker);
+	}
+
 	if((MYSQL_RES*)result->getResultSetReference() == mResultSet)
 		mResultSet = NULL;
 
@@ -131,6 +379,12 @@ void DatabaseImplementationMySql::GetNextRow(DatabaseResult* result, DataBinding
   MYSQL_ROW     row;
   MYSQL_RES*    mySqlResult = (MYSQL_RES*)result->getResultSetReference();
 
+  if(result->getStatementId())
+  {
+    _getNextStatementRow(result, binding, object);
+    return;
+  }
+
   // If any rows were returned
   if (mySqlResult)
   {
@@ -232,13 +486,242 @@ void DatabaseImplementationMySql::GetNextRow(DatabaseResult* result, DataBinding
 }
 
 
+//======================================================================================================================
+//
+// the client library converts the columns and writes them straight to the bound offsets,
+// only strings of unknown length get fetched in a second step
+//
+
+void DatabaseImplementationMySql::_getNextStatementRow(DatabaseResult* result, DataBinding* binding, void* object)
+{
+  MYSQL_STMT* statement = (MYSQL_STMT*)result->getResultSetReference();
+
+  if(!statement)
+    return;
+
+  MYSQL_BIND    binds[200];
+  unsigned long lengths[200];
+  my_bool       nulls[200];
+  uint32        columns = mysql_stmt_field_count(statement);
+
+  if(columns > 200)
+    columns = 200;
+
+  // columns without a binding are skipped
+  memset(binds, 0, sizeof(MYSQL_BIND) * columns);
+
+  for(uint32 c = 0; c < columns; c++)
+  {
+    binds[c].buffer_type  = MYSQL_TYPE_NULL;
+    binds[c].length       = &lengths[c];
+    binds[c].is_null      = &nulls[c];
+    lengths[c]            = 0;
+    nulls[c]              = 0;
+  }
+
+  for(uint32 i = 0; i < binding->getFieldCount(); i++)
+  {
+    DataField*  field   = &binding->mDataFields[i];
+    int8*       target  = &((int8*)object)[field->mDataOffset];
+
+    if(field->mColumn >= columns)
+      continue;
+
+    MYSQL_BIND* bind = &binds[field->mColumn];
+
+    bind->buffer = target;
+
+    switch(field->mDataType)
+    {
+      case DFT_uint8:   bind->is_unsigned = 1;
+      case DFT_int8:    bind->buffer_type = MYSQL_TYPE_TINY;      break;
+      case DFT_uint16:  bind->is_unsigned = 1;
+      case DFT_int16:   bind->buffer_type = MYSQL_TYPE_SHORT;     break;
+      case DFT_uint32:  bind->is_unsigned = 1;
+      case DFT_int32:   bind->buffer_type = MYSQL_TYPE_LONG;      break;
+      case DFT_uint64:  bind->is_unsigned = 1;
+      case DFT_int64:   bind->buffer_type = MYSQL_TYPE_LONGLONG;  break;
+      case DFT_float:   bind->buffer_type = MYSQL_TYPE_FLOAT;     break;
+      case DFT_double:  bind->buffer_type = MYSQL_TYPE_DOUBLE;    break;
+
+      // leave room for the terminator
+      case DFT_string:
+      {
+        bind->buffer_type   = MYSQL_TYPE_STRING;
+        bind->buffer_length = field->mDataSize ? field->mDataSize - 1 : 0;
+      }
+      break;
+
+      // we only learn the length here, fetched below
+      case DFT_bstring:
+      {
+        bind->buffer_type   = MYSQL_TYPE_STRING;
+        bind->buffer        = 0;
+        bind->buffer_length = 0;
+      }
+      break;
+
+      case DFT_raw:
+      {
+        bind->buffer_type   = MYSQL_TYPE_BLOB;
+        bind->buffer_length = field->mDataSize;
+      }
+      break;
+
+      default:
+      {
+        bind->buffer_type   = MYSQL_TYPE_NULL;
+        bind->buffer        = 0;
+      }
+      break;
+    }
+  }
+
+  if(mysql_stmt_bind_result(statement, binds))
+  {
+    gLogger->log(LogManager::EMERGENCY, "DatabaseError: %s", mysql_stmt_error(statement));
+    return;
+  }
+
+  // truncated strings are fine, we terminate them ourselves
+  int32 status = mysql_stmt_fetch(statement);
+
+  if(status != 0 && status != MYSQL_DATA_TRUNCATED)
+    return;
+
+  for(uint32 i = 0; i < binding->getFieldCount(); i++)
+  {
+    DataField*  field   = &binding->mDataFields[i];
+    int8*       target  = &((int8*)object)[field->mDataOffset];
+    uint32      column  = field->mColumn;
+
+    if(column >= columns)
+      continue;
+
+    switch(field->mDataType)
+    {
+      case DFT_string:
+      {
+        if(!field->mDataSize)
+          break;
+
+        uint32 length = nulls[column] ? 0 : (uint32)lengths[column];
+
+        if(length > field->mDataSize - 1)
+          length = field->mDataSize - 1;
+
+        target[length] = 0;
+      }
+      break;
+
+      case DFT_bstring:
+      {
+        BString* bindingString = reinterpret_cast<BString*>(target);
+
+        if(nulls[column])
+        {
+          *bindingString = "";
+          break;
+        }
+
+        int8                localBuffer[8192];
+        std::vector<int8>   largeBuffer;
+        int8*               buffer = localBuffer;
+        uint32              length = (uint32)lengths[column];
+
+        if(length >= sizeof(localBuffer))
+        {
+          largeBuffer.resize(length + 1);
+          buffer = &largeBuffer[0];
+        }
+
+        MYSQL_BIND columnBind;
+        memset(&columnBind, 0, sizeof(MYSQL_BIND));
+
+        columnBind.buffer_type    = MYSQL_TYPE_STRING;
+        columnBind.buffer         = buffer;
+        columnBind.buffer_length  = length;
+
+        if(length)
+          mysql_stmt_fetch_column(statement, &columnBind, column, 0);
+
+        buffer[length] = 0;
+
+        *bindingString = buffer;
+      }
+      break;
+
+      case DFT_int8:
+      case DFT_uint8:     if(nulls[column]) *((uint8*)target) = 0;   break;
+      case DFT_int16:
+      case DFT_uint16:    if(nulls[column]) *((uint16*)target) = 0;  break;
+      case DFT_int32:
+      case DFT_uint32:    if(nulls[column]) *((uint32*)target) = 0;  break;
+      case DFT_int64:
+      case DFT_uint64:    if(nulls[column]) *((uint64*)target) = 0;  break;
+      case DFT_float:     if(nulls[column]) *((float*)target) = 0;   break;
+      case DFT_double:    if(nulls[column]) *((double*)target) = 0;  break;
+
+      default: break;
+    }
+  }
+}
+
 //======================================================================================================================
 void DatabaseImplementationMySql::ResetRowIndex(DatabaseResult* result, uint64 index)
 {
+  if(result->getStatementId())
+  {
+    if(result->getResultSetReference())
+      mysql_stmt_data_seek((MYSQL_STMT*)result->getResultSetReference(), index);
+
+    return;
+  }
+
   mysql_data_seek((MYSQL_RES*)result->getResultSetReference(), index);
 }
 
 
+//======================================================================================================================
+//
+// the worker of a multi result waits until it gets destroyed, so we have the connection to ourselves
+//
+
+bool DatabaseImplementationMySql::NextResultSet(DatabaseResult* result)
+{
+  if(!result->isMultiResult() || result->getStatementId())
+    return false;
+
+  MYSQL* connection = (MYSQL*)result->getConnectionReference();
+
+  mysql_free_result((MYSQL_RES*)result->getResultSetReference());
+
+  result->setResultSetReference(0);
+  result->setRowCount(0);
+
+  int32 status = mysql_next_result(connection);
+
+  if(status > 0)
+  {
+    gLogger->log(LogManager::EMERGENCY, "DatabaseError: %s", mysql_error(connection));
+  }
+
+  if(status != 0)
+    return false;
+
+  MYSQL_RES* resultSet = mysql_store_result(connection);
+
+  result->setResultSetReference((void*)resultSet);
+
+  if(resultSet)
+  {
+    result->setRowCount(resultSet->row_count);
+  }
+
+  return true;
+}
+
+
 //======================================================================================================================
 uint64 DatabaseImplementationMySql::GetInsertId(void)
 {
@@ -31,12 +31,20 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "DatabaseImplementation.h"
 #include "Utils/typedefs.h"
 
+#include <boost/thread/mutex.hpp>
+#include <utility>
+#include <vector>
+
 //======================================================================================================================
 class DatabaseResult;
 
 typedef struct st_mysql MYSQL;
 typedef struct st_mysql_res MYSQL_RES;
 typedef struct st_mysql_rows MYSQL_ROWS;
+typedef struct st_mysql_stmt MYSQL_STMT;
+
+typedef std::vector<MYSQL_STMT*>	StatementHandleList;
+typedef std::vector<std::pair<uint32,MYSQL_STMT*> >	ReturnedStatementList;
 
 
 //======================================================================================================================
@@ -48,17 +56,33 @@ public:
   virtual							~DatabaseImplementationMySql(void);
   
   virtual DatabaseResult*			ExecuteSql(int8* sql,bool procedure = false);
+  virtual DatabaseResult*			ExecuteStatement(uint32 statementId, const int8* sql, StatementParameters* parameters);
   virtual DatabaseWorkerThread*		DestroyResult(DatabaseResult* result);
 
   virtual void						GetNextRow(DatabaseResult* result, DataBinding* binding, void* object);
   virtual void						ResetRowIndex(DatabaseResult* result, uint64 index = 0);
+  virtual bool						NextResultSet(DatabaseResult* result);
   virtual uint64					GetInsertId(void);
 
   virtual uint32					Escape_String(int8* target,const int8* source,uint32 length);
 
 private:
+  MYSQL_STMT*                 _acquireStatement(uint32 statementId, const int8* sql);
+  void                        _releaseStatement(uint32 statementId, MYSQL_STMT* statement);
+  void                        _returnStatement(uint32 statementId, MYSQL_STMT* statement);
+  void                        _freeReturnedStatements(void);
+  void                        _dropStatements(void);
+  void                        _getNextStatementRow(DatabaseResult* result, DataBinding* binding, void* object);
+
   MYSQL*                      mConnection;
   MYSQL_RES*                  mResultSet;
+
+  // idle handles per registered statement. results are destroyed on the main thread, which hands their
+  // handles back to the connection they were prepared on. freeing a result touches the connection, so the
+  // thread owning it does that before its next query and only then the handle is idle again
+  std::vector<StatementHandleList> mStatementHandles;
+  ReturnedStatementList       mReturnedStatements;
+  boost::mutex                mStatementMutex;
 };
 
 
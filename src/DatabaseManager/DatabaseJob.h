@@ -28,20 +28,27 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #ifndef ANH_DATABASEMANAGER_DATABASEJOB_H
 #define ANH_DATABASEMANAGER_DATABASEJOB_H
 
+#include "Utils/typedefs.h"
+
+#include <cassert>
 #include <stdlib.h>
 #include <cstring>
 
+// longest statement a job holds, terminator included
+#define DATABASE_JOB_MAX_SQL	8192
+
 //======================================================================================================================
 class DatabaseCallback;
 class DatabaseResult;
 class DataBinding;
+class StatementParameters;
 
 
 //======================================================================================================================
 class DatabaseJob
 {
 public:
-	DatabaseJob() : mDatabaseCallback(NULL),mDatabaseResult(NULL),mClientReference(NULL),mMultiJob(false){}
+	DatabaseJob() : mDatabaseCallback(NULL),mDatabaseResult(NULL),mClientReference(NULL),mParameters(NULL),mStatementSql(NULL),mStatementId(0),mMultiJob(false),mWaited(false),mDone(false){}
   DatabaseCallback*           getCallback(void)                               { return mDatabaseCallback; }
   DatabaseResult*             getDatabaseResult(void)                         { return mDatabaseResult; };
   void*                       getClientReference(void)                        { return mClientReference; }
@@ -50,16 +57,33 @@ public:
   void                        setCallback(DatabaseCallback* callback)         { mDatabaseCallback = callback; }
   void                        setDatabaseResult(DatabaseResult* result)       { mDatabaseResult = result; }
   void                        setClientReference(void* ref)                   { mClientReference = ref; }
-  void                        setSql(int8* sql)                               { strcpy(mSql, sql); }
+  void                        setSql(int8* sql)                               { assert(strlen(sql) < sizeof(mSql) && "sql does not fit a database job"); strcpy(mSql, sql); }
   void						  setMultiJob(bool job){ mMultiJob = job; }
   bool						  isMultiJob(){ return mMultiJob; }
 
+  // a waited job isnt handed back through the complete queue, the thread that queued it picks it up
+  void						  setWaited(bool waited){ mWaited = waited; }
+  bool						  isWaited(){ return mWaited; }
+  void						  setDone(bool done){ mDone = done; }
+  bool						  isDone(){ return mDone; }
+
+  // a registered statement instead of plain sql, the parameters are a copy the database owns (see Database::_createJob)
+  void						  setStatement(uint32 id, const int8* sql, StatementParameters* parameters){ mStatementId = id; mStatementSql = sql; mParameters = parameters; }
+  uint32					  getStatementId(){ return mStatementId; }
+  const int8*				  getStatementSql(){ return mStatementSql; }
+  StatementParameters*		  getParameters(){ return mParameters; }
+
 private:
   DatabaseCallback*           mDatabaseCallback;
   DatabaseResult*             mDatabaseResult;
   void*                       mClientReference;
-  int8                        mSql[8192];
+  int8                        mSql[DATABASE_JOB_MAX_SQL];
+  StatementParameters*		  mParameters;
+  const int8*				  mStatementSql;
+  uint32					  mStatementId;
   bool						  mMultiJob;
+  bool						  mWaited;
+  bool						  mDone;
 };
 
 
@@ -49,6 +49,13 @@ void DatabaseResult::ResetRowIndex(int index)
   mDatabaseImplementation->ResetRowIndex(this,index);
 }
 
+
+//======================================================================================================================
+bool DatabaseResult::NextResultSet(void)
+{
+  return mDatabaseImplementation->NextResultSet(this);
+}
+
   
 
 
@@ -42,12 +42,16 @@ class DatabaseResult
 {
 public:
                               DatabaseResult(bool multiResult = false) 
-								  :mWorkerReference(0), mConnectionReference(0),mResultSetReference(0),mRowCount(0),mDatabaseImplementation(0),mMultiResult(multiResult) {};
+								  :mWorkerReference(0), mConnectionReference(0),mResultSetReference(0),mRowCount(0),mDatabaseImplementation(0),mStatementId(0),mMultiResult(multiResult) {};
                               ~DatabaseResult(void) {};
 
   virtual void               GetNextRow(DataBinding* dataBinding, void* object);
   void                        ResetRowIndex(int index = 0);
 
+  // multi results (procedures, several statements in one query) only, moves on to the next result set.
+  // returns false once there are none left
+  bool                        NextResultSet(void);
+
   void*						  getConnectionReference(void){ return mConnectionReference; }
   void						  setConnectionReference(void* ref)	{ mConnectionReference =  ref; }
 
@@ -57,6 +61,10 @@ public:
   bool						  isMultiResult(){ return mMultiResult; }
   void						  setMultiResult(bool b){ mMultiResult = b; }
 
+  // results of registered statements hold the statement handle as their result set
+  uint32					  getStatementId(){ return mStatementId; }
+  void						  setStatementId(uint32 id){ mStatementId = id; }
+
   DatabaseImplementation*     getDatabaseImplementation(void)                 { return mDatabaseImplementation; }
   void*                       getResultSetReference(void)                     { return mResultSetReference; }
   uint64                      getRowCount(void)                               { return mRowCount; }
@@ -71,6 +79,7 @@ private:
   void*							mResultSetReference;
   uint64						mRowCount;
   DatabaseImplementation*		mDatabaseImplementation;
+  uint32						mStatementId;
   bool							mMultiResult;
 };
 
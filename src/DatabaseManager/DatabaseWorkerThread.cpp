@@ -45,11 +45,12 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 //======================================================================================================================
 
-DatabaseWorkerThread::DatabaseWorkerThread(DBType type, Database* database, char* host, uint16 port, char* user, char* pass, char* schema) :
+DatabaseWorkerThread::DatabaseWorkerThread(DBType type, Database* database, char* host, uint16 port, char* user, char* pass, char* schema, bool ordered) :
 mDatabase(database),
 mDatabaseImplementation(0),
-mCurrentJob(0),
-mDatabaseImplementationType(type)
+mDatabaseImplementationType(type),
+mResultPending(false),
+mOrdered(ordered)
 {
   mPort = port;
   strcpy(mHostname, host);
@@ -70,6 +71,9 @@ DatabaseWorkerThread::~DatabaseWorkerThread(void)
 {
 	mExit = true;
 
+	// in case we still wait for a result to be destroyed
+	releaseResult();
+
     mThread.interrupt();
     mThread.join();
 
@@ -109,35 +113,37 @@ void DatabaseWorkerThread::run()
   // Call our internal _startup method
   _startup();
 
-	  // Main loop
+	  // Main loop, waitForJob blocks until there is work for us or the database shuts down
 	  while(!mExit)
 	  {
-          // Is there a job waiting?
-		if(mCurrentJob)
+		DatabaseJob* job = mDatabase->waitForJob(this);
+
+		if(!job)
+			break;
+
+		// Execute our query
+		DatabaseResult* result = 0;
+
+		if(job->getStatementId())
+			result = mDatabaseImplementation->ExecuteStatement(job->getStatementId(), job->getStatementSql(), job->getParameters());
+		else
+			result = mDatabaseImplementation->ExecuteSql(job->getSql(),job->isMultiJob());
+
+		// Attach the result to our job and send it back.
+		job->setDatabaseResult(result);
+
+		// a multi result keeps our connection busy until the main thread destroyed it
+		if(result->isMultiResult())
 		{
-            boost::mutex::scoped_lock lk(mWorkerThreadMutex);
-		  // Execute our query
-		  DatabaseResult* result = mDatabaseImplementation->ExecuteSql(mCurrentJob->getSql(),mCurrentJob->isMultiJob());
-
-		  // Attach the result to our job and send it back.
-		  mCurrentJob->setDatabaseResult(result);
-
-		  // put it on the complete list
-		  mDatabase->pushDatabaseJobComplete(mCurrentJob);
-
-		  // Put ourselves back on the idle list.
-		  if(!result->isMultiResult())
-		  {
-			mDatabase->pushIdleWorker(this);
-		  }
-		  else
+			boost::mutex::scoped_lock lk(mWorkerThreadMutex);
+			mResultPending = true;
 			result->setWorkerReference(this);
+		}
 
-		  mCurrentJob = 0;
-		} 
+		// put it on the complete list
+		mDatabase->pushDatabaseJobComplete(job);
 
-		// and always sleep a little.
-        boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+		_waitForResultRelease();
 	  }
 	 
 	 // internal shutdown method
@@ -146,6 +152,30 @@ void DatabaseWorkerThread::run()
 
 //======================================================================================================================
 
+void DatabaseWorkerThread::releaseResult(void)
+{
+	{
+		boost::mutex::scoped_lock lk(mWorkerThreadMutex);
+		mResultPending = false;
+	}
+
+	mResultCondition.notify_one();
+}
+
+//======================================================================================================================
+
+void DatabaseWorkerThread::_waitForResultRelease(void)
+{
+	boost::mutex::scoped_lock lk(mWorkerThreadMutex);
+
+	while(mResultPending && !mExit)
+	{
+		mResultCondition.wait(lk);
+	}
+}
+
+//======================================================================================================================
+
 
 
 
@@ -30,8 +30,12 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "DatabaseType.h"
 #include "Utils/typedefs.h"
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
 #include <boost/thread/thread.hpp>
 
+#include <deque>
+
 //======================================================================================================================
 
 class Database;
@@ -43,12 +47,20 @@ class DatabaseImplementation;
 class DatabaseWorkerThread
 {
 public:
-                              DatabaseWorkerThread(DBType type, Database* datbase, int8* host, uint16 port, int8* user, int8* pass, int8* schema);
+                              DatabaseWorkerThread(DBType type, Database* datbase, int8* host, uint16 port, int8* user, int8* pass, int8* schema, bool ordered);
                               ~DatabaseWorkerThread(void);
 
   virtual void				  run(); 
 
-  void                        ExecuteJob(DatabaseJob* job);
+  // keyed jobs, only touched with the databases job mutex held
+  void                        pushOrderedJob(DatabaseJob* job){ mOrderedJobs.push_back(job); }
+  DatabaseJob*                popOrderedJob(void);
+
+  // an ordered worker only runs keyed jobs
+  bool                        isOrdered(void) const { return mOrdered; }
+
+  // called by the main thread, once it destroyed our multi result
+  void                        releaseResult(void);
 
   void						  requestExit(){ mExit = true; }
 
@@ -62,16 +74,20 @@ protected:
 private:
   void                        _startup(void);
   void                        _shutdown(void);
+  void                        _waitForResultRelease(void);
 
   bool						  mIsDone;
   Database*                   mDatabase;
   DatabaseImplementation*     mDatabaseImplementation;
 
-  DatabaseJob*                mCurrentJob;
+  std::deque<DatabaseJob*>    mOrderedJobs;
   DBType                      mDatabaseImplementationType;
 
   boost::mutex              mWorkerThreadMutex;
+  boost::condition_variable mResultCondition;
   boost::thread			    mThread;
+  bool						  mResultPending;
+  bool						  mOrdered;
   bool						  mExit;
 };
 
@@ -79,10 +95,15 @@ private:
 
 //======================================================================================================================
 
-inline void DatabaseWorkerThread::ExecuteJob(DatabaseJob* job)
+inline DatabaseJob* DatabaseWorkerThread::popOrderedJob(void)
 {
-    boost::mutex::scoped_lock lk(mWorkerThreadMutex);
-    mCurrentJob = job;
+    if(mOrderedJobs.empty())
+        return 0;
+
+    DatabaseJob* job = mOrderedJobs.front();
+    mOrderedJobs.pop_front();
+
+    return job;
 }
 
 //======================================================================================================================
@@ -0,0 +1,134 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#ifndef ANH_DATABASEMANAGER_STATEMENTPARAMETERS_H
+#define ANH_DATABASEMANAGER_STATEMENTPARAMETERS_H
+
+#include "DataBinding.h"
+#include "Utils/typedefs.h"
+
+#include <cassert>
+#include <cstring>
+
+// The parameters of a registered statement, added in the order of the placeholders in its sql.
+// The values are copied, so the object can be reused or go out of scope right after queueing the statement.
+// Copying only moves the fields and bytes in use, every copy still has the full size.
+//======================================================================================================================
+/*
+  StatementParameters params;
+  params.addFloat(player->mPosition.x);
+  params.addUint64(player->getId());
+  mDatabase->ExecuteStatementAsync(this, container, mSavePositionStatement, &params);
+*/
+
+#define STATEMENT_MAX_PARAMETERS	64
+#define STATEMENT_PARAMETER_BUFFER	2048
+
+//======================================================================================================================
+
+class StatementParameters
+{
+	public:
+					StatementParameters(void) : mCount(0), mSize(0) { }
+					StatementParameters(const StatementParameters& other) : mCount(0), mSize(0) { *this = other; }
+
+		StatementParameters& operator=(const StatementParameters& other);
+
+		void		addInt8(int8 value)			{ _add(DFT_int8, &value, sizeof(value)); }
+		void		addUint8(uint8 value)		{ _add(DFT_uint8, &value, sizeof(value)); }
+		void		addInt16(int16 value)		{ _add(DFT_int16, &value, sizeof(value)); }
+		void		addUint16(uint16 value)		{ _add(DFT_uint16, &value, sizeof(value)); }
+		void		addInt32(int32 value)		{ _add(DFT_int32, &value, sizeof(value)); }
+		void		addUint32(uint32 value)		{ _add(DFT_uint32, &value, sizeof(value)); }
+		void		addInt64(int64 value)		{ _add(DFT_int64, &value, sizeof(value)); }
+		void		addUint64(uint64 value)		{ _add(DFT_uint64, &value, sizeof(value)); }
+		void		addFloat(float value)		{ _add(DFT_float, &value, sizeof(value)); }
+		void		addDouble(double value)		{ _add(DFT_double, &value, sizeof(value)); }
+
+		// no escaping needed, the string is sent as is
+		void		addString(const int8* value){ _add(DFT_string, value, (uint32)strlen(value)); }
+		void		addRaw(const void* value, uint32 size){ _add(DFT_raw, value, size); }
+
+		uint32		getCount(void)				{ return mCount; }
+		DataField*	getField(uint32 index)		{ return &mFields[index]; }
+		int8*		getData(uint32 index)		{ return &mData[mFields[index].mDataOffset]; }
+
+		void		clear(void)					{ mCount = 0; mSize = 0; }
+
+	private:
+
+		void		_add(DataFieldType type, const void* value, uint32 size);
+
+		uint32		mCount;
+		uint32		mSize;
+		DataField	mFields[STATEMENT_MAX_PARAMETERS];
+		int8		mData[STATEMENT_PARAMETER_BUFFER];
+};
+
+//======================================================================================================================
+
+inline StatementParameters& StatementParameters::operator=(const StatementParameters& other)
+{
+	if(this == &other)
+		return *this;
+
+	mCount	= other.mCount;
+	mSize	= other.mSize;
+
+	memcpy(mFields, other.mFields, sizeof(DataField) * mCount);
+	memcpy(mData, other.mData, mSize);
+
+	return *this;
+}
+
+//======================================================================================================================
+
+inline void StatementParameters::_add(DataFieldType type, const void* value, uint32 size)
+{
+	// keep the numbers aligned, the client library reads them in place
+	mSize = (mSize + 7) & ~7;
+
+	assert(mCount < STATEMENT_MAX_PARAMETERS && "Exceeds max parameter count");
+	assert(mSize + size <= STATEMENT_PARAMETER_BUFFER && "Exceeds parameter buffer size");
+
+	mFields[mCount].mDataType	= type;
+	mFields[mCount].mDataOffset	= mSize;
+	mFields[mCount].mDataSize	= size;
+	mFields[mCount].mColumn		= mCount;
+
+	memcpy(&mData[mSize], value, size);
+
+	mSize += size;
+	mCount++;
+}
+
+//======================================================================================================================
+
+#endif // ANH_DATABASEMANAGER_STATEMENTPARAMETERS_H
+
+
+
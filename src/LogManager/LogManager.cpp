@@ -29,8 +29,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include <cstdarg>
 #include <stdarg.h>
 #include <stdio.h>
-#include <vector>
 
+#include "Utils/atomic.h"
 #include "Utils/clock.h"
 
 LogManager* LogManager::mSingleton;
@@ -38,37 +38,53 @@ LogManager* LogManager::mSingleton;
 class LOG_ENTRY
 {
 public:
+	volatile uint32				mSequence;
 	LogManager::LOG_PRIORITY	mPriority;
-	uint8			mChannels;
-	std::string		mMessage;
-
-	bool mContinuation;
+	uint8						mChannels;
+	bool						mContinuation;
+	char						mMessage[LOG_ENTRY_SIZE];
 };
 
 LogManager::LogManager()
+: mRingWritePos(0)
+, mRingReadPos(0)
+, mDroppedEntries(0)
+, mLoggerSleeping(0)
+, mMaxPriority(0)
+, mOutputFile(0)
 {
 	_printLogo();
 
-	boost::thread t(std::tr1::bind(&LogManager::_LoggerThread, this));
-	mThread = boost::move(t);
-
 	//Set the Defaults to No Logs.
 	mMinPriorities[0] = 0;
 	mMinPriorities[1] = 0;
 	mMinPriorities[2] = 0;
+
+	mRing = new LOG_ENTRY[LOG_RING_SIZE];
+
+	for(uint32 i = 0; i < LOG_RING_SIZE; i++)
+	{
+		mRing[i].mSequence = i;
+	}
+
+	boost::thread t(std::tr1::bind(&LogManager::_LoggerThread, this));
+	mThread = boost::move(t);
 }
 
 bool LogManager::setupConsoleLogging(LOG_PRIORITY min_priority)
 {
 	mMinPriorities[0] = min_priority;
+	_updateMaxPriority();
 	return true;
 }
 
 bool LogManager::setupFileLogging(LOG_PRIORITY min_priority, std::string filename)
 {
-	mMinPriorities[1] = min_priority;
 	mOutputFile = fopen(filename.c_str(), "w");
 
+	if(!mOutputFile)
+		return false;
+
 	if(ferror(mOutputFile))
 	{
 		printf("Error dealing with the log file.");
@@ -76,77 +92,95 @@ bool LogManager::setupFileLogging(LOG_PRIORITY min_priority, std::string filenam
 		return false;
 	}
 
-	if(!mOutputFile)
-		return false;
+	mMinPriorities[1] = min_priority;
+	_updateMaxPriority();
 
 	return true;
 }
 
-void LogManager::_LoggerThread()
+void LogManager::_updateMaxPriority()
 {
-	std::vector<LOG_ENTRY*> mTempEntries;
+	mMaxPriority = std::max<uint8>(mMinPriorities[0], std::max<uint8>(mMinPriorities[1], mMinPriorities[2]));
+}
 
+void LogManager::_LoggerThread()
+{
 	char* priority_strings[] = {"EMER", "ALRT", "CRIT", "ERRO", "WARN", "NOTI", "INFO", "DEBG"};
 
+	uint32	reportedDrops = 0;
+	bool	fileDirty = false;
+
 	while(true)
 	{
-		this->mEntriesMutex.lock();
+		LOG_ENTRY* entry = &mRing[mRingReadPos & (LOG_RING_SIZE - 1)];
 
-		mTempEntries.reserve(mEntries.size());
-
-		while(mEntries.size() > 0)
+		if(Anh_Utils::atomicLoad(&entry->mSequence) != mRingReadPos + 1)
 		{
-			mTempEntries.push_back(mEntries.front());
-			mEntries.pop();
-		}
-		this->mEntriesMutex.unlock();
+			// ring is empty, catch up on housekeeping before we go to sleep
+			if(fileDirty)
+			{
+				fflush(mOutputFile);
+				fileDirty = false;
+			}
+
+			uint32 drops = mDroppedEntries;
 
-		std::vector<LOG_ENTRY*>::iterator end = mTempEntries.end();
+			if(drops != reportedDrops)
+			{
+				printf("[LogManager] %u log entries dropped, the log ring was full\n", drops - reportedDrops);
+				reportedDrops = drops;
+			}
+
+			boost::mutex::scoped_lock lk(mWakeMutex);
+
+			Anh_Utils::atomicStore(&mLoggerSleeping, 1);
+			Anh_Utils::memoryBarrier();
+
+			// a producer not seeing us asleep yet wont notify, the timeout covers that window
+			if(Anh_Utils::atomicLoad(&entry->mSequence) != mRingReadPos + 1)
+			{
+				mWakeCondition.timed_wait(lk, boost::posix_time::milliseconds(100));
+			}
+
+			Anh_Utils::atomicStore(&mLoggerSleeping, 0);
+			continue;
+		}
 
 		struct tm t;
 		time_t te = time(NULL);
 		localtime_r(&te, &t);
 
-		for(std::vector<LOG_ENTRY*>::iterator it=mTempEntries.begin(); it != end; it++)
+		if(entry->mChannels & LOG_CHANNEL_CONSOLE && (entry->mPriority <= mMinPriorities[0]))
 		{
-			if((*it)->mChannels & LOG_CHANNEL_CONSOLE && ((*it)->mPriority <= mMinPriorities[0]))
-			{
-				if(!(*it)->mContinuation)
-					printf("[%02d:%02d:%02d] [%s] ",t.tm_hour,t.tm_min,t.tm_sec, priority_strings[(int)(*it)->mPriority - 1]);
-				else
-					printf("                  ");
+			if(!entry->mContinuation)
+				printf("[%02d:%02d:%02d] [%s] ",t.tm_hour,t.tm_min,t.tm_sec, priority_strings[(int)entry->mPriority - 1]);
+			else
+				printf("                  ");
 
-				printf("%s\n", (*it)->mMessage.c_str());
-			}
-			
-			if((*it)->mChannels & LOG_CHANNEL_FILE && ((*it)->mPriority <= mMinPriorities[1]))
+			printf("%s\n", entry->mMessage);
+		}
+		
+		if(entry->mChannels & LOG_CHANNEL_FILE && (entry->mPriority <= mMinPriorities[1]))
+		{
+			if(mOutputFile)
 			{
-				if(mOutputFile)
-				{
-          // Use a lock guard for the mutex which will unlock when it goes out of scope,
-          // in this case at the end of this inner if statement.
-          boost::lock_guard<boost::mutex> guard(mEntriesMutex);
-
-					if(!(*it)->mContinuation)
-						fprintf(mOutputFile, "[%02d:%02d:%02d] [%s] ",t.tm_hour,t.tm_min,t.tm_sec, priority_strings[(int)(*it)->mPriority - 1]);
-					else
-						fprintf(mOutputFile, "                  ");
-					
-					fprintf(mOutputFile, "%s\n", (*it)->mMessage.c_str());
-					fflush(mOutputFile);
-				}
+				if(!entry->mContinuation)
+					fprintf(mOutputFile, "[%02d:%02d:%02d] [%s] ",t.tm_hour,t.tm_min,t.tm_sec, priority_strings[(int)entry->mPriority - 1]);
+				else
+					fprintf(mOutputFile, "                  ");
+				
+				fprintf(mOutputFile, "%s\n", entry->mMessage);
+				fileDirty = true;
 			}
-
-			//if((*it)->mChannels & LOG_CHANNEL_DATABASE && ((*it)->mPriority <= mMinPriorities[2]))
-			//{
-			//}
-
-			delete (*it);
 		}
 
-		mTempEntries.clear();
+		//if(entry->mChannels & LOG_CHANNEL_DATABASE && (entry->mPriority <= mMinPriorities[2]))
+		//{
+		//}
 
-		boost::this_thread::sleep(boost::posix_time::milliseconds(10));
+		// hand the entry back to the producers
+		Anh_Utils::atomicStore(&entry->mSequence, mRingReadPos + LOG_RING_SIZE);
+		++mRingReadPos;
 	}
 }
 
@@ -159,108 +193,139 @@ printf("                    ___) |\\ V  V /| |_| |/ ___ \\| |\\  |  _  |\n");
 printf("                   |____/  \\_/\\_/  \\____/_/   \\_\\_| \\_|_| |_|\n");
 printf("                                               There is Another...\n\n");
 }
+
+void LogManager::_logV(LOG_PRIORITY priority, uint8 channels, bool continuation, const char* format, va_list args)
+{
+	// claim an entry
+	uint32		pos = Anh_Utils::atomicLoad(&mRingWritePos);
+	LOG_ENTRY*	entry;
+
+	while(true)
+	{
+		entry = &mRing[pos & (LOG_RING_SIZE - 1)];
+
+		int32 diff = (int32)(Anh_Utils::atomicLoad(&entry->mSequence) - pos);
+
+		if(diff == 0)
+		{
+			if(Anh_Utils::atomicCompareAndSwap(&mRingWritePos, pos, pos + 1))
+			{
+				break;
+			}
+
+			pos = Anh_Utils::atomicLoad(&mRingWritePos);
+		}
+		else if(diff < 0)
+		{
+			// the logger thread is behind a full ring, rather lose the line than stall the server
+			Anh_Utils::atomicIncrement(&mDroppedEntries);
+			return;
+		}
+		else
+		{
+			pos = Anh_Utils::atomicLoad(&mRingWritePos);
+		}
+	}
+
+	vsnprintf(entry->mMessage, LOG_ENTRY_SIZE, format, args);
+
+	entry->mPriority		= priority;
+	entry->mChannels		= channels;
+	entry->mContinuation	= continuation;
+
+	// publish it
+	Anh_Utils::atomicStore(&entry->mSequence, pos + 1);
+
+	if(Anh_Utils::atomicLoad(&mLoggerSleeping))
+	{
+		mWakeCondition.notify_one();
+	}
+}
 	
-void LogManager::log(LOG_PRIORITY priority, std::string format, ...)
+void LogManager::log(LOG_PRIORITY priority, const char* format, ...)
 {
-	//Read the VA List Info
+	if(priority > mMaxPriority)
+		return;
+
 	va_list args;
 	va_start(args, format);
+	_logV(priority, LOG_CHANNEL_ALL, false, format, args);
+	va_end(args);
+}
 
-  // Determine the size of the buffer needed and create an appropriately
-  // sized container.
-  const int size = vsnprintf(NULL, 0, format.c_str(), args);
-  std::vector<char> buffer(size+1); // Account for the \n terminator.
+void LogManager::log(LOG_PRIORITY priority, std::string format, ...)
+{
+	if(priority > mMaxPriority)
+		return;
 
-	vsprintf(&buffer[0], format.c_str(), args);
+	va_list args;
+	va_start(args, format);
+	_logV(priority, LOG_CHANNEL_ALL, false, format.c_str(), args);
 	va_end(args);
+}
 
-	LOG_ENTRY* entry = new LOG_ENTRY();
-
-	entry->mPriority = priority;
-	entry->mChannels = LOG_CHANNEL_ALL;
-  entry->mMessage.assign(buffer.begin(), buffer.end());
-	entry->mContinuation = false;
+void LogManager::logCont(LOG_PRIORITY priority, const char* format, ...)
+{
+	if(priority > mMaxPriority)
+		return;
 
-	mEntriesMutex.lock();
-	mEntries.push(entry);
-	mEntriesMutex.unlock();
+	va_list args;
+	va_start(args, format);
+	_logV(priority, LOG_CHANNEL_ALL, true, format, args);
+	va_end(args);
 }
 
 void LogManager::logCont(LOG_PRIORITY priority, std::string format, ...)
 {
+	if(priority > mMaxPriority)
+		return;
 
-	//Read the VA List Info
 	va_list args;
-	va_start(args, format);  
-  
-  // Determine the size of the buffer needed and create an appropriately
-  // sized container.
-  const int size = vsnprintf(NULL, 0, format.c_str(), args);
-  std::vector<char> buffer(size+1); // Account for the \n terminator.
-
-	vsprintf(&buffer[0], format.c_str(), args);
+	va_start(args, format);
+	_logV(priority, LOG_CHANNEL_ALL, true, format.c_str(), args);
 	va_end(args);
+}
 
-	LOG_ENTRY* entry = new LOG_ENTRY();
-
-	entry->mPriority = priority;
-	entry->mChannels = LOG_CHANNEL_ALL;
-  entry->mMessage.assign(buffer.begin(), buffer.end());
-	entry->mContinuation = true;
+void LogManager::logS(LOG_PRIORITY priority, uint8 channels, const char* format, ...)
+{
+	if(priority > mMaxPriority)
+		return;
 
-	mEntriesMutex.lock();
-	mEntries.push(entry);
-	mEntriesMutex.unlock();
+	va_list args;
+	va_start(args, format);
+	_logV(priority, channels, false, format, args);
+	va_end(args);
 }
 
 void LogManager::logS(LOG_PRIORITY priority, uint8 channels, std::string format, ...)
 {
-	//Read the VA List Info
+	if(priority > mMaxPriority)
+		return;
+
 	va_list args;
 	va_start(args, format);
-  
-  // Determine the size of the buffer needed and create an appropriately
-  // sized container.
-  const int size = vsnprintf(NULL, 0, format.c_str(), args);
-  std::vector<char> buffer(size+1); // Account for the \n terminator.
-
-	vsprintf(&buffer[0], format.c_str(), args);
+	_logV(priority, channels, false, format.c_str(), args);
 	va_end(args);
+}
 
-	LOG_ENTRY* entry = new LOG_ENTRY();
-
-	entry->mPriority = priority;
-	entry->mChannels = channels;
-  entry->mMessage.assign(buffer.begin(), buffer.end());
-	entry->mContinuation = false;
+void LogManager::logContS(LOG_PRIORITY priority, uint8 channels, const char* format, ...)
+{
+	if(priority > mMaxPriority)
+		return;
 
-	mEntriesMutex.lock();
-	mEntries.push(entry);
-	mEntriesMutex.unlock();
+	va_list args;
+	va_start(args, format);
+	_logV(priority, channels, true, format, args);
+	va_end(args);
 }
 
 void LogManager::logContS(LOG_PRIORITY priority, uint8 channels, std::string format, ...)
 {
-	//Read the VA List Info
+	if(priority > mMaxPriority)
+		return;
+
 	va_list args;
 	va_start(args, format);
-  
-  // Determine the size of the buffer needed and create an appropriately
-  // sized container.
-  const int size = vsnprintf(NULL, 0, format.c_str(), args);
-  std::vector<char> buffer(size+1); // Account for the \n terminator.
-
-	vsprintf(&buffer[0], format.c_str(), args);
+	_logV(priority, channels, true, format.c_str(), args);
 	va_end(args);
-
-	LOG_ENTRY* entry = new LOG_ENTRY();
-
-	entry->mPriority = priority;
-	entry->mChannels = channels;
-  entry->mMessage.assign(buffer.begin(), buffer.end());
-	entry->mContinuation = true;
-
-	mEntriesMutex.lock();
-	mEntries.push(entry);
-	mEntriesMutex.unlock();
 }
@@ -31,7 +31,10 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "Utils\typedefs.h"
 
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
 #include <boost/thread/thread.hpp>
+#include <cstdarg>
 #include <string>
 #include <queue>
 #include <memory>
@@ -43,6 +46,10 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #define LOG_CHANNEL_NONE	 0
 #define LOG_CHANNEL_ALL		 7
 
+// entries are formatted straight into a preallocated ring, longer messages get truncated
+#define LOG_ENTRY_SIZE		 512
+#define LOG_RING_SIZE		 4096	// power of two
+
 class LOG_ENTRY;
 class Database;
 
@@ -72,11 +79,21 @@ public:
 
 	bool setupConsoleLogging(LOG_PRIORITY min_priority);
 	bool setupFileLogging(LOG_PRIORITY min_priority, std::string filename);
+
+	// true if any channel logs this priority, check it before building expensive log arguments
+	bool isLogged(LOG_PRIORITY priority) const { return priority <= mMaxPriority; }
+
+	// entries lost because the ring was full
+	uint32 getDroppedEntries() const { return mDroppedEntries; }
 	
+	void log(LOG_PRIORITY priority, const char* format, ...);
 	void log(LOG_PRIORITY priority, std::string format, ...);
+	void logCont(LOG_PRIORITY priority, const char* format, ...);
 	void logCont(LOG_PRIORITY priority, std::string format, ...);
 
+	void logS(LOG_PRIORITY priority, uint8 channels, const char* format, ...);
 	void logS(LOG_PRIORITY priority, uint8 channels, std::string format, ...);
+	void logContS(LOG_PRIORITY priority, uint8 channels, const char* format, ...);
 	void logContS(LOG_PRIORITY priority, uint8 channels, std::string format, ...);
 
 	static LogManager* mSingleton;
@@ -88,13 +105,23 @@ private:
 
 	void _printLogo();
 	void _LoggerThread();
+	void _logV(LOG_PRIORITY priority, uint8 channels, bool continuation, const char* format, va_list args);
+	void _updateMaxPriority();
 
 	boost::thread				mThread;
-	boost::mutex				mEntriesMutex;
-	std::queue<LOG_ENTRY*>		mEntries;
 
+	// multi producer ring, every entry carries a sequence number telling whether it is free or written
+	LOG_ENTRY*					mRing;
+	volatile uint32				mRingWritePos;
+	uint32						mRingReadPos;		// logger thread only
+	volatile uint32				mDroppedEntries;
+
+	boost::mutex				mWakeMutex;
+	boost::condition_variable	mWakeCondition;
+	volatile uint32				mLoggerSleeping;
 
 	uint8						mMinPriorities[3];
+	uint8						mMaxPriority;
 	FILE*						mOutputFile;
 };
 
@@ -0,0 +1,159 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#include "BaselineCache.h"
+
+#include "Common/Message.h"
+#include "Common/MessageFactory.h"
+
+//======================================================================================================================
+
+BaselineCache::BaselineCache(MessageFactory* messageFactory,uint32 capacity,uint32 maxBytes)
+: mMessageFactory(messageFactory)
+, mCapacity(capacity)
+, mMaxBytes(maxBytes)
+, mBytes(0)
+, mHits(0)
+, mMisses(0)
+{
+}
+
+//======================================================================================================================
+
+BaselineCache::~BaselineCache()
+{
+	clear();
+}
+
+//======================================================================================================================
+
+Message* BaselineCache::getBaseline(uint64 objectId,uint8 slot,uint32 version)
+{
+	BaselineMap::iterator it = mBaselineMap.find(BaselineKey(objectId,slot));
+
+	if(it == mBaselineMap.end())
+	{
+		mMisses++;
+		return(NULL);
+	}
+
+	BaselineList::iterator baselineIt = (*it).second;
+
+	// the object changed since, no one is going to ask for that version again
+	if((*baselineIt).mVersion != version)
+	{
+		_evict(it);
+
+		mMisses++;
+		return(NULL);
+	}
+
+	mBaselines.splice(mBaselines.begin(),mBaselines,baselineIt);
+
+	mHits++;
+
+	return(mMessageFactory->ShareMessage((*baselineIt).mBaseline));
+}
+
+//======================================================================================================================
+
+Message* BaselineCache::storeBaseline(uint64 objectId,uint8 slot,uint32 version,Message* baseline)
+{
+	uint32 size = baseline->getSize();
+
+	if(!mCapacity || size > mMaxBytes)
+		return(baseline);
+
+	BaselineMap::iterator it = mBaselineMap.find(BaselineKey(objectId,slot));
+
+	if(it != mBaselineMap.end())
+	{
+		_evict(it);
+	}
+
+	while(mBaselines.size() && (mBaselineMap.size() >= mCapacity || mBytes + size > mMaxBytes))
+	{
+		_evictOldest();
+	}
+
+	baseline = mMessageFactory->PinMessage(baseline);
+	mBytes += size;
+
+	CachedBaseline cached;
+
+	cached.mObjectId	= objectId;
+	cached.mBaseline	= baseline;
+	cached.mVersion		= version;
+	cached.mSlot		= slot;
+
+	mBaselines.push_front(cached);
+	mBaselineMap.insert(std::make_pair(BaselineKey(objectId,slot),mBaselines.begin()));
+
+	return(mMessageFactory->ShareMessage(baseline));
+}
+
+//======================================================================================================================
+
+void BaselineCache::clear()
+{
+	BaselineList::iterator it = mBaselines.begin();
+
+	while(it != mBaselines.end())
+	{
+		(*it).mBaseline->setPendingDelete(true);
+		++it;
+	}
+
+	mBaselines.clear();
+	mBaselineMap.clear();
+	mBytes = 0;
+}
+
+//======================================================================================================================
+//
+// shares still waiting to be sent keep the payload alive
+//
+
+void BaselineCache::_evict(BaselineMap::iterator it)
+{
+	BaselineList::iterator baselineIt = (*it).second;
+
+	mBytes -= (*baselineIt).mBaseline->getSize();
+	(*baselineIt).mBaseline->setPendingDelete(true);
+
+	mBaselines.erase(baselineIt);
+	mBaselineMap.erase(it);
+}
+
+//======================================================================================================================
+
+void BaselineCache::_evictOldest()
+{
+	CachedBaseline& oldest = mBaselines.back();
+
+	_evict(mBaselineMap.find(BaselineKey(oldest.mObjectId,oldest.mSlot)));
+}
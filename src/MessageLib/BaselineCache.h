@@ -0,0 +1,105 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#ifndef ANH_MESSAGELIB_BASELINECACHE_H
+#define ANH_MESSAGELIB_BASELINECACHE_H
+
+#include "Utils/typedefs.h"
+
+#include <boost/unordered_map.hpp>
+
+#include <list>
+#include <utility>
+
+class Message;
+class MessageFactory;
+
+//======================================================================================================================
+//
+// Serialized baselines, built once per object and version and handed to every observer as a share of the same payload.
+// A baseline is identified by the object id and its slot (see BaselineCacheSlot), the version tells whether the object
+// changed since it was built. Only the most recently used baselines are kept, up to capacity baselines and maxBytes
+// of payload. The cached messages are pinned in the factory since they may well outlive MESSAGE_MAX_LIFE_TIME,
+// which also moves them out of its heap.
+// A capacity of 0 turns the cache off, every baseline is sent as built then.
+//
+
+class BaselineCache
+{
+	public:
+
+		BaselineCache(MessageFactory* messageFactory,uint32 capacity,uint32 maxBytes);
+		~BaselineCache();
+
+		// a share of the cached baseline, NULL if we don't have it at this version
+		Message*				getBaseline(uint64 objectId,uint8 slot,uint32 version);
+
+		// takes over the freshly built baseline and returns the message to send in its place
+		Message*				storeBaseline(uint64 objectId,uint8 slot,uint32 version,Message* baseline);
+
+		void					clear();
+
+		uint32					getSize(){ return static_cast<uint32>(mBaselineMap.size()); }
+		uint32					getCapacity(){ return mCapacity; }
+		uint32					getBytes(){ return mBytes; }
+		uint32					getMaxBytes(){ return mMaxBytes; }
+		uint64					getHits(){ return mHits; }
+		uint64					getMisses(){ return mMisses; }
+
+	private:
+
+		struct CachedBaseline
+		{
+			uint64		mObjectId;
+			Message*	mBaseline;
+			uint32		mVersion;
+			uint8		mSlot;
+		};
+
+		typedef std::pair<uint64,uint8>											BaselineKey;
+		typedef std::list<CachedBaseline>										BaselineList;
+		typedef boost::unordered_map<BaselineKey,BaselineList::iterator>		BaselineMap;
+
+		void					_evict(BaselineMap::iterator it);
+		void					_evictOldest();
+
+		MessageFactory*			mMessageFactory;
+
+		// most recently used first
+		BaselineList			mBaselines;
+		BaselineMap				mBaselineMap;
+
+		uint32					mCapacity;
+		uint32					mMaxBytes;
+		uint32					mBytes;
+		uint64					mHits;
+		uint64					mMisses;
+};
+
+//======================================================================================================================
+
+#endif
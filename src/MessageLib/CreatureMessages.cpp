@@ -146,6 +146,12 @@ bool MessageLib::sendBaselinesCREO_3(CreatureObject* creatureObject,PlayerObject
 	if(!(targetObject->isConnected()))
 		return(false);
 
+	if(Message* cached = _getCachedBaseline(creatureObject,BaselineCache_CREO_3))
+	{
+		(targetObject->getClient())->SendChannelA(cached, targetObject->getAccountId(), CR_Client, 5);
+		return(true);
+	}
+
 	Message*		message;
 	Ham*			creatureHam = creatureObject->getHam();
 	string			firstName = creatureObject->getFirstName().getAnsi();
@@ -277,7 +283,7 @@ bool MessageLib::sendBaselinesCREO_3(CreatureObject* creatureObject,PlayerObject
 		mMessageFactory->addUint32(creatureHam->mWillpower.getWounds());
 	}
 
-	message = mMessageFactory->EndMessage();
+	message = _cacheBaseline(creatureObject,BaselineCache_CREO_3,mMessageFactory->EndMessage());
 
 	(targetObject->getClient())->SendChannelA(message, targetObject->getAccountId(), CR_Client, 5);
 
@@ -390,6 +396,12 @@ bool MessageLib::sendBaselinesCREO_6(CreatureObject* creatureObject,PlayerObject
 	if(!(targetObject->isConnected()))
 		return(false);
 
+	if(Message* cached = _getCachedBaseline(creatureObject,BaselineCache_CREO_6))
+	{
+		(targetObject->getClient())->SendChannelA(cached, targetObject->getAccountId(), CR_Client, 5);
+		return(true);
+	}
+
 	Ham*			creatureHam		= creatureObject->getHam();
 	
 	// Test ERU
@@ -405,7 +417,7 @@ bool MessageLib::sendBaselinesCREO_6(CreatureObject* creatureObject,PlayerObject
 	string			moodStr			= gWorldManager->getMood(moodId);
 
 	ObjectList*		equippedObjects = creatureObject->getEquipManager()->getEquippedObjects();
-	ObjectIDList*	defenders		= creatureObject->getDefenders();
+	const ObjectIDList*	defenders	= creatureObject->getDefenders();
 
 	ObjectList::iterator eqIt = equippedObjects->begin();
 
@@ -420,7 +432,7 @@ bool MessageLib::sendBaselinesCREO_6(CreatureObject* creatureObject,PlayerObject
 	mMessageFactory->addUint32(defenders->size());
 	mMessageFactory->addUint32(creatureObject->mDefenderUpdateCounter);
 
-	ObjectIDList::iterator defenderIt = defenders->begin();
+	ObjectIDList::const_iterator defenderIt = defenders->begin();
 
 	while(defenderIt != defenders->end())
 	{
@@ -598,7 +610,7 @@ bool MessageLib::sendBaselinesCREO_6(CreatureObject* creatureObject,PlayerObject
 	mMessageFactory->addData(data->getData(),data->getSize());
 	data->setPendingDelete(true);
 
-	(targetObject->getClient())->SendChannelA(mMessageFactory->EndMessage(), targetObject->getAccountId(), CR_Client, 5);
+	(targetObject->getClient())->SendChannelA(_cacheBaseline(creatureObject,BaselineCache_CREO_6,mMessageFactory->EndMessage()), targetObject->getAccountId(), CR_Client, 5);
 
 	return(true);
 }
@@ -638,6 +650,8 @@ void MessageLib::sendDefenderUpdate(CreatureObject* creatureObject,uint8 updateT
 {
 	// ObjectList*	defenders = creatureObject->getDefenders();
 
+	creatureObject->invalidateBaseline(BaselineCache_CREO_6);
+
 	mMessageFactory->StartMessage();
 	mMessageFactory->addUint32(opDeltasMessage);
 	mMessageFactory->addUint64(creatureObject->getId());
@@ -701,7 +715,7 @@ void MessageLib::sendDefenderUpdate(CreatureObject* creatureObject,uint8 updateT
 
 void MessageLib::sendNewDefenderList(CreatureObject* creatureObject)
 {
-	ObjectIDList* defenders = creatureObject->getDefenders();
+	const ObjectIDList* defenders = creatureObject->getDefenders();
 	uint32 byteCount = 15;
 
 	if (defenders->empty())
@@ -710,6 +724,8 @@ void MessageLib::sendNewDefenderList(CreatureObject* creatureObject)
 		byteCount = 13;
 	}
 
+	creatureObject->invalidateBaseline(BaselineCache_CREO_6);
+
 	mMessageFactory->StartMessage();
 	mMessageFactory->addUint32(opDeltasMessage);
 	mMessageFactory->addUint64(creatureObject->getId());
@@ -720,7 +736,7 @@ void MessageLib::sendNewDefenderList(CreatureObject* creatureObject)
 	mMessageFactory->addUint16(1);
 	mMessageFactory->addUint16(1);
 
-	ObjectIDList::iterator defenderIt = defenders->begin();
+	ObjectIDList::const_iterator defenderIt = defenders->begin();
 	// Shall we not advance the updatecounter if we send a reset, where size() is 0?
 
 	// I'm pretty sure the idea of update counters is to let the client know that somethings have changed,
@@ -790,6 +806,8 @@ bool MessageLib::sendEquippedListUpdate_InRange(CreatureObject* creatureObject)
 		++eqIt;
 	}
 
+	creatureObject->invalidateBaseline(BaselineCache_CREO_6);
+
 	mMessageFactory->StartMessage();
 	mMessageFactory->addUint32(opDeltasMessage);
 	mMessageFactory->addUint64(creatureObject->getId());
@@ -896,6 +914,8 @@ bool MessageLib::sendEquippedItemUpdate_InRange(CreatureObject* creatureObject,
 		return false;
 	}
 
+	creatureObject->invalidateBaseline(BaselineCache_CREO_6);
+
 	mMessageFactory->StartMessage();
 	mMessageFactory->addUint32(opDeltasMessage);
 	mMessageFactory->addUint64(creatureObject->getId());
@@ -996,6 +1016,8 @@ bool MessageLib::sendUpdatePvpStatus(CreatureObject* creatureObject,PlayerObject
 
 void MessageLib::sendMoodUpdate(CreatureObject* srcObject)
 {
+	srcObject->invalidateBaseline(BaselineCache_CREO_6);
+
 	mMessageFactory->StartMessage();
 	mMessageFactory->addUint32(opDeltasMessage);
 	mMessageFactory->addUint64(srcObject->getId());
@@ -1018,6 +1040,8 @@ void MessageLib::sendMoodUpdate(CreatureObject* srcObject)
 
 void MessageLib::sendPostureUpdate(CreatureObject* creatureObject)
 {
+	creatureObject->invalidateBaseline(BaselineCache_CREO_3);
+
 	mMessageFactory->StartMessage();
 	mMessageFactory->addUint32(opDeltasMessage);
 	mMessageFactory->addUint64(creatureObject->getId());
@@ -1042,6 +1066,8 @@ void MessageLib::sendPostureAndStateUpdate(CreatureObject* creatureObject)
 	// Test code for npc combat with objects that can have no states, like debris.
 	if (creatureObject->getCreoGroup() != CreoGroup_AttackableObject)
 	{
+		creatureObject->invalidateBaseline(BaselineCache_CREO_3);
+
 		mMessageFactory->StartMessage();
 		mMessageFactory->addUint32(opDeltasMessage);
 		mMessageFactory->addUint64(creatureObject->getId());
@@ -1069,6 +1095,8 @@ void MessageLib::sendStateUpdate(CreatureObject* creatureObject)
 	// Test code for npc combat with objects that can have no states, like debris.
 	if (creatureObject->getCreoGroup() != CreoGroup_AttackableObject)
 	{
+		creatureObject->invalidateBaseline(BaselineCache_CREO_3);
+
 		mMessageFactory->StartMessage();
 		mMessageFactory->addUint32(opDeltasMessage);
 		mMessageFactory->addUint64(creatureObject->getId());
@@ -1101,6 +1129,8 @@ void MessageLib::sendSingleBarUpdate(CreatureObject* creatureObject)
 			return;
 		}
 
+		creatureObject->invalidateBaseline(BaselineCache_CREO_3);
+
 		mMessageFactory->StartMessage();
 		mMessageFactory->addUint32(opDeltasMessage);
 		mMessageFactory->addUint64(creatureObject->getId());
@@ -1325,6 +1355,8 @@ void MessageLib::sendCurrentHitpointDeltasCreo6_Single(CreatureObject* creatureO
 	if(ham == NULL)
 		return;
 
+	creatureObject->invalidateBaseline(BaselineCache_CREO_6);
+
 	mMessageFactory->StartMessage();
 	mMessageFactory->addUint32(opDeltasMessage);
 	mMessageFactory->addUint64(creatureObject->getId());
@@ -1360,6 +1392,8 @@ void MessageLib::sendMaxHitpointDeltasCreo6_Single(CreatureObject* creatureObjec
 	if(ham == NULL)
 		return;
 
+	creatureObject->invalidateBaseline(BaselineCache_CREO_6);
+
 	mMessageFactory->StartMessage();
 	mMessageFactory->addUint32(opDeltasMessage);
 	mMessageFactory->addUint64(creatureObject->getId());
@@ -1430,6 +1464,8 @@ void MessageLib::sendWoundUpdateCreo3(CreatureObject* creatureObject,uint8 barIn
 	if(ham == NULL)
 		return;
 
+	creatureObject->invalidateBaseline(BaselineCache_CREO_3);
+
 	mMessageFactory->StartMessage();
 	mMessageFactory->addUint32(opDeltasMessage);
 	mMessageFactory->addUint64(creatureObject->getId());
@@ -1464,6 +1500,8 @@ void MessageLib::sendCurrentHitpointDeltasCreo6_Full(CreatureObject* creatureObj
 	if(ham == NULL)
 		return;
 
+	creatureObject->invalidateBaseline(BaselineCache_CREO_6);
+
 	mMessageFactory->StartMessage();
 	mMessageFactory->addUint32(opDeltasMessage);
 	mMessageFactory->addUint64(creatureObject->getId());
@@ -1509,6 +1547,8 @@ void MessageLib::sendBFUpdateCreo3(CreatureObject* playerObject)
 	if(!ham || !pObject || !(pObject->isConnected()))
 		return;
 
+	playerObject->invalidateBaseline(BaselineCache_CREO_3);
+
 	mMessageFactory->StartMessage();
 	mMessageFactory->addUint32(opDeltasMessage);
 	mMessageFactory->addUint64(playerObject->getId());
@@ -1533,6 +1573,8 @@ void MessageLib::sendBFUpdateCreo3(CreatureObject* playerObject)
 
 void MessageLib::sendOwnerUpdateCreo3(MountObject* mount)
 {
+	mount->invalidateBaseline(BaselineCache_CREO_3);
+
 	mMessageFactory->StartMessage();
 	mMessageFactory->addUint32(opDeltasMessage);
 	mMessageFactory->addUint64(mount->getId());
@@ -1557,6 +1599,8 @@ void MessageLib::sendOwnerUpdateCreo3(MountObject* mount)
 
 void MessageLib::sendTargetUpdateDeltasCreo6(CreatureObject* creatureObject)
 {
+	creatureObject->invalidateBaseline(BaselineCache_CREO_6);
+
 	mMessageFactory->StartMessage();
 	mMessageFactory->addUint32(opDeltasMessage);
 	mMessageFactory->addUint64(creatureObject->getId());
@@ -1581,6 +1625,8 @@ void MessageLib::sendInviteSenderUpdateDeltasCreo6(uint64 id, PlayerObject* targ
 	if(!(targetPlayer->isConnected()))
 		return;
 
+	targetPlayer->invalidateBaseline(BaselineCache_CREO_6);
+
 	mMessageFactory->StartMessage();
 	mMessageFactory->addUint32(opDeltasMessage);
 	mMessageFactory->addUint64(targetPlayer->getId());
@@ -1607,6 +1653,8 @@ void MessageLib::sendGroupIdUpdateDeltasCreo6(uint64 groupId, const PlayerObject
 	if(!(target->isConnected()))
 		return;
 
+	player->invalidateBaseline(BaselineCache_CREO_6);
+
 	mMessageFactory->StartMessage();
 	mMessageFactory->addUint32(opDeltasMessage);
 	mMessageFactory->addUint64(player->getId());
@@ -1672,6 +1720,8 @@ void MessageLib::sendListenToId(PlayerObject* playerObject)
 
 void MessageLib::UpdateEntertainerPerfomanceCounter(CreatureObject* creatureObject)
 {
+	creatureObject->invalidateBaseline(BaselineCache_CREO_6);
+
 	mMessageFactory->StartMessage();
 	mMessageFactory->addUint32(opDeltasMessage);
 	mMessageFactory->addUint64(creatureObject->getId());
@@ -1693,6 +1743,8 @@ void MessageLib::UpdateEntertainerPerfomanceCounter(CreatureObject* creatureObje
 
 void MessageLib::sendPerformanceId(CreatureObject* creatureObject)
 {
+	creatureObject->invalidateBaseline(BaselineCache_CREO_6);
+
 	mMessageFactory->StartMessage();
 	mMessageFactory->addUint32(opDeltasMessage);
 	mMessageFactory->addUint64(creatureObject->getId());
@@ -1714,6 +1766,8 @@ void MessageLib::sendPerformanceId(CreatureObject* creatureObject)
 
 void MessageLib::sendAnimationString(CreatureObject* creatureObject)
 {
+	creatureObject->invalidateBaseline(BaselineCache_CREO_6);
+
 	mMessageFactory->StartMessage();
 	mMessageFactory->addUint32(opDeltasMessage);
 	mMessageFactory->addUint64(creatureObject->getId());
@@ -1735,6 +1789,8 @@ void MessageLib::sendAnimationString(CreatureObject* creatureObject)
 
 void MessageLib::sendMoodString(CreatureObject* creatureObject,string animation)
 {
+	creatureObject->invalidateBaseline(BaselineCache_CREO_6);
+
 	mMessageFactory->StartMessage();
 	mMessageFactory->addUint32(opDeltasMessage);
 	mMessageFactory->addUint64(creatureObject->getId());
@@ -1754,6 +1810,8 @@ void MessageLib::sendMoodString(CreatureObject* creatureObject,string animation)
 
 void MessageLib::sendCustomizationUpdateCreo3(CreatureObject* creatureObject)
 {
+	creatureObject->invalidateBaseline(BaselineCache_CREO_3);
+
 	mMessageFactory->StartMessage();
 	mMessageFactory->addUint32(opDeltasMessage);
 	mMessageFactory->addUint64(creatureObject->getId());
@@ -1776,6 +1834,8 @@ void MessageLib::sendCustomizationUpdateCreo3(CreatureObject* creatureObject)
 
 void MessageLib::sendScaleUpdateCreo3(CreatureObject* creatureObject)
 {
+	creatureObject->invalidateBaseline(BaselineCache_CREO_3);
+
 	mMessageFactory->StartMessage();
 	mMessageFactory->addUint32(opDeltasMessage);
 	mMessageFactory->addUint64(creatureObject->getId());
@@ -1798,6 +1858,8 @@ void MessageLib::sendScaleUpdateCreo3(CreatureObject* creatureObject)
 
 void MessageLib::sendWeaponIdUpdate(CreatureObject* creatureObject)
 {
+	creatureObject->invalidateBaseline(BaselineCache_CREO_6);
+
 	mMessageFactory->StartMessage();
 	mMessageFactory->addUint32(opDeltasMessage);
 	mMessageFactory->addUint64(creatureObject->getId());
@@ -1827,6 +1889,8 @@ void MessageLib::sendWeaponIdUpdate(CreatureObject* creatureObject)
 
 void MessageLib::sendIncapTimerUpdate(CreatureObject* creatureObject)
 {
+	creatureObject->invalidateBaseline(BaselineCache_CREO_3);
+
 	mMessageFactory->StartMessage();
 	mMessageFactory->addUint32(opDeltasMessage);
 	mMessageFactory->addUint64(creatureObject->getId());
@@ -1918,6 +1982,8 @@ void MessageLib::sendStationaryFlagUpdate(PlayerObject* playerObject)
 {
 	mMessageFactory->StartMessage();
 	
+	playerObject->invalidateBaseline(BaselineCache_CREO_6);
+
 	mMessageFactory->addUint32(opDeltasMessage);
 	mMessageFactory->addUint64(playerObject->getId());
 	mMessageFactory->addUint32(opCREO);
@@ -132,16 +132,18 @@ bool MessageLib::sendBaselinesMSCO_3(ManufacturingSchematic* manSchem,PlayerObje
 			//=============================0
 			// see whether the attribute has any component values which need adding in the preview
 
-			if(manSchem->hasPPAttribute(gWorldManager->getAttributeKey((*it).first)))
+			float attributeValue = 0.0f;
+			(*it).second.get(&attributeValue);
+
+			if(manSchem->hasPPAttribute((*it).first))
 			{
-				float attributeValue = boost::lexical_cast<float,std::string>((*it).second);
-				float attributeAddValue = manSchem->getPPAttribute<float>(gWorldManager->getAttributeKey((*it).first));
+				float attributeAddValue = manSchem->getPPAttribute<float>((*it).first);
 				gLogger->log(LogManager::DEBUG,"MessageLib::sendBaselinesMSCO_3 Attribute Add Value");
 				gLogger->log(LogManager::DEBUG,"MessageLib::sendBaselinesMSCO_3 we will add %f to %s",attributeAddValue,gWorldManager->getAttributeKey((*it).first).getAnsi());
 				mMessageFactory->addFloat(attributeValue+attributeAddValue);
 			}
 			else
-				mMessageFactory->addFloat(boost::lexical_cast<float,std::string>((*it).second));
+				mMessageFactory->addFloat(attributeValue);
 
 			++it;
 		}
@@ -1158,14 +1160,16 @@ bool MessageLib::sendDeltasMSCO_3(ManufacturingSchematic* manSchem,PlayerObject*
 
 		mMessageFactory->addString(gWorldManager->getAttributeKey((*it).first));
 
-		if(manSchem->hasPPAttribute(gWorldManager->getAttributeKey((*it).first)))
+		float attributeValue = 0.0f;
+		(*it).second.get(&attributeValue);
+
+		if(manSchem->hasPPAttribute((*it).first))
 		{
-			float attributeValue = boost::lexical_cast<float,std::string>((*it).second);
-			float attributeAddValue = manSchem->getPPAttribute<float>(gWorldManager->getAttributeKey((*it).first));
+			float attributeAddValue = manSchem->getPPAttribute<float>((*it).first);
 			mMessageFactory->addFloat(attributeValue+attributeAddValue);
 		}
 		else
-			mMessageFactory->addFloat(boost::lexical_cast<float,std::string>((*it).second));
+			mMessageFactory->addFloat(attributeValue);
 
 		//mMessageFactory->addFloat(boost::lexical_cast<float,std::string>((*it).second));
 
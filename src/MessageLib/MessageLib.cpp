@@ -26,6 +26,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 */
 
 #include "MessageLib.h"
+#include "BaselineCache.h"
 
 #include "ZoneServer/BuildingObject.h"
 #include "ZoneServer/CellObject.h"
@@ -55,6 +56,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "ZoneServer/WorldManager.h"
 #include "ZoneServer/ZoneOpcodes.h"
 
+#include "ConfigManager/ConfigManager.h"
 #include "LogManager/LogManager.h"
 
 #include "Common/atMacroString.h"
@@ -76,6 +78,7 @@ MessageLib*	MessageLib::mSingleton  = NULL;
 MessageLib::MessageLib()
 {
 	mMessageFactory = gMessageFactory;
+	mBaselineCache	= new BaselineCache(mMessageFactory,gConfig->read<uint32>("BaselineCacheSize",8192),gConfig->read<uint32>("BaselineCacheBytes",4194304));
 }
 
 //======================================================================================================================
@@ -101,6 +104,20 @@ MessageLib::~MessageLib()
 	delete(mSingleton);
 }
 
+//======================================================================================================================
+
+Message* MessageLib::_getCachedBaseline(const Object* const object,BaselineCacheSlot slot) const
+{
+	return(mBaselineCache->getBaseline(object->getId(),static_cast<uint8>(slot),object->getBaselineVersion(slot)));
+}
+
+//======================================================================================================================
+
+Message* MessageLib::_cacheBaseline(const Object* const object,BaselineCacheSlot slot,Message* baseline) const
+{
+	return(mBaselineCache->storeBaseline(object->getId(),static_cast<uint8>(slot),object->getBaselineVersion(slot),baseline));
+}
+
 //======================================================================================================================
 //
 // Checks the validity of the player in the global map
@@ -192,11 +209,8 @@ void MessageLib::_sendToInRangeUnreliable(Message* message, Object* const object
  		{
 			if(_checkPlayer((*playerIt)))
 			{
- 				// clone our message
- 				mMessageFactory->StartMessage();
- 				mMessageFactory->addData(message->getData(),message->getSize());
- 
- 				((*playerIt)->getClient())->SendChannelAUnreliable(mMessageFactory->EndMessage(),(*playerIt)->getAccountId(),CR_Client,static_cast<uint8>(priority));		
+ 				// share our message, the payload stays in one place
+ 				((*playerIt)->getClient())->SendChannelAUnreliable(mMessageFactory->ShareMessage(message),(*playerIt)->getAccountId(),CR_Client,static_cast<uint8>(priority));		
  			}
 			else
 			{
@@ -220,11 +234,8 @@ void MessageLib::_sendToInRangeUnreliable(Message* message, Object* const object
 				bool yn = _checkDistance((*playerIt)->mPosition,object,mMessageFactory->HeapWarningLevel());
 				if(yn)
 				{
-					// clone our message
-					mMessageFactory->StartMessage();
-					mMessageFactory->addData(message->getData(),message->getSize());
-	
-					((*playerIt)->getClient())->SendChannelAUnreliable(mMessageFactory->EndMessage(),(*playerIt)->getAccountId(),CR_Client,static_cast<uint8>(priority));
+					// share our message, the payload stays in one place
+					((*playerIt)->getClient())->SendChannelAUnreliable(mMessageFactory->ShareMessage(message),(*playerIt)->getAccountId(),CR_Client,static_cast<uint8>(priority));
 				}
 				else
 				{
@@ -261,11 +272,8 @@ void MessageLib::_sendToInRange(Message* message, Object* const object,uint16 pr
 	{
 		if(_checkPlayer((*playerIt)))
 		{
-			// clone our message
-			mMessageFactory->StartMessage();
-			mMessageFactory->addData(message->getData(),message->getSize());
-
-			((*playerIt)->getClient())->SendChannelA(mMessageFactory->EndMessage(),(*playerIt)->getAccountId(),CR_Client,static_cast<uint8>(priority));
+			// share our message, the payload stays in one place
+			((*playerIt)->getClient())->SendChannelA(mMessageFactory->ShareMessage(message),(*playerIt)->getAccountId(),CR_Client,static_cast<uint8>(priority));
 		}
 
 		++playerIt;
@@ -358,29 +366,32 @@ void MessageLib::_sendToAll(Message* message,uint16 priority,bool unreliable) co
 	const PlayerAccMap* const		players		= gWorldManager->getPlayerAccMap();
 	PlayerAccMap::const_iterator	playerIt	= players->begin();
 
+	AccountIdList	recipients;
+	DispatchClient*	route = NULL;
+
+	recipients.reserve(players->size());
+
 	while(playerIt != players->end())
 	{
 		const PlayerObject* const player = (*playerIt).second;
 
 		if(_checkPlayer(player))
 		{
-			mMessageFactory->StartMessage();
-			mMessageFactory->addData(message->getData(),message->getSize());
-
-			if(unreliable)
-			{
-				(player->getClient())->SendChannelAUnreliable(mMessageFactory->EndMessage(),player->getAccountId(),CR_Client,static_cast<uint8>(priority));
-			}
-			else
-			{
-				(player->getClient())->SendChannelA(mMessageFactory->EndMessage(),player->getAccountId(),CR_Client,static_cast<uint8>(priority));
-			}
+			recipients.push_back(player->getAccountId());
+			route = player->getClient();
 		}
 
 		++playerIt;
 	}
 
-	mMessageFactory->DestroyMessage(message);
+	if(!route)
+	{
+		mMessageFactory->DestroyMessage(message);
+		return;
+	}
+
+	// one message across to the connection server, it fans out to the clients
+	route->SendChannelAMulticast(message,recipients,static_cast<uint8>(priority),unreliable);
 }
 
 //======================================================================================================================
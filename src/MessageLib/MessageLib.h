@@ -32,6 +32,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 //#include "Utils/typedefs.h"
 //#include "ZoneServer/ObjectFactory.h"
 #include "ZoneServer/ObjectController.h"
+#include "ZoneServer/Object_Enums.h"
 #include "ZoneServer/Skill.h"   //for skillmodslist
 
 #include "Common/bytebuffer.h"
@@ -41,6 +42,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #define	 gMessageLib	MessageLib::getSingletonPtr()
 
+class BaselineCache;
 class MessageFactory;
 class Item;
 class IntangibleObject;
@@ -521,6 +523,10 @@ private:
 	bool				_checkPlayer(const PlayerObject* const player) const;
 	bool				_checkPlayer(uint64 playerId) const;
 
+	// baselines that are the same for every observer, see BaselineCache
+	Message*			_getCachedBaseline(const Object* const object,BaselineCacheSlot slot) const;
+	Message*			_cacheBaseline(const Object* const object,BaselineCacheSlot slot,Message* baseline) const;
+
 	void				_sendToInRangeUnreliable(Message* message, Object* const object,uint16 priority,bool toSelf = true);
 	void				_sendToInRange(Message* message, Object* const object,uint16 priority,bool toSelf = true);
 
@@ -532,6 +538,7 @@ private:
 	static bool			mInsFlag;
 
 	MessageFactory*		mMessageFactory;
+	BaselineCache*		mBaselineCache;
 };
 
 //======================================================================================================================
@@ -1434,10 +1434,10 @@ bool MessageLib::sendCharacterMatchResults(const PlayerList* const matchedPlayer
 		mMessageFactory->addUint32(player->getRaceId());
 
 		// only cities for now
-		ObjectSet				regions;
+		ObjectVector			regions;
 		gWorldManager->getSI()->getObjectsInRange(player,&regions,ObjType_Region,1);
 
-		ObjectSet::iterator	objIt = regions.begin();
+		ObjectVector::iterator	objIt = regions.begin();
 		string				regionName;
 
 		while(objIt != regions.end())
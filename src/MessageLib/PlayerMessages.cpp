@@ -66,6 +66,12 @@ bool MessageLib::sendBaselinesPLAY_3(PlayerObject* playerObject,PlayerObject* ta
 	if(!(targetObject->isConnected()))
 		return(false);
 
+	if(Message* cached = _getCachedBaseline(playerObject,BaselineCache_PLAY_3))
+	{
+		(targetObject->getClient())->SendChannelA(cached, targetObject->getAccountId(), CR_Client, 5);
+		return(true);
+	}
+
 	mMessageFactory->StartMessage(); 
 	mMessageFactory->addUint32(opBaselinesMessage);  
 	mMessageFactory->addUint64(playerObject->getPlayerObjId()); 
@@ -105,7 +111,7 @@ bool MessageLib::sendBaselinesPLAY_3(PlayerObject* playerObject,PlayerObject* ta
 	mMessageFactory->addUint32(0x000018d8); // Total Playtime in seconds
 	mMessageFactory->addUint32(0);
 
-	(targetObject->getClient())->SendChannelA(mMessageFactory->EndMessage(), targetObject->getAccountId(), CR_Client, 5);
+	(targetObject->getClient())->SendChannelA(_cacheBaseline(playerObject,BaselineCache_PLAY_3,mMessageFactory->EndMessage()), targetObject->getAccountId(), CR_Client, 5);
 
 	return(true);
 }
@@ -442,6 +448,8 @@ void MessageLib::sendDrinkUpdate(PlayerObject* playerObject)
 
 void MessageLib::sendTitleUpdate(PlayerObject* playerObject)
 {
+	playerObject->invalidateBaseline(BaselineCache_PLAY_3);
+
 	mMessageFactory->StartMessage();               
 	mMessageFactory->addUint32(opDeltasMessage);  
 	mMessageFactory->addUint64(playerObject->getPlayerObjId());          
@@ -464,6 +472,8 @@ void MessageLib::sendTitleUpdate(PlayerObject* playerObject)
 
 void MessageLib::sendUpdatePlayerFlags(PlayerObject* playerObject)
 {
+	playerObject->invalidateBaseline(BaselineCache_PLAY_3);
+
 	mMessageFactory->StartMessage();               
 	mMessageFactory->addUint32(opDeltasMessage);  
 	mMessageFactory->addUint64(playerObject->getPlayerObjId());          
@@ -937,6 +947,8 @@ bool MessageLib::sendMatchPlay3(PlayerObject* playerObject)
 	if(!(playerObject->isConnected()))
 		return(false);
 
+	playerObject->invalidateBaseline(BaselineCache_PLAY_3);
+
 	mMessageFactory->StartMessage();               
 	mMessageFactory->addUint32(opDeltasMessage);  
 	mMessageFactory->addUint64(playerObject->getPlayerObjId());          
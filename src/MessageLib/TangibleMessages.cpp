@@ -54,6 +54,12 @@ bool MessageLib::sendBaselinesTANO_3(const TangibleObject* const tangibleObject,
 	if(!(targetObject->isConnected()))
 		return(false);
 
+	if(Message* cached = _getCachedBaseline(tangibleObject,BaselineCache_TANO_3))
+	{
+		(targetObject->getClient())->SendChannelA(cached, targetObject->getAccountId(), CR_Client, 5);
+		return(true);
+	}
+
 	Message* message;
 	string customName = tangibleObject->getCustomName().getAnsi();
 	customName.convert(BSTRType_Unicode16);
@@ -100,7 +106,7 @@ bool MessageLib::sendBaselinesTANO_3(const TangibleObject* const tangibleObject,
 	mMessageFactory->addUint8(tangibleObject->getStatic());	// !!!!
 	
 
-	message = mMessageFactory->EndMessage();
+	message = _cacheBaseline(tangibleObject,BaselineCache_TANO_3,mMessageFactory->EndMessage());
 
 	(targetObject->getClient())->SendChannelA(message, targetObject->getAccountId(), CR_Client, 5);
 
@@ -118,6 +124,12 @@ bool MessageLib::sendBaselinesTANO_6(const TangibleObject* const tangibleObject,
 	if(!(targetObject->isConnected()))
 		return(false);
 
+	if(Message* cached = _getCachedBaseline(tangibleObject,BaselineCache_TANO_6))
+	{
+		(targetObject->getClient())->SendChannelA(cached, targetObject->getAccountId(), CR_Client, 5);
+		return(true);
+	}
+
 	Message* message;
 
 	mMessageFactory->StartMessage();  
@@ -134,7 +146,7 @@ bool MessageLib::sendBaselinesTANO_6(const TangibleObject* const tangibleObject,
 	mMessageFactory->addString(tangibleObject->getUnknownStr2());
 	mMessageFactory->addUint8(0);	// unknown
 
-	message = mMessageFactory->EndMessage();
+	message = _cacheBaseline(tangibleObject,BaselineCache_TANO_6,mMessageFactory->EndMessage());
 
 	(targetObject->getClient())->SendChannelA(message, targetObject->getAccountId(), CR_Client, 5);
 
@@ -210,6 +222,8 @@ bool MessageLib::sendUpdateComplexity(TangibleObject* tangibleObject,PlayerObjec
 	if(!(playerObject->isConnected()))
 		return(false);
 
+	tangibleObject->invalidateBaseline(BaselineCache_TANO_3);
+
 	mMessageFactory->StartMessage();  
 	mMessageFactory->addUint32(opDeltasMessage);
 	mMessageFactory->addUint64(tangibleObject->getId());
@@ -237,6 +251,8 @@ bool  MessageLib::sendUpdateCustomization_InRange(TangibleObject* tangibleObject
 		if(!(playerObject->isConnected()))
 		return(false);
 
+	tangibleObject->invalidateBaseline(BaselineCache_TANO_3);
+
 	mMessageFactory->StartMessage();  
 	mMessageFactory->addUint32(opDeltasMessage);
 	mMessageFactory->addUint64(tangibleObject->getId());
@@ -269,6 +285,8 @@ bool MessageLib::sendUpdateTypeOption(TangibleObject* tangibleObject,PlayerObjec
 	if(!(playerObject->isConnected()))
 		return(false);
 
+	tangibleObject->invalidateBaseline(BaselineCache_TANO_3);
+
 	mMessageFactory->StartMessage();  
 	mMessageFactory->addUint32(opDeltasMessage);
 	mMessageFactory->addUint64(tangibleObject->getId());
@@ -299,6 +317,8 @@ bool MessageLib::sendUpdateTimer(TangibleObject* tangibleObject,PlayerObject* pl
 
 	Message* newMessage;
 
+	tangibleObject->invalidateBaseline(BaselineCache_TANO_3);
+
 	mMessageFactory->StartMessage();  
 	mMessageFactory->addUint32(opDeltasMessage);
 	mMessageFactory->addUint64(tangibleObject->getId());
@@ -337,6 +357,8 @@ bool MessageLib::sendUpdateUses(TangibleObject* tangibleObject,PlayerObject* pla
 		   
 	Message* newMessage;
 
+	tangibleObject->invalidateBaseline(BaselineCache_TANO_3);
+
 	mMessageFactory->StartMessage();  
 	mMessageFactory->addUint32(opDeltasMessage);
 	mMessageFactory->addUint64(tangibleObject->getId());
@@ -28,52 +28,103 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "CompCryptor.h"
 #include <zlib.h>
 
+#include <cstring>
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/thread/once.hpp>
+
 
 //======================================================================================================================
-CompCryptor::CompCryptor(void)
+CompCryptor::CompCryptor(int compressionLevel, uint32 compressMinSize)
+: mDeflateReady(false)
+, mInflateReady(false)
+, mCompressMinSize(compressMinSize)
 {
-	mStreamData = new z_stream;
+  resetStatistics();
+
+  // cryptors get created from several threads, the first one builds the slice tables
+  boost::call_once(_initCrcSliceTable, mCrcSliceTableOnce);
+
+  mDeflateStream = new z_stream;
+  mDeflateStream->zalloc = Z_NULL;
+  mDeflateStream->zfree = Z_NULL;
+  mDeflateStream->opaque = Z_NULL;
+  mDeflateStream->avail_in = 0;
+  mDeflateStream->next_in = Z_NULL;
+  mDeflateReady = (deflateInit(mDeflateStream, compressionLevel) == Z_OK);
+
+  mInflateStream = new z_stream;
+  mInflateStream->zalloc = Z_NULL;
+  mInflateStream->zfree = Z_NULL;
+  mInflateStream->opaque = Z_NULL;
+  mInflateStream->avail_in = 0;
+  mInflateStream->next_in = Z_NULL;
+  mInflateReady = (inflateInit(mInflateStream) == Z_OK);
 }
 
 
 //======================================================================================================================
 CompCryptor::~CompCryptor(void)
 {
-	delete mStreamData;
+  if (mDeflateReady)
+    deflateEnd(mDeflateStream);
+
+  if (mInflateReady)
+    inflateEnd(mInflateStream);
+
+  delete mDeflateStream;
+  delete mInflateStream;
+}
+
+
+//======================================================================================================================
+void CompCryptor::resetStatistics(void)
+{
+  mCompressCalls = 0;
+  mCompressSkipped = 0;
+  mCompressBytesIn = 0;
+  mCompressBytesOut = 0;
+  mCompressTime = 0;
 }
 
 //======================================================================================================================
 int CompCryptor::Compress(int8* inData, uint32 inLen, int8* outData, uint32 outLen)
 {
-  // Init our stream
-  mStreamData->zalloc = Z_NULL;
-  mStreamData->zfree = Z_NULL;
-  mStreamData->opaque = Z_NULL;
-  mStreamData->avail_in = 0;
-  mStreamData->next_in = Z_NULL;
-  deflateInit(mStreamData, Z_DEFAULT_COMPRESSION);
+  // Small acks and deltas hardly ever shrink, send them as they are.
+  if (inLen < mCompressMinSize || !mDeflateReady)
+  {
+    mCompressSkipped++;
+    return 0;
+  }
+
+  boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+
+  // Reuse our stream, this keeps the allocated state around.
+  deflateReset(mDeflateStream);
 
   // Setup our struct
-  mStreamData->next_in = (Bytef*)inData;
-  mStreamData->avail_in = inLen;
-  mStreamData->next_out = (Bytef*)outData;
-  mStreamData->avail_out = outLen;
+  mDeflateStream->next_in = (Bytef*)inData;
+  mDeflateStream->avail_in = inLen;
+  mDeflateStream->next_out = (Bytef*)outData;
+  mDeflateStream->avail_out = outLen;
 
   // compress our data and get it's final size.
-  deflate(mStreamData, Z_FINISH);
-  uint32 outBytes = mStreamData->total_out;
-  if (outBytes)
-  {
-    // We only call this on a successful decompression.
-    deflateEnd(mStreamData);
-  }
+  int result = deflate(mDeflateStream, Z_FINISH);
+  uint32 outBytes = mDeflateStream->total_out;
 
-  // May as well not compress it if it's going to be bigger.
-  if (outBytes > inLen)
+  mCompressTime += (boost::posix_time::microsec_clock::universal_time() - start).total_microseconds();
+  mCompressCalls++;
+  mCompressBytesIn += inLen;
+
+  // May as well not compress it if it's going to be bigger, or if it didn't fit in the first place.
+  if (result != Z_STREAM_END || outBytes > inLen)
   {
+    mCompressBytesOut += inLen;
     return 0;
   }
 
+  mCompressBytesOut += outBytes;
+
   return outBytes;
 }
 
@@ -82,90 +133,121 @@ int CompCryptor::Compress(int8* inData, uint32 inLen, int8* outData, uint32 outL
 int CompCryptor::Decompress(int8* inData, uint32 inLen, int8* outData, uint32 outLen)
 {
   // If it's not compressed, don't decompress it.
-  if (inData[0] != 'x')
+  if (inData[0] != 'x' || !mInflateReady)
     return 0;
 
-  // Init our stream
-  mStreamData->zalloc = Z_NULL;
-  mStreamData->zfree = Z_NULL;
-  mStreamData->opaque = Z_NULL;
-  mStreamData->avail_in = 0;
-  mStreamData->next_in = Z_NULL;
-  inflateInit(mStreamData);
+  // Reuse our stream, this keeps the allocated state around.
+  inflateReset(mInflateStream);
 
   // Setup our struct
-  mStreamData->next_in = (Bytef*)inData;
-  mStreamData->avail_in = inLen;
-  mStreamData->next_out = (Bytef*)outData;
-  mStreamData->avail_out = outLen;
+  mInflateStream->next_in = (Bytef*)inData;
+  mInflateStream->avail_in = inLen;
+  mInflateStream->next_out = (Bytef*)outData;
+  mInflateStream->avail_out = outLen;
 
   // compress our data and get it's final size.
-  inflate(mStreamData, Z_FINISH);
-  uint32 outBytes = mStreamData->total_out;
-  if (outBytes)
-  {
-    // We only call this on a successful decompression.
-    inflateEnd(mStreamData);
-  }
+  inflate(mInflateStream, Z_FINISH);
 
-  return outBytes;
+  return mInflateStream->total_out;
 }
 
 
 //======================================================================================================================
+//
+// The cipher chains 4 byte blocks, every block is xor'ed with the previous ciphertext block and the bytes
+// behind the last full block are xor'ed with the low byte of the last ciphertext block.
+// Blocks are moved with memcpy, so unaligned packet data is fine and the compiler keeps the chain in a register.
+//
+
 int CompCryptor::Encrypt(int8* data, uint32 len, uint32 seed)
 {
-  //seed = seed ^ 0x62491908;
-
-  int retVal = 0;
-
-  //uint32 tempSeed = 0;
   uint32 blockCount = (len / 4);
-  uint32 byteCount = (len % 4);
+  uint32 block;
 
   for(uint32 count = 0; count < blockCount; count++)
   {
-    ((uint32*)data)[count] ^= seed;
-    seed = ((uint32*)data)[count];
+    memcpy(&block, data + count * 4, 4);
+    seed ^= block;
+    memcpy(data + count * 4, &seed, 4);
   }
 
-  for(uint32 count = blockCount * 4; count < blockCount * 4 + byteCount; count++)
+  for(uint32 count = blockCount * 4; count < len; count++)
   {
     data[count] ^= seed;
   }
 
-  return retVal;
+  return 0;
 }
 
 
 //======================================================================================================================
+//
+// Other than encryption, decryption has no chain: plaintext block n is ciphertext n ^ ciphertext n-1.
+// As the xor is bytewise, we can walk the blocks backwards 8 bytes at a time against the data 4 bytes
+// before them, every source byte is read before it gets overwritten.
+//
+
 int CompCryptor::Decrypt(int8* data, uint32 len, uint32 seed)
 {
-  //seed = seed ^ 0x62491908;
+  uint32 blockCount = (len / 4);
 
-  int retVal = 0;
+  if(!blockCount)
+  {
+    for(uint32 count = 0; count < len; count++)
+    {
+      data[count] ^= seed;
+    }
 
-  uint32 tempSeed = 0;
-  uint32 blockCount = (len / 4);
-  uint32 byteCount = (len % 4);
+    return 0;
+  }
 
-  for(uint32 count = 0; count < blockCount; count++)
+  // the trailing bytes use the last ciphertext block
+  uint32 lastBlock;
+  memcpy(&lastBlock, data + (blockCount - 1) * 4, 4);
+
+  for(uint32 count = blockCount * 4; count < len; count++)
   {
-    tempSeed = ((uint32*)data)[count];
-    ((uint32*)data)[count] ^= seed;
-    seed = tempSeed;
+    data[count] ^= lastBlock;
   }
 
-  for(uint32 count = blockCount * 4; count < blockCount * 4 + byteCount; count++)
- {
-    data[count] ^= seed;
+  // blocks 1 .. blockCount - 1, two at a time
+  uint32 end = blockCount * 4;
+  uint64 cur, prev;
+
+  while(end >= 12)
+  {
+    memcpy(&cur, data + end - 8, 8);
+    memcpy(&prev, data + end - 12, 8);
+    cur ^= prev;
+    memcpy(data + end - 8, &cur, 8);
+    end -= 8;
   }
 
-  return retVal;
+  uint32 block, prevBlock;
+
+  if(end == 8)
+  {
+    memcpy(&block, data + 4, 4);
+    memcpy(&prevBlock, data, 4);
+    block ^= prevBlock;
+    memcpy(data + 4, &block, 4);
+  }
+
+  // block 0 against the seed
+  memcpy(&block, data, 4);
+  block ^= seed;
+  memcpy(data, &block, 4);
+
+  return 0;
 }
 
 
 //======================================================================================================================
+//
+// Standard reflected crc32, the seed bytes are run through it before the data.
+// The data is processed 8 bytes per round with the slice tables.
+//
+
 uint32 CompCryptor::GenerateCRC(int8* data, uint32 len, uint32 seed)
 {
   uint32 newCRC = 0, index = 0;
@@ -182,17 +264,57 @@ uint32 CompCryptor::GenerateCRC(int8* data, uint32 len, uint32 seed)
   newCRC = (newCRC >> 8) &0x00FFFFFF;
   newCRC ^= mCrcTable[index & 0xFF];
 
+  const uint8* bytes = (const uint8*)data;
+
+  while(len >= 8)
+  {
+    uint32 one = newCRC ^ ((uint32)bytes[0] | ((uint32)bytes[1] << 8) | ((uint32)bytes[2] << 16) | ((uint32)bytes[3] << 24));
+    uint32 two = (uint32)bytes[4] | ((uint32)bytes[5] << 8) | ((uint32)bytes[6] << 16) | ((uint32)bytes[7] << 24);
+
+    newCRC = mCrcSliceTable[7][one & 0xFF] ^
+             mCrcSliceTable[6][(one >> 8) & 0xFF] ^
+             mCrcSliceTable[5][(one >> 16) & 0xFF] ^
+             mCrcSliceTable[4][one >> 24] ^
+             mCrcSliceTable[3][two & 0xFF] ^
+             mCrcSliceTable[2][(two >> 8) & 0xFF] ^
+             mCrcSliceTable[1][(two >> 16) & 0xFF] ^
+             mCrcSliceTable[0][two >> 24];
+
+    bytes += 8;
+    len -= 8;
+  }
+
   for(uint32 i = 0; i < len; i++ )
   {
-      index = (data[i]) ^ newCRC;
-      newCRC = (newCRC >> 8) & 0x00FFFFFF;
-      newCRC ^= mCrcTable[index & 0xFF];
+      newCRC = (newCRC >> 8) ^ mCrcTable[(bytes[i] ^ newCRC) & 0xFF];
   }
 
   return ~newCRC;
 }
 
 
+//======================================================================================================================
+uint32 CompCryptor::mCrcSliceTable[8][256];
+boost::once_flag CompCryptor::mCrcSliceTableOnce = BOOST_ONCE_INIT;
+
+void CompCryptor::_initCrcSliceTable(void)
+{
+  for(uint32 i = 0; i < 256; i++)
+  {
+    mCrcSliceTable[0][i] = mCrcTable[i];
+  }
+
+  for(uint32 slice = 1; slice < 8; slice++)
+  {
+    for(uint32 i = 0; i < 256; i++)
+    {
+      uint32 crc = mCrcSliceTable[slice - 1][i];
+      mCrcSliceTable[slice][i] = (crc >> 8) ^ mCrcTable[crc & 0xFF];
+    }
+  }
+}
+
+
 //======================================================================================================================
 const uint32 CompCryptor::mCrcTable[256] =
 {
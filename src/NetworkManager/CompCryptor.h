@@ -30,16 +30,22 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "Utils/typedefs.h"
 
+#include <boost/thread/once.hpp>
+
 
 //======================================================================================================================
 typedef struct z_stream_s z_stream;
 
 
 //======================================================================================================================
+// One CompCryptor is owned by each socket thread. The zlib streams are initialized once
+// and reset for every packet, instead of paying for deflateInit / inflateInit each time.
 class CompCryptor
 {
 public:
-                                    CompCryptor(void);
+                                    // compressionLevel is a zlib level (0-9, -1 zlib default)
+                                    // payloads smaller than compressMinSize are not compressed at all
+                                    CompCryptor(int compressionLevel = -1, uint32 compressMinSize = 0);
                                     ~CompCryptor(void);
 
   int                               Compress(int8* inData, uint32 inLen, int8* outData, uint32 outLen);
@@ -50,9 +56,33 @@ public:
 
   uint32                            GenerateCRC(int8* data, uint32 len, uint32 seed);
 
+  // compression statistics
+  uint64                            getCompressCalls(void)      { return mCompressCalls; }
+  uint64                            getCompressSkipped(void)    { return mCompressSkipped; }
+  uint64                            getCompressBytesIn(void)    { return mCompressBytesIn; }
+  uint64                            getCompressBytesOut(void)   { return mCompressBytesOut; }
+  uint64                            getCompressTime(void)       { return mCompressTime; }  // microseconds
+  void                              resetStatistics(void);
+
 private:
-  z_stream*                         mStreamData;
+  static void                       _initCrcSliceTable(void);
+
+  z_stream*                         mDeflateStream;
+  z_stream*                         mInflateStream;
+  bool                              mDeflateReady;
+  bool                              mInflateReady;
+  uint32                            mCompressMinSize;
+
+  uint64                            mCompressCalls;
+  uint64                            mCompressSkipped;
+  uint64                            mCompressBytesIn;
+  uint64                            mCompressBytesOut;
+  uint64                            mCompressTime;
   static const uint32               mCrcTable[256];
+
+  // mCrcSliceTable[0] is mCrcTable, [n] advances a byte through n more zero bytes (slicing-by-8)
+  static uint32                     mCrcSliceTable[8][256];
+  static boost::once_flag           mCrcSliceTableOnce;
 };
 
 
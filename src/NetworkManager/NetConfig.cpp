@@ -48,6 +48,41 @@ NetConfig::NetConfig()
 
 	 mServerPacketWindow			= gConfig->read<int>("ServerPacketWindowSize",800);
 	 mClientPacketWindow			= gConfig->read<int>("ClientPacketWindowSize",80);
+
+	 mReceiveBatchSize				= gConfig->read<int>("UDPReceiveBatchSize",32);
+
+	 if(mReceiveBatchSize < 1)
+		 mReceiveBatchSize = 1;
+
+	 if(mReceiveBatchSize > 256)
+		 mReceiveBatchSize = 256;
+
+	 mSendBatchSize					= gConfig->read<int>("UDPSendBatchSize",64);
+
+	 if(mSendBatchSize < 1)
+		 mSendBatchSize = 1;
+
+	 if(mSendBatchSize > 256)
+		 mSendBatchSize = 256;
+
+	 mSocketShards					= gConfig->read<int>("UDPSocketShards",1);
+
+	 if(mSocketShards < 1)
+		 mSocketShards = 1;
+
+	 if(mSocketShards > 16)
+		 mSocketShards = 16;
+
+	 // -1 is the zlib default (6)
+	 mCompressionLevelServerServer	= gConfig->read<int>("CompressionLevelServerServer",-1);
+	 mCompressionLevelServerClient	= gConfig->read<int>("CompressionLevelServerClient",-1);
+	 mCompressionMinSize			= gConfig->read<int>("CompressionMinSize",32);
+
+	 if(mCompressionLevelServerServer < -1 || mCompressionLevelServerServer > 9)
+		 mCompressionLevelServerServer = -1;
+
+	 if(mCompressionLevelServerClient < -1 || mCompressionLevelServerClient > 9)
+		 mCompressionLevelServerClient = -1;
 	 //mMaxBazaarListing = gConfig->read<int>("BazaarMaxListing",35);
 
 }
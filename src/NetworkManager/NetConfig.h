@@ -53,6 +53,14 @@ class NetConfig
 
 		uint32	getServerPacketWindow(){ return mServerPacketWindow;}
 		uint32	getClientPacketWindow(){ return mClientPacketWindow;}
+
+		uint32	getReceiveBatchSize(){ return mReceiveBatchSize;}
+		uint32	getSendBatchSize(){ return mSendBatchSize;}
+		uint32	getSocketShards(){ return mSocketShards;}
+
+		int32	getServerServerCompressionLevel(){ return mCompressionLevelServerServer;}
+		int32	getServerClientCompressionLevel(){ return mCompressionLevelServerClient;}
+		uint32	getCompressionMinSize(){ return mCompressionMinSize;}
 		
 	private:
 
@@ -74,6 +82,20 @@ class NetConfig
 
 		uint32					mServerPacketWindow;
 		uint32					mClientPacketWindow;
+
+		//amount of datagrams the socket read thread pulls per syscall
+		uint32					mReceiveBatchSize;
+
+		//amount of datagrams the socket write thread collects before it flushes them to the socket
+		uint32					mSendBatchSize;
+
+		//amount of SO_REUSEPORT sockets (each with its own read/write thread) a client service listens on
+		uint32					mSocketShards;
+
+		//zlib level used by the socket write threads and the payload size below which we dont compress at all
+		int32					mCompressionLevelServerServer;
+		int32					mCompressionLevelServerClient;
+		uint32					mCompressionMinSize;
 };
 
 #endif
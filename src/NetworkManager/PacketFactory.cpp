@@ -29,14 +29,37 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Packet.h"
 #include "NetConfig.h"
 
+#include "Utils/atomic.h"
+
+#include <cstddef>
+#include <cstdlib>
+
 
 //======================================================================================================================
+//
+// the packet lives in mStorage, the header in front of it links the free lists
+//
 
-PacketFactory::PacketFactory(bool serverservice)
-: mPacketPool(sizeof(Packet))
+struct PacketBlock
 {
-	mPacketCount = 0;
+	PacketCache*	mOwner;
+	PacketBlock*	mNext;
+	uint64			mStorage[(sizeof(Packet) + sizeof(uint64) - 1) / sizeof(uint64)];
+};
+
+static inline PacketBlock* _blockFromPacket(Packet* packet)
+{
+	return reinterpret_cast<PacketBlock*>(reinterpret_cast<int8*>(packet) - offsetof(PacketBlock, mStorage));
+}
 
+
+//======================================================================================================================
+
+PacketFactory::PacketFactory(bool serverservice)
+: mThreadCache(&PacketFactory::_releaseCache)
+, mCapacity(0)
+, mHighWaterMark(0)
+{
 	if(serverservice)
 		mMaxPayLoad = gNetConfig->getServerServerReliableSize();
 	else
@@ -48,10 +71,24 @@ PacketFactory::PacketFactory(bool serverservice)
 
 PacketFactory::~PacketFactory(void)
 {
-	// Destory our clock
-	// delete mClock;
+	// all threads using us are gone by now
+	mThreadCache.reset();
+
+	PacketCacheList::iterator cacheIt = mCaches.begin();
 
-	mPacketPool.purge_memory();
+	while(cacheIt != mCaches.end())
+	{
+		delete(*cacheIt);
+		++cacheIt;
+	}
+
+	PacketChunkList::iterator chunkIt = mChunks.begin();
+
+	while(chunkIt != mChunks.end())
+	{
+		free(*chunkIt);
+		++chunkIt;
+	}
 }
 
 //======================================================================================================================
@@ -67,15 +104,28 @@ void PacketFactory::Process(void)
 
 Packet* PacketFactory::CreatePacket(void)
 {
+	PacketCache* cache = _getCache();
+
+	if(!cache->mFreeList)
+	{
+		// take back everything other threads returned to us
+		cache->mFreeList = Anh_Utils::atomicExchange(&cache->mRemoteList, (PacketBlock*)0);
 
-	boost::recursive_mutex::scoped_lock lk(mPacketFactoryMutex);
-	Packet* newPacket = new(mPacketPool.malloc()) Packet();
+		if(!cache->mFreeList)
+		{
+			_refill(cache);
+		}
+	}
+
+	PacketBlock* block = cache->mFreeList;
+	cache->mFreeList = block->mNext;
+	cache->mCreated++;
+
+	Packet* newPacket = new(block->mStorage) Packet();
 
 	newPacket->setTimeCreated(Anh_Utils::Clock::getSingleton()->getStoredTime());
 	newPacket->setMaxPayload(mMaxPayLoad);
 
-	mPacketCount++;
-
 	return newPacket;
 }
 
@@ -83,10 +133,103 @@ Packet* PacketFactory::CreatePacket(void)
 
 void PacketFactory::DestroyPacket(Packet* packet)
 {
-	boost::recursive_mutex::scoped_lock lk(mPacketFactoryMutex);
-	
-	mPacketPool.free(packet);
-	mPacketCount--;
+	PacketCache* cache = _getCache();
+	PacketBlock* block = _blockFromPacket(packet);
+	PacketCache* owner = block->mOwner;
+
+	cache->mDestroyed++;
+
+	if(owner == cache)
+	{
+		block->mNext = cache->mFreeList;
+		cache->mFreeList = block;
+		return;
+	}
+
+	PacketBlock* head;
+
+	do
+	{
+		head = owner->mRemoteList;
+		block->mNext = head;
+	}
+	while(!Anh_Utils::atomicCompareAndSwap(&owner->mRemoteList, head, block));
+}
+
+//======================================================================================================================
+
+uint32 PacketFactory::getOutstanding(void)
+{
+	boost::mutex::scoped_lock lk(mCacheMutex);
+
+	uint32 outstanding = 0;
+
+	PacketCacheList::iterator it = mCaches.begin();
+
+	while(it != mCaches.end())
+	{
+		outstanding += (*it)->mCreated - (*it)->mDestroyed;
+		++it;
+	}
+
+	if(outstanding > mHighWaterMark && outstanding <= mCapacity)
+	{
+		mHighWaterMark = outstanding;
+	}
+
+	return outstanding;
+}
+
+//======================================================================================================================
+
+PacketCache* PacketFactory::_getCache(void)
+{
+	PacketCache* cache = mThreadCache.get();
+
+	if(cache)
+	{
+		return cache;
+	}
+
+	cache = new PacketCache();
+	cache->mFreeList	= 0;
+	cache->mRemoteList	= 0;
+	cache->mCreated		= 0;
+	cache->mDestroyed	= 0;
+
+	{
+		boost::mutex::scoped_lock lk(mCacheMutex);
+		mCaches.push_back(cache);
+	}
+
+	mThreadCache.reset(cache);
+
+	return cache;
+}
+
+//======================================================================================================================
+
+void PacketFactory::_refill(PacketCache* cache)
+{
+	PacketBlock* chunk = reinterpret_cast<PacketBlock*>(malloc(PACKET_CHUNK_SIZE * sizeof(PacketBlock)));
+
+	for(uint32 i = 0; i < PACKET_CHUNK_SIZE; i++)
+	{
+		chunk[i].mOwner	= cache;
+		chunk[i].mNext	= (i + 1 < PACKET_CHUNK_SIZE) ? &chunk[i + 1] : 0;
+	}
+
+	cache->mFreeList = chunk;
+
+	{
+		boost::mutex::scoped_lock lk(mCacheMutex);
+		mChunks.push_back(chunk);
+	}
+
+	Anh_Utils::atomicAdd(&mCapacity, PACKET_CHUNK_SIZE);
+
+	// we only get here once every packet this thread owns is in use, good moment to sample
+	getOutstanding();
 }
 
 //======================================================================================================================
@@ -31,12 +31,36 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Utils/typedefs.h"
 #include "Utils/clock.h"
 #include "Packet.h"
-#include <boost/pool/pool.hpp>
+
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+
+#include <vector>
 
 
 //======================================================================================================================
 
-typedef boost::pool<boost::default_user_allocator_malloc_free> PacketPool;
+// amount of packets carved out of one malloc when a thread cache runs dry
+#define PACKET_CHUNK_SIZE 64
+
+struct PacketBlock;
+
+//======================================================================================================================
+//
+// Every thread creating or destroying packets gets its own cache. A packet remembers the cache it was carved for.
+// Destroying it on that cache's thread links it into the local free list, destroying it on any other thread
+// pushes it onto the owners remote list with a single compare and swap.
+// The owner takes the whole remote list at once when its local list runs dry, nobody pops single
+// entries off the remote list, so there is no ABA problem.
+//
+
+struct PacketCache
+{
+	PacketBlock*			mFreeList;		// owner thread only
+	PacketBlock* volatile	mRemoteList;	// pushed to by other threads, emptied by the owner
+	uint32					mCreated;		// written by the owner thread only
+	uint32					mDestroyed;		// written by the owner thread only
+};
 
 //======================================================================================================================
 
@@ -52,13 +76,33 @@ class PacketFactory
 		Packet*		CreatePacket(void);
 		void		DestroyPacket(Packet* packet);
 
+		// statistics, approximate while other threads are working
+		uint32		getOutstanding(void);
+		uint32		getHighWaterMark(void){ return mHighWaterMark; }
+		uint32		getCapacity(void){ return mCapacity; }
+
 		uint16		mMaxPayLoad;
 
 	private:
-		uint32							mPacketCount;
-        PacketPool						mPacketPool;
-		boost::recursive_mutex			mPacketFactoryMutex;
-	  
+
+		typedef std::vector<PacketCache*>	PacketCacheList;
+		typedef std::vector<void*>			PacketChunkList;
+
+		PacketCache*	_getCache(void);
+		void			_refill(PacketCache* cache);
+
+		// caches belong to the factory, not to the thread
+		static void		_releaseCache(PacketCache*){}
+
+		boost::thread_specific_ptr<PacketCache>	mThreadCache;
+
+		// only taken when a thread creates its cache or a cache needs a new chunk
+		boost::mutex					mCacheMutex;
+		PacketCacheList					mCaches;
+		PacketChunkList					mChunks;
+
+		volatile uint32					mCapacity;
+		volatile uint32					mHighWaterMark;
 };
 
 //======================================================================================================================
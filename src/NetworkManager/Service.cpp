@@ -70,9 +70,6 @@ bool Service::mSocketsSubsystemInitComplete = false;
 
 Service::Service(NetworkManager* networkManager, bool serverservice, uint32 id, int8* localAddress, uint16 localPort,uint32 mfHeapSize) :
 mNetworkManager(networkManager),
-mSocketReadThread(0),
-mSocketWriteThread(0),
-mLocalSocket(0),
 avgTime(0),
 avgPacketsbuild (0),
 mLocalAddress(0),
@@ -100,8 +97,101 @@ mServerService(serverservice)
 	}
 	#endif //WIN32
 
+	// A client service may spread its sessions over several sockets bound to the same port. The kernel hashes
+	// every remote address onto one of them (SO_REUSEPORT), so each shard only ever sees its own sessions and
+	// keeps them in its own address map. Server services stay on a single socket, as the answers to our outgoing
+	// connects have to arrive on the socket they were sent from.
+	uint32 shards = 1;
+
+#if(ANH_PLATFORM == ANH_PLATFORM_LINUX) && defined(SO_REUSEPORT)
+	if(!mServerService)
+	{
+		shards = gNetConfig->getSocketShards();
+	}
+#endif
+
+	if(shards > 1)
+	{
+		gLogger->log(LogManager::INFORMATION, "Service %u: sharding port %u over %u sockets", mId, localPort, shards);
+	}
+
+	for(uint32 i = 0; i < shards; i++)
+	{
+		SOCKET localSocket = _createSocket(shards > 1);
+
+		// Create our read/write socket classes
+		SocketWriteThread* writeThread = new SocketWriteThread(localSocket,this,mServerService);
+
+		mLocalSockets.push_back(localSocket);
+		mSocketWriteThreads.push_back(writeThread);
+		mSocketReadThreads.push_back(new SocketReadThread(localSocket, writeThread,this,mfHeapSize / shards, mServerService));
+	}
+
+	// Query the stack for the actual address and port we got and store it in the service.
+	//getsockname(mLocalSocket, (sockaddr*)&server, &serverLen);
+	//mLocalAddress = server.sin_addr.s_addr;
+	//mLocalPort = server.sin_port;
+/*
+	// Reset the connect call to universe.
+	toAddr.sa_family = AF_INET;
+	*((uint32*)&toAddr.sa_data[2]) = 0;
+	*((uint16*)&(toAddr.sa_data[0])) = 0;
+	sent = connect(mLocalSocket, &toAddr, toLen);
+*/
+}
+
+//======================================================================================================================
+
+Service::~Service(void)
+{
+	Session* session = 0;
+
+	while(mSessionProcessQueue.size())
+	{
+		session = mSessionProcessQueue.pop();
+
+		if(session)
+		{
+			session->getSocketReadThread()->RemoveAndDestroySession(session);
+		}
+	}
+
+	for(uint32 i = 0; i < mLocalSockets.size(); i++)
+	{
+		delete mSocketWriteThreads[i];
+		delete mSocketReadThreads[i];
+
+		closesocket(mLocalSockets[i]);
+	}
+
+	mSocketWriteThreads.clear();
+	mSocketReadThreads.clear();
+	mLocalSockets.clear();
+
+	#if(ANH_PLATFORM == ANH_PLATFORM_WIN32)
+		WSACleanup();
+	#endif
+}
+
+//======================================================================================================================
+
+SOCKET Service::_createSocket(bool reusePort)
+{
 	// Create our socket descriptors
-	SOCKET mLocalSocket = socket(PF_INET, SOCK_DGRAM, 0);
+	SOCKET localSocket = socket(PF_INET, SOCK_DGRAM, 0);
+
+#if(ANH_PLATFORM == ANH_PLATFORM_LINUX) && defined(SO_REUSEPORT)
+	// has to be set on every socket sharing the port, before binding
+	if(reusePort)
+	{
+		int reuse = 1;
+
+		if(setsockopt(localSocket, SOL_SOCKET, SO_REUSEPORT, (char*)&reuse, sizeof(reuse)) != 0)
+		{
+			gLogger->log(LogManager::CRITICAL, "Service %u: SO_REUSEPORT failed, socket shards will not receive any traffic", mId);
+		}
+	}
+#endif
 
 	// Bind to our listen port.
 	sockaddr_in   server;
@@ -110,7 +200,7 @@ mServerService(serverservice)
 	server.sin_addr.s_addr = INADDR_ANY;
 
 	// Attempt to bind to our socket
-	bind(mLocalSocket, (sockaddr*)&server, sizeof(server));
+	bind(localSocket, (sockaddr*)&server, sizeof(server));
 
 	// We need to call connect on the socket to an address before we can know which address we have.
 	// The address specified in the connect call determines which interface our socket is associated with
@@ -141,55 +231,13 @@ mServerService(serverservice)
 
 	value = configvalue *1024;
 	
-	setsockopt(mLocalSocket,SOL_SOCKET,SO_RCVBUF,(char*)&value,valuelength);
+	setsockopt(localSocket,SOL_SOCKET,SO_RCVBUF,(char*)&value,valuelength);
 
 	int temp = 1;
 	//9 is IP_DONTFRAG (PK told me to put that here so we know wtf 9 means :P
-	setsockopt(mLocalSocket, IPPROTO_IP, 9, (char*)&temp, sizeof(temp));
-
-
-	// Create our read/write socket classes
-	mSocketWriteThread = new SocketWriteThread(mLocalSocket,this,mServerService);
-	mSocketReadThread = new SocketReadThread(mLocalSocket, mSocketWriteThread,this,mfHeapSize, mServerService);
-
-	// Query the stack for the actual address and port we got and store it in the service.
-	//getsockname(mLocalSocket, (sockaddr*)&server, &serverLen);
-	//mLocalAddress = server.sin_addr.s_addr;
-	//mLocalPort = server.sin_port;
-/*
-	// Reset the connect call to universe.
-	toAddr.sa_family = AF_INET;
-	*((uint32*)&toAddr.sa_data[2]) = 0;
-	*((uint16*)&(toAddr.sa_data[0])) = 0;
-	sent = connect(mLocalSocket, &toAddr, toLen);
-*/
-}
-
-//======================================================================================================================
-
-Service::~Service(void)
-{
-	Session* session = 0;
-
-	while(mSessionProcessQueue.size())
-	{
-		session = mSessionProcessQueue.pop();
-
-		if(session)
-		{
-			mSocketReadThread->RemoveAndDestroySession(session);
-		}
-	}
+	setsockopt(localSocket, IPPROTO_IP, 9, (char*)&temp, sizeof(temp));
 
-	delete mSocketWriteThread;
-	delete mSocketReadThread;
-
-	closesocket(mLocalSocket);
-	mLocalSocket = INVALID_SOCKET;
-
-	#if(ANH_PLATFORM == ANH_PLATFORM_WIN32)
-		WSACleanup();
-	#endif
+	return localSocket;
 }
 
 //======================================================================================================================
@@ -259,7 +307,8 @@ void Service::Process()
 		}
 		else if(session->getStatus() == SSTAT_Destroy)
 		{
-		  mSocketReadThread->RemoveAndDestroySession(session);
+		  // every shard keeps its own address map
+		  session->getSocketReadThread()->RemoveAndDestroySession(session);
 
 
 		  continue;
@@ -312,14 +361,17 @@ void Service::Connect(NetworkClient* client, int8* address, uint16 port)
 	// a queue/async connect method.  FIXME:  Make queue based, async using NetworkCallback for status changes.
 
 	// We want this to be a blocking call for now, so loop waiting for change in session status from Connecting.
-	mSocketReadThread->NewOutgoingConnection(address, port);
+	// Outgoing connections always go through our first socket.
+	SocketReadThread* socketReadThread = mSocketReadThreads[0];
+
+	socketReadThread->NewOutgoingConnection(address, port);
 
 	// don't want a hard loop pegging the cpu.
 	while(1)
 	{
-		if(mSocketReadThread->getNewConnectionInfo()->mSession)
+		if(socketReadThread->getNewConnectionInfo()->mSession)
 		{
-			if(mSocketReadThread->getNewConnectionInfo()->mSession->getStatus() == SSTAT_Connected)
+			if(socketReadThread->getNewConnectionInfo()->mSession->getStatus() == SSTAT_Connected)
 			{
 				break;
 			}
@@ -328,8 +380,8 @@ void Service::Connect(NetworkClient* client, int8* address, uint16 port)
         boost::this_thread::sleep(boost::posix_time::milliseconds(10));
 	}
 
-	client->setSession(mSocketReadThread->getNewConnectionInfo()->mSession);
-	mSocketReadThread->getNewConnectionInfo()->mSession->setClient(client);
+	client->setSession(socketReadThread->getNewConnectionInfo()->mSession);
+	socketReadThread->getNewConnectionInfo()->mSession->setClient(client);
 }
 
 //======================================================================================================================
@@ -32,6 +32,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Utils/concurrent_queue.h"
 
 #include <list>
+#include <vector>
 
 
 //======================================================================================================================
@@ -47,6 +48,9 @@ class NetworkCallback;
 
 typedef Anh_Utils::concurrent_queue<Session*>	SessionQueue;
 typedef std::list<NetworkCallback*>				NetworkCallbackList;
+typedef std::vector<SOCKET>						SocketList;
+typedef std::vector<SocketReadThread*>			SocketReadThreadList;
+typedef std::vector<SocketWriteThread*>			SocketWriteThreadList;
 
 //======================================================================================================================
 
@@ -69,6 +73,7 @@ class Service
 		int8*	getLocalAddress(void);
 		uint16	getLocalPort(void);
 		uint32	getId(void){ return mId; };
+		uint32	getShardCount(void){ return mSocketReadThreads.size(); }
 
 		void	setId(uint32 id){ mId = id; };
 		void	setQueued(bool b){ mQueued = b; }
@@ -76,14 +81,18 @@ class Service
 
 	private:
 
+		SOCKET					_createSocket(bool reusePort);
+
 		NetworkCallback*		mCallBack;
 		//NetworkCallbackList		mNetworkCallbackList;
 		SessionQueue			mSessionProcessQueue;
 		int8					mLocalAddressName[256];
 		NetworkManager*			mNetworkManager;
-		SocketReadThread*		mSocketReadThread;
-		SocketWriteThread*		mSocketWriteThread;
-		SOCKET					mLocalSocket;
+
+		// one socket with its own read / write thread per shard, shard 0 handles outgoing connections
+		SocketReadThreadList	mSocketReadThreads;
+		SocketWriteThreadList	mSocketWriteThreads;
+		SocketList				mLocalSockets;
 		uint64					avgTime;
 		uint64					lasttime;
 		uint32					avgPacketsbuild;
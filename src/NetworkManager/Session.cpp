@@ -95,8 +95,16 @@ mInSequenceNext(0),
 mOutSequenceRollover(false),
 mNextPacketSequenceSent(0),
 mLastRemotePacketAckReceived(0),
-mWindowSizeCurrent(8000),
+mWindowSizeCurrent(SESSION_WINDOW_INITIAL),
 mWindowResendSize(8000),
+mSlowStartThreshold(8000),
+mWindowAckCredit(0),
+mLastWindowReduction(0),
+mSmoothedRoundtripTime(0),
+mRoundtripTimeVariance(0),
+mRetransmitTimeout(SESSION_RTO_INITIAL),
+mPacketsResent(0),
+mPacketsFastResent(0),
 mSendDelayedAck(false),
 mInOutgoingQueue(false),
 mInIncomingQueue(false),
@@ -309,7 +317,8 @@ void Session::ProcessWriteThread(void)
   {
 	  if(!mSendDelayedAck)
 	  {
-		if(packetBuildTimeStart - mLastWriteThreadTime < 300)
+		//unacknowledged packets need us to look at their retransmission timeout though
+		if((packetBuildTimeStart - mLastWriteThreadTime < 300) && mWindowPacketList.empty() && mRolloverWindowPacketList.empty())
 		{
 			endCount++;
 			return;
@@ -369,7 +378,8 @@ void Session::ProcessWriteThread(void)
   uint32 pUnreliableBuild = 0;
 
   //build reliable packets
-  while(((now - packetBuildTimeStart) < mPacketBuildTimeLimit) && ((mRolloverWindowPacketList.size() + mWindowPacketList.size()) < mWindowSizeCurrent) && mOutgoingMessageQueue.size())
+  //packets waiting for the window to open count as well, no need to build more than we can send
+  while(((now - packetBuildTimeStart) < mPacketBuildTimeLimit) && ((mRolloverWindowPacketList.size() + mWindowPacketList.size() + mNewRolloverWindowPacketList.size() + mNewWindowPacketList.size()) < mWindowSizeCurrent) && mOutgoingMessageQueue.size())
   {
 	pBuild += _buildPackets();
 	now = Anh_Utils::Clock::getSingleton()->getLocalTime();
@@ -397,7 +407,7 @@ void Session::ProcessWriteThread(void)
 	PacketWindowList::iterator	iterRoll;
 
 	Packet*						windowPacket	= NULL;
-	uint32						packetsSent		= 0;
+	uint32						packetsInFlight	= 0;
 
 	//Rollover happens when our sequence reaches 65535
 	//the old (< sequence = 0)packets go in the rolloverqueue and wait for being send and/or acknowledged and then deleted
@@ -416,24 +426,21 @@ void Session::ProcessWriteThread(void)
 			
 		
 		iterRoll = mNewRolloverWindowPacketList.begin();
+		packetsInFlight = mRolloverWindowPacketList.size() + mWindowPacketList.size();
 
 		while(iterRoll != mNewRolloverWindowPacketList.end())
 		{
 
 			windowPacket = *iterRoll;
-			windowPacket->setReadIndex(2);
-			uint16 sequence = ntohs(windowPacket->getUint16());
-
 			
-			// If we've sent our mWindowSizeCurrent of packets, break out and wait for some acks.
-			// make sure we send at least a minimum as we dont want any stalling
-			if (packetsSent >= mWindowSizeCurrent)
+			// If our window of not yet acknowledged packets is full, break out and wait for some acks.
+			if (packetsInFlight >= mWindowSizeCurrent)
 				break;
 
 			_addOutgoingReliablePacket(windowPacket);
 			iterRoll = mNewRolloverWindowPacketList.erase(iterRoll);
 			mRolloverWindowPacketList.push_back(windowPacket);
-			packetsSent++;
+			packetsInFlight++;
 
 			mNextPacketSequenceSent++;		
 		}
@@ -447,25 +454,23 @@ void Session::ProcessWriteThread(void)
 	//A Rollover might still be in existance
 
 	iter = mNewWindowPacketList.begin();
+	packetsInFlight = mRolloverWindowPacketList.size() + mWindowPacketList.size();
 
 	//mNewWindoPacketList has the not yet send Packets
 	while(iter != mNewWindowPacketList.end())
 	{
 
 		windowPacket = *iter;
-		//windowPacket->setReadIndex(2);
-		//uint16 sequence = ntohs(windowPacket->getUint16());
 		
-		// If we've sent our mWindowSizeCurrent of packets, break out and wait for some acks.
-		// make sure we send at least a minimum as we dont wont any stalling
-		if (packetsSent >= mWindowSizeCurrent)
+		// If our window of not yet acknowledged packets is full, break out and wait for some acks.
+		if (packetsInFlight >= mWindowSizeCurrent)
 			break;
 
 		_addOutgoingReliablePacket(windowPacket);
 		
 		//mWindoPacketList has the already send but not yet acknowledged Packets
 		mWindowPacketList.push_back(windowPacket);
-		packetsSent++;
+		packetsInFlight++;
 
 		++mNextPacketSequenceSent;
 
@@ -473,6 +478,9 @@ void Session::ProcessWriteThread(void)
 			
 	}
 
+	// resend whatever did not get acknowledged within our retransmission timeout
+	_resendOutgoingPackets(Anh_Utils::Clock::getSingleton()->getLocalTime());
+
 	lk.unlock();
   
   // Handle any specific commands
@@ -558,6 +566,8 @@ void Session::SendChannelA(Message* message)
 	  message->setFastpath(false);	  //send it as reliable if its to big
 	  mOutgoingMessageQueue.push(message);
   }
+
+  SignalWriteThread();
 }
 
 void Session::SendChannelAUnreliable(Message* message)
@@ -579,6 +589,8 @@ void Session::SendChannelAUnreliable(Message* message)
   }
   else
 	mUnreliableMessageQueue.push(message);
+
+  SignalWriteThread();
 }
 
 
@@ -713,6 +725,10 @@ void Session::HandleSessionPacket(Packet* packet)
 	case SESSIONOP_DataAck4:
 	{
 	  _processDataChannelAck(packet);
+
+	  // the ack might have opened up our window
+	  if(HasPendingWrite())
+		  SignalWriteThread();
 	  return;
 	}
         
@@ -799,7 +815,8 @@ void Session::HandleSessionPacket(Packet* packet)
 	   }
 	  
 	   //were missing something
-	   gLogger->log(LogManager::DEBUG, "Handle Session Packet :: Incoming data - seq: %i expect: %u Session:0x%x%.4x", sequence, mInSequenceNext, mService->getId(), getId());
+	   if(gLogger->isLogged(LogManager::DEBUG))
+		   gLogger->log(LogManager::DEBUG, "Handle Session Packet :: Incoming data - seq: %i expect: %u Session:0x%x%.4x", sequence, mInSequenceNext, mService->getId(), getId());
 			
 		switch(packetType )
 		{
@@ -1204,6 +1221,7 @@ void Session::_processDataChannelPacket(Packet* packet, bool fastPath)
    
 	mInSequenceNext++;
 	mSendDelayedAck = true;
+	SignalWriteThread();
 	
 
 
@@ -1318,6 +1336,7 @@ void Session::_processDataChannelB(Packet* packet)
 		// in sequence is per packet not per message 
 		mInSequenceNext++;
 		mSendDelayedAck = true;
+		SignalWriteThread();
   
 
 
@@ -1332,8 +1351,6 @@ void Session::_processDataChannelB(Packet* packet)
 //======================================================================================================================
 void Session::_processDataChannelAck(Packet* packet)
 {
-	uint32 oldsize = mWindowSizeCurrent;
-
 	Packet* windowPacket = 0;
 	uint16 windowPacketSequence = 0;
 	PacketWindowList::iterator iter;
@@ -1363,13 +1380,6 @@ void Session::_processDataChannelAck(Packet* packet)
 			mOutSequenceRollover = false;
 			iter = mRolloverWindowPacketList.begin();
 			
-			//now that communication is reestablished we can resize our window again
-			if(mWindowSizeCurrent < mWindowResendSize)
-			{
-				mWindowSizeCurrent += uint32(mWindowResendSize/10);
-				if(mWindowSizeCurrent >mWindowResendSize)
-					mWindowSizeCurrent = mWindowResendSize;
-			}
 			//destroy them now they are acknowleged
 			//they dont have to be resend
 			while(iter != mRolloverWindowPacketList.end())
@@ -1381,6 +1391,10 @@ void Session::_processDataChannelAck(Packet* packet)
 			
 
 			}
+
+			//now that communication is reestablished we can resize our window again
+			_growWindow(pDel);
+			pDel = 0;
 		}
 		else//else if(sequence < 0xFFFF - mRolloverWindowPacketList.size()) thats an ack purely for the old list
 		{
@@ -1397,19 +1411,13 @@ void Session::_processDataChannelAck(Packet* packet)
 			{
 				
 				// This is a proper ack, so handle it.
-				if(mWindowSizeCurrent < mWindowResendSize)
-				{
-					// I dont go with a set window of packets in our queues here as I think
-					// that the servers (especially the zones) need to keep on sending
-					// especially when loads of players log on to one zone in this situation we get easily a few thousand to tenthsnd messages
-					// in a short time
-					mWindowSizeCurrent += uint32(mWindowResendSize/10);
-					if(mWindowSizeCurrent >mWindowResendSize)
-						mWindowSizeCurrent = mWindowResendSize;
-				}
 				while(sequence >= windowPacketSequence)
 				{	
 					pDel ++;
+
+					if(sequence == windowPacketSequence && !windowPacket->getResends())
+						_updateRoundtripTime(uint32(Anh_Utils::Clock::getSingleton()->getLocalTime() - windowPacket->getTimeQueued()));
+
 					mPacketFactory->DestroyPacket(*iter);
 					mRolloverWindowPacketList.erase(iter);
 
@@ -1435,7 +1443,7 @@ void Session::_processDataChannelAck(Packet* packet)
 				mLastRemotePacketAckReceived = Anh_Utils::Clock::getSingleton()->getStoredTime();
 
 				// Our current window increases here, as we know come communication is back.
-			
+				_growWindow(pDel);
 			}//if(sequence < windowPacketSequence)
 
 			mPacketFactory->DestroyPacket(packet);
@@ -1470,16 +1478,14 @@ void Session::_processDataChannelAck(Packet* packet)
 	else
 	{
 		// This is a proper ack, so handle it.
-		if(mWindowSizeCurrent < mWindowResendSize)
-		{
-			mWindowSizeCurrent += uint32(mWindowResendSize/10);
-			if(mWindowSizeCurrent >mWindowResendSize)
-				mWindowSizeCurrent = mWindowResendSize;
-		}
-
 		while (sequence >= windowPacketSequence)
 		{
 			pDel ++;
+
+			// only packets we never resend tell us the truth about our roundtrip time
+			if(sequence == windowPacketSequence && !windowPacket->getResends())
+				_updateRoundtripTime(uint32(Anh_Utils::Clock::getSingleton()->getLocalTime() - windowPacket->getTimeQueued()));
+
 			mPacketFactory->DestroyPacket(*iter);
 			mWindowPacketList.erase(iter);
 			
@@ -1496,6 +1502,7 @@ void Session::_processDataChannelAck(Packet* packet)
 
 		mLastRemotePacketAckReceived = Anh_Utils::Clock::getSingleton()->getStoredTime();
 
+		_growWindow(pDel);
 	}
 
 	// Destroy our incoming packet, it's not needed any longer.
@@ -1506,214 +1513,287 @@ void Session::_processDataChannelAck(Packet* packet)
 //======================================================================================================================
 void Session::_processDataOrderPacket(Packet* packet)
 {
+  boost::recursive_mutex::scoped_lock lk(mSessionMutex);// mRolloverWindowPacketList and WindowPacketList get accessed by the socketwritethread and by the socketreadthread both through the session
+
   packet->setReadIndex(2);
   uint16 sequence = ntohs(packet->getUint16());
 
-  PacketWindowList::iterator	iter			= mWindowPacketList.begin();
-  Packet*						windowPacket	= *iter;
-  
-  PacketWindowList::iterator iterRoll = mRolloverWindowPacketList.begin();
-  
-  windowPacket->setReadIndex(2);
-  uint16 windowSequence = ntohs(windowPacket->getUint16());
+  if(mWindowPacketList.size() || mRolloverWindowPacketList.size())
+	  _fastResendOutgoingPackets(sequence, 0);
 
-  
-  gLogger->log(LogManager::WARNING, "Out-Of-order packet session 0x%x%.4x seq: %u, windowsequ : %u", mService->getId(), mId, sequence, windowSequence);
+  // Destroy our incoming packet, it's not needed any longer.
+  mPacketFactory->DestroyPacket(packet);
+}
 
-  //Do some bounds checking
-  if (sequence < windowSequence)
-  {
-	  gLogger->log(LogManager::WARNING,"Out-Of-Order packet sequence too small, may be a duplicate or we handled our acks wrong.  seq: %u, expect >: %u", sequence, windowSequence);
-  }
 
-  if (sequence > windowSequence + mWindowPacketList.size())
-  {
-	  gLogger->log(LogManager::WARNING, "Rollover Out-Of-Order packet  seq: %u, expect >: %u", sequence, windowSequence);
-  }
-	
-	//The location of the packetsequence out of order has NOBEARING on the question on which list we will find the last properly received Packet!!!
+//======================================================================================================================
+void Session::_processDataOrderChannelB(Packet* packet)
+{
+  boost::recursive_mutex::scoped_lock lk(mSessionMutex);//			   
 
+  packet->setReadIndex(2);
+  uint16 sequence = ntohs(packet->getUint16());
+  uint16 bottomSequence = ntohs(packet->getUint16());
 
-	if(mRolloverWindowPacketList.size()&& (sequence > (65535-mRolloverWindowPacketList.size())))
+  if(mWindowPacketList.size() || mRolloverWindowPacketList.size())
+	  _fastResendOutgoingPackets(sequence, bottomSequence);
+
+  // Destroy our incoming packet, it's not needed any longer.
+  mPacketFactory->DestroyPacket(packet);
+}
+
+
+//======================================================================================================================
+//
+// the remote side received sequence ahead of time, so everything below it (and above bottomSequence) that is still
+// in our window got lost. We resend those right away instead of waiting for their timeout, but at most once per
+// roundtrip each as repeated out of order packets for the same hole would otherwise flood a bad link with duplicates
+//
+
+void Session::_fastResendOutgoingPackets(uint16 sequence, uint16 bottomSequence)
+{
+	boost::recursive_mutex::scoped_lock lk(mSessionMutex);
+
+	uint64	now		= Anh_Utils::Clock::getSingleton()->getLocalTime();
+	uint64	minAge	= SESSION_RTO_MIN;
+	uint32	resent	= 0;
+
+	if(mSmoothedRoundtripTime)
 	{
-		//jupp its on the rolloverlist
-        boost::recursive_mutex::scoped_lock lk(mSessionMutex); // mRolloverWindowPacketList and WindowPacketList get accessed by the socketwritethread and by the socketreadthread both through the session
+		minAge = mSmoothedRoundtripTime + mRoundtripTimeVariance;
+		if(minAge < SESSION_FAST_RESEND_MIN)
+			minAge = SESSION_FAST_RESEND_MIN;
+	}
 
-		uint16 count = 0;
-		for (iterRoll = mRolloverWindowPacketList.begin(); iterRoll != mWindowPacketList.end(); iterRoll++)
-		{
-			// Grab our window packet
-			windowPacket = (*iterRoll);
-			windowPacket->setReadIndex(2);
-			uint16 windowRollSequence = ntohs(windowPacket->getUint16());
+	//The location of the packetsequence out of order has NOBEARING on the question on which list we will find the last properly received Packet!!!
+	//a sequence on the rolloverlist means the holes are on it as well, otherwise the whole rolloverlist is older than the sequence
+	bool onRollover = mRolloverWindowPacketList.size() && (sequence > (65535 - mRolloverWindowPacketList.size()));
 
-			// If it's smaller than the order packet send it, otherwise break;
-			if (windowRollSequence < sequence )
-			{
-				//count++;
-				//if(count > 50)
-				//	break;
-					
-				if(Anh_Utils::Clock::getSingleton()->getLocalTime() - windowPacket->getTimeOOHSent() < 200)
-					break;
-				
-				_addOutgoingReliablePacket(windowPacket);
-				
-				windowPacket->setTimeOOHSent(Anh_Utils::Clock::getSingleton()->getLocalTime());
+	if(gLogger->isLogged(LogManager::DEBUG))
+		gLogger->log(LogManager::DEBUG, "Out-Of-order packet session 0x%x%.4x seq: %u, window : %u, rto : %u", mService->getId(), mId, sequence, mWindowSizeCurrent, mRetransmitTimeout);
 
-				if (mWindowSizeCurrent > (mWindowResendSize/10))
-					mWindowSizeCurrent--;
+	PacketWindowList::iterator iter = mRolloverWindowPacketList.begin();
 
-			}
-		}
-	 }
-  
-     uint16 count = 0;
-	 for (iter = mWindowPacketList.begin(); iter != mWindowPacketList.end(); iter++)
-	 {
-         boost::recursive_mutex::scoped_lock lk(mSessionMutex);//			   mRolloverWindowPacketList and WindowPacketList get accessed by the socketwritethread and by the socketreadthread both through the session
-	 
-		// Grab our window packet
-		windowPacket = (*iter);
+	while(iter != mRolloverWindowPacketList.end() && resent < mWindowSizeCurrent)
+	{
+		Packet* windowPacket = (*iter);
 		windowPacket->setReadIndex(2);
 		uint16 windowSequence = ntohs(windowPacket->getUint16());
 
-		// If it's smaller than the order packet send it, otherwise break;
-		// do we want to throttle the amount of packets being send to 10 or 50 or 100 ???
-		// if we receive a sequence on the rolloverlist (65530 for example) we will
-		// always send ALL packets on the regular list - 
-		
-		//make sure we do not spam the connection needlessly with packets
-		if(Anh_Utils::Clock::getSingleton()->getLocalTime() - windowPacket->getTimeOOHSent() > 200)
-		{		
-			_addOutgoingReliablePacket(windowPacket);
-					
-			windowPacket->setTimeOOHSent(Anh_Utils::Clock::getSingleton()->getLocalTime());
+		if(onRollover && windowSequence >= sequence)
+			break;
 
-			if (mWindowSizeCurrent > (mWindowResendSize/10))
-				mWindowSizeCurrent--;
-		
-		}
-		else
+		if((!onRollover || windowSequence >= bottomSequence) && _resendPacket(windowPacket, now, minAge))
+			resent++;
+
+		++iter;
+	}
+
+	if(!onRollover)
+	{
+		iter = mWindowPacketList.begin();
+
+		while(iter != mWindowPacketList.end() && resent < mWindowSizeCurrent)
 		{
-			mPacketFactory->DestroyPacket(packet);
-			return;
+			Packet* windowPacket = (*iter);
+			windowPacket->setReadIndex(2);
+			uint16 windowSequence = ntohs(windowPacket->getUint16());
+
+			if(windowSequence >= sequence)
+				break;
+
+			if((windowSequence >= bottomSequence) && _resendPacket(windowPacket, now, minAge))
+				resent++;
+
+			++iter;
 		}
-	}  
+	}
 
-  // Destroy our incoming packet, it's not needed any longer.
-  mPacketFactory->DestroyPacket(packet);
+	if(resent)
+	{
+		mPacketsFastResent += resent;
+
+		// a hole in the sequence is our sign of congestion
+		_shrinkWindow(false);
+	}
 }
 
 
 //======================================================================================================================
-void Session::_processDataOrderChannelB(Packet* packet)
+//
+// called from the write thread, packets not acknowledged within our retransmission timeout are resend
+// the first timeout collapses the window and doubles the timeout until the next roundtrip sample comes in
+//
+
+void Session::_resendOutgoingPackets(uint64 now)
 {
-	boost::recursive_mutex::scoped_lock lk(mSessionMutex);//			   
+	boost::recursive_mutex::scoped_lock lk(mSessionMutex);
 
-  packet->setReadIndex(2);
-  uint16 sequence = ntohs(packet->getUint16());
-  uint16 bottomSequence = ntohs(packet->getUint16());
+	PacketWindowList*	windowLists[2]	= { &mRolloverWindowPacketList, &mWindowPacketList };
+	uint64				minAge			= mRetransmitTimeout;
+	uint32				resent			= 0;
 
-  if(!mWindowPacketList.size())
-  {
-	  mPacketFactory->DestroyPacket(packet);
-	  return;
-  }
+	// rollover packets are the older ones
+	for(uint32 i = 0; i < 2; i++)
+	{
+		PacketWindowList::iterator iter = windowLists[i]->begin();
 
-  PacketWindowList::iterator iter = mWindowPacketList.begin();
-  PacketWindowList::iterator iterRoll = mRolloverWindowPacketList.begin();
-  
-  Packet* windowPacket = *iter;
-  windowPacket->setReadIndex(2);
-  uint16 windowSequence = ntohs(windowPacket->getUint16());
-  
+		while(iter != windowLists[i]->end())
+		{
+			Packet* windowPacket = (*iter);
 
-  gLogger->log(LogManager::WARNING, "Out-Of-order packet session 0x%x%.4x seq: %u, windowsequ : %u", mService->getId(), mId, sequence, windowSequence);
+			if(now - windowPacket->getTimeQueued() < minAge)
+			{
+				// packets behind a not yet resend one went out even later
+				if(!windowPacket->getResends())
+					return;
 
-  //Do some bounds checking
-  if (sequence < windowSequence)
-  {
-	  gLogger->log(LogManager::WARNING,"Out-Of-Order packet sequence too small, may be a duplicate or we handled our acks wrong.  seq: %u, expect >: %u", sequence, windowSequence);
-  }
+				++iter;
+				continue;
+			}
 
-  if (sequence > windowSequence + mWindowPacketList.size())
-  {
-	  gLogger->log(LogManager::WARNING, "Rollover Out-Of-Order packet  seq: %u, expect >: %u", sequence, windowSequence);
-  }
-	
-	//The location of the packetsequence out of order has NOBEARING on the question on which list we will find the last properly received Packet!!!
+			if(!resent)
+			{
+				_shrinkWindow(true);
 
+				mRetransmitTimeout <<= 1;
+				if(mRetransmitTimeout > SESSION_RTO_MAX)
+					mRetransmitTimeout = SESSION_RTO_MAX;
+			}
+
+			if(resent >= mWindowSizeCurrent)
+				return;
+
+			_resendPacket(windowPacket, now, minAge);
+			mPacketsResent++;
+			resent++;
+
+			++iter;
+		}
+	}
+}
 
-	if(mRolloverWindowPacketList.size()&& (sequence > (65535-mRolloverWindowPacketList.size())))
+
+//======================================================================================================================
+
+bool Session::_resendPacket(Packet* packet, uint64 now, uint64 minAge)
+{
+	// did it go out recently ?
+	if(now - packet->getTimeQueued() < minAge)
+		return false;
+
+	packet->setResends(packet->getResends() + 1);
+	_addOutgoingReliablePacket(packet);
+
+	return true;
+}
+
+
+//======================================================================================================================
+//
+// RFC 6298, srtt and its variance smoothed by 1/8 and 1/4, rto = srtt + 4 * variance
+//
+
+void Session::_updateRoundtripTime(uint32 sample)
+{
+	if(!mSmoothedRoundtripTime)
 	{
-		//jupp its on the rolloverlist
-		//mRolloverWindowPacketList and WindowPacketList get accessed by the socketwritethread and by the socketreadthread both through the session
-	 
-		uint16 count = 0;
-		for (iterRoll = mRolloverWindowPacketList.begin(); iterRoll != mWindowPacketList.end(); iterRoll++)
-		{
-			// Grab our window packet
-			windowPacket = (*iterRoll);
-			windowPacket->setReadIndex(2);
-			uint16 windowRollSequence = ntohs(windowPacket->getUint16());
+		mSmoothedRoundtripTime	= sample;
+		mRoundtripTimeVariance	= sample / 2;
+	}
+	else
+	{
+		uint32 delta = (mSmoothedRoundtripTime > sample) ? (mSmoothedRoundtripTime - sample) : (sample - mSmoothedRoundtripTime);
 
-			// If it's smaller than the order packet send it, otherwise break;
-			if ((windowRollSequence < sequence) && (windowRollSequence >= bottomSequence))
-			{
-				//count++;
-				//if(count > 50)
-				//	break;
-					
-				if(Anh_Utils::Clock::getSingleton()->getLocalTime() - windowPacket->getTimeOOHSent() < 200)
-					break;
-				
-				_addOutgoingReliablePacket(windowPacket);
-				
-				windowPacket->setTimeOOHSent(Anh_Utils::Clock::getSingleton()->getLocalTime());
+		mRoundtripTimeVariance	= (3 * mRoundtripTimeVariance + delta) / 4;
+		mSmoothedRoundtripTime	= (7 * mSmoothedRoundtripTime + sample) / 8;
+	}
 
-				if (mWindowSizeCurrent > (mWindowResendSize/10))
-					mWindowSizeCurrent--;
+	// 0 means no sample yet, a lan easily gets us below our clocks resolution
+	if(!mSmoothedRoundtripTime)
+		mSmoothedRoundtripTime = 1;
 
-			}
-		}
+	mRetransmitTimeout = mSmoothedRoundtripTime + 4 * mRoundtripTimeVariance;
 
-	 }
+	if(mRetransmitTimeout < SESSION_RTO_MIN)
+		mRetransmitTimeout = SESSION_RTO_MIN;
+	else if(mRetransmitTimeout > SESSION_RTO_MAX)
+		mRetransmitTimeout = SESSION_RTO_MAX;
+}
 
-     uint16 count = 0;
-	 for (iter = mWindowPacketList.begin(); iter != mWindowPacketList.end(); iter++)
-	 {
-        // boost::recursive_mutex::scoped_lock lk(mSessionMutex);
-		// Grab our window packet
-		windowPacket = (*iter);
-		windowPacket->setReadIndex(2);
-		uint16 windowSequence = ntohs(windowPacket->getUint16());
 
-		// If it's smaller than the order packet send it, otherwise break;
-		// do we want to throttle the amount of packets being send to 10 or 50 or 100 ???
-		// if we receive a sequence on the rolloverlist (65530 for example) we will
-		// always send ALL packets on the regular list - I dont anticipate a big deal here though!!!
-		if(Anh_Utils::Clock::getSingleton()->getLocalTime() - windowPacket->getTimeOOHSent() > 100)
-		{
-				
-			_addOutgoingReliablePacket(windowPacket);
-					
-			windowPacket->setTimeOOHSent(Anh_Utils::Clock::getSingleton()->getLocalTime());
+//======================================================================================================================
+//
+// slow start below the threshold (one packet per acked packet), additive increase of one packet per window above it
+//
 
-			if (mWindowSizeCurrent > (mWindowResendSize/10))
-				mWindowSizeCurrent--;
-		
-		}
-		else
+void Session::_growWindow(uint32 ackedPackets)
+{
+	if(mWindowSizeCurrent >= mWindowResendSize)
+		return;
+
+	if(mWindowSizeCurrent < mSlowStartThreshold)
+	{
+		mWindowSizeCurrent += ackedPackets;
+	}
+	else
+	{
+		mWindowAckCredit += ackedPackets;
+
+		while(mWindowAckCredit >= mWindowSizeCurrent)
 		{
-			mPacketFactory->DestroyPacket(packet);
-			return;
+			mWindowAckCredit -= mWindowSizeCurrent;
+			mWindowSizeCurrent++;
 		}
 	}
-  
 
-  // Destroy our incoming packet, it's not needed any longer.
-  mPacketFactory->DestroyPacket(packet);
+	if(mWindowSizeCurrent > mWindowResendSize)
+		mWindowSizeCurrent = mWindowResendSize;
+}
+
+
+//======================================================================================================================
+//
+// multiplicative decrease, halve on a reported loss, start over from the minimum on a timeout
+// losses reported within the same roundtrip belong to the same congestion event
+//
+
+void Session::_shrinkWindow(bool timeout)
+{
+	uint64 now			= Anh_Utils::Clock::getSingleton()->getLocalTime();
+	uint64 roundtrip	= mSmoothedRoundtripTime ? mSmoothedRoundtripTime : SESSION_RTO_MIN;
+
+	if(!timeout && (now - mLastWindowReduction) < roundtrip)
+		return;
+
+	mLastWindowReduction = now;
+
+	uint32 packetsInFlight = mWindowPacketList.size() + mRolloverWindowPacketList.size();
+
+	if(packetsInFlight > mWindowSizeCurrent)
+		packetsInFlight = mWindowSizeCurrent;
+
+	mSlowStartThreshold = packetsInFlight / 2;
+
+	if(mSlowStartThreshold < SESSION_WINDOW_MIN)
+		mSlowStartThreshold = SESSION_WINDOW_MIN;
+
+	mWindowSizeCurrent	= timeout ? SESSION_WINDOW_MIN : mSlowStartThreshold;
+	mWindowAckCredit	= 0;
+
+	if(mWindowSizeCurrent > mWindowResendSize)
+		mWindowSizeCurrent = mWindowResendSize;
+}
+
+
+//======================================================================================================================
+
+void Session::setResendWindowSize(uint32 resendWindowSize)
+{
+	mWindowResendSize	= resendWindowSize;
+	mSlowStartThreshold	= resendWindowSize;
+	mWindowSizeCurrent	= (resendWindowSize < SESSION_WINDOW_INITIAL) ? resendWindowSize : SESSION_WINDOW_INITIAL;
+	mWindowAckCredit	= 0;
 }
 
 
@@ -1754,6 +1834,7 @@ void Session::_processFragmentedPacket(Packet* packet)
   
 	// Need to send out acks
 	mSendDelayedAck = true;
+	SignalWriteThread();
 
 	// If we are not already processing a multi-packet message, start to.
 	if (mFragmentedPacketTotalSize == 0)
@@ -1882,6 +1963,7 @@ void Session::_processRoutedFragmentedPacket(Packet* packet)
   
 	// Need to send out acks
 	mSendDelayedAck = true;
+	SignalWriteThread();
 
 	// If we are not already processing a multi-packet message, start to.
 	if (mRoutedFragmentedPacketTotalSize == 0)
@@ -2444,6 +2526,8 @@ void Session::_addOutgoingReliablePacket(Packet* packet)
   // Set our last packet sent time index
   packet->setTimeQueued(Anh_Utils::Clock::getSingleton()->getLocalTime());
   mOutgoingReliablePacketQueue.push(packet); 
+
+  SignalWriteThread();
 }
 
 
@@ -2456,6 +2540,75 @@ void Session::_addOutgoingUnreliablePacket(Packet* packet)
   // Set our last packet sent time index
   packet->setTimeQueued(Anh_Utils::Clock::getSingleton()->getLocalTime());
   mOutgoingUnreliablePacketQueue.push(packet);
+
+  SignalWriteThread();
+}
+
+
+//======================================================================================================================
+//
+// puts us on the write threads ready queue, unless we are on it already
+// calls from within the write thread while we are being processed are caught by WriteThreadDone
+//
+
+void Session::SignalWriteThread(void)
+{
+	boost::recursive_mutex::scoped_lock lk(mSessionMutex);
+
+	if(mInOutgoingQueue || mStatus == SSTAT_Disconnected || mStatus == SSTAT_Destroy || !mSocketWriteThread)
+		return;
+
+	mInOutgoingQueue = true;
+	mSocketWriteThread->SignalSession(this);
+}
+
+
+//======================================================================================================================
+//
+// called by the write thread after it processed us, requeues the session when work is left over
+// (build time limit, per round packet limit or packets that did not fit the send window yet)
+//
+
+void Session::WriteThreadDone(void)
+{
+	boost::recursive_mutex::scoped_lock lk(mSessionMutex);
+
+	mInOutgoingQueue = false;
+
+	if(HasPendingWrite())
+		SignalWriteThread();
+}
+
+
+//======================================================================================================================
+//
+// messages waiting only count when our window has room for them, otherwise the next ack signals us.
+// packets in flight count once their retransmission timeout ran out
+//
+
+bool Session::HasPendingWrite(void)
+{
+	boost::recursive_mutex::scoped_lock lk(mSessionMutex);
+
+	if(mOutgoingReliablePacketQueue.size() || mOutgoingUnreliablePacketQueue.size() || mUnreliableMessageQueue.size() || mSendDelayedAck)
+		return true;
+
+	// the oldest unacknowledged packet is due for a resend, the rollover ones went out first
+	PacketWindowList* oldest = mRolloverWindowPacketList.size() ? &mRolloverWindowPacketList : &mWindowPacketList;
+
+	if(oldest->size() && Anh_Utils::Clock::getSingleton()->getLocalTime() - oldest->front()->getTimeQueued() >= mRetransmitTimeout)
+		return true;
+
+	// built packets and messages only count when our window has room for them
+	uint32 packetsInFlight = mRolloverWindowPacketList.size() + mWindowPacketList.size();
+
+	if(packetsInFlight >= mWindowSizeCurrent)
+		return false;
+
+	if(mNewWindowPacketList.size() || (mOutSequenceRollover && mNewRolloverWindowPacketList.size()))
+		return true;
+
+	return (mOutgoingMessageQueue.size() && ((packetsInFlight + mNewRolloverWindowPacketList.size() + mNewWindowPacketList.size()) < mWindowSizeCurrent));
 }
 
 
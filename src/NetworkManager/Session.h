@@ -58,6 +58,19 @@ typedef std::queue<Packet*>								PacketQueue;
 //typedef std::priority_queue<Message*,std::vector<Message*>,CompareMsg>  MessageQueue;
 typedef std::queue<Message*>							MessageQueue;
 
+//======================================================================================================================
+//
+// reliable channel retransmission and congestion window, times in ms, windows in packets
+// the configured ServerPacketWindowSize / ClientPacketWindowSize is the upper bound of the window
+//
+
+#define SESSION_RTO_INITIAL			1000	// until we got our first roundtrip sample
+#define SESSION_RTO_MIN				200
+#define SESSION_RTO_MAX				8000
+#define SESSION_WINDOW_INITIAL		16
+#define SESSION_WINDOW_MIN			4
+#define SESSION_FAST_RESEND_MIN		10		// we dont resend a reported hole twice within that time, however fast the link
+
 //======================================================================================================================
 
 enum SessionStatus
@@ -99,11 +112,17 @@ class Session
 	  void						  SendChannelAUnreliable(Message* message);
 	  void                        DestroyIncomingMessage(Message* message);
 	  void                        DestroyPacket(Packet* packet);
+
+	  // outbound readiness, hands the session to the socket write thread once it has something to send
+	  void                        SignalWriteThread(void);
+	  void                        WriteThreadDone(void);
+	  bool                        HasPendingWrite(void);
 	  
 	  
 	  // Accessor methods
 	  NetworkClient*              getClient(void)                                 { return mClient; }
 	  Service*                    getService(void)                                { return mService; }
+	  SocketReadThread*           getSocketReadThread(void)                       { return mSocketReadThread; }
 	  uint32                      getId(void)                                     { return mId; }
 	  uint32                      getAddress(void)                                { return mAddress; }
 	  int8*                       getAddressString(void);
@@ -121,9 +140,14 @@ class Session
 	  bool                        getInOutgoingQueue(void)                        { return mInOutgoingQueue; }
 	  bool                        getInIncomingQueue(void)                        { return mInIncomingQueue; }
 	  uint32					  getResendWindowSize()							  { return mWindowResendSize; }
+	  uint32					  getWindowSize()								  { return mWindowSizeCurrent; }
+	  uint32					  getSmoothedRoundtripTime()					  { return mSmoothedRoundtripTime; }
+	  uint32					  getRetransmitTimeout()						  { return mRetransmitTimeout; }
+	  uint64					  getPacketsResent()							  { return mPacketsResent; }
+	  uint64					  getPacketsFastResent()						  { return mPacketsFastResent; }
 
 
-	  void						  setResendWindowSize(uint32 resendWindowSize)	  { mWindowResendSize = resendWindowSize;  mWindowSizeCurrent = resendWindowSize; }
+	  void						  setResendWindowSize(uint32 resendWindowSize);
 	  void                        setClient(NetworkClient* client)                { mClient = client; }
 	  void                        setService(Service* service)                    { mService = service; }
 	  void                        setSocketReadThread(SocketReadThread* thread)   { mSocketReadThread = thread; }
@@ -183,7 +207,13 @@ private:
 	  void                        _buildOutgoingUnreliablePackets(Message* message);
 	  void                        _addOutgoingReliablePacket(Packet* packet);
 	  void                        _addOutgoingUnreliablePacket(Packet* packet);
-	  void                        _resendOutgoingPackets(void);
+	  void                        _resendOutgoingPackets(uint64 now);
+	  void                        _fastResendOutgoingPackets(uint16 sequence, uint16 bottomSequence);
+	  bool                        _resendPacket(Packet* packet, uint64 now, uint64 minAge);
+
+	  void                        _updateRoundtripTime(uint32 sample);
+	  void                        _growWindow(uint32 ackedPackets);
+	  void                        _shrinkWindow(bool timeout);
 	  void                        _sendPingPacket(void);
 
 	  void						  _handleOutSequenceRollover();
@@ -250,11 +280,21 @@ private:
 	  bool						  mOutSequenceRollover;
 	  uint16                      mNextPacketSequenceSent;
 	  uint64                      mLastRemotePacketAckReceived;
-	  uint32                      mWindowSizeCurrent;		//amount of packets we want to send in one round
-	  uint32                      mWindowResendSize;	    //
+	  uint32                      mWindowSizeCurrent;		//congestion window, amount of packets we allow to be send and not yet acknowledged
+	  uint32                      mWindowResendSize;	    //upper bound of the window (ServerPacketWindowSize / ClientPacketWindowSize)
+	  uint32                      mSlowStartThreshold;		//below it the window grows by every acked packet, above it by one packet per window
+	  uint32                      mWindowAckCredit;			//acked packets counting towards the next additive increase
+	  uint64                      mLastWindowReduction;		//we shrink at most once per roundtrip
+
+	  // Retransmission timeout estimation (RFC 6298), sampled from never resent packets only
+	  uint32                      mSmoothedRoundtripTime;
+	  uint32                      mRoundtripTimeVariance;
+	  uint32                      mRetransmitTimeout;
+	  uint64                      mPacketsResent;			//timed out
+	  uint64                      mPacketsFastResent;		//reported missing by an out of order packet
 
 	  bool                        mSendDelayedAck;        // We processed some incoming packets, send an ack
-	  bool                        mInOutgoingQueue;       // Are we already in the queue?
+	  bool                        mInOutgoingQueue;       // Are we already in the write threads ready queue?
 	  bool                        mInIncomingQueue;       // Are we already in the queue?
 
 	  uint16                      mLastSequenceAcked;
@@ -54,6 +54,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #define socklen_t int
 #else
 #include <sys/socket.h>
+#include <netinet/in.h>
 #include <arpa/inet.h>
 
 #define INVALID_SOCKET	-1
@@ -61,6 +62,14 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #define closesocket		close
 #endif
 
+// recvmmsg is available on linux 2.6.33+ / glibc 2.12+, everywhere else we fall back to one recvfrom per datagram
+#if(ANH_PLATFORM == ANH_PLATFORM_LINUX) && defined(MSG_WAITFORONE)
+#define ANH_HAVE_RECVMMSG
+#if defined(SO_MEMINFO)
+#include <linux/sock_diag.h>
+#endif
+#endif
+
 //======================================================================================================================
 
 SocketReadThread::SocketReadThread(SOCKET socket, SocketWriteThread* writeThread, Service* service,uint32 mfHeapSize, bool serverservice) :
@@ -70,7 +79,19 @@ mSessionFactory(0),
 mPacketFactory(0),
 mCompCryptor(0),
 mSocket(0),
-mIsRunning(false)
+mIsRunning(false),
+mReceiveRing(0),
+mReceiveSessions(0),
+mReceiveHeaders(0),
+mReceiveVectors(0),
+mReceiveAddresses(0),
+mReceiveBatchSize(1),
+mReceiveCalls(0),
+mReceivedPackets(0),
+mLastStatsReport(0),
+mPacketsPerReceiveCall(0.0f),
+mReceiveQueueDepth(0),
+mReceiveQueueDepthMax(0)
 {
 	if(serverservice)
 	{
@@ -102,6 +123,33 @@ mIsRunning(false)
 	mReceivePacket = mPacketFactory->CreatePacket();
 	mDecompressPacket = mPacketFactory->CreatePacket();
 
+#if defined(ANH_HAVE_RECVMMSG)
+	// Preallocate the receive ring for batched reads. The headers and addresses stay fixed,
+	// only the iovecs get repointed when a ring packet has been handed over to a session.
+	mReceiveBatchSize	= gNetConfig->getReceiveBatchSize();
+
+	if(mReceiveBatchSize > 1)
+	{
+		mReceiveRing		= new Packet*[mReceiveBatchSize];
+		mReceiveSessions	= new Session*[mReceiveBatchSize];
+		mReceiveHeaders		= new mmsghdr[mReceiveBatchSize];
+		mReceiveVectors		= new iovec[mReceiveBatchSize];
+		mReceiveAddresses	= new sockaddr_in[mReceiveBatchSize];
+
+		memset(mReceiveHeaders, 0, sizeof(mmsghdr) * mReceiveBatchSize);
+
+		for(uint32 i = 0; i < mReceiveBatchSize; i++)
+		{
+			mReceiveRing[i]		= mPacketFactory->CreatePacket();
+			mReceiveSessions[i]	= 0;
+
+			mReceiveHeaders[i].msg_hdr.msg_name		= &mReceiveAddresses[i];
+			mReceiveHeaders[i].msg_hdr.msg_iov		= &mReceiveVectors[i];
+			mReceiveHeaders[i].msg_hdr.msg_iovlen	= 1;
+		}
+	}
+#endif
+
 	// start our thread
     boost::thread t(std::tr1::bind(&SocketReadThread::run, this));
     mThread = boost::move(t);
@@ -120,6 +168,15 @@ SocketReadThread::~SocketReadThread()
     mThread.interrupt();
     mThread.join();
 
+#if defined(ANH_HAVE_RECVMMSG)
+	// the ring packets go down with the packet pool
+	delete [] mReceiveRing;
+	delete [] mReceiveSessions;
+	delete [] mReceiveHeaders;
+	delete [] mReceiveVectors;
+	delete [] mReceiveAddresses;
+#endif
+
 	delete mPacketFactory;
 	delete mSessionFactory;
 	
@@ -132,25 +189,18 @@ SocketReadThread::~SocketReadThread()
 
 void SocketReadThread::run(void)
 {
-	struct sockaddr_in  from;
-	uint32              address, fromLen = sizeof(from), count;
-	int16               recvLen;
-	uint16              port, decompressLen;
-	Session*            session;
-	fd_set              socketSet;
-	struct              timeval tv;
-
-	FD_ZERO(&socketSet);
-
 	// Call our internal _startup method
 	_startup();
 
+	mLastStatsReport = Anh_Utils::Clock::getSingleton()->getStoredTime();
+
 	while(!mExit)
 	{
 		// Check to see if *WE* are about to connect to a remote server 
 		if(mNewConnection.mPort != 0)
 		{
 			Session* newSession = mSessionFactory->CreateSession();
+			newSession->setSocketReadThread(this);
 			newSession->setCommand(SCOM_Connect);
 			newSession->setAddress(inet_addr(mNewConnection.mAddress));
 			newSession->setPort(htons(mNewConnection.mPort));
@@ -168,276 +218,508 @@ void SocketReadThread::run(void)
 			mSocketWriteThread->NewSession(newSession);
 		}
 
-		// Reset our internal members so we can use the packet again.
-		mReceivePacket->Reset();
-		mDecompressPacket->Reset();
-
-		// Build a new fd_set structure
-		FD_SET(mSocket, &socketSet);
+		bool morePending = false;
 
-		// We're going to block for 250ms.
-		tv.tv_sec   = 0;
-		tv.tv_usec  = 250;
+		if(mReceiveBatchSize > 1)
+		{
+			morePending = _receiveBatch();
+		}
+		else
+		{
+			_receiveSingle();
+		}
 
-		count = select(mSocket, &socketSet, 0, 0, &tv);
+		if(Anh_Utils::Clock::getSingleton()->getStoredTime() - mLastStatsReport > RECEIVE_STATS_INTERVAL)
+		{
+			_reportReceiveStats();
+		}
 
-		if(count && FD_ISSET(mSocket, &socketSet))
+		// a full batch means the socket buffer is backing up, go right back to reading
+		if(!morePending)
 		{
-			// Read any incoming packets.
-			recvLen = recvfrom(mSocket, mReceivePacket->getData(),(int) mMessageMaxSize, 0, (sockaddr*)&from, reinterpret_cast<socklen_t*>(&fromLen));
+			boost::this_thread::sleep(boost::posix_time::microseconds(10));
+		}
+	}
 
-			if(recvLen <= 0)
-			{
-				int	errorNr = 0;
+	// Shutdown internally
+	_shutdown();
+}
+
+//======================================================================================================================
+
+void SocketReadThread::_receiveSingle(void)
+{
+	struct sockaddr_in  from;
+	uint32              fromLen = sizeof(from), count;
+	int16               recvLen;
+	fd_set              socketSet;
+	struct              timeval tv;
+
+	// Reset our internal members so we can use the packet again.
+	mReceivePacket->Reset();
+	mDecompressPacket->Reset();
+
+	// Build a new fd_set structure
+	FD_ZERO(&socketSet);
+	FD_SET(mSocket, &socketSet);
+
+	// We're going to block for 250ms.
+	tv.tv_sec   = 0;
+	tv.tv_usec  = 250;
+
+	count = select(mSocket + 1, &socketSet, 0, 0, &tv);
+
+	if(!count || !FD_ISSET(mSocket, &socketSet))
+	{
+		return;
+	}
+
+	// Read any incoming packets.
+	recvLen = recvfrom(mSocket, mReceivePacket->getData(),(int) mMessageMaxSize, 0, (sockaddr*)&from, reinterpret_cast<socklen_t*>(&fromLen));
+
+	if(recvLen <= 0)
+	{
+		int	errorNr = 0;
 #if(ANH_PLATFORM == ANH_PLATFORM_WIN32)
 
-				errorNr = WSAGetLastError();
+		errorNr = WSAGetLastError();
 
-				char	errorMsg[512];
+		char	errorMsg[512];
 
-				if(FormatMessage(FORMAT_MESSAGE_FROM_SYSTEM, NULL, errorNr, MAKELANGID(LANG_NEUTRAL,SUBLANG_DEFAULT),(LPTSTR)errorMsg, (sizeof(errorMsg) / sizeof(TCHAR)) - 1, NULL))
-				{
-					gLogger->log(LogManager::WARNING, "Error(recvFrom): %s",errorMsg);
-				}
-				else
-				{
-					gLogger->log(LogManager::WARNING, "Error(recvFrom): %i",errorNr);
-				}
-					
+		if(FormatMessage(FORMAT_MESSAGE_FROM_SYSTEM, NULL, errorNr, MAKELANGID(LANG_NEUTRAL,SUBLANG_DEFAULT),(LPTSTR)errorMsg, (sizeof(errorMsg) / sizeof(TCHAR)) - 1, NULL))
+		{
+			gLogger->log(LogManager::WARNING, "Error(recvFrom): %s",errorMsg);
+		}
+		else
+		{
+			gLogger->log(LogManager::WARNING, "Error(recvFrom): %i",errorNr);
+		}
+			
 #elif(ANH_PLATFORM == ANH_PLATFORM_LINUX)
 
-				errorNr = recvLen;
+		errorNr = recvLen;
 
 #endif
-				continue;
-			}
+		return;
+	}
 
-			if(recvLen > mMessageMaxSize)
-			{
-				gLogger->log(LogManager::NOTICE, "Socket Read Thread Received Size > mMessageMaxSize: %u", recvLen);
-			}
+	mReceiveCalls++;
+	mReceivedPackets++;
 
-			// Get our remote Address and port
-			address		= from.sin_addr.s_addr;
-			port		= from.sin_port;
+	if(recvLen > mMessageMaxSize)
+	{
+		gLogger->log(LogManager::NOTICE, "Socket Read Thread Received Size > mMessageMaxSize: %u", recvLen);
+	}
+
+	// Get our remote Address and port
+	uint32 address	= from.sin_addr.s_addr;
+	uint16 port		= from.sin_port;
 
-			uint64 hash = address | (((uint64)port) << 32);
+	uint64 hash = address | (((uint64)port) << 32);
 
-			// Grab our packet type
-			mReceivePacket->Reset();           // Reset our internal members so we can use the packet again.
-			mReceivePacket->setSize(recvLen); // crc is subtracted by the decryption
+	// Grab our packet type
+	mReceivePacket->Reset();           // Reset our internal members so we can use the packet again.
+	mReceivePacket->setSize(recvLen); // crc is subtracted by the decryption
 
-			uint8  packetTypeLow	= mReceivePacket->peekUint8();
-			uint16 packetType		= mReceivePacket->getUint16();
+	uint8  packetTypeLow	= mReceivePacket->peekUint8();
+	uint16 packetType		= mReceivePacket->getUint16();
 
-			boost::mutex::scoped_lock lk(mSocketReadMutex);
+	boost::mutex::scoped_lock lk(mSocketReadMutex);
+
+	Session* session = _getSession(hash, address, port, packetType);
+
+	lk.unlock();
+
+	if(session)
+	{
+		_handlePacket(session, recvLen, packetType, packetTypeLow);
+	}
+}
+
+//======================================================================================================================
+//
+// pulls up to mReceiveBatchSize datagrams with a single recvmmsg call and resolves their sessions under one lock
+// returns true when the batch came back full, ie there is likely more waiting on the socket
+//
+
+bool SocketReadThread::_receiveBatch(void)
+{
+#if defined(ANH_HAVE_RECVMMSG)
+	fd_set              socketSet;
+	struct              timeval tv;
+
+	FD_ZERO(&socketSet);
+	FD_SET(mSocket, &socketSet);
 
-			AddressSessionMap::iterator i = mAddressSessionMap.find(hash);
+	tv.tv_sec   = 0;
+	tv.tv_usec  = 250;
 
-			if(i != mAddressSessionMap.end())
+	if(select(mSocket + 1, &socketSet, 0, 0, &tv) <= 0 || !FD_ISSET(mSocket, &socketSet))
+	{
+		return false;
+	}
+
+	for(uint32 i = 0; i < mReceiveBatchSize; i++)
+	{
+		mReceiveRing[i]->Reset();
+
+		mReceiveVectors[i].iov_base				= mReceiveRing[i]->getData();
+		mReceiveVectors[i].iov_len				= mMessageMaxSize;
+		mReceiveHeaders[i].msg_hdr.msg_namelen	= sizeof(sockaddr_in);
+		mReceiveHeaders[i].msg_len				= 0;
+	}
+
+	int received = recvmmsg(mSocket, mReceiveHeaders, mReceiveBatchSize, MSG_DONTWAIT, 0);
+
+	if(received <= 0)
+	{
+		return false;
+	}
+
+	mReceiveCalls++;
+	mReceivedPackets += received;
+
+	// Resolve the sessions for the whole batch in one go. Consecutive datagrams usually come
+	// from the same remote, so remember the last hit and skip the map lookup for it.
+	{
+		boost::mutex::scoped_lock lk(mSocketReadMutex);
+
+		uint64		lastHash	= 0;
+		Session*	lastSession	= 0;
+
+		for(int i = 0; i < received; i++)
+		{
+			mReceiveSessions[i] = 0;
+
+			if(mReceiveHeaders[i].msg_len == 0)
 			{
-				session = (*i).second;
+				continue;
 			}
-			else
+
+			uint32 address	= mReceiveAddresses[i].sin_addr.s_addr;
+			uint16 port		= mReceiveAddresses[i].sin_port;
+			uint64 hash		= address | (((uint64)port) << 32);
+
+			if(lastSession && hash == lastHash)
 			{
-				// We should only be creating a new session if it's a session request packet
-				if(packetType == SESSIONOP_SessionRequest)
-				{
-					session = mSessionFactory->CreateSession();
-					session->setSocketReadThread(this);
-					session->setPacketFactory(mPacketFactory);
-					session->setAddress(address);  // Store the address and port in network order so we don't have to
-					session->setPort(port);  // convert them all the time.  Only convert for humans.
-					session->setResendWindowSize(mSessionResendWindowSize);
-
-					// Insert the session into our address map and process list
-					mAddressSessionMap.insert(std::make_pair(hash, session));
-					mSocketWriteThread->NewSession(session);
-					session->mHash = hash;
-
-					gLogger->log(LogManager::DEBUG, "Added Service %i: New Session(%s, %u), AddressMap: %i",mSessionFactory->getService()->getId(), inet_ntoa(from.sin_addr), ntohs(session->getPort()), mAddressSessionMap.size());
-				}
-				else
-				{
-					gLogger->log(LogManager::WARNING, "Socket Read Thread Session not found. Type:0x%.4x", packetType);
+				mReceiveSessions[i] = lastSession;
+				continue;
+			}
 
-					lk.unlock();
+			mReceiveSessions[i] = _getSession(hash, address, port, *((uint16*)mReceiveRing[i]->getData()));
 
-					continue;
-				}
+			if(mReceiveSessions[i])
+			{
+				lastHash	= hash;
+				lastSession	= mReceiveSessions[i];
 			}
+		}
+	}
 
-			lk.unlock();
+	// mReceivePacket is borrowed for every ring slot, _handlePacket replaces it once a session took the packet
+	Packet* receivePacket = mReceivePacket;
 
-			// I don't like any of the code below, but it's going to take me a bit to work out a good way to handle decompression
-			// and decryption.  It's dependent on session layer protocol information, which should not be looked at here.  Should
-			// be placed in Session, though I'm not sure how or where yet.
-			// Set the size of the packet
+	for(int i = 0; i < received; i++)
+	{
+		if(!mReceiveSessions[i])
+		{
+			continue;
+		}
 
-			// Validate our date header.  If it's not a valid header, drop it.
-			if(packetType > 0x00ff && (packetType & 0x00ff) == 0 && session != NULL)
-			{
-				switch(packetType)
-				{
-					case SESSIONOP_Disconnect:
-					case SESSIONOP_DataAck1:
-					case SESSIONOP_DataAck2:
-					case SESSIONOP_DataAck3:
-					case SESSIONOP_DataAck4:
-					case SESSIONOP_DataOrder1:
-					case SESSIONOP_DataOrder2:
-					case SESSIONOP_DataOrder3:
-					case SESSIONOP_DataOrder4:
-					case SESSIONOP_Ping:
-					{
-						// Before we do anything else, check the CRC.
-						uint32 packetCrc = mCompCryptor->GenerateCRC(mReceivePacket->getData(), recvLen - 2, session->getEncryptKey());  // - 2 crc
-
-						uint8 crcLow  = (uint8)*(mReceivePacket->getData() + recvLen - 1);
-						uint8 crcHigh = (uint8)*(mReceivePacket->getData() + recvLen - 2);
-
-						if (crcLow != (uint8)packetCrc || crcHigh != (uint8)(packetCrc >> 8))
-						{
-							// CRC mismatch.  Dropping packet.
-							//gLogger->hexDump(mReceivePacket->getData(),mReceivePacket->getSize());
-							gLogger->log(LogManager::DEBUG, "DIS/ACK/ORDER/PING dropped.");
-							continue;
-						}
-
-						// Decrypt the packet
-						mCompCryptor->Decrypt(mReceivePacket->getData() + 2, recvLen - 4, session->getEncryptKey());
-
-						// Send the packet to the session.
-						session->HandleSessionPacket(mReceivePacket);
-						mReceivePacket = mPacketFactory->CreatePacket();
-					}
-					break;
+		int16 recvLen = (int16)mReceiveHeaders[i].msg_len;
 
-					case SESSIONOP_MultiPacket:
-					case SESSIONOP_NetStatRequest:
-					case SESSIONOP_NetStatResponse:
-					case SESSIONOP_DataChannel1:
-					case SESSIONOP_DataChannel2:
-					case SESSIONOP_DataChannel3:
-					case SESSIONOP_DataChannel4:
-					case SESSIONOP_DataFrag1:
-					case SESSIONOP_DataFrag2:
-					case SESSIONOP_DataFrag3:
-					case SESSIONOP_DataFrag4:
-					{
-						// Before we do anything else, check the CRC.
-						uint32 packetCrc = mCompCryptor->GenerateCRC(mReceivePacket->getData(), recvLen - 2, session->getEncryptKey());
-
-						uint8 crcLow  = (uint8)*(mReceivePacket->getData() + recvLen - 1);
-						uint8 crcHigh = (uint8)*(mReceivePacket->getData() + recvLen - 2);
-
-						if (crcLow != (uint8)packetCrc || crcHigh != (uint8)(packetCrc >> 8))
-						{
-							// CRC mismatch.  Dropping packet.
-
-							gLogger->log(LogManager::NOTICE, "Socket Read Thread: Reliable Packet dropped. %X CRC mismatch.", packetType);
-							mCompCryptor->Decrypt(mReceivePacket->getData() + 2, recvLen - 4, session->getEncryptKey());  // don't hardcode the header buffer or CRC len.
-							continue;
-						}
-
-						// Decrypt the packet
-						mCompCryptor->Decrypt(mReceivePacket->getData() + 2, recvLen - 4, session->getEncryptKey());  // don't hardcode the header buffer or CRC len.
-
-						// Decompress the packet
-						decompressLen = mCompCryptor->Decompress(mReceivePacket->getData() + 2, recvLen - 5, mDecompressPacket->getData() + 2, mDecompressPacket->getMaxPayload() - 5);
-
-						if(decompressLen > 0)
-						{
-							mDecompressPacket->setIsCompressed(true);
-							mDecompressPacket->setSize(decompressLen + 2); // add the packet header size
-							*((uint16*)(mDecompressPacket->getData())) = *((uint16*)mReceivePacket->getData());
-							session->HandleSessionPacket(mDecompressPacket);
-							mDecompressPacket = mPacketFactory->CreatePacket();
-
-							break;
-						}
-						else 
-						{
-							// we have to remove comp/crc
-							mReceivePacket->setSize(mReceivePacket->getSize() - 3);
-						}
-					}
-
-					case SESSIONOP_SessionRequest:
-					case SESSIONOP_SessionResponse:
-					case SESSIONOP_FatalError:
-					case SESSIONOP_FatalErrorResponse:
-					//case SESSIONOP_Reset:
-					{
-						// Send the packet to the session.
-
-						session->HandleSessionPacket(mReceivePacket);
-						mReceivePacket = mPacketFactory->CreatePacket();
-					}
-					break;
+		if(recvLen > mMessageMaxSize)
+		{
+			gLogger->log(LogManager::NOTICE, "Socket Read Thread Received Size > mMessageMaxSize: %u", recvLen);
+		}
 
-					default:
-					{
-						gLogger->log(LogManager::NOTICE, "SocketReadThread: Dont know what todo with this packet! --tmr <3");
-					}
-					break;
+		mReceivePacket = mReceiveRing[i];
+		mReceivePacket->setSize(recvLen);
+		mDecompressPacket->Reset();
 
-				} //end switch(sessionOp)
-			}
-			// Validate that our data is actually fastpath
-			else if(packetTypeLow < 0x0d && session != NULL) // highest fastpath I've seen is 0x0b -tmr
+		uint8  packetTypeLow	= mReceivePacket->peekUint8();
+		uint16 packetType		= mReceivePacket->getUint16();
+
+		_handlePacket(mReceiveSessions[i], recvLen, packetType, packetTypeLow);
+
+		mReceiveRing[i] = mReceivePacket;
+	}
+
+	mReceivePacket = receivePacket;
+
+	if((uint32)received == mReceiveBatchSize)
+	{
+		_sampleReceiveQueueDepth();
+		return true;
+	}
+#endif
+
+	return false;
+}
+
+//======================================================================================================================
+//
+// looks up the session for a remote, creates it on a session request
+// must be called with mSocketReadMutex held
+//
+
+Session* SocketReadThread::_getSession(uint64 hash, uint32 address, uint16 port, uint16 packetType)
+{
+	AddressSessionMap::iterator i = mAddressSessionMap.find(hash);
+
+	if(i != mAddressSessionMap.end())
+	{
+		return (*i).second;
+	}
+
+	// We should only be creating a new session if it's a session request packet
+	if(packetType != SESSIONOP_SessionRequest)
+	{
+		gLogger->log(LogManager::WARNING, "Socket Read Thread Session not found. Type:0x%.4x", packetType);
+		return NULL;
+	}
+
+	Session* session = mSessionFactory->CreateSession();
+	session->setSocketReadThread(this);
+	session->setPacketFactory(mPacketFactory);
+	session->setAddress(address);  // Store the address and port in network order so we don't have to
+	session->setPort(port);  // convert them all the time.  Only convert for humans.
+	session->setResendWindowSize(mSessionResendWindowSize);
+
+	// Insert the session into our address map and process list
+	mAddressSessionMap.insert(std::make_pair(hash, session));
+	mSocketWriteThread->NewSession(session);
+	session->mHash = hash;
+
+	if(gLogger->isLogged(LogManager::DEBUG))
+		gLogger->log(LogManager::DEBUG, "Added Service %i: New Session(%s, %u), AddressMap: %i",mSessionFactory->getService()->getId(), inet_ntoa(*((in_addr*)(&address))), ntohs(session->getPort()), mAddressSessionMap.size());
+
+	return session;
+}
+
+//======================================================================================================================
+//
+// validates, decrypts and decompresses mReceivePacket and hands it to the session
+// whenever the session keeps a packet, a fresh one is put in its place
+//
+
+void SocketReadThread::_handlePacket(Session* session, int16 recvLen, uint16 packetType, uint8 packetTypeLow)
+{
+	uint16 decompressLen;
+
+	// I don't like any of the code below, but it's going to take me a bit to work out a good way to handle decompression
+	// and decryption.  It's dependent on session layer protocol information, which should not be looked at here.  Should
+	// be placed in Session, though I'm not sure how or where yet.
+	// Set the size of the packet
+
+	// Validate our date header.  If it's not a valid header, drop it.
+	if(packetType > 0x00ff && (packetType & 0x00ff) == 0 && session != NULL)
+	{
+		switch(packetType)
+		{
+			case SESSIONOP_Disconnect:
+			case SESSIONOP_DataAck1:
+			case SESSIONOP_DataAck2:
+			case SESSIONOP_DataAck3:
+			case SESSIONOP_DataAck4:
+			case SESSIONOP_DataOrder1:
+			case SESSIONOP_DataOrder2:
+			case SESSIONOP_DataOrder3:
+			case SESSIONOP_DataOrder4:
+			case SESSIONOP_Ping:
 			{
 				// Before we do anything else, check the CRC.
-				uint32	packetCrc	= mCompCryptor->GenerateCRC(mReceivePacket->getData(), recvLen - 2, session->getEncryptKey());
-				uint8	crcLow		= (uint8)*(mReceivePacket->getData() + recvLen - 1);
-				uint8	crcHigh		= (uint8)*(mReceivePacket->getData() + recvLen - 2);
+				uint32 packetCrc = mCompCryptor->GenerateCRC(mReceivePacket->getData(), recvLen - 2, session->getEncryptKey());  // - 2 crc
+
+				uint8 crcLow  = (uint8)*(mReceivePacket->getData() + recvLen - 1);
+				uint8 crcHigh = (uint8)*(mReceivePacket->getData() + recvLen - 2);
 
-				if(crcLow != (uint8)packetCrc || crcHigh != (uint8)(packetCrc >> 8))
+				if (crcLow != (uint8)packetCrc || crcHigh != (uint8)(packetCrc >> 8))
 				{
 					// CRC mismatch.  Dropping packet.
-					gLogger->log(LogManager::NOTICE, "Packet dropped.  CRC mismatch.");
-					continue;
+					//gLogger->hexDump(mReceivePacket->getData(),mReceivePacket->getSize());
+					gLogger->log(LogManager::DEBUG, "DIS/ACK/ORDER/PING dropped.");
+					return;
 				}
 
-				// It's a 'fastpath' packet.  Send it directly up the data channel
-				mCompCryptor->Decrypt(mReceivePacket->getData() + 1, recvLen - 3, session->getEncryptKey());  // don't hardcode the header buffer or CRc len.
+				// Decrypt the packet
+				mCompCryptor->Decrypt(mReceivePacket->getData() + 2, recvLen - 4, session->getEncryptKey());
 
-				// Decompress the packet
-				decompressLen	= 0;
-				uint8 compFlag	= (uint8)*(mReceivePacket->getData() + recvLen - 3);
+				// Send the packet to the session.
+				session->HandleSessionPacket(mReceivePacket);
+				mReceivePacket = mPacketFactory->CreatePacket();
+			}
+			break;
+
+			case SESSIONOP_MultiPacket:
+			case SESSIONOP_NetStatRequest:
+			case SESSIONOP_NetStatResponse:
+			case SESSIONOP_DataChannel1:
+			case SESSIONOP_DataChannel2:
+			case SESSIONOP_DataChannel3:
+			case SESSIONOP_DataChannel4:
+			case SESSIONOP_DataFrag1:
+			case SESSIONOP_DataFrag2:
+			case SESSIONOP_DataFrag3:
+			case SESSIONOP_DataFrag4:
+			{
+				// Before we do anything else, check the CRC.
+				uint32 packetCrc = mCompCryptor->GenerateCRC(mReceivePacket->getData(), recvLen - 2, session->getEncryptKey());
+
+				uint8 crcLow  = (uint8)*(mReceivePacket->getData() + recvLen - 1);
+				uint8 crcHigh = (uint8)*(mReceivePacket->getData() + recvLen - 2);
 
-				if(compFlag == 1)
+				if (crcLow != (uint8)packetCrc || crcHigh != (uint8)(packetCrc >> 8))
 				{
-					decompressLen = mCompCryptor->Decompress(mReceivePacket->getData() + 1, recvLen - 4, mDecompressPacket->getData() + 1, mDecompressPacket->getMaxPayload() - 4);
+					// CRC mismatch.  Dropping packet.
+
+					gLogger->log(LogManager::NOTICE, "Socket Read Thread: Reliable Packet dropped. %X CRC mismatch.", packetType);
+					mCompCryptor->Decrypt(mReceivePacket->getData() + 2, recvLen - 4, session->getEncryptKey());  // don't hardcode the header buffer or CRC len.
+					return;
 				}
 
+				// Decrypt the packet
+				mCompCryptor->Decrypt(mReceivePacket->getData() + 2, recvLen - 4, session->getEncryptKey());  // don't hardcode the header buffer or CRC len.
+
+				// Decompress the packet
+				decompressLen = mCompCryptor->Decompress(mReceivePacket->getData() + 2, recvLen - 5, mDecompressPacket->getData() + 2, mDecompressPacket->getMaxPayload() - 5);
+
 				if(decompressLen > 0)
 				{
 					mDecompressPacket->setIsCompressed(true);
-					mDecompressPacket->setSize(decompressLen + 1); // add the packet header size
-
-					*((uint8*)(mDecompressPacket->getData())) = *((uint8*)mReceivePacket->getData());
-
-					// send the packet up the stack
-					session->HandleFastpathPacket(mDecompressPacket);
+					mDecompressPacket->setSize(decompressLen + 2); // add the packet header size
+					*((uint16*)(mDecompressPacket->getData())) = *((uint16*)mReceivePacket->getData());
+					session->HandleSessionPacket(mDecompressPacket);
 					mDecompressPacket = mPacketFactory->CreatePacket();
+
+					break;
 				}
-				else
+				else 
 				{
-					// send the packet up the stack, remove comp/crc
+					// we have to remove comp/crc
 					mReceivePacket->setSize(mReceivePacket->getSize() - 3);
-
-					session->HandleFastpathPacket(mReceivePacket);
-					mReceivePacket = mPacketFactory->CreatePacket();
 				}
 			}
+
+			case SESSIONOP_SessionRequest:
+			case SESSIONOP_SessionResponse:
+			case SESSIONOP_FatalError:
+			case SESSIONOP_FatalErrorResponse:
+			//case SESSIONOP_Reset:
+			{
+				// Send the packet to the session.
+
+				session->HandleSessionPacket(mReceivePacket);
+				mReceivePacket = mPacketFactory->CreatePacket();
+			}
+			break;
+
+			default:
+			{
+				gLogger->log(LogManager::NOTICE, "SocketReadThread: Dont know what todo with this packet! --tmr <3");
+			}
+			break;
+
+		} //end switch(sessionOp)
+	}
+	// Validate that our data is actually fastpath
+	else if(packetTypeLow < 0x0d && session != NULL) // highest fastpath I've seen is 0x0b -tmr
+	{
+		// Before we do anything else, check the CRC.
+		uint32	packetCrc	= mCompCryptor->GenerateCRC(mReceivePacket->getData(), recvLen - 2, session->getEncryptKey());
+		uint8	crcLow		= (uint8)*(mReceivePacket->getData() + recvLen - 1);
+		uint8	crcHigh		= (uint8)*(mReceivePacket->getData() + recvLen - 2);
+
+		if(crcLow != (uint8)packetCrc || crcHigh != (uint8)(packetCrc >> 8))
+		{
+			// CRC mismatch.  Dropping packet.
+			gLogger->log(LogManager::NOTICE, "Packet dropped.  CRC mismatch.");
+			return;
+		}
+
+		// It's a 'fastpath' packet.  Send it directly up the data channel
+		mCompCryptor->Decrypt(mReceivePacket->getData() + 1, recvLen - 3, session->getEncryptKey());  // don't hardcode the header buffer or CRc len.
+
+		// Decompress the packet
+		decompressLen	= 0;
+		uint8 compFlag	= (uint8)*(mReceivePacket->getData() + recvLen - 3);
+
+		if(compFlag == 1)
+		{
+			decompressLen = mCompCryptor->Decompress(mReceivePacket->getData() + 1, recvLen - 4, mDecompressPacket->getData() + 1, mDecompressPacket->getMaxPayload() - 4);
 		}
 
-		boost::this_thread::sleep(boost::posix_time::microseconds(10));
+		if(decompressLen > 0)
+		{
+			mDecompressPacket->setIsCompressed(true);
+			mDecompressPacket->setSize(decompressLen + 1); // add the packet header size
+
+			*((uint8*)(mDecompressPacket->getData())) = *((uint8*)mReceivePacket->getData());
+
+			// send the packet up the stack
+			session->HandleFastpathPacket(mDecompressPacket);
+			mDecompressPacket = mPacketFactory->CreatePacket();
+		}
+		else
+		{
+			// send the packet up the stack, remove comp/crc
+			mReceivePacket->setSize(mReceivePacket->getSize() - 3);
+
+			session->HandleFastpathPacket(mReceivePacket);
+			mReceivePacket = mPacketFactory->CreatePacket();
+		}
 	}
+}
 
-	// Shutdown internally
-	_shutdown();
+//======================================================================================================================
+//
+// samples the amount of bytes waiting in the socket receive buffer
+//
+
+void SocketReadThread::_sampleReceiveQueueDepth(void)
+{
+#if defined(ANH_HAVE_RECVMMSG) && defined(SO_MEMINFO)
+	uint32		memInfo[SK_MEMINFO_VARS];
+	socklen_t	memInfoLen = sizeof(memInfo);
+
+	if(getsockopt(mSocket, SOL_SOCKET, SO_MEMINFO, memInfo, &memInfoLen) == 0)
+	{
+		if(memInfo[SK_MEMINFO_RMEM_ALLOC] > mReceiveQueueDepthMax)
+		{
+			mReceiveQueueDepthMax = memInfo[SK_MEMINFO_RMEM_ALLOC];
+		}
+	}
+#endif
+}
+
+//======================================================================================================================
+
+void SocketReadThread::_reportReceiveStats(void)
+{
+	mLastStatsReport = Anh_Utils::Clock::getSingleton()->getStoredTime();
+
+	if(mReceiveCalls)
+	{
+		mPacketsPerReceiveCall = (float)mReceivedPackets / (float)mReceiveCalls;
+	}
+	else
+	{
+		mPacketsPerReceiveCall = 0.0f;
+	}
+
+	mReceiveQueueDepth = mReceiveQueueDepthMax;
+
+	gLogger->log(LogManager::INFORMATION, "Service %i: Socket Read Thread received %"PRIu64" packets in %"PRIu64" calls (%.2f per call, batch %u), receive queue peak %u bytes",
+		mSessionFactory->getService()->getId(), mReceivedPackets, mReceiveCalls, mPacketsPerReceiveCall, mReceiveBatchSize, mReceiveQueueDepth);
+
+	uint32 outstanding = mPacketFactory->getOutstanding();
+
+	gLogger->log(LogManager::INFORMATION, "Service %i: Packet pool %u packets in use, peak %u, %u allocated",
+		mSessionFactory->getService()->getId(), outstanding, mPacketFactory->getHighWaterMark(), mPacketFactory->getCapacity());
+
+	mReceiveCalls			= 0;
+	mReceivedPackets		= 0;
+	mReceiveQueueDepthMax	= 0;
 }
 
 //======================================================================================================================
@@ -35,6 +35,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include <list>
 #include <map>
 
+// interval in ms in which the read thread logs its receive statistics
+#define RECEIVE_STATS_INTERVAL 60000
 	
 //======================================================================================================================
 
@@ -47,6 +49,10 @@ class Session;
 class Service;
 class Packet;
 
+struct mmsghdr;
+struct iovec;
+struct sockaddr_in;
+
 //======================================================================================================================
 
 typedef std::list<Session*>			SessionList;
@@ -82,11 +88,23 @@ class SocketReadThread
 	  bool                          getIsRunning(void)          { return mIsRunning; }
 	  void							requestExit()				{ mExit = true; }
 
+	  // receive statistics, refreshed every RECEIVE_STATS_INTERVAL ms
+	  uint32                        getReceiveBatchSize(void)   { return mReceiveBatchSize; }
+	  float                         getPacketsPerReceiveCall(void) { return mPacketsPerReceiveCall; }
+	  uint32                        getReceiveQueueDepth(void)  { return mReceiveQueueDepth; }
+
 	protected:
 
 	  void                          _startup(void);
 	  void                          _shutdown(void);
 
+	  void                          _receiveSingle(void);
+	  bool                          _receiveBatch(void);
+	  Session*                      _getSession(uint64 hash, uint32 address, uint16 port, uint16 packetType);
+	  void                          _handlePacket(Session* session, int16 recvLen, uint16 packetType, uint8 packetTypeLow);
+	  void                          _sampleReceiveQueueDepth(void);
+	  void                          _reportReceiveStats(void);
+
 	  Packet*                       mReceivePacket;
 	  Packet*                       mDecompressPacket;
 
@@ -106,6 +124,21 @@ class SocketReadThread
       boost::thread 				mThread;
       boost::mutex					mSocketReadMutex;
 	  AddressSessionMap             mAddressSessionMap;
+
+	  // batched receive ring, only used when the platform offers recvmmsg
+	  Packet**                      mReceiveRing;
+	  Session**                     mReceiveSessions;
+	  struct mmsghdr*               mReceiveHeaders;
+	  struct iovec*                 mReceiveVectors;
+	  struct sockaddr_in*           mReceiveAddresses;
+	  uint32                        mReceiveBatchSize;
+
+	  uint64                        mReceiveCalls;
+	  uint64                        mReceivedPackets;
+	  uint64                        mLastStatsReport;
+	  float                         mPacketsPerReceiveCall;
+	  uint32                        mReceiveQueueDepth;
+	  uint32                        mReceiveQueueDepthMax;
 	  
 	  bool							mExit;
 };
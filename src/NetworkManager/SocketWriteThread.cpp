@@ -53,6 +53,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 	#endif
 #else
 #include <sys/socket.h>
+#include <netinet/in.h>
 #include <arpa/inet.h>
 #include <errno.h>
 
@@ -61,30 +62,46 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #define closesocket		close
 #endif
 
+// sendmmsg is available on linux 3.0+ / glibc 2.14+, everywhere else every datagram gets its own sendto
+#if(ANH_PLATFORM == ANH_PLATFORM_LINUX) && defined(MSG_WAITFORONE) && defined(__GLIBC__) && ((__GLIBC__ > 2) || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 14))
+#define ANH_HAVE_SENDMMSG
+#endif
+
 #include <boost/thread/thread.hpp>
 
 //======================================================================================================================
 
 SocketWriteThread::SocketWriteThread(SOCKET socket, Service* service, bool serverservice) :
+mSendHeaders(0),
+mSendVectors(0),
+mSendCount(0),
 mService(0),
 mCompCryptor(0),
 mSocket(0),
-mIsRunning(false)
+mIsRunning(false),
+mLastHousekeeping(0),
+mLastStatsReport(0)
 {
 	mSocket = socket;
 	mService = service;
 
+	int32 compressionLevel;
+
 	if(serverservice)
 	{
 
 		mServerService = true;
 		mMessageMaxSize = gNetConfig->getServerServerReliableSize();
+		mReliablePacketsPerRound = 1000;
+		compressionLevel = gNetConfig->getServerServerCompressionLevel();
 
 	}
 	else
 	{
 		mServerService = false;
 		mMessageMaxSize = gNetConfig->getServerClientReliableSize();
+		mReliablePacketsPerRound = 50;
+		compressionLevel = gNetConfig->getServerClientCompressionLevel();
 	}
 
 
@@ -92,7 +109,33 @@ mIsRunning(false)
 	// mClock = new Anh_Utils::Clock();
 
 	// Create our CompCryptor object.
-	mCompCryptor = new CompCryptor();
+	mCompCryptor = new CompCryptor(compressionLevel, gNetConfig->getCompressionMinSize());
+
+	// Allocate our send batch
+	mSendBatchSize	= gNetConfig->getSendBatchSize();
+	mSendBuffers	= new int8[mSendBatchSize * SEND_BUFFER_SIZE];
+	mSendLengths	= new uint32[mSendBatchSize];
+	mSendAddresses	= new sockaddr_in[mSendBatchSize];
+
+	memset(mSendAddresses, 0, sizeof(sockaddr_in) * mSendBatchSize);
+
+#if defined(ANH_HAVE_SENDMMSG)
+	mSendHeaders	= new mmsghdr[mSendBatchSize];
+	mSendVectors	= new iovec[mSendBatchSize];
+
+	memset(mSendHeaders, 0, sizeof(mmsghdr) * mSendBatchSize);
+
+	for(uint32 i = 0; i < mSendBatchSize; i++)
+	{
+		mSendVectors[i].iov_base				= mSendBuffers + (i * SEND_BUFFER_SIZE);
+		mSendVectors[i].iov_len					= 0;
+
+		mSendHeaders[i].msg_hdr.msg_name		= &mSendAddresses[i];
+		mSendHeaders[i].msg_hdr.msg_namelen		= sizeof(sockaddr_in);
+		mSendHeaders[i].msg_hdr.msg_iov			= &mSendVectors[i];
+		mSendHeaders[i].msg_hdr.msg_iovlen		= 1;
+	}
+#endif
 
 	// start our thread
     boost::thread t(std::tr1::bind(&SocketWriteThread::run, this));
@@ -119,11 +162,22 @@ SocketWriteThread::~SocketWriteThread()
 	// shutdown our thread
 	mExit = true;
 
+	mReadyCondition.notify_one();
+
     mThread.interrupt();
     mThread.join();
 
 	delete mCompCryptor;
 
+	delete [] mSendBuffers;
+	delete [] mSendLengths;
+	delete [] mSendAddresses;
+
+#if defined(ANH_HAVE_SENDMMSG)
+	delete [] mSendHeaders;
+	delete [] mSendVectors;
+#endif
+
 	// delete(mClock);
 }
 
@@ -131,73 +185,83 @@ SocketWriteThread::~SocketWriteThread()
 void SocketWriteThread::run()
 {
 	Session*            session;
-	Packet*             packet;
 
 	// Call our internal _startup method
 	_startup();
-	
-	uint32 packets = 50;
-	if(mServerService)
-		packets = 1000;
 
+	mLastStatsReport = Anh_Utils::Clock::getSingleton()->getStoredTime();
 	
 	// Main loop
 	while(!mExit)
 	{
+		uint64 now = Anh_Utils::Clock::getSingleton()->getLocalTime();
 
-		uint32 sessionCount = mSessionQueue.size();
-
-		for(uint32 i = 0; i < sessionCount; i++)
+		// Every WRITE_HOUSEKEEPING_INTERVAL all sessions get a visit, they need to time out, ping and
+		// process their commands regardless of whether they have anything to send.
+		if(now - mLastHousekeeping >= WRITE_HOUSEKEEPING_INTERVAL)
 		{
-			uint32 packetCount = 0;
-			session = mSessionQueue.pop();
+			mLastHousekeeping = now;
 
-			if(!session)
-				continue;
+			uint32 sessionCount = mSessionQueue.size();
 
-			// Process our session
-			session->ProcessWriteThread();
-
-			// Send any outgoing reliable packets
-			//uint32 rcount = 0;
-
-			while (session->getOutgoingReliablePacketCount())
+			for(uint32 i = 0; i < sessionCount; i++)
 			{
-				packetCount++;
-				if(packetCount > packets)
-					break;
-
-				packet = session->getOutgoingReliablePacket();
-				_sendPacket(packet, session);
+				session = mSessionQueue.pop();
+
+				if(!session)
+					continue;
+
+				// If the session is still in a connected state, Put us back in the queue.
+				if (session->getStatus() != SSTAT_Disconnected)
+				{
+					_processSession(session);
+
+					if(session->HasPendingWrite())
+						session->SignalWriteThread();
+
+					mSessionQueue.push(session);
+				}
+				else if(session->getInOutgoingQueue())
+				{
+					// still sitting in the ready queue, hand it over next round
+					mSessionQueue.push(session);
+				}
+				else
+				{
+					gLogger->log(LogManager::DEBUG, "Socket Write Thread: Destroy Session");
+					
+					session->setStatus(SSTAT_Destroy);
+					mService->AddSessionToProcessQueue(session);
+				}
 			}
+		}
 
+		// Now the sessions that told us they have something to send. Sessions that are left with
+		// work afterwards requeue themselves in WriteThreadDone.
+		uint32 readyCount = mReadySessionQueue.size();
 
-			packetCount = 0;
-			
-			// Send any outgoing unreliable packets
-			//uint32 ucount = 0;
-			while (session->getOutgoingUnreliablePacketCount())
-			{
-				
-				packet = session->getOutgoingUnreliablePacket();
-				_sendPacket(packet, session);
-				session->DestroyPacket(packet);
-			}
+		for(uint32 i = 0; i < readyCount; i++)
+		{
+			session = mReadySessionQueue.pop();
 
+			if(!session)
+				continue;
 
-			// If the session is still in a connected state, Put us back in the queue.
-			if (session->getStatus() != SSTAT_Disconnected)
+			if(session->getStatus() != SSTAT_Disconnected)
 			{
-				mSessionQueue.push(session);
-			}
-			else
-			{
-				gLogger->log(LogManager::DEBUG, "Socket Write Thread: Destroy Session");
-				
-				session->setStatus(SSTAT_Destroy);
-				mService->AddSessionToProcessQueue(session);
+				_processSession(session);
 			}
+
+			session->WriteThreadDone();
 		}
+
+		_flushPackets();
+
+		if(Anh_Utils::Clock::getSingleton()->getStoredTime() - mLastStatsReport > WRITE_STATS_INTERVAL)
+		{
+			_reportCompressionStats();
+		}
+
 		/*
 		if(!mServerService)
 		{
@@ -225,7 +289,13 @@ void SocketWriteThread::run()
 		
 		*/
 
-        boost::this_thread::sleep(boost::posix_time::milliseconds(1));
+		// Nothing left to do, sleep until a session signals us or the next housekeeping round is due.
+		boost::mutex::scoped_lock lk(mReadyMutex);
+
+		if(!mReadySessionQueue.size() && !mExit)
+		{
+			mReadyCondition.timed_wait(lk, boost::posix_time::milliseconds(WRITE_HOUSEKEEPING_INTERVAL));
+		}
 	}
 
 	// Shutdown internally
@@ -251,10 +321,44 @@ void SocketWriteThread::_shutdown(void)
 
 //======================================================================================================================
 
+void SocketWriteThread::_processSession(Session* session)
+{
+	Packet*	packet;
+	uint32	packetCount = 0;
+
+	// Process our session
+	session->ProcessWriteThread();
+
+	// Send any outgoing reliable packets
+	while (session->getOutgoingReliablePacketCount())
+	{
+		packetCount++;
+		if(packetCount > mReliablePacketsPerRound)
+			break;
+
+		packet = session->getOutgoingReliablePacket();
+		_sendPacket(packet, session);
+	}
+
+	// Send any outgoing unreliable packets
+	while (session->getOutgoingUnreliablePacketCount())
+	{
+		packet = session->getOutgoingUnreliablePacket();
+		_sendPacket(packet, session);
+		session->DestroyPacket(packet);
+	}
+}
+
+//======================================================================================================================
+//
+// compresses / encrypts the packet into the next free slot of our send batch
+// the packet itself is left untouched, so reliables can be resend later on
+//
+
 void SocketWriteThread::_sendPacket(Packet* packet, Session* session)
 {
-	struct sockaddr     toAddr;
-	uint32              sent, toLen = sizeof(toAddr), outLen;
+	uint32              outLen;
+	int8*				sendBuffer = mSendBuffers + (mSendCount * SEND_BUFFER_SIZE);
 
 
 	// Some basic bounds checking.
@@ -265,8 +369,10 @@ void SocketWriteThread::_sendPacket(Packet* packet, Session* session)
 	//}
 	//assert(packet->getSize() <= mMessageMaxSize);
 
+#if defined(_DEBUG)
 	// Want a fresh send buffer for debugging purposes.
-	memset(mSendBuffer, 0xcd, sizeof(mSendBuffer));
+	memset(sendBuffer, 0xcd, SEND_BUFFER_SIZE);
+#endif
 /*
   // Going to simulate network packet loss here.
   seed_rand_mwc1616(mClock->getLocalTime());
@@ -284,24 +390,25 @@ void SocketWriteThread::_sendPacket(Packet* packet, Session* session)
 	packet->setTimeSent(Anh_Utils::Clock::getSingleton()->getStoredTime());
 
 	// Setup our to address
-	toAddr.sa_family = AF_INET;
-	*((unsigned int*)&toAddr.sa_data[2]) = session->getAddress();     // Ports and addresses are stored in network order.
-	*((unsigned short*)&(toAddr.sa_data[0])) = session->getPort();    // Only need to convert for humans.
+	mSendAddresses[mSendCount].sin_family		= AF_INET;
+	mSendAddresses[mSendCount].sin_addr.s_addr	= session->getAddress();     // Ports and addresses are stored in network order.
+	mSendAddresses[mSendCount].sin_port			= session->getPort();    // Only need to convert for humans.
 
 	// Copy our 2 byte header.
-	*((uint16*)mSendBuffer) = *((uint16*)packet->getData());
+	*((uint16*)sendBuffer) = *((uint16*)packet->getData());
 
 	// Compress the packet if needed.
 	if(packet->getIsCompressed())
 	{
+		// leave room for the header, the compression flag and the crc
 		if(packetTypeLow == 0)
 		{
 			// Compress our packet, but not the header
-			outLen = mCompCryptor->Compress(packet->getData() + 2, packet->getSize() - 2, mSendBuffer + 2, sizeof(mSendBuffer));
+			outLen = mCompCryptor->Compress(packet->getData() + 2, packet->getSize() - 2, sendBuffer + 2, SEND_BUFFER_SIZE - 5);
 		}
 		else
 		{
-			outLen = mCompCryptor->Compress(packet->getData() + 1, packet->getSize() - 1, mSendBuffer + 1, sizeof(mSendBuffer));
+			outLen = mCompCryptor->Compress(packet->getData() + 1, packet->getSize() - 1, sendBuffer + 1, SEND_BUFFER_SIZE - 4);
 		}
 
 		// If we compressed it, place a 1 at the end of the buffer.
@@ -309,36 +416,36 @@ void SocketWriteThread::_sendPacket(Packet* packet, Session* session)
 		{
 			if(packetTypeLow == 0)
 			{
-				mSendBuffer[outLen + 2] = 1;
+				sendBuffer[outLen + 2] = 1;
 				outLen += 3;  //thats 2 (uncompressed) headerbytes plus the encryption flag
 			}
 			else
 			{
-				mSendBuffer[outLen + 1] = 1;
+				sendBuffer[outLen + 1] = 1;
 				outLen += 2;
 			}
 		}
 		// else a 0 - so no compression
 		else
 		{
-		  memcpy(mSendBuffer, packet->getData(), packet->getSize());
+		  memcpy(sendBuffer, packet->getData(), packet->getSize());
 		  outLen = packet->getSize();
 
-		  mSendBuffer[outLen] = 0;
+		  sendBuffer[outLen] = 0;
 		  outLen += 1;
 		}
 	}
 	else if(packetType == SESSIONOP_SessionResponse || packetType == SESSIONOP_CriticalError)
 	{
-		memcpy(mSendBuffer, packet->getData(), packet->getSize());
+		memcpy(sendBuffer, packet->getData(), packet->getSize());
 		outLen = packet->getSize();
 	}
 	else
 	{
-		memcpy(mSendBuffer, packet->getData(), packet->getSize());
+		memcpy(sendBuffer, packet->getData(), packet->getSize());
 		outLen = packet->getSize();
 
-		mSendBuffer[outLen] = 0;
+		sendBuffer[outLen] = 0;
 		outLen += 1;
 	}
 
@@ -347,27 +454,96 @@ void SocketWriteThread::_sendPacket(Packet* packet, Session* session)
 	{
 		if(packetTypeLow == 0)
 		{
-			mCompCryptor->Encrypt(mSendBuffer + 2, outLen - 2, session->getEncryptKey()); // -2 header is not encrypted
+			mCompCryptor->Encrypt(sendBuffer + 2, outLen - 2, session->getEncryptKey()); // -2 header is not encrypted
 		}
 		else if(packetTypeLow < 0x0d)
 		{
-			mCompCryptor->Encrypt(mSendBuffer + 1, outLen - 1, session->getEncryptKey()); // - 1 header is not encrypted
+			mCompCryptor->Encrypt(sendBuffer + 1, outLen - 1, session->getEncryptKey()); // - 1 header is not encrypted
 		}
 
-		packet->setCRC(mCompCryptor->GenerateCRC(mSendBuffer, outLen, session->getEncryptKey()));
+		packet->setCRC(mCompCryptor->GenerateCRC(sendBuffer, outLen, session->getEncryptKey()));
 
 
-		mSendBuffer[outLen] = (uint8)(packet->getCRC() >> 8);
-		mSendBuffer[outLen + 1] = (uint8)packet->getCRC();
+		sendBuffer[outLen] = (uint8)(packet->getCRC() >> 8);
+		sendBuffer[outLen + 1] = (uint8)packet->getCRC();
 		outLen += 2;
 	}
 
-	sent = sendto(mSocket, mSendBuffer, outLen, 0, &toAddr, toLen);
+	mSendLengths[mSendCount] = outLen;
+
+	if(++mSendCount == mSendBatchSize)
+	{
+		_flushPackets();
+	}
+}
+
+//======================================================================================================================
+//
+// puts all collected datagrams on the wire, a single sendmmsg call where available
+//
+
+void SocketWriteThread::_flushPackets(void)
+{
+	if(!mSendCount)
+		return;
+
+#if defined(ANH_HAVE_SENDMMSG)
+	for(uint32 i = 0; i < mSendCount; i++)
+	{
+		mSendVectors[i].iov_len = mSendLengths[i];
+	}
+
+	uint32 sent = 0;
+
+	while(sent < mSendCount)
+	{
+		int result = sendmmsg(mSocket, mSendHeaders + sent, mSendCount - sent, 0);
+
+		if(result <= 0)
+		{
+			gLogger->log(LogManager::ALERT, "Unkown Error from socket sendmmsg: %u", errno);
+
+			// the first datagram failed, drop it and carry on with the rest
+			sent++;
+			continue;
+		}
+
+		sent += result;
+	}
+#else
+	for(uint32 i = 0; i < mSendCount; i++)
+	{
+		int32 sent = sendto(mSocket, mSendBuffers + (i * SEND_BUFFER_SIZE), mSendLengths[i], 0, (sockaddr*)&mSendAddresses[i], sizeof(sockaddr_in));
+
+		if (sent < 0)
+		{
+			gLogger->log(LogManager::ALERT, "Unkown Error from socket sendto: %u", errno);
+		}
+	}
+#endif
+
+	mSendCount = 0;
+}
+
+//======================================================================================================================
 
-	if (sent < 0)
+void SocketWriteThread::_reportCompressionStats(void)
+{
+	mLastStatsReport = Anh_Utils::Clock::getSingleton()->getStoredTime();
+
+	uint64 bytesIn	= mCompCryptor->getCompressBytesIn();
+	uint64 bytesOut	= mCompCryptor->getCompressBytesOut();
+	float  saved	= 0.0f;
+
+	if(bytesIn)
 	{
-		gLogger->log(LogManager::ALERT, "Unkown Error from socket sendto: %u", errno);
+		saved = 100.0f * (float)(bytesIn - bytesOut) / (float)bytesIn;
 	}
+
+	gLogger->log(LogManager::INFORMATION, "Service %i: Socket Write Thread compressed %"PRIu64" packets (%"PRIu64" skipped), %"PRIu64" -> %"PRIu64" bytes (%.1f%% saved) in %.2f ms",
+		mService->getId(), mCompCryptor->getCompressCalls(), mCompCryptor->getCompressSkipped(), bytesIn, bytesOut, saved, (float)mCompCryptor->getCompressTime() / 1000.0f);
+
+	mCompCryptor->resetStatistics();
 }
 
 //======================================================================================================================
@@ -376,6 +552,22 @@ void SocketWriteThread::NewSession(Session* session)
 {
 	//using concurrent queue that has a recursive mutex
 	mSessionQueue.push(session);
+
+	// get it going right away, it might have a connect command pending
+	session->SignalWriteThread();
+}
+
+//======================================================================================================================
+//
+// called by the sessions themselves, a session is on the ready queue at most once (see Session::SignalWriteThread)
+//
+
+void SocketWriteThread::SignalSession(Session* session)
+{
+	mReadySessionQueue.push(session);
+
+	boost::mutex::scoped_lock lk(mReadyMutex);
+	mReadyCondition.notify_one();
 }
 
 //======================================================================================================================
@@ -32,10 +32,19 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Utils/clock.h"
 #include "Utils/concurrent_queue.h"
 
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/recursive_mutex.hpp>
 #include <boost/thread/thread.hpp>
 
 #define SEND_BUFFER_SIZE 8192
 
+// interval in ms in which every session gets visited for timeouts, pings and commands, even when it has nothing to send
+#define WRITE_HOUSEKEEPING_INTERVAL 100
+
+// interval in ms in which the write thread logs its compression statistics
+#define WRITE_STATS_INTERVAL 60000
+
 //======================================================================================================================
 
 class Service;
@@ -43,6 +52,10 @@ class Packet;
 class Session;
 class CompCryptor;
 
+struct mmsghdr;
+struct iovec;
+struct sockaddr_in;
+
 typedef Anh_Utils::concurrent_queue<Session*>    SessionQueue;
 
 //======================================================================================================================
@@ -57,6 +70,7 @@ class SocketWriteThread
 		virtual void	run();
 
 		void			NewSession(Session* session);
+		void			SignalSession(Session* session);
 
 		bool			getIsRunning(void){ return mIsRunning; }
 		void			requestExit(){ mExit = true; }
@@ -66,12 +80,24 @@ class SocketWriteThread
 		void			_startup(void);
 		void			_shutdown(void);
 
+		void			_processSession(Session* session);
 		void			_sendPacket(Packet* packet, Session* session);
+		void			_flushPackets(void);
+		void			_reportCompressionStats(void);
 
 		//void				*mtheHandle;
 
 		uint16				mMessageMaxSize;
-		int8				mSendBuffer[SEND_BUFFER_SIZE];  
+		uint32				mReliablePacketsPerRound;
+
+		// outgoing datagrams are collected here and flushed in batches
+		int8*				mSendBuffers;
+		uint32*				mSendLengths;
+		struct sockaddr_in*	mSendAddresses;
+		struct mmsghdr*		mSendHeaders;
+		struct iovec*		mSendVectors;
+		uint32				mSendBatchSize;
+		uint32				mSendCount;
 		Service*			mService;
 		CompCryptor*		mCompCryptor;
 		SOCKET				mSocket;
@@ -89,7 +115,12 @@ class SocketWriteThread
 		bool				mServerService;
 		// Anh_Utils::Clock*	mClock;
 
-		SessionQueue				mSessionQueue;
+		SessionQueue				mSessionQueue;			// all our sessions, visited every WRITE_HOUSEKEEPING_INTERVAL
+		SessionQueue				mReadySessionQueue;		// sessions that signaled outbound work
+		boost::mutex				mReadyMutex;
+		boost::condition_variable	mReadyCondition;
+		uint64						mLastHousekeeping;
+		uint64						mLastStatsReport;
 
         boost::thread   			mThread;
 		boost::recursive_mutex      mSocketWriteMutex;
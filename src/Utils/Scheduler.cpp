@@ -28,30 +28,77 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "Scheduler.h"
 
+#include <vector>
+
 
 namespace Anh_Utils
 {
 	//======================================================================================================================
+	//
+	// slot lists are circular with a dummy head, so unlinking a task needs no knowledge of its list
+	//
 
-	Scheduler::Scheduler(uint64 processTimeLimit, uint64 throttleLimit) : mNextTask(0),mNextTaskId(1),mProcessTimeLimit(processTimeLimit),mThrottleLimit(throttleLimit)
+	static Task* _createListHead()
+	{
+		return new Task(0,0,0,0,FDCallback(),NULL);
+	}
+
+	//======================================================================================================================
+
+	Scheduler::Scheduler(uint64 processTimeLimit, uint64 throttleLimit)
+	: mRunningTask(NULL)
+	, mRunningTaskRemoved(false)
+	, mNextTaskId(1)
+	, mProcessTimeLimit(processTimeLimit)
+	, mThrottleLimit(throttleLimit)
 	{
 		mLastProcessTime = 0;
-		// We do have a global clock object, don't use seperate clock and times for every process.
-		// mClock = new Anh_Utils::Clock();
+
+		mWheelTime = gClock->getLocalTime();
+
+		for(uint32 level = 0; level < SCHEDULER_WHEEL_LEVELS; level++)
+		{
+			for(uint32 slot = 0; slot < SCHEDULER_WHEEL_SLOTS; slot++)
+			{
+				mWheel[level][slot] = _createListHead();
+			}
+		}
+
+		mReadyList = _createListHead();
 	}
 
 	//======================================================================================================================
 
 	Scheduler::~Scheduler()
 	{
-		// delete(mClock);
+		TaskMap::iterator it = mTaskMap.begin();
+
+		while(it != mTaskMap.end())
+		{
+			delete((*it).second);
+			++it;
+		}
+
+		for(uint32 level = 0; level < SCHEDULER_WHEEL_LEVELS; level++)
+		{
+			for(uint32 slot = 0; slot < SCHEDULER_WHEEL_SLOTS; slot++)
+			{
+				delete(mWheel[level][slot]);
+			}
+		}
+
+		delete(mReadyList);
 	}
 
 	//======================================================================================================================
 
 	uint64 Scheduler::addTask(FDCallback callback,uint8 priority,uint64 interval,void* async)
 	{
-		mTasks.push(Task(mNextTaskId,priority,gClock->getLocalTime(),interval,callback,async));
+		Task* task = new Task(mNextTaskId,priority,gClock->getLocalTime(),interval,callback,async);
+
+		mTaskMap.insert(std::make_pair(task->mId,task));
+		_schedule(task);
+
 		return(mNextTaskId++);
 	}
 
@@ -59,65 +106,54 @@ namespace Anh_Utils
 
 	void Scheduler::removeTask(uint64 id)
 	{
-		//printf("scheduler to do remove task : %I64u",id);
 		if(!id)
 			return;
 
-		TaskContainer::iterator it = mTasks.begin();
+		TaskMap::iterator it = mTaskMap.find(id);
 
-		while(it != mTasks.end())
+		if(it == mTaskMap.end())
 		{
-			if(it->mId == id)
-			{
-				mTasks.erase(it);
-		//		printf("scheduler removeD task : %I64u",id);
-				break;
-			}
+			return;
+		}
 
-			++it;
+		Task* task = (*it).second;
+		mTaskMap.erase(it);
+
+		// removed from within its own callback, runTask cleans up
+		if(task == mRunningTask)
+		{
+			mRunningTaskRemoved = true;
+			return;
 		}
 
-		mTasks.assureHeap(true);
+		_unlink(task);
+		delete(task);
 	}
 
+	//======================================================================================================================
+
 	bool Scheduler::checkTask(uint64 id)
 	{
-		//printf("scheduler to do remove task : %I64u",id);
 		if(!id)
 			return false;
 
-		TaskContainer::iterator it = mTasks.begin();
-
-		while(it != mTasks.end())
-		{
-			if(it->mId == id)
-			{
-		//		printf("scheduler removeD task : %I64u",id);
-				return true;
-			}
-
-			++it;
-		}
-
-		//mTasks.assureHeap(true);
-		return false;
+		return(mTaskMap.find(id) != mTaskMap.end());
 	}
 
 	//======================================================================================================================
 
 	void Scheduler::process()
 	{
-		// uint64	frameStartTime = mClock->UpdateAndGetTime();
-
-		// while(runTask() && ((mClock->UpdateAndGetTime() - frameStartTime) < mProcessTimeLimit));
 		uint64	frameStartTime = Anh_Utils::Clock::getSingleton()->getLocalTime();
 
-		//Check for throttle
-		if(frameStartTime < (mLastProcessTime + mThrottleLimit))
+		//Check for throttle, a clock that went backwards (timeGetTime wraps after 49.7 days) never throttles
+		if(frameStartTime >= mLastProcessTime && frameStartTime < (mLastProcessTime + mThrottleLimit))
 		{
 			return;
 		}
 
+		_advance(frameStartTime);
+
 		while(runTask() && ((Anh_Utils::Clock::getSingleton()->getLocalTime() - frameStartTime) < mProcessTimeLimit));
 
 		//Set internal Clock so we know when the last call was
@@ -128,41 +164,208 @@ namespace Anh_Utils
 
 	bool Scheduler::runTask()
 	{
-		if(!(mTasks.empty()))
+		Task* task = mReadyList->mNext;
+
+		if(task == mReadyList)
+		{
+			return(false);
+		}
+
+		_unlink(task);
+
+		uint64 currentTime = Anh_Utils::Clock::getSingleton()->getLocalTime();
+
+		mRunningTask		= task;
+		mRunningTaskRemoved	= false;
+
+		bool keep = task->mCallback(currentTime,task->mAsync);
+
+		mRunningTask = NULL;
+
+		if(mRunningTaskRemoved)
+		{
+			delete(task);
+		}
+		else if(!keep)
+		{
+			mTaskMap.erase(task->mId);
+			delete(task);
+		}
+		else
+		{
+			task->mLastCallTime	= currentTime;
+			task->mDueTime		= currentTime + task->mInterval + 1;
+
+			_schedule(task);
+		}
+
+		return(mReadyList->mNext != mReadyList);
+	}
+
+	//======================================================================================================================
+	//
+	// moves every slot up to currentTime to the ready list
+	//
+
+	void Scheduler::_advance(uint64 currentTime)
+	{
+		if(currentTime < mWheelTime)
+		{
+			_rebase(currentTime);
+		}
+
+		while(mWheelTime < currentTime)
 		{
-			Task&	task(mTasks[mNextTask]);
-			uint64	currentTime = Anh_Utils::Clock::getSingleton()->getLocalTime();
-			if((currentTime - task.mLastCallTime) > task.mInterval)
+			++mWheelTime;
+
+			// higher levels first, their tasks may end up in the lower level slot we cascade next
+			uint32 level = SCHEDULER_WHEEL_LEVELS - 1;
+
+			while(level > 0)
 			{
-				if(task.mCallback(currentTime,task.mAsync) == false)
+				if(!(mWheelTime & ((1ULL << (SCHEDULER_WHEEL_BITS * level)) - 1)))
 				{
-					removeTask(task.mId);
-				}
-				else
-				{
-					task.mLastCallTime = currentTime;
-					++mNextTask;
+					_cascade(level);
 				}
+
+				--level;
 			}
-			else
-				++mNextTask;
 
-			if(mNextTask >= mTasks.size())
+			Task* head = mWheel[0][mWheelTime & (SCHEDULER_WHEEL_SLOTS - 1)];
+
+			while(head->mNext != head)
 			{
-				reset();
-				return(false);
+				Task* task = head->mNext;
+
+				_unlink(task);
+				_link(mReadyList,task);
 			}
-			else
-				return(true);
 		}
-		else
+	}
+
+	//======================================================================================================================
+	//
+	// the clock went backwards, moves the wheel to currentTime and keeps every pending task's remaining delay
+	//
+
+	void Scheduler::_rebase(uint64 currentTime)
+	{
+		std::vector<Task*> pending;
+
+		for(uint32 level = 0; level < SCHEDULER_WHEEL_LEVELS; level++)
 		{
-			reset();
-			return(false);
+			for(uint32 slot = 0; slot < SCHEDULER_WHEEL_SLOTS; slot++)
+			{
+				Task* head = mWheel[level][slot];
+
+				while(head->mNext != head)
+				{
+					Task* task = head->mNext;
+
+					_unlink(task);
+					pending.push_back(task);
+				}
+			}
+		}
+
+		for(uint32 i = 0; i < pending.size(); i++)
+		{
+			Task* task = pending[i];
+
+			task->mDueTime		= currentTime + ((task->mDueTime > mWheelTime) ? task->mDueTime - mWheelTime : 0);
+			task->mLastCallTime	= currentTime;
+		}
+
+		mWheelTime = currentTime;
+
+		for(uint32 i = 0; i < pending.size(); i++)
+		{
+			_schedule(pending[i]);
+		}
+	}
+
+	//======================================================================================================================
+	//
+	// redistributes the current slot of a level onto the levels below
+	//
+
+	void Scheduler::_cascade(uint32 level)
+	{
+		Task* head = mWheel[level][(mWheelTime >> (SCHEDULER_WHEEL_BITS * level)) & (SCHEDULER_WHEEL_SLOTS - 1)];
+
+		// detach the list first, tasks beyond the wheel range may land in the same slot again
+		Task* first = head->mNext;
+		Task* last	= head->mPrev;
+
+		if(first == head)
+		{
+			return;
+		}
+
+		head->mNext = head;
+		head->mPrev = head;
+		last->mNext = NULL;
+
+		while(first)
+		{
+			Task* task	= first;
+			first		= first->mNext;
+
+			task->mPrev = task;
+			task->mNext = task;
+
+			_schedule(task);
+		}
+	}
+
+	//======================================================================================================================
+
+	void Scheduler::_schedule(Task* task)
+	{
+		if(task->mDueTime <= mWheelTime)
+		{
+			_link(mReadyList,task);
+			return;
+		}
+
+		uint64 delta	= task->mDueTime - mWheelTime;
+		uint64 dueTime	= task->mDueTime;
+		uint32 level	= 0;
+
+		while(level < SCHEDULER_WHEEL_LEVELS - 1 && delta >= (1ULL << (SCHEDULER_WHEEL_BITS * (level + 1))))
+		{
+			++level;
 		}
+
+		// beyond the range of the wheel, park it in the farthest slot, it gets rescheduled from there
+		if(delta >= (1ULL << (SCHEDULER_WHEEL_BITS * SCHEDULER_WHEEL_LEVELS)))
+		{
+			dueTime = mWheelTime + (1ULL << (SCHEDULER_WHEEL_BITS * SCHEDULER_WHEEL_LEVELS)) - 1;
+		}
+
+		_link(mWheel[level][(dueTime >> (SCHEDULER_WHEEL_BITS * level)) & (SCHEDULER_WHEEL_SLOTS - 1)],task);
+	}
+
+	//======================================================================================================================
+
+	void Scheduler::_link(Task* list,Task* task)
+	{
+		task->mPrev			= list->mPrev;
+		task->mNext			= list;
+		list->mPrev->mNext	= task;
+		list->mPrev			= task;
+	}
+
+	//======================================================================================================================
+
+	void Scheduler::_unlink(Task* task)
+	{
+		task->mPrev->mNext	= task->mNext;
+		task->mNext->mPrev	= task->mPrev;
+		task->mPrev			= task;
+		task->mNext			= task;
 	}
 }
 
 //======================================================================================================================
 
-
@@ -30,45 +30,60 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "typedefs.h"
 #include "FastDelegate.h"
-#include "PriorityVector.h"
 #include "clock.h"
-#include <algorithm>
+
+#include <boost/unordered_map.hpp>
 
 
 typedef fastdelegate::FastDelegate2<uint64,void*,bool> FDCallback;
 
+// the wheel has SCHEDULER_WHEEL_LEVELS levels of SCHEDULER_WHEEL_SLOTS slots, level 0 slots are 1ms wide,
+// every further level is SCHEDULER_WHEEL_SLOTS times wider. 4 levels of 256 slots cover 49 days.
+#define SCHEDULER_WHEEL_BITS	8
+#define SCHEDULER_WHEEL_SLOTS	(1 << SCHEDULER_WHEEL_BITS)
+#define SCHEDULER_WHEEL_LEVELS	4
+
 
 namespace Anh_Utils
 {
 	//======================================================================================================================
+	//
+	// A task is due once more than mInterval ms passed since its last call (or since it was added).
+	// Tasks are linked into the slot list of the wheel they are waiting in, or into the ready list once due.
+	//
 
 	class Task
 	{
 		public:
 
 			Task(uint64 id,uint8 priority,uint64 lastCallTime,uint64 interval,FDCallback callback,void* async)
-				: mId(id),mPriority(priority),mLastCallTime(lastCallTime),mInterval(interval),mCallback(callback),mAsync(async){}
+				: mId(id),mPriority(priority),mLastCallTime(lastCallTime),mInterval(interval),mCallback(callback),mAsync(async)
+				, mDueTime(lastCallTime + interval + 1),mPrev(this),mNext(this){}
 			
 			~Task(){}
 
-			bool operator< (const Task& right) const
-			{
-				return(mPriority < right.mPriority);
-			} 
-
 			uint64		mId;
 			uint8		mPriority;
 			uint64		mLastCallTime;
 			uint64		mInterval;
 			FDCallback	mCallback;
 			void*		mAsync;
+
+			uint64		mDueTime;
+			Task*		mPrev;
+			Task*		mNext;
 	};
 
 //======================================================================================================================
 
-typedef priority_vector<Task> TaskContainer;
+typedef boost::unordered_map<uint64,Task*> TaskMap;
 
 //======================================================================================================================
+//
+// Hierarchical timing wheel. Adding, removing and checking a task are O(1), process() only touches the
+// tasks that are due (plus one slot per elapsed ms and an occasional cascade), idle tasks cost nothing.
+// Due tasks fire in order of their due time, tasks due in the same ms in the order they got due.
+//
 
 	class Scheduler
 	{
@@ -80,16 +95,30 @@ typedef priority_vector<Task> TaskContainer;
 			uint64	addTask(FDCallback callback,uint8 priority,uint64 interval,void* async);
 			void	removeTask(uint64 id);
 			bool	checkTask(uint64 id);
-			void	reset(){ mNextTask = 0; }
 			void	process();
+
+			// runs the next due task, returns false if there is none
 			bool	runTask();
+
+			uint32	getTaskCount(){ return (uint32)mTaskMap.size(); }
 		
 		protected:
 
-			TaskContainer		mTasks;	
-			uint32				mNextTask;
+			void	_advance(uint64 currentTime);
+			void	_rebase(uint64 currentTime);
+			void	_cascade(uint32 level);
+			void	_schedule(Task* task);
+
+			static void	_link(Task* list,Task* task);
+			static void	_unlink(Task* task);
+
+			TaskMap				mTaskMap;
+			Task*				mWheel[SCHEDULER_WHEEL_LEVELS][SCHEDULER_WHEEL_SLOTS];	// list heads
+			Task*				mReadyList;												// list head
+			Task*				mRunningTask;
+			bool				mRunningTaskRemoved;
+			uint64				mWheelTime;		// every slot up to this ms has been moved to the ready list
 			uint64				mNextTaskId;
-			// Anh_Utils::Clock*	mClock;
 			uint64				mProcessTimeLimit, mThrottleLimit, mLastProcessTime;
 	};
 }
@@ -98,5 +127,3 @@ typedef priority_vector<Task> TaskContainer;
 
 //======================================================================================================================
 
-
-
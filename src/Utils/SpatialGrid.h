@@ -0,0 +1,290 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#ifndef ANH_UTILS_SPATIAL_GRID_H
+#define ANH_UTILS_SPATIAL_GRID_H
+
+#include "typedefs.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <boost/unordered_map.hpp>
+
+
+namespace Anh_Utils
+{
+	//======================================================================================================================
+	//
+	// uniform grid over a fixed area, meant for objects that move every few hundred ms
+	// every cell keeps its entries in a flat array, an entry knows its cell and slot through the location map,
+	// so moves inside a cell only write the position and moves across cells are a swap and pop plus a push back
+	// positions outside the area are kept in the border cells
+	//
+
+	template<class T>
+	class spatial_grid
+	{
+		public:
+
+			struct Entry
+			{
+				T*		item;
+				uint64	id;
+				float	x;
+				float	z;
+			};
+
+			spatial_grid(float lowX, float lowZ, float width, float height, float cellSize)
+			: mLowX(lowX)
+			, mLowZ(lowZ)
+			, mCellSize(cellSize)
+			{
+				mColumns	= std::max<uint32>(1,static_cast<uint32>(ceil(width / cellSize)));
+				mRows		= std::max<uint32>(1,static_cast<uint32>(ceil(height / cellSize)));
+
+				mCells.resize(mColumns * mRows);
+			}
+
+	//======================================================================================================================
+
+			bool insert(uint64 id, T* item, float x, float z)
+			{
+				if(mLocations.find(id) != mLocations.end())
+				{
+					return(false);
+				}
+
+				uint32	cell	= _cellIndex(x,z);
+				Entry	entry	= { item, id, x, z };
+
+				mLocations[id] = Location(cell,mCells[cell].size());
+				mCells[cell].push_back(entry);
+
+				return(true);
+			}
+
+	//======================================================================================================================
+
+			bool remove(uint64 id)
+			{
+				typename LocationMap::iterator it = mLocations.find(id);
+
+				if(it == mLocations.end())
+				{
+					return(false);
+				}
+
+				_removeEntry((*it).second);
+				mLocations.erase(it);
+
+				return(true);
+			}
+
+	//======================================================================================================================
+
+			bool update(uint64 id, float x, float z)
+			{
+				typename LocationMap::iterator it = mLocations.find(id);
+
+				if(it == mLocations.end())
+				{
+					return(false);
+				}
+
+				Location&	location	= (*it).second;
+				uint32		cell		= _cellIndex(x,z);
+
+				// still in the same cell, just move it
+				if(cell == location.cell)
+				{
+					Entry& entry = mCells[cell][location.index];
+
+					entry.x = x;
+					entry.z = z;
+
+					return(true);
+				}
+
+				Entry entry = mCells[location.cell][location.index];
+
+				entry.x = x;
+				entry.z = z;
+
+				_removeEntry(location);
+
+				location.cell	= cell;
+				location.index	= mCells[cell].size();
+
+				mCells[cell].push_back(entry);
+
+				return(true);
+			}
+
+	//======================================================================================================================
+
+			bool	contains(uint64 id) const { return(mLocations.find(id) != mLocations.end()); }
+			uint32	size() const { return(mLocations.size()); }
+
+			uint32	getColumns() const { return(mColumns); }
+			uint32	getRows() const { return(mRows); }
+			float	getCellSize() const { return(mCellSize); }
+
+	//======================================================================================================================
+	//
+	// calls visitor(entry) for every entry within range of x,z
+	//
+
+			template<class Visitor>
+			void visitRange(float x, float z, float range, Visitor& visitor) const
+			{
+				float rangeSquared = range * range;
+
+				uint32 lowColumn,lowRow,highColumn,highRow;
+
+				_cellCoords(x - range,z - range,lowColumn,lowRow);
+				_cellCoords(x + range,z + range,highColumn,highRow);
+
+				for(uint32 row = lowRow;row <= highRow;row++)
+				{
+					for(uint32 column = lowColumn;column <= highColumn;column++)
+					{
+						const Cell& cell = mCells[row * mColumns + column];
+
+						for(uint32 i = 0;i < cell.size();i++)
+						{
+							const Entry& entry = cell[i];
+
+							float dx = entry.x - x;
+							float dz = entry.z - z;
+
+							if(dx * dx + dz * dz <= rangeSquared)
+							{
+								visitor(entry);
+							}
+						}
+					}
+				}
+			}
+
+	//======================================================================================================================
+	//
+	// calls visitor(entry) for every entry inside the rectangle
+	//
+
+			template<class Visitor>
+			void visitRectangle(float lowX, float lowZ, float width, float height, Visitor& visitor) const
+			{
+				uint32 lowColumn,lowRow,highColumn,highRow;
+
+				_cellCoords(lowX,lowZ,lowColumn,lowRow);
+				_cellCoords(lowX + width,lowZ + height,highColumn,highRow);
+
+				for(uint32 row = lowRow;row <= highRow;row++)
+				{
+					for(uint32 column = lowColumn;column <= highColumn;column++)
+					{
+						const Cell& cell = mCells[row * mColumns + column];
+
+						for(uint32 i = 0;i < cell.size();i++)
+						{
+							const Entry& entry = cell[i];
+
+							if(entry.x >= lowX && entry.x <= lowX + width && entry.z >= lowZ && entry.z <= lowZ + height)
+							{
+								visitor(entry);
+							}
+						}
+					}
+				}
+			}
+
+		private:
+
+			struct Location
+			{
+				Location() : cell(0),index(0){}
+				Location(uint32 c, uint32 i) : cell(c),index(i){}
+
+				uint32 cell;
+				uint32 index;
+			};
+
+			typedef std::vector<Entry>							Cell;
+			typedef boost::unordered_map<uint64,Location>		LocationMap;
+
+	//======================================================================================================================
+
+			void _cellCoords(float x, float z, uint32& column, uint32& row) const
+			{
+				float c = floor((x - mLowX) / mCellSize);
+				float r = floor((z - mLowZ) / mCellSize);
+
+				column	= (c <= 0.0f) ? 0 : std::min<uint32>(static_cast<uint32>(c),mColumns - 1);
+				row		= (r <= 0.0f) ? 0 : std::min<uint32>(static_cast<uint32>(r),mRows - 1);
+			}
+
+			uint32 _cellIndex(float x, float z) const
+			{
+				uint32 column,row;
+
+				_cellCoords(x,z,column,row);
+
+				return(row * mColumns + column);
+			}
+
+	//======================================================================================================================
+	//
+	// swap the last entry of the cell into the hole and fix up its location
+	//
+
+			void _removeEntry(const Location& location)
+			{
+				Cell& cell = mCells[location.cell];
+
+				if(location.index != cell.size() - 1)
+				{
+					cell[location.index] = cell.back();
+					mLocations[cell[location.index].id].index = location.index;
+				}
+
+				cell.pop_back();
+			}
+
+			float				mLowX;
+			float				mLowZ;
+			float				mCellSize;
+			uint32				mColumns;
+			uint32				mRows;
+
+			std::vector<Cell>	mCells;
+			LocationMap			mLocations;
+	};
+}
+
+#endif
+
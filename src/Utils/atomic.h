@@ -0,0 +1,168 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#ifndef ANH_UTILS_ATOMIC_H
+#define ANH_UTILS_ATOMIC_H
+
+#include "typedefs.h"
+
+#if(ANH_PLATFORM == ANH_PLATFORM_WIN32)
+#include <windows.h>
+#include <intrin.h>
+#endif
+
+
+//==============================================================================================================================
+//
+// Minimal set of atomic operations for the lock free containers.
+// All of them are full memory barriers, gcc builtins on linux, Interlocked* on windows.
+//
+
+namespace Anh_Utils
+{
+	//==============================================================================================================================
+	//
+	// returns the new value
+	//
+
+	inline uint32 atomicIncrement(volatile uint32* value)
+	{
+#if(ANH_PLATFORM == ANH_PLATFORM_WIN32)
+		return (uint32)InterlockedIncrement((volatile LONG*)value);
+#else
+		return __sync_add_and_fetch(value, 1);
+#endif
+	}
+
+	inline uint32 atomicDecrement(volatile uint32* value)
+	{
+#if(ANH_PLATFORM == ANH_PLATFORM_WIN32)
+		return (uint32)InterlockedDecrement((volatile LONG*)value);
+#else
+		return __sync_sub_and_fetch(value, 1);
+#endif
+	}
+
+	inline uint32 atomicAdd(volatile uint32* value, uint32 amount)
+	{
+#if(ANH_PLATFORM == ANH_PLATFORM_WIN32)
+		return (uint32)InterlockedExchangeAdd((volatile LONG*)value, (LONG)amount) + amount;
+#else
+		return __sync_add_and_fetch(value, amount);
+#endif
+	}
+
+	//==============================================================================================================================
+	//
+	// compare and swap, returns true if *target was oldVal and got replaced
+	//
+
+	inline bool atomicCompareAndSwap(volatile uint32* target, uint32 oldVal, uint32 newVal)
+	{
+#if(ANH_PLATFORM == ANH_PLATFORM_WIN32)
+		return (uint32)InterlockedCompareExchange((volatile LONG*)target, (LONG)newVal, (LONG)oldVal) == oldVal;
+#else
+		return __sync_bool_compare_and_swap(target, oldVal, newVal);
+#endif
+	}
+
+	template<typename T>
+	inline bool atomicCompareAndSwap(T* volatile* target, T* oldVal, T* newVal)
+	{
+#if(ANH_PLATFORM == ANH_PLATFORM_WIN32)
+		return InterlockedCompareExchangePointer((PVOID volatile*)target, newVal, oldVal) == oldVal;
+#else
+		return __sync_bool_compare_and_swap(target, oldVal, newVal);
+#endif
+	}
+
+	//==============================================================================================================================
+	//
+	// swaps in newVal, returns the previous value
+	//
+
+	template<typename T>
+	inline T* atomicExchange(T* volatile* target, T* newVal)
+	{
+		T* oldVal;
+
+		do
+		{
+			oldVal = *target;
+		}
+		while(!atomicCompareAndSwap(target, oldVal, newVal));
+
+		return oldVal;
+	}
+
+	//==============================================================================================================================
+	//
+	// load with acquire, store with release semantics, for publishing data through a flag or sequence number.
+	// x86 keeps loads and stores in order by itself, all we have to stop is the compiler.
+	//
+
+	inline void _orderBarrier()
+	{
+#if(ANH_PLATFORM == ANH_PLATFORM_WIN32)
+		_ReadWriteBarrier();
+#elif defined(__i386__) || defined(__x86_64__)
+		__asm__ __volatile__("" ::: "memory");
+#else
+		__sync_synchronize();
+#endif
+	}
+
+	inline uint32 atomicLoad(volatile uint32* value)
+	{
+		uint32 result = *value;
+		_orderBarrier();
+		return result;
+	}
+
+	inline void atomicStore(volatile uint32* target, uint32 value)
+	{
+		_orderBarrier();
+		*target = value;
+	}
+
+	//==============================================================================================================================
+	//
+	// full fence
+	//
+
+	inline void memoryBarrier()
+	{
+#if(ANH_PLATFORM == ANH_PLATFORM_WIN32)
+		MemoryBarrier();
+#else
+		__sync_synchronize();
+#endif
+	}
+}
+
+#endif
+
@@ -27,6 +27,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "typedefs.h"  // This must be first here to remove the dependency from the header.
 #include "bstring.h"
+#include "crc.h"
 
 #include <algorithm>
 
@@ -41,12 +42,13 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 //======================================================================================================================
 
 BString::BString()
-: mString(0)
+: mString(mInline)
 , mType(BSTRType_ANSI)
-, mAllocated(0)
+, mAllocated(BSTRING_INLINE_SIZE)
 , mCharacterWidth(1)
 , mLength(0)
 {
+  memset(mInline,0,BSTRING_INLINE_SIZE);
   _allocate();
   *(uint32*)mString = 0;   // Make sure a new empty string is null terminated.
 }
@@ -54,9 +56,9 @@ BString::BString()
 //======================================================================================================================
 
 BString::BString(BStringType type,uint16 length)
-	: mString(0)
+	: mString(mInline)
   , mType(type)
-  , mAllocated(0)
+  , mAllocated(BSTRING_INLINE_SIZE)
   , mLength(length)
 {
 	if(type == BSTRType_ANSI)
@@ -64,6 +66,7 @@ BString::BString(BStringType type,uint16 length)
 	else if(type == BSTRType_Unicode16)
 		mCharacterWidth = 2;
 
+	memset(mInline,0,BSTRING_INLINE_SIZE);
 	_allocate();
 	*(uint32*)mString = 0;
 }
@@ -72,18 +75,19 @@ BString::BString(BStringType type,uint16 length)
 
 BString::~BString()
 {
-    if (mString) delete [] mString;
+    _release();
 }
 
 //======================================================================================================================
 
 BString::BString(const int8* data)
-: mString(0)
+: mString(mInline)
 , mType(BSTRType_ANSI)
-, mAllocated(0)
+, mAllocated(BSTRING_INLINE_SIZE)
 , mCharacterWidth(1)
 , mLength(0)
 {
+	memset(mInline,0,BSTRING_INLINE_SIZE);
 	_allocate();
 	// we might get a null pointer from db queries
 	if(data != NULL)
@@ -95,12 +99,13 @@ BString::BString(const int8* data)
 //======================================================================================================================
 
 BString::BString(const uint16* data)
-: mString(0)
+: mString(mInline)
 , mType(BSTRType_Unicode16)
-, mAllocated(0)
+, mAllocated(BSTRING_INLINE_SIZE)
 , mCharacterWidth(1)
 , mLength(0)
 {
+	memset(mInline,0,BSTRING_INLINE_SIZE);
 	_allocate();
 	// we might get a null pointer from db queries
 	if(data != NULL)
@@ -112,12 +117,13 @@ BString::BString(const uint16* data)
 //======================================================================================================================
 
 BString::BString(const wchar_t* data)
-: mString(0)
+: mString(mInline)
 , mType(BSTRType_Unicode16)
-, mAllocated(0)
+, mAllocated(BSTRING_INLINE_SIZE)
 , mCharacterWidth(1)
 , mLength(0)
 {
+	memset(mInline,0,BSTRING_INLINE_SIZE);
 	_allocate();
 	// we might get a null pointer from db queries
 	if(data != NULL)
@@ -130,18 +136,30 @@ BString::BString(const wchar_t* data)
 //======================================================================================================================
 
 BString::BString(const BString& data)
-: mString(0)
+: mString(mInline)
 , mType(BSTRType_ANSI)
-, mAllocated(0)
+, mAllocated(BSTRING_INLINE_SIZE)
 , mCharacterWidth(1)
 , mLength(0)
 {
+	memset(mInline,0,BSTRING_INLINE_SIZE);
 	_allocate();
 	*this = data;
 }
 
 //======================================================================================================================
 
+void BString::_release()
+{
+	// the inline buffer is part of us
+	if(mString != mInline)
+		delete [] mString;
+
+	mString = mInline;
+}
+
+//======================================================================================================================
+
 uint16 BString::initRawBSTR(int8* data, BStringType type)
 {
 	uint16	totalLen = *(uint16*)data;
@@ -169,8 +187,7 @@ uint16 BString::initRawBSTR(int8* data, BStringType type)
 	// If we don't have enough room in our buffer, re-allocate a new one
 	if(charLen > mAllocated)
 	{
-		if(mString)
-			delete [] mString;
+		_release();
 
 		mAllocated = (((static_cast<uint16>(charLen) / BSTRING_ALLOC_BLOCK_SIZE) + 1) * BSTRING_ALLOC_BLOCK_SIZE);
 		mString = new int8[mAllocated];
@@ -318,17 +335,19 @@ BString& BString::operator =(int8* data)
 
 BString& BString::operator =(const BString& data)
 {
+	if(this == &data)
+		return *this;
+
 	mType = data.getType();
 	mCharacterWidth = static_cast<uint16>(data.getCharacterWidth());
 	mLength = data.getLength();
-    mAllocated = static_cast<uint16>(data.getAllocated());
 
-  if (mString)
-    delete [] mString;
-	mString = new int8[mAllocated];
+	// only grows if the string doesnt fit what we have already
+	_allocate();
 
-  // Copy our string into the new buffer.
-  memcpy(mString, data.getRawData(), mAllocated);
+	// Copy our string and its terminator into the buffer.
+	memcpy(mString, data.getRawData(), std::min<uint32>(mLength * mCharacterWidth, data.getAllocated()));
+	memset(&mString[mLength * mCharacterWidth], 0, mCharacterWidth);
 
 	return *this;
 }
@@ -504,26 +523,43 @@ void BString::convert(BStringType type)
 		return;
 
 	//  Locals
+	int8    inlineBuffer[BSTRING_INLINE_SIZE];
 	int8*   newBuffer = 0;
 	uint16  allocated = 0;
 
-	// what's the target type and how much space will we need
+	mCharacterWidth = (type == BSTRType_ANSI) ? 1 : 2;
+
+	// how much space will we need, short strings get converted on the stack and stay inline
+	uint32 needed = (mLength + 1) * mCharacterWidth;
+
+	if(needed <= BSTRING_INLINE_SIZE)
+	{
+		allocated = BSTRING_INLINE_SIZE;
+		newBuffer = inlineBuffer;
+	}
+	else
+	{
+		allocated = static_cast<uint16>(((needed / BSTRING_ALLOC_BLOCK_SIZE) + 1) * BSTRING_ALLOC_BLOCK_SIZE);
+		newBuffer = new int8[allocated];
+	}
+
+	//Initial null terminator
+	memset(newBuffer,0,allocated);
+
+	// what's the target type
 	switch(type)
 	{
 		case BSTRType_ANSI:
 		{
-			mCharacterWidth = 1;
-			allocated = ((((mLength+1) / BSTRING_ALLOC_BLOCK_SIZE) + 1) * BSTRING_ALLOC_BLOCK_SIZE);
-
-			// Allocate a new buffer for the converted string.
-			newBuffer = new int8[allocated];
-			//Initial null terminator
-			memset(newBuffer,0,allocated);
-
-			// Convert the string if needed.
+			// Convert the string if needed, our unicode is 2 bytes wide whatever wchar_t is on this platform
 			if(mType == BSTRType_Unicode16)
 			{
-                wcstombs(newBuffer, reinterpret_cast<wchar_t*>(mString), std::min(allocated, mAllocated));
+				const uint16* source = reinterpret_cast<const uint16*>(mString);
+
+				for(uint16 i = 0; i < mLength; i++)
+				{
+					newBuffer[i] = (source[i] > 0xff) ? '?' : static_cast<int8>(source[i]);
+				}
 			}
 			else if(mType == BSTRType_UTF8)
 			{
@@ -535,31 +571,20 @@ void BString::convert(BStringType type)
 
 		case BSTRType_Unicode16:
 		{
-			mCharacterWidth = 2;
-			allocated = (((((mLength+1) * mCharacterWidth) / BSTRING_ALLOC_BLOCK_SIZE) + 1) * BSTRING_ALLOC_BLOCK_SIZE);
-
-			// Allocate a new buffer for the converted string.
-			newBuffer = new int8[allocated];
-			//Initial null terminator
-			memset(newBuffer,0,allocated);
-
 			if(mType == BSTRType_ANSI || mType == BSTRType_UTF8)
 			{
-                mbstowcs(reinterpret_cast<wchar_t*>(newBuffer),mString, std::min(allocated/2, mLength+1));
+				uint16* target = reinterpret_cast<uint16*>(newBuffer);
+
+				for(uint16 i = 0; i < mLength; i++)
+				{
+					target[i] = static_cast<uint8>(mString[i]);
+				}
 			}
 		}
 		break;
 
 		case BSTRType_UTF8:
 		{
-			mCharacterWidth = 2;
-
-			allocated = (((((mLength+1) * mCharacterWidth) / BSTRING_ALLOC_BLOCK_SIZE) + 1) * BSTRING_ALLOC_BLOCK_SIZE);
-			// Allocate a new buffer for the converted string.
-			newBuffer = new int8[allocated];
-			//Initial null terminator
-			*(uint32*)newBuffer = 0;
-
 			if(mType == BSTRType_ANSI)
 			{
 				// FIXME: Implement, not sure if it needs to be though
@@ -574,8 +599,13 @@ void BString::convert(BStringType type)
 	}
 
 	// We are now the new type of string
-	if(mString != 0)
-		delete [] mString;
+	_release();
+
+	if(newBuffer == inlineBuffer)
+	{
+		memcpy(mInline,inlineBuffer,BSTRING_INLINE_SIZE);
+		newBuffer = mInline;
+	}
 
 	mString		= newBuffer;
 	mAllocated	= allocated;
@@ -813,8 +843,7 @@ void BString::_allocate()
 			break;
 		}
 
-		if(mString != 0)
-			delete [] mString;
+		_release();
 
 		mString = newString;
 	}
@@ -865,76 +894,8 @@ uint32 BString::getAllocated() const
 //======================================================================================================================
 uint32 BString::CRC(char* data)
 {
-  uint32 length = (uint32)strlen(data);
-
-  uint32 crc = 0xffffffff;  // starting seed
-  for (uint32 i = 0; i < length; i++)
-  {
-    crc = mCrcTable[data[i] ^ (crc >> 24)] ^ (crc << 8);
-  }
-
-  return ~crc;
-}
-
-
-//======================================================================================================================
-uint32 BString::mCrcTable[256] =
-{
-    0x0000000,
-    0x04C11DB7, 0x09823B6E, 0x0D4326D9, 0x130476DC, 0x17C56B6B,
-    0x1A864DB2, 0x1E475005, 0x2608EDB8, 0x22C9F00F, 0x2F8AD6D6,
-    0x2B4BCB61, 0x350C9B64, 0x31CD86D3, 0x3C8EA00A, 0x384FBDBD,
-    0x4C11DB70, 0x48D0C6C7, 0x4593E01E, 0x4152FDA9, 0x5F15ADAC,
-    0x5BD4B01B, 0x569796C2, 0x52568B75, 0x6A1936C8, 0x6ED82B7F,
-    0x639B0DA6, 0x675A1011, 0x791D4014, 0x7DDC5DA3, 0x709F7B7A,
-    0x745E66CD, 0x9823B6E0, 0x9CE2AB57, 0x91A18D8E, 0x95609039,
-    0x8B27C03C, 0x8FE6DD8B, 0x82A5FB52, 0x8664E6E5, 0xBE2B5B58,
-    0xBAEA46EF, 0xB7A96036, 0xB3687D81, 0xAD2F2D84, 0xA9EE3033,
-    0xA4AD16EA, 0xA06C0B5D, 0xD4326D90, 0xD0F37027, 0xDDB056FE,
-    0xD9714B49, 0xC7361B4C, 0xC3F706FB, 0xCEB42022, 0xCA753D95,
-    0xF23A8028, 0xF6FB9D9F, 0xFBB8BB46, 0xFF79A6F1, 0xE13EF6F4,
-    0xE5FFEB43, 0xE8BCCD9A, 0xEC7DD02D, 0x34867077, 0x30476DC0,
-    0x3D044B19, 0x39C556AE, 0x278206AB, 0x23431B1C, 0x2E003DC5,
-    0x2AC12072, 0x128E9DCF, 0x164F8078, 0x1B0CA6A1, 0x1FCDBB16,
-    0x018AEB13, 0x054BF6A4, 0x0808D07D, 0x0CC9CDCA, 0x7897AB07,
-    0x7C56B6B0, 0x71159069, 0x75D48DDE, 0x6B93DDDB, 0x6F52C06C,
-    0x6211E6B5, 0x66D0FB02, 0x5E9F46BF, 0x5A5E5B08, 0x571D7DD1,
-    0x53DC6066, 0x4D9B3063, 0x495A2DD4, 0x44190B0D, 0x40D816BA,
-    0xACA5C697, 0xA864DB20, 0xA527FDF9, 0xA1E6E04E, 0xBFA1B04B,
-    0xBB60ADFC, 0xB6238B25, 0xB2E29692, 0x8AAD2B2F, 0x8E6C3698,
-    0x832F1041, 0x87EE0DF6, 0x99A95DF3, 0x9D684044, 0x902B669D,
-    0x94EA7B2A, 0xE0B41DE7, 0xE4750050, 0xE9362689, 0xEDF73B3E,
-    0xF3B06B3B, 0xF771768C, 0xFA325055, 0xFEF34DE2, 0xC6BCF05F,
-    0xC27DEDE8, 0xCF3ECB31, 0xCBFFD686, 0xD5B88683, 0xD1799B34,
-    0xDC3ABDED, 0xD8FBA05A, 0x690CE0EE, 0x6DCDFD59, 0x608EDB80,
-    0x644FC637, 0x7A089632, 0x7EC98B85, 0x738AAD5C, 0x774BB0EB,
-    0x4F040D56, 0x4BC510E1, 0x46863638, 0x42472B8F, 0x5C007B8A,
-    0x58C1663D, 0x558240E4, 0x51435D53, 0x251D3B9E, 0x21DC2629,
-    0x2C9F00F0, 0x285E1D47, 0x36194D42, 0x32D850F5, 0x3F9B762C,
-    0x3B5A6B9B, 0x0315D626, 0x07D4CB91, 0x0A97ED48, 0x0E56F0FF,
-    0x1011A0FA, 0x14D0BD4D, 0x19939B94, 0x1D528623, 0xF12F560E,
-    0xF5EE4BB9, 0xF8AD6D60, 0xFC6C70D7, 0xE22B20D2, 0xE6EA3D65,
-    0xEBA91BBC, 0xEF68060B, 0xD727BBB6, 0xD3E6A601, 0xDEA580D8,
-    0xDA649D6F, 0xC423CD6A, 0xC0E2D0DD, 0xCDA1F604, 0xC960EBB3,
-    0xBD3E8D7E, 0xB9FF90C9, 0xB4BCB610, 0xB07DABA7, 0xAE3AFBA2,
-    0xAAFBE615, 0xA7B8C0CC, 0xA379DD7B, 0x9B3660C6, 0x9FF77D71,
-    0x92B45BA8, 0x9675461F, 0x8832161A, 0x8CF30BAD, 0x81B02D74,
-    0x857130C3, 0x5D8A9099, 0x594B8D2E, 0x5408ABF7, 0x50C9B640,
-    0x4E8EE645, 0x4A4FFBF2, 0x470CDD2B, 0x43CDC09C, 0x7B827D21,
-    0x7F436096, 0x7200464F, 0x76C15BF8, 0x68860BFD, 0x6C47164A,
-    0x61043093, 0x65C52D24, 0x119B4BE9, 0x155A565E, 0x18197087,
-    0x1CD86D30, 0x029F3D35, 0x065E2082, 0x0B1D065B, 0x0FDC1BEC,
-    0x3793A651, 0x3352BBE6, 0x3E119D3F, 0x3AD08088, 0x2497D08D,
-    0x2056CD3A, 0x2D15EBE3, 0x29D4F654, 0xC5A92679, 0xC1683BCE,
-    0xCC2B1D17, 0xC8EA00A0, 0xD6AD50A5, 0xD26C4D12, 0xDF2F6BCB,
-    0xDBEE767C, 0xE3A1CBC1, 0xE760D676, 0xEA23F0AF, 0xEEE2ED18,
-    0xF0A5BD1D, 0xF464A0AA, 0xF9278673, 0xFDE69BC4, 0x89B8FD09,
-    0x8D79E0BE, 0x803AC667, 0x84FBDBD0, 0x9ABC8BD5, 0x9E7D9662,
-    0x933EB0BB, 0x97FFAD0C, 0xAFB010B1, 0xAB710D06, 0xA6322BDF,
-    0xA2F33668, 0xBCB4666D, 0xB8757BDA, 0xB5365D03, 0xB1F740B4,
-};
-
-
+  return Anh_Utils::crc(data,(uint32)strlen(data));
+}
 
 
 //======================================================================================================================
@@ -965,11 +926,5 @@ void BString::setType(BStringType type)
 //======================================================================================================================
 uint32 BString::getCrc() const
 {
-  uint32 crc = 0xffffffff;  // starting seed
-  for (uint32 i = 0; i < mLength; i++)
-  {
-    crc = mCrcTable[mString[i] ^ (crc >> 24)] ^ (crc << 8);
-  }
-
-  return ~crc;
+  return Anh_Utils::crc(mString,mLength);
 }
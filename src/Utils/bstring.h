@@ -38,6 +38,9 @@ typedef std::vector<BString> BStringVector;
 
 #define BSTRING_ALLOC_BLOCK_SIZE      64
 
+// strings fitting in here, terminator included, live inside the BString and never touch the heap
+#define BSTRING_INLINE_SIZE           32
+
 enum BStringType
 {
   BSTRType_ANSI,
@@ -113,14 +116,14 @@ public:
 
 private:
     void _allocate();
+    void _release();
 
-    int8* mString;          // Pointer to the allocated buffer
+    int8* mString;          // Pointer to the allocated buffer, mInline for short strings
+    int8  mInline[BSTRING_INLINE_SIZE];
     BStringType mType;            // What format is the current string in.
     uint16 mAllocated;       // Length of the allocated buffer which should be a multiple of
     uint16 mCharacterWidth;  // Size of a single character in bytes
     uint16 mLength;          // Length of the string itself.  BStrings are NOT null terminated
-
-    static uint32 mCrcTable[256];
 };
 
 #endif //MMOSERVER_UTILS_BSTRING_H
@@ -34,7 +34,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #if(ANH_PLATFORM == ANH_PLATFORM_WIN32)
 #include <windows.h>
 #else
-#include <sys/time.h>
+#include <time.h>
 #endif
 
 using namespace Anh_Utils;
@@ -48,6 +48,9 @@ bool	Clock::mInsFlag    = false;
 
 Clock::Clock()
 {
+	// our scheduler needs the clock while we are still constructing it
+	mSingleton = this;
+
 	mStoredTime = getLocalTime();
 	mClockScheduler		= new Anh_Utils::Scheduler();
 	mClockScheduler->addTask(fastdelegate::MakeDelegate(this,&Clock::_setStoredTime),1,1000,NULL);
@@ -114,9 +117,10 @@ uint64 Clock::getLocalTime() const
 #if(ANH_PLATFORM == ANH_PLATFORM_WIN32)
 	return timeGetTime(); 
 #else
-	struct timeval tv;
-	gettimeofday(&tv, NULL);
-	return tv.tv_usec / 1000;
+	// milliseconds since an arbitrary point, like timeGetTime()
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
 #endif
 }
 
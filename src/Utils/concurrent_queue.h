@@ -25,70 +25,253 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 ---------------------------------------------------------------------------------------
 */
 
+
 #ifndef ANH_UTILS_CONCURRENT_QUEUE_H
 #define ANH_UTILS_CONCURRENT_QUEUE_H
 
-#include <boost/thread/recursive_mutex.hpp>
-#include <queue>
+#include "typedefs.h"
+#include "atomic.h"
+
+#include <boost/static_assert.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <deque>
 
 
 //======================================================================================================================
+//
+// Bounded lock free multi producer / multi consumer queue (a ring of cells with sequence numbers, every
+// cell is claimed with one compare and swap on the queue position, the sequence numbers rule out ABA).
+//
+// When the ring is full, items go to a mutex protected overflow deque until the consumers caught up, so
+// push never fails. Items of one producer are popped in the order they were pushed.
+// size() and empty() are lock free snapshots.
+//
 
 namespace Anh_Utils
 {
-	template<class T,class Container = std::deque<T>,class QueueMutex = boost::recursive_mutex >
+	template<class T,uint32 Capacity = 4096>
 	class concurrent_queue
 	{
 		public:
 
+			concurrent_queue()
+			: mEnqueuePos(0)
+			, mDequeuePos(0)
+			, mOverflowCount(0)
+			{
+				// Capacity needs to be a power of two
+				BOOST_STATIC_ASSERT(Capacity >= 2 && !(Capacity & (Capacity - 1)));
+
+				for(uint32 i = 0; i < Capacity; i++)
+				{
+					mCells[i].mSequence = i;
+				}
+			}
+
 			void push(const T& item)
 			{
-                boost::recursive_mutex::scoped_lock lk(mMutex);
+				if(!atomicLoad(&mOverflowCount) && _tryPush(item))
+				{
+					return;
+				}
 
-				mContainer.push_back(item);
+				boost::mutex::scoped_lock lk(mOverflowMutex);
+
+				mOverflow.push_back(item);
+				atomicIncrement(&mOverflowCount);
 			}
 
+			// returns T() if the queue is empty
 			T pop()
 			{
-                boost::recursive_mutex::scoped_lock lk(mMutex);
+				T item = T();
 
-				T item = mContainer.front();
-				mContainer.pop_front();
+				try_pop(item);
 
 				return(item);
 			}
 
-			bool empty() const
+			bool try_pop(T& item)
 			{
-                boost::recursive_mutex::scoped_lock lk(mMutex);
+				while(true)
+				{
+					if(_tryPop(item))
+					{
+						return(true);
+					}
+
+					// a producer claimed a cell but didnt finish writing it yet
+					if(atomicLoad(&mEnqueuePos) != atomicLoad(&mDequeuePos))
+					{
+						boost::this_thread::yield();
+						continue;
+					}
+
+					if(!atomicLoad(&mOverflowCount))
+					{
+						return(false);
+					}
+
+					boost::mutex::scoped_lock lk(mOverflowMutex);
+
+					if(mOverflow.empty())
+					{
+						return(false);
+					}
 
-				bool result = mContainer.empty();
+					item = mOverflow.front();
+					mOverflow.pop_front();
+					atomicDecrement(&mOverflowCount);
 
-				return(result);
+					return(true);
+				}
 			}
 
-			typename Container::size_type size()
+			// pops up to maxCount items into items, returns the amount popped
+			uint32 pop_batch(T* items,uint32 maxCount)
 			{
-                boost::recursive_mutex::scoped_lock lk(mMutex);
+				uint32 count = 0;
 
-				size_t result = mContainer.size();
+				while(count < maxCount && try_pop(items[count]))
+				{
+					++count;
+				}
 
-				return(result);
+				return(count);
 			}
 
-			T& front()
+			bool empty() const
+			{
+				return(size() == 0);
+			}
+
+			uint32 size() const
 			{
-                boost::recursive_mutex::scoped_lock lk(mMutex);
+				concurrent_queue* self = const_cast<concurrent_queue*>(this);
 
-				T item = mContainer.front();
+				uint32 dequeuePos = atomicLoad(&self->mDequeuePos);
+				uint32 enqueuePos = atomicLoad(&self->mEnqueuePos);
 
-				return(item);
+				// positions are read one after the other, a pop in between may overtake our enqueue snapshot
+				uint32 ringCount = ((int32)(enqueuePos - dequeuePos) > 0) ? enqueuePos - dequeuePos : 0;
+
+				return(ringCount + atomicLoad(&self->mOverflowCount));
+			}
+
+			// returns T() if the queue is empty, only meaningful with a single consumer
+			T front()
+			{
+				Cell* cell = &mCells[atomicLoad(&mDequeuePos) & (Capacity - 1)];
+
+				if(atomicLoad(&cell->mSequence) == atomicLoad(&mDequeuePos) + 1)
+				{
+					return(cell->mItem);
+				}
+
+				boost::mutex::scoped_lock lk(mOverflowMutex);
+
+				if(mOverflow.empty())
+				{
+					return(T());
+				}
+
+				return(mOverflow.front());
 			}
 
 		private:
 
-			Container		mContainer;
-			QueueMutex		mMutex;
+			struct Cell
+			{
+				volatile uint32	mSequence;
+				T				mItem;
+			};
+
+			bool _tryPush(const T& item)
+			{
+				uint32	pos = atomicLoad(&mEnqueuePos);
+				Cell*	cell;
+
+				while(true)
+				{
+					cell = &mCells[pos & (Capacity - 1)];
+
+					int32 diff = (int32)(atomicLoad(&cell->mSequence) - pos);
+
+					if(diff == 0)
+					{
+						if(atomicCompareAndSwap(&mEnqueuePos,pos,pos + 1))
+						{
+							break;
+						}
+
+						pos = atomicLoad(&mEnqueuePos);
+					}
+					else if(diff < 0)
+					{
+						// full
+						return(false);
+					}
+					else
+					{
+						pos = atomicLoad(&mEnqueuePos);
+					}
+				}
+
+				cell->mItem = item;
+				atomicStore(&cell->mSequence,pos + 1);
+
+				return(true);
+			}
+
+			bool _tryPop(T& item)
+			{
+				uint32	pos = atomicLoad(&mDequeuePos);
+				Cell*	cell;
+
+				while(true)
+				{
+					cell = &mCells[pos & (Capacity - 1)];
+
+					int32 diff = (int32)(atomicLoad(&cell->mSequence) - (pos + 1));
+
+					if(diff == 0)
+					{
+						if(atomicCompareAndSwap(&mDequeuePos,pos,pos + 1))
+						{
+							break;
+						}
+
+						pos = atomicLoad(&mDequeuePos);
+					}
+					else if(diff < 0)
+					{
+						// empty, or the producer of this cell is still writing
+						return(false);
+					}
+					else
+					{
+						pos = atomicLoad(&mDequeuePos);
+					}
+				}
+
+				item = cell->mItem;
+				atomicStore(&cell->mSequence,pos + Capacity);
+
+				return(true);
+			}
+
+			// keep the producer and consumer positions on their own cache lines
+			volatile uint32		mEnqueuePos;
+			int8				mPad1[60];
+			volatile uint32		mDequeuePos;
+			int8				mPad2[60];
+			volatile uint32		mOverflowCount;
+
+			Cell				mCells[Capacity];
+
+			boost::mutex		mOverflowMutex;
+			std::deque<T>		mOverflow;
 	};
 }
 
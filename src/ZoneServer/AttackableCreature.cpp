@@ -32,7 +32,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "MessageLib/MessageLib.h"
 #include "NpcManager.h"
 #include "PlayerObject.h"
-#include "QuadTree.h"
+#include "ObjectGrid.h"
 #include "ResourceContainer.h"
 #include "Weapon.h"
 #include "WorldManager.h"
@@ -381,7 +381,7 @@ bool AttackableCreature::setTargetInAttackRange(void)
 			{
 				// We only accepts new targets.
 				/*
-				ObjectIDList::iterator defenderIt = this->getDefenders()->begin();
+				ObjectIDList::const_iterator defenderIt = this->getDefenders()->begin();
 				bool newTarget = true;
 				while (defenderIt != this->getDefenders()->end())
 				{
@@ -501,7 +501,7 @@ bool AttackableCreature::showWarningInRange(void)
 		{
 			if (!(*it)->isIncapacitated() && !(*it)->isDead())
 			{
-				ObjectIDList::iterator defenderIt = this->getDefenders()->begin();
+				ObjectIDList::const_iterator defenderIt = this->getDefenders()->begin();
 				bool newTarget = true;
 				while (defenderIt != this->getDefenders()->end())
 				{
@@ -589,7 +589,7 @@ bool AttackableCreature::setTargetDefenderWithinWeaponRange(void)
 {
 	bool foundTarget = false;
 
-	ObjectIDList::iterator defenderIt = this->getDefenders()->begin();
+	ObjectIDList::const_iterator defenderIt = this->getDefenders()->begin();
 	while (defenderIt != this->getDefenders()->end())
 	{
 		if (CreatureObject* defenderCreature = dynamic_cast<CreatureObject*>(gWorldManager->getObjectById((*defenderIt))))
@@ -656,7 +656,7 @@ bool AttackableCreature::setTargetDefenderWithinMaxRange(void)
 {
 	bool foundTarget = false;
 
-	ObjectIDList::iterator defenderIt = this->getDefenders()->begin();
+	ObjectIDList::const_iterator defenderIt = this->getDefenders()->begin();
 	while (defenderIt != this->getDefenders()->end())
 	{
 		if (CreatureObject* defenderCreature = dynamic_cast<CreatureObject*>(gWorldManager->getObjectById((*defenderIt))))
@@ -744,7 +744,7 @@ uint64 AttackableCreature::getDefenderOutOfAggroRange(void)
 {
 	uint64 targetOutOfRange = 0;
 
-	ObjectIDList::iterator defenderIt = this->getDefenders()->begin();
+	ObjectIDList::const_iterator defenderIt = this->getDefenders()->begin();
 	while (defenderIt != this->getDefenders()->end())
 	{
 		if (CreatureObject* defenderCreature = dynamic_cast<CreatureObject*>(gWorldManager->getObjectById((*defenderIt))))
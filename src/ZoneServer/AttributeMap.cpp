@@ -0,0 +1,157 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#include "AttributeMap.h"
+
+#include "Utils/bstring.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+
+//======================================================================================================================
+
+namespace
+{
+	struct KeyLess
+	{
+		bool operator()(const AttributeMap::value_type& entry,uint32 keyCrc) const { return entry.first < keyCrc; }
+	};
+
+	// only plain decimal numbers count, anything strtod would take beyond that (hex, inf, whitespace) stays text
+	bool isNumber(const std::string& value,bool* isFloat)
+	{
+		const char*	c		= value.c_str();
+		bool		digits	= false;
+
+		*isFloat = false;
+
+		if(*c == '-' || *c == '+')
+			++c;
+
+		for(;*c;++c)
+		{
+			if(*c >= '0' && *c <= '9')
+				digits = true;
+			else if(*c == '.' || *c == 'e' || *c == 'E' || ((*c == '-' || *c == '+') && (c[-1] == 'e' || c[-1] == 'E')))
+				*isFloat = true;
+			else
+				return(false);
+		}
+
+		return(digits);
+	}
+}
+
+//======================================================================================================================
+
+void AttributeValue::set(const std::string& value)
+{
+	bool isFloat;
+
+	mString		= value;
+	mType		= AttributeValue_String;
+	mInteger	= 0;
+
+	if(!isNumber(value,&isFloat))
+		return;
+
+	char* end;
+	errno = 0;
+
+	if(!isFloat)
+	{
+		long long integer = strtoll(value.c_str(),&end,10);
+
+		// too big for us, lexical_cast can still have a go at it
+		if(*end || errno == ERANGE)
+			return;
+
+		mInteger	= static_cast<int64>(integer);
+		mType		= AttributeValue_Integer;
+	}
+	else
+	{
+		double number = strtod(value.c_str(),&end);
+
+		if(*end || errno == ERANGE)
+			return;
+
+		mFloat		= number;
+		mType		= AttributeValue_Float;
+	}
+}
+
+//======================================================================================================================
+
+template<>
+bool AttributeValue::get<BString>(BString* value) const
+{
+	*value = mString.c_str();
+	return(true);
+}
+
+//======================================================================================================================
+
+AttributeMap::iterator AttributeMap::find(uint32 keyCrc)
+{
+	iterator it = std::lower_bound(mEntries.begin(),mEntries.end(),keyCrc,KeyLess());
+
+	if(it != mEntries.end() && (*it).first == keyCrc)
+		return(it);
+
+	return(mEntries.end());
+}
+
+//======================================================================================================================
+
+AttributeMap::const_iterator AttributeMap::find(uint32 keyCrc) const
+{
+	const_iterator it = std::lower_bound(mEntries.begin(),mEntries.end(),keyCrc,KeyLess());
+
+	if(it != mEntries.end() && (*it).first == keyCrc)
+		return(it);
+
+	return(mEntries.end());
+}
+
+//======================================================================================================================
+
+std::pair<AttributeMap::iterator,bool> AttributeMap::insert(uint32 keyCrc,const std::string& value)
+{
+	iterator it = std::lower_bound(mEntries.begin(),mEntries.end(),keyCrc,KeyLess());
+
+	if(it != mEntries.end() && (*it).first == keyCrc)
+		return(std::make_pair(it,false));
+
+	it = mEntries.insert(it,std::make_pair(keyCrc,AttributeValue(value)));
+
+	return(std::make_pair(it,true));
+}
+
+//======================================================================================================================
+
@@ -0,0 +1,173 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#ifndef	ANH_ZONESERVER_ATTRIBUTEMAP_H
+#define	ANH_ZONESERVER_ATTRIBUTEMAP_H
+
+#include "Utils/typedefs.h"
+
+#include <boost/lexical_cast.hpp>
+#include <boost/type_traits/is_integral.hpp>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+class BString;
+
+//======================================================================================================================
+
+enum AttributeValueType
+{
+	AttributeValue_String	= 0,
+	AttributeValue_Integer	= 1,
+	AttributeValue_Float	= 2
+};
+
+//======================================================================================================================
+//
+// an attribute value, numbers get parsed once when the value is set and are read natively from then on
+// the text is kept as it came, so the client and the db see exactly what was stored
+//
+
+class AttributeValue
+{
+	public:
+
+		AttributeValue() : mType(AttributeValue_String),mInteger(0){}
+		explicit AttributeValue(const std::string& value){ set(value); }
+
+		void				set(const std::string& value);
+
+		uint8				getType() const { return mType; }
+		const std::string&	str() const { return mString; }
+		const char*			c_str() const { return mString.c_str(); }
+
+		// false if the value cant be read as T
+		template<typename T> bool	get(T* value) const;
+
+	private:
+
+		uint8			mType;
+
+		union
+		{
+			int64		mInteger;
+			double		mFloat;
+		};
+
+		std::string		mString;
+};
+
+//======================================================================================================================
+
+template<typename T>
+bool AttributeValue::get(T* value) const
+{
+	if(mType == AttributeValue_String)
+	{
+		// neither a whole nor a decimal number, leave it to a real cast
+		try
+		{
+			*value = boost::lexical_cast<T>(mString);
+			return(true);
+		}
+		catch(boost::bad_lexical_cast &)
+		{
+			return(false);
+		}
+	}
+
+	// whole types only take whole numbers that fit, like lexical_cast would
+	if(boost::is_integral<T>::value)
+	{
+		if(mType != AttributeValue_Integer)
+			return(false);
+
+		*value = static_cast<T>(mInteger);
+
+		return(static_cast<int64>(*value) == mInteger);
+	}
+
+	if(mType == AttributeValue_Integer)
+		*value = static_cast<T>(mInteger);
+	else
+		*value = static_cast<T>(mFloat);
+
+	return(true);
+}
+
+template<>
+inline bool AttributeValue::get<std::string>(std::string* value) const
+{
+	*value = mString;
+	return(true);
+}
+
+template<>
+bool AttributeValue::get<BString>(BString* value) const;
+
+//======================================================================================================================
+//
+// flat map of attribute values, sorted by the crc of their key
+// objects only carry a handful of attributes, so a sorted vector beats the node based map on both lookups and memory
+//
+
+class AttributeMap
+{
+	public:
+
+		typedef std::pair<uint32,AttributeValue>	value_type;
+		typedef std::vector<value_type>				Entries;
+		typedef Entries::iterator					iterator;
+		typedef Entries::const_iterator				const_iterator;
+
+		iterator				begin(){ return mEntries.begin(); }
+		iterator				end(){ return mEntries.end(); }
+		const_iterator			begin() const { return mEntries.begin(); }
+		const_iterator			end() const { return mEntries.end(); }
+
+		uint32					size() const { return static_cast<uint32>(mEntries.size()); }
+		bool					empty() const { return mEntries.empty(); }
+		void					clear(){ mEntries.clear(); }
+
+		iterator				find(uint32 keyCrc);
+		const_iterator			find(uint32 keyCrc) const;
+
+		// like std::map, an existing value is left alone
+		std::pair<iterator,bool>	insert(uint32 keyCrc,const std::string& value);
+		void						erase(iterator it){ mEntries.erase(it); }
+
+	private:
+
+		Entries					mEntries;
+};
+
+//======================================================================================================================
+
+#endif
+
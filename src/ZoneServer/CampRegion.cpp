@@ -29,7 +29,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Camp.h"
 #include "PlayerObject.h"
 #include "QTRegion.h"
-#include "QuadTree.h"
+#include "ObjectGrid.h"
 #include "WorldManager.h"
 #include "ZoneTree.h"
 #include "MessageLib/MessageLib.h"
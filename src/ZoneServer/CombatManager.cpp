@@ -43,11 +43,16 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "DatabaseManager/DataBinding.h"
 
 #include "Utils/rand.h"
+#include "Utils/crc.h"
 //=========================================================================================
 
 bool			CombatManager::mInsFlag		= false;
 CombatManager*	CombatManager::mSingleton	= NULL;
 
+// looked up on every hit, so we dont hash the keys each time
+static const uint32 WeaponDamageMinCrc = Anh_Utils::crc("cat_wpn_damage.wpn_damage_min");
+static const uint32 WeaponDamageMaxCrc = Anh_Utils::crc("cat_wpn_damage.wpn_damage_max");
+
 //=========================================================================================
 
 CombatManager::CombatManager(Database* database) :
@@ -420,13 +425,13 @@ uint8 CombatManager::_executeAttack(CreatureObject* attacker,CreatureObject* def
 
 		// NOTE: Some weapon data just for tesing and to give the npc a fair chance...
 
-		if (weapon->hasAttribute("cat_wpn_damage.wpn_damage_min"))
+		if (weapon->hasAttribute(WeaponDamageMinCrc))
 		{
-			baseMinDamage = weapon->getAttribute<int32>("cat_wpn_damage.wpn_damage_min");
+			baseMinDamage = weapon->getAttribute<int32>(WeaponDamageMinCrc);
 		}
-		if (weapon->hasAttribute("cat_wpn_damage.wpn_damage_max"))
+		if (weapon->hasAttribute(WeaponDamageMaxCrc))
 		{
-			baseMaxDamage = weapon->getAttribute<int32>("cat_wpn_damage.wpn_damage_max");
+			baseMaxDamage = weapon->getAttribute<int32>(WeaponDamageMaxCrc);
 		}
 
 
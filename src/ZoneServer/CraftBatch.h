@@ -102,6 +102,7 @@ class CraftAttribute
 
 		uint32	getAttributeId(){ return mAttributeId; }
 		string	getAttributeKey(){ return mAttributeKey; }
+		uint32	getAttributeKeyCrc(){ return mAttributeKeyCrc; }
 		float	getMin(){ return mMin; }
 		float	getMax(){ return mMax; }
 		uint32  getSchemWeightBatch(){return mSchemWeightBatch;}
@@ -113,6 +114,7 @@ class CraftAttribute
 		uint32  mListId;
 		uint32	mAttributeId;
 		string	mAttributeKey;
+		uint32	mAttributeKeyCrc;
 		uint8	mType;
 		float	mMin;
 		float	mMax;
@@ -1530,9 +1530,9 @@ void CraftingSession::modifyAttributeValue(CraftAttribute* att, float attValue)
 	{
 		int32 intAtt = 0;
 		//is there an attribute of a component that affects us??
-		if(mManufacturingSchematic->hasPPAttribute(att->getAttributeKey()))
+		if(mManufacturingSchematic->hasPPAttribute(att->getAttributeKeyCrc()))
 		{
-			float attributeAddValue = mManufacturingSchematic->getPPAttribute<float>(att->getAttributeKey());
+			float attributeAddValue = mManufacturingSchematic->getPPAttribute<float>(att->getAttributeKeyCrc());
 			intAtt = (int32)(ceil(attributeAddValue));
 		}
 
@@ -1544,9 +1544,9 @@ void CraftingSession::modifyAttributeValue(CraftAttribute* att, float attValue)
 		float f = rndFloat(attValue);
 
 		//is there an attribute of a component that affects us??
-		if(mManufacturingSchematic->hasPPAttribute(att->getAttributeKey()))
+		if(mManufacturingSchematic->hasPPAttribute(att->getAttributeKeyCrc()))
 		{
-			float attributeAddValue = mManufacturingSchematic->getPPAttribute<float>(att->getAttributeKey());
+			float attributeAddValue = mManufacturingSchematic->getPPAttribute<float>(att->getAttributeKeyCrc());
 			f += rndFloat(attributeAddValue);
 
 		}
@@ -816,6 +816,8 @@ void CreatureObject::die()
 			defenderIt = mDefenders.erase(defenderIt);
 		}
 
+		invalidateBaseline(BaselineCache_CREO_6);
+
 		// bring up the clone selection window
 		ObjectSet inRangeBuildings;
 		BStringVector buildingNames;
@@ -962,6 +964,7 @@ void CreatureObject::addDefender(uint64 defenderId)
 	}
 
 	mDefenders.push_back(defenderId);
+	invalidateBaseline(BaselineCache_CREO_6);
 }
 
 
@@ -972,6 +975,7 @@ void CreatureObject::clearDefenders()
 	if (mDefenders.size())
 	{
 		mDefenders.clear();
+		invalidateBaseline(BaselineCache_CREO_6);
 	}
 }
 
@@ -987,6 +991,8 @@ void CreatureObject::removeAllDefender(void)
 		it = mDefenders.erase(it);
 		index++;
 	}
+
+	invalidateBaseline(BaselineCache_CREO_6);
 }
 
 //=============================================================================
@@ -1003,6 +1009,7 @@ void CreatureObject::removeDefenderAndUpdateList(uint64 defenderId)
 		{
 			gMessageLib->sendDefenderUpdate(this,0,index,defenderId);
 			(void)mDefenders.erase(it);
+			invalidateBaseline(BaselineCache_CREO_6);
 			break;
 		}
 		index++;
@@ -1035,6 +1042,7 @@ bool CreatureObject::setAsActiveDefenderAndUpdateList(uint64 defenderId)
 			// Move the defender to top of list.
 			(void)mDefenders.erase(it);
 			mDefenders.push_front(defenderId);
+			invalidateBaseline(BaselineCache_CREO_6);
 			// gMessageLib->sendDefenderUpdate(this,2,0,defenderId);
 
 			// gMessageLib->sendNewDefenderList(this);
@@ -71,12 +71,12 @@ class CreatureObject : public MovingObject
 		Ham*				getHam(){ return &mHam; }
 
 		string				getFirstName() const { return mFirstName; }
-		void				setFirstName(string name){ mFirstName = name; }
+		void				setFirstName(string name){ mFirstName = name; invalidateBaselines(); }
 		string				getLastName() const { return mLastName; }
-		void				setLastName(string name){ mLastName = name; }
+		void				setLastName(string name){ mLastName = name; invalidateBaselines(); }
 
 		uint8				getPosture() const { return mPosture; }
-		void				setPosture(uint8 posture){ mPosture = posture; }
+		void				setPosture(uint8 posture){ mPosture = posture; invalidateBaselines(); }
 
 		// Postures are NOT bitwise constants.
 		// Can NOT use bitwise operation on non bitwise constants.
@@ -87,28 +87,28 @@ class CreatureObject : public MovingObject
 		// bool				checkPosturesEither(uint8 postures){ return((mPosture & postures) != 0); }
 
 		float				getScale(){ return mScale; }
-		void				setScale(float scale){ mScale = scale; }
+		void				setScale(float scale){ mScale = scale; invalidateBaselines(); }
 		uint16				getCL(){ return mCL; }
-		void				setCL(uint16 cl){ mCL = cl; }
+		void				setCL(uint16 cl){ mCL = cl; invalidateBaselines(); }
 		uint8				getRaceId() const { return mRaceId; }
 		void				setRaced(uint8 id){ mRaceId = id; }
 		string				getSpeciesString(){ return mSpecies; }
-		void				setSpeciesString(const int8* species){ mSpecies = species; }
+		void				setSpeciesString(const int8* species){ mSpecies = species; invalidateBaselines(); }
 		string				getSpeciesGroup(){ return mSpeciesGroup; }
-		void				setSpeciesGroup(const int8* speciesGroup){ mSpeciesGroup = speciesGroup; }
+		void				setSpeciesGroup(const int8* speciesGroup){ mSpeciesGroup = speciesGroup; invalidateBaselines(); }
 		//Object*			getTarget() const { return mTargetObject; }
 		Object*				getTarget() const;
 		// void				setTarget(Object* object){ mTargetObject = object; }
-		void				setTarget(uint64 targetId){ mTargetId = targetId; }
+		void				setTarget(uint64 targetId){ mTargetId = targetId; invalidateBaselines(); }
 		// uint64			getTargetId() const { return(mTargetObject != NULL) ? mTargetObject->getId():0; }
 		uint64				getTargetId() const { return mTargetId; }
 		uint64				getGroupId() const { return mGroupId; }
-		void				setGroupId(uint64 groupId) { mGroupId = groupId; }
+		void				setGroupId(uint64 groupId) { mGroupId = groupId; invalidateBaselines(); }
 
 		uint16*				getCustomization(){ return &mCustomization[0]; }
 		void				setCustomization(uint8 index, uint16 val){ mCustomization[index] = val; }
 		string				getCustomizationStr(){ return mCustomizationStr; }
-		void				setCustomizationStr(const int8* customization){ mCustomizationStr = customization; }
+		void				setCustomizationStr(const int8* customization){ mCustomizationStr = customization; invalidateBaselines(); }
 
 		//we need to reference hair outside of the equipmanager as the hairslot can be occupied by helmets
 		Object*				getHair(){ return mHair; }
@@ -118,7 +118,7 @@ class CreatureObject : public MovingObject
 		void				setCreoGroup(CreatureGroup group){ mCreoGroup = group; }
 
 		uint8				getMoodId() const { return mMoodId; }
-		void				setMoodId(uint8 id){ mMoodId = id; }
+		void				setMoodId(uint8 id){ mMoodId = id; invalidateBaselines(); }
 
 		// skills
 		void				addSkill(Skill* skill){ mSkills.push_back(skill); }
@@ -160,8 +160,8 @@ class CreatureObject : public MovingObject
 		// states
 		uint64				getState(){ return mState; }
 		//void				setState(uint64 state){ mState = state; }
-		void				toggleStateOn(CreatureState state){ mState = mState | state; }
-		void				toggleStateOff(CreatureState state){ mState = mState & ~state; }
+		void				toggleStateOn(CreatureState state){ mState = mState | state; invalidateBaselines(); }
+		void				toggleStateOff(CreatureState state){ mState = mState & ~state; invalidateBaselines(); }
 		//void				toggleState(CreatureState state){ mState = mState ^ state; }
 		bool				checkState(CreatureState state){ return((mState & state) == state); }
 		bool				checkStates(uint64 states){ return((mState & states) == states); }
@@ -171,7 +171,7 @@ class CreatureObject : public MovingObject
 		string				getFaction(){ return mFaction; }
 		void				setFaction(const int8* faction){ mFaction = faction; }
 		uint8				getFactionRank(){ return mFactionRank; }
-		void				setFactionRank(uint8 rank){ mFactionRank = rank; }
+		void				setFactionRank(uint8 rank){ mFactionRank = rank; invalidateBaselines(); }
 		FactionList*		getFactionList(){ return &mFactionList; }
 		int32				getFactionPointsByFactionId(uint32 id);
 		bool				updateFactionPoints(uint32 factionId,int32 value);
@@ -199,10 +199,10 @@ class CreatureObject : public MovingObject
 		void				setPerformingState(PerformingState state){ mPendingPerform = state; }
 
 		uint32				getPerformanceId(){ return mPerformanceId; }
-		void				setPerformanceId(uint32 Id){ mPerformanceId = Id; }
+		void				setPerformanceId(uint32 Id){ mPerformanceId = Id; invalidateBaselines(); }
 
 		string				getCurrentAnimation(){ return mCurrentAnimation; }
-		void				setCurrentAnimation(string state){ mCurrentAnimation = state; }
+		void				setCurrentAnimation(string state){ mCurrentAnimation = state; invalidateBaselines(); }
 
 		bool				isStationary(){ return mStationary; }
 		void				setStationary(bool val){ mStationary = val; }
@@ -210,7 +210,8 @@ class CreatureObject : public MovingObject
 		uint32				UpdatePerformanceCounter();
 
 
-		ObjectIDList*		getDefenders(){ return &mDefenders; }
+		// the defender list is part of CREO_6, change it through the functions below only
+		const ObjectIDList*	getDefenders() const { return &mDefenders; }
 		void				addDefender(uint64 defenderId);
 		void				removeAllDefender(void);
 
@@ -277,7 +278,6 @@ class CreatureObject : public MovingObject
 
 		BuffList			mBuffList;
 		FactionList			mFactionList;
-		ObjectIDList		mDefenders;
 		SkillCommandMap		mSkillCommandMap;
 		SkillCommandList	mSkillCommands;
 		SkillList			mSkills;
@@ -346,6 +346,10 @@ class CreatureObject : public MovingObject
 		void				SetBuffAsyncCount(uint32 count){mBuffAsyncCount = count; }
 		void				IncBuffAsyncCount(){mBuffAsyncCount++; }
 		void				DecBuffAsyncCount(){mBuffAsyncCount--; }
+
+	private:
+
+		ObjectIDList		mDefenders;
 };
 
 //=============================================================================
@@ -32,6 +32,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "DatabaseManager/DatabaseResult.h"
 #include "DatabaseManager/DataBinding.h"
 #include "Utils/utils.h"
+#include "Utils/crc.h"
 
 
 
@@ -90,35 +91,43 @@ void FactoryBase::_buildAttributeMap(Object* object,DatabaseResult* result)
 {
 	Attribute_QueryContainer	attribute;
 	uint64						count = result->getRowCount();
-	int8						str[256];
-	BStringVector				dataElements;
 
 	for(uint64 i = 0;i < count;i++)
 	{
 		result->GetNextRow(mAttributeBinding,(void*)&attribute);
-		if(attribute.mKey.getCrc() == BString("cat_manf_schem_ing_resource").getCrc())
-		{
-			attribute.mValue.split(dataElements,' ');
-			sprintf(str,"cat_manf_schem_ing_resource.\"%s",dataElements[0].getAnsi());
+		_addAttribute(object,&attribute);
+	}
+
+	object->setLoadState(LoadState_Loaded);
+}
+
+//=============================================================================
+
+void FactoryBase::_addAttribute(Object* object,Attribute_QueryContainer* attribute)
+{
+	int8			str[256];
+	BStringVector	dataElements;
 
-			attribute.mKey		= BString(str);
-			attribute.mValue	= dataElements[1].getAnsi();
+	if(attribute->mKey.getCrc() == Anh_Utils::crc("cat_manf_schem_ing_resource"))
+	{
+		attribute->mValue.split(dataElements,' ');
+		sprintf(str,"cat_manf_schem_ing_resource.\"%s",dataElements[0].getAnsi());
 
-			//add key to the worldmanager
-			if(gWorldManager->getAttributeKey(attribute.mKey.getCrc()) == "")
-			{
-				gWorldManager->mObjectAttributeKeyMap.insert(std::make_pair(attribute.mKey.getCrc(),attribute.mKey));
-			}
+		attribute->mKey		= BString(str);
+		attribute->mValue	= dataElements[1].getAnsi();
 
+		//add key to the worldmanager
+		if(gWorldManager->getAttributeKey(attribute->mKey.getCrc()) == "")
+		{
+			gWorldManager->mObjectAttributeKeyMap.insert(std::make_pair(attribute->mKey.getCrc(),attribute->mKey));
 		}
 
-		if(attribute.mInternal)
-			object->addInternalAttribute(attribute.mKey,std::string(attribute.mValue.getAnsi()));
-		else
-			object->addAttribute(attribute.mKey,std::string(attribute.mValue.getAnsi()));
 	}
 
-	object->setLoadState(LoadState_Loaded);
+	if(attribute->mInternal)
+		object->addInternalAttribute(attribute->mKey,std::string(attribute->mValue.getAnsi()));
+	else
+		object->addAttribute(attribute->mKey,std::string(attribute->mValue.getAnsi()));
 }
 
 //=============================================================================
@@ -42,6 +42,7 @@ class DispatchClient;
 class ObjectFactoryCallback;
 class InLoadingContainer;
 class Type1_QueryContainer;
+class Attribute_QueryContainer;
 class Object;
 class Item;
 class QueryContainerBase;
@@ -70,6 +71,7 @@ class FactoryBase : public DatabaseCallback
 	protected:
 
 		void				_buildAttributeMap(Object* object,DatabaseResult* result);
+		void				_addAttribute(Object* object,Attribute_QueryContainer* attribute);
 
 		InLoadingContainer* _getObject(uint64 id);
 		bool				_removeFromObjectLoadMap(uint64 id);
@@ -172,6 +174,9 @@ class Attribute_QueryContainer
 		string	mKey;
 		string	mValue;
 		uint8	mInternal;
+
+		// only bound when the attributes of several objects come in one result
+		uint64	mObjectId;
 };
 
 //=============================================================================
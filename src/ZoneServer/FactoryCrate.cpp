@@ -29,6 +29,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Inventory.h"
 #include "Item_Enums.h"
 #include "ObjectFactory.h"
+#include "PersistenceManager.h"
 #include "PlayerObject.h"
 #include "StructureManager.h"
 #include "WorldManager.h"
@@ -205,7 +206,7 @@ int32 FactoryCrate::decreaseContent(uint32 amount)
 	}
 
 	this->setAttribute("factory_count",boost::lexical_cast<std::string>(newAmount));
-	gWorldManager->getDatabase()->ExecuteSqlAsync(0,0,"UPDATE item_attributes SET value='%i' WHERE item_id=%"PRIu64" AND attribute_id=%u",newAmount,this->getId(),AttrType_factory_count);
+	gPersistenceManager->setAttribute(PersistTable_ItemAttributes,this->getId(),AttrType_factory_count,boost::lexical_cast<std::string>(newAmount));
 
 	return newAmount;
 }
@@ -206,6 +206,9 @@ void Ham::updateBattleFatigue(int32 bf, bool sendUpdate)
 		mBattleFatigue = 0;
 	}
 
+	if(mParent)
+		mParent->invalidateBaseline(BaselineCache_CREO_3);
+
 	if(sendUpdate)
 		gMessageLib->sendBFUpdateCreo3(mParent);
 }
@@ -225,6 +228,9 @@ void Ham::setBattleFatigue(int32 bf)
 	{
 		mBattleFatigue = 0;
 	}
+
+	if(mParent)
+		mParent->invalidateBaseline(BaselineCache_CREO_3);
 }
 
 //===========================================================================
@@ -297,6 +303,9 @@ void Ham::setTargetStatValue(uint8 propertyIndex,int32 propertyValue)
 void Ham::setPropertyValue(uint8 propertyIndex,uint8 valueIndex, int32 propertyValue)
 {
 	mHamBars[propertyIndex]->setValue(valueIndex,propertyValue);
+
+	if(mParent)
+		mParent->invalidateBaselines();
 }
 
 //===========================================================================
@@ -340,6 +349,10 @@ void Ham::updatePrimaryWounds(int32 propertyDelta)
 
 int32 Ham::updatePropertyValue(uint8 barIndex,uint8 valueIndex,int32 propertyDelta,bool damage,bool sendUpdate, bool debuff)
 {
+	// the hambars are part of both creature baselines, whether we send a delta or not
+	if(mParent)
+		mParent->invalidateBaselines();
+
 	int32 mod = propertyDelta;
 	if(propertyDelta == 0)
 	{
@@ -31,7 +31,6 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #define     gHeightmap    Heightmap::getSingletonPtr()
 
 #include "Utils/typedefs.h"
-#include "Utils/lockfree_queue.h"
 #include <boost/thread/thread.hpp>
 #include <string>
 #include "HeightmapAsyncContainer.h"
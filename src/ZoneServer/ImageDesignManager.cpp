@@ -39,6 +39,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "DatabaseManager/Database.h"
 
 #include "Common/MessageFactory.h"
+#include "Utils/crc.h"
 
 //======================================================================================================================
 //gets the information on a holoemote from the loaded db data
@@ -91,7 +92,7 @@ string EntertainerManager::getHoloNames()
 	HoloEmoteEffects::iterator it = mHoloList.begin();
 	while(it != mHoloList.end())
 	{
-		if ((*it)->pCRC != BString("all").getCrc())
+		if ((*it)->pCRC != Anh_Utils::crc("all"))
 		{
 			if(isNew)
 			{
@@ -733,7 +734,7 @@ void EntertainerManager::commitIdChanges(PlayerObject* customer,PlayerObject* de
 	{
 		gLogger->log(LogManager::DEBUG,"ID apply changes : attribute : %s crc : %u", it->first.getAnsi(),it->first.getCrc());
 		//apply the attributes and retrieve the data to update the db
-		if(it->first.getCrc() != BString("height").getCrc())
+		if(it->first.getCrc() != Anh_Utils::crc("height"))
 		{
 			data = commitIdAttribute(customer, it->first, it->second);
 		}
@@ -28,6 +28,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Bank.h"
 #include "Inventory.h"
 #include "WorldConfig.h"
+#include "PersistenceManager.h"
 #include "PlayerObject.h"
 #include "TangibleObject.h"
 #include "TreasuryManager.h"
@@ -141,7 +142,7 @@ void InsuranceTerminal::handleObjectMenuSelect(uint8 messageType,Object* srcObje
 							{
 								// Update attribute.
 								tangibleObject->setInternalAttribute("insured","1");
-								gWorldManager->getDatabase()->ExecuteSqlAsync(NULL,NULL,"UPDATE item_attributes SET value=1 WHERE item_id=%"PRIu64" AND attribute_id=%u",tangibleObject->getId(), 1270);
+								gPersistenceManager->setAttribute(PersistTable_ItemAttributes,tangibleObject->getId(),1270,"1");
 
 								tangibleObject->setTypeOptions(tangibleObject->getTypeOptions() | 4);
 
@@ -352,7 +353,7 @@ void InsuranceTerminal::handleUIEvent(uint32 action,int32 element,string inputSt
 							// Update attribute.
 							// string str("insured");
 							tangibleObject->setInternalAttribute("insured","1");
-							gWorldManager->getDatabase()->ExecuteSqlAsync(NULL,NULL,"UPDATE item_attributes SET value=1 WHERE item_id=%"PRIu64" AND attribute_id=%u",tangibleObject->getId(), 1270);
+							gPersistenceManager->setAttribute(PersistTable_ItemAttributes,tangibleObject->getId(),1270,"1");
 							
 							tangibleObject->setTypeOptions(tangibleObject->getTypeOptions() | 4);
 
@@ -516,7 +517,7 @@ void InsuranceTerminal::handleUIEvent(uint32 action,int32 element,string inputSt
 								// Insure the item.
 								// Update attribute.
 								tangibleObject->setInternalAttribute("insured","1");
-								gWorldManager->getDatabase()->ExecuteSqlAsync(NULL,NULL,"UPDATE item_attributes SET value=1 WHERE item_id=%"PRIu64" AND attribute_id=%u",tangibleObject->getId(), 1270);
+								gPersistenceManager->setAttribute(PersistTable_ItemAttributes,tangibleObject->getId(),1270,"1");
 
 								tangibleObject->setTypeOptions(tangibleObject->getTypeOptions() | 4);
 
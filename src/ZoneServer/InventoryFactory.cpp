@@ -27,6 +27,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "InventoryFactory.h"
 #include "Inventory.h"
+#include "ItemFactory.h"
 #include "ObjectFactoryCallback.h"
 #include "TangibleFactory.h"
 #include "WorldManager.h"
@@ -155,20 +156,21 @@ void InventoryFactory::handleDatabaseJobComplete(void* ref,DatabaseResult* resul
 
 			mObjectLoadMap.insert(std::make_pair(inventory->getId(),new(mILCPool.ordered_malloc()) InLoadingContainer(inventory,asyncContainer->mOfCallback,asyncContainer->mClient,static_cast<uint8>(count))));
 
+			bool requestTree = false;
+
 			for(uint32 i = 0;i < count;i++)
 			{
 				result->GetNextRow(binding,&queryContainer);
 
 				if(strcmp(queryContainer.mString.getAnsi(),"containers") == 0)
 					mTangibleFactory->requestObject(this,queryContainer.mId,TanGroup_Container,0,asyncContainer->mClient);
-				else if(strcmp(queryContainer.mString.getAnsi(),"items") == 0)
-					mTangibleFactory->requestObject(this,queryContainer.mId,TanGroup_Item,0,asyncContainer->mClient);
-				else if(strcmp(queryContainer.mString.getAnsi(),"resource_containers") == 0)
-					mTangibleFactory->requestObject(this,queryContainer.mId,TanGroup_ResourceContainer,0,asyncContainer->mClient);
-				
-					
-			
+				else
+					requestTree = true;
 			}
+
+			// items and resource containers come with all their content in one go
+			if(requestTree)
+				gItemFactory->requestContainerTree(this,inventory->getId(),asyncContainer->mClient);
 			
 			mDatabase->DestroyDataBinding(binding);
 		}
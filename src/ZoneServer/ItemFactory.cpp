@@ -38,6 +38,9 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Item.h"
 #include "ManufacturingSchematic.h"
 #include "Medicine.h"
+#include "PersistenceManager.h"
+#include "ResourceContainer.h"
+#include "ResourceContainerFactory.h"
 #include "ObjectFactoryCallback.h"
 #include "TangibleFactory.h"
 #include "Scout.h"
@@ -50,12 +53,14 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "WorldManager.h"
 #include "LogManager/LogManager.h"
 #include "DatabaseManager/Database.h"
+#include "DatabaseManager/DatabaseJob.h"
 #include "DatabaseManager/DatabaseResult.h"
 #include "DatabaseManager/DataBinding.h"
 #include "WorldConfig.h"
 
 #include "Utils/utils.h"
 
+#include <algorithm>
 #include <cassert>
 
 //=============================================================================
@@ -138,17 +143,10 @@ void ItemFactory::handleDatabaseJobComplete(void* ref,DatabaseResult* result)
 			if(item->getCapacity() && (asyncContainer->mDepth <= ContainerDepth))
 			{
 				item->setLoadState(LoadState_ContainerContent);
-				// query contents				
-				QueryContainerBase* asContainer = new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(asyncContainer->mOfCallback,ItemFactoryQuery_Items,asyncContainer->mClient);
-				asContainer->mObject = item;
-				asContainer->mDepth = asyncContainer->mDepth;
 
 				//containers are normal items like furniture, lightsabers and stuff
-				mDatabase->ExecuteSqlAsync(this,asContainer,
-						"(SELECT \'items\',items.id FROM items WHERE (parent_id=%"PRIu64"))"
-						" UNION (SELECT \'resource_containers\',resource_containers.id FROM resource_containers WHERE (parent_id=%"PRIu64"))",
-						item->getId(),item->getId());
-				
+				//their whole content comes along in one job
+				_requestContainerTree(asyncContainer->mOfCallback,item->getId(),item,asyncContainer->mClient,asyncContainer->mDepth + 1);
 			}
 
 			//
@@ -160,51 +158,12 @@ void ItemFactory::handleDatabaseJobComplete(void* ref,DatabaseResult* result)
 		}
 		break;
 
-		case ItemFactoryQuery_Items:
+		case ItemFactoryQuery_ContainerTree:
 		{
-			uint64		count = result->getRowCount();
-
-			Item* item = dynamic_cast<Item*>(asyncContainer->mObject);
-
-			item->setLoadCount((uint32)count);
-
-			Type1_QueryContainer queryContainer;
-
-			DataBinding*	binding = mDatabase->CreateDataBinding(2);
-			binding->addField(DFT_bstring,offsetof(Type1_QueryContainer,mString),64,0);
-			binding->addField(DFT_uint64,offsetof(Type1_QueryContainer,mId),8,1);
-
-
-			// nothing to load ? handle our callback immediately
-			if(!count)
-			{
-				item->setLoadState(LoadState_Loaded);
-				asyncContainer->mOfCallback->handleObjectReady(asyncContainer->mObject,asyncContainer->mClient);
-				return;
-			}
-
-			//otherwise enter us on the loadmap for future reference
-			mObjectLoadMap.insert(std::make_pair(item->getId(),new(mILCPool.ordered_malloc()) InLoadingContainer(item,asyncContainer->mOfCallback,asyncContainer->mClient,static_cast<uint32>(count))));
-
-			// request all children
-			for(uint64 i = 0;i < count;i++)
-			{
-				result->GetNextRow(binding,&queryContainer);
-				
-				if(strcmp(queryContainer.mString.getAnsi(),"items") == 0)
-				{
-					// increase our iteration depth
-					requestContainerContent(this,queryContainer.mId, 0, 0, asyncContainer->mClient, asyncContainer->mDepth+1);
-				}
-				else
-				if(strcmp(queryContainer.mString.getAnsi(),"resource_containers") == 0)
-				{
-					// no need to worry about iteration depth with resourceContainers
-					gTangibleFactory->requestObject(this,queryContainer.mId,TanGroup_ResourceContainer, 0, asyncContainer->mClient);
-				}
-			}
+			_buildContainerTree(asyncContainer,result);
 		}
 		break;
+
 		default:break;
 	}
 
@@ -232,35 +191,275 @@ void ItemFactory::requestObject(ObjectFactoryCallback* ofCallback,uint64 id,uint
 
 //=============================================================================
 
-void ItemFactory::requestContainerContent(ObjectFactoryCallback* ofCallback,uint64 id,uint16 subGroup,uint16 subType,DispatchClient* client, uint32 depth)
+void ItemFactory::requestContainerTree(ObjectFactoryCallback* ofCallback,uint64 parentId,DispatchClient* client)
 {
-	QueryContainerBase* asContainer = new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(ofCallback,ItemFactoryQuery_MainData,client,id);
-	asContainer->mDepth = depth;
+	_requestContainerTree(ofCallback,parentId,NULL,client,0);
+}
 
-	mDatabase->ExecuteSqlAsync(this,asContainer,
-													"SELECT items.id,items.parent_id,items.item_family,items.item_type,items.privateowner_id,items.oX,items.oY,"
-													"items.oZ,items.oW,items.x,items.y,items.z,items.planet_id,items.customName,"
-													"item_types.object_string,item_types.stf_name,item_types.stf_file,item_types.stf_detail_name,"
-													"item_types.stf_detail_file,items.maxCondition,items.damage,items.dynamicint32,"
-													"item_types.equipSlots,item_types.equipRestrictions, item_customization.1, item_customization.2, item_types.container "
-													"FROM items "
-													"INNER JOIN item_types ON (items.item_type = item_types.id) "
-													"LEFT JOIN item_customization ON (items.id = item_customization.id)"
-													"WHERE items.id = %"PRIu64"",id);
+//=============================================================================
+//levels of the tree we join down from a root at the given depth, so we stop where the container depth does
+
+static uint32 _containerTreeLevels(uint32 depth)
+{
+	uint32 containerDepth	= gWorldConfig->getPlayerContainerDepth();
+	uint32 levels			= 1;
+
+	if(depth <= containerDepth)
+		levels = containerDepth - depth + 2;
+
+	return std::min<uint32>(levels,ITEM_TREE_LEVELS);
 }
 
 //=============================================================================
+//one job with four result sets: the items below parentId, their attributes,
+//the resource containers in any of them and the attributes of those.
+//the ids of the tree are collected once into a temporary table of the worker's connection,
+//a multi result job has that connection to itself until its result is destroyed
 
-Item* ItemFactory::_createItem(DatabaseResult* result)
+void ItemFactory::_requestContainerTree(ObjectFactoryCallback* ofCallback,uint64 parentId,Item* container,DispatchClient* client,uint32 depth)
 {
-	Item*			item;
-	ItemIdentifier	itemIdentifier;
+	QueryContainerBase* asContainer = new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(ofCallback,ItemFactoryQuery_ContainerTree,client,parentId);
+	asContainer->mObject	= container;
+	asContainer->mDepth		= depth;
+
+	uint32	levels = _containerTreeLevels(depth);
+	int8	tree[4096];
+	int8	sql[DATABASE_JOB_MAX_SQL + 1024];
+	int8*	treeEnd = tree;
+
+	//every level joins the items table once more, t0 being the direct children
+	for(uint32 level = 0;level < levels;level++)
+	{
+		if(level)
+			treeEnd += sprintf(treeEnd," UNION ALL ");
+
+		treeEnd += sprintf(treeEnd,"SELECT t%u.id,%u AS tree_level FROM items t%u",level,level,level);
+
+		for(uint32 join = level;join > 0;join--)
+			treeEnd += sprintf(treeEnd," INNER JOIN items t%u ON (t%u.parent_id = t%u.id)",join - 1,join,join - 1);
+
+		treeEnd += sprintf(treeEnd," WHERE t0.parent_id = %"PRIu64"",parentId);
+	}
+
+	int8* sqlEnd = sql;
+
+	sqlEnd += sprintf(sqlEnd,"DROP TEMPORARY TABLE IF EXISTS item_tree;"
+							"CREATE TEMPORARY TABLE item_tree ENGINE=MEMORY %s;",tree);
+
+	sqlEnd += sprintf(sqlEnd,"SELECT items.id,items.parent_id,items.item_family,items.item_type,items.privateowner_id,items.oX,items.oY,"
+							"items.oZ,items.oW,items.x,items.y,items.z,items.planet_id,items.customName,"
+							"item_types.object_string,item_types.stf_name,item_types.stf_file,item_types.stf_detail_name,"
+							"item_types.stf_detail_file,items.maxCondition,items.damage,items.dynamicint32,"
+							"item_types.equipSlots,item_types.equipRestrictions, item_customization.1, item_customization.2, item_types.container,tree.tree_level "
+							"FROM item_tree tree "
+							"INNER JOIN items ON (items.id = tree.id) "
+							"INNER JOIN item_types ON (items.item_type = item_types.id) "
+							"LEFT JOIN item_customization ON (items.id = item_customization.id) "
+							"ORDER BY tree.tree_level;");
+
+	sqlEnd += sprintf(sqlEnd,"SELECT item_attributes.item_id,attributes.name,item_attributes.value,attributes.internal "
+							"FROM item_tree tree "
+							"INNER JOIN item_attributes ON (item_attributes.item_id = tree.id) "
+							"INNER JOIN attributes ON (item_attributes.attribute_id = attributes.id) "
+							"ORDER BY item_attributes.item_id,item_attributes.order;");
+
+	sqlEnd += sprintf(sqlEnd,"SELECT resource_containers.* "
+							"FROM (SELECT %"PRIu64" AS id UNION ALL SELECT tree_items.id FROM item_tree tree_items) tree "
+							"INNER JOIN resource_containers ON (resource_containers.parent_id = tree.id);",parentId);
 
+	sqlEnd += sprintf(sqlEnd,"SELECT object_attributes.object_id,attributes.name,object_attributes.value,attributes.internal "
+					"FROM (SELECT %"PRIu64" AS id UNION ALL SELECT tree_items.id FROM item_tree tree_items) tree "
+					"INNER JOIN resource_containers ON (resource_containers.parent_id = tree.id) "
+					"INNER JOIN object_attributes ON (object_attributes.object_id = resource_containers.id) "
+					"INNER JOIN attributes ON (object_attributes.attribute_id = attributes.id) "
+					"ORDER BY object_attributes.object_id,object_attributes.order;",parentId);
+
+	sqlEnd += sprintf(sqlEnd,"DROP TEMPORARY TABLE item_tree");
+
+	assert(sqlEnd - sql < DATABASE_JOB_MAX_SQL && "container tree query does not fit a database job");
+
+	mDatabase->ExecuteProcedureAsync(this,asContainer,"%s",sql);
+}
+
+//=============================================================================
+//builds the whole tree in memory, the items come ordered by their level so a parent is always there before its content
+
+void ItemFactory::_buildContainerTree(QueryContainerBase* asyncContainer,DatabaseResult* result)
+{
+	Item*		container		= dynamic_cast<Item*>(asyncContainer->mObject);
+	uint64		rootId			= asyncContainer->mId;
+	uint32		depth			= asyncContainer->mDepth;
+	uint32		levels			= _containerTreeLevels(depth);
+	uint32		containerDepth	= gWorldConfig->getPlayerContainerDepth();
+
+	std::map<uint64,Object*>	items;
+	std::map<uint64,Object*>	resourceContainers;
+	std::map<uint64,Item*>		parents;	// containers whose content came along
+	std::vector<Object*>		loaded;		// in load order, parents first
+	std::vector<std::pair<Item*,uint32> >	deferred;	// containers at the last level, with their depth
+
+	// skip the results of dropping and filling the id set
+	result->NextResultSet();
+	result->NextResultSet();
+
+	// identify all rows first, so every item gets created in one pass over the result
 	uint64 count = result->getRowCount();
+	std::vector<ItemIdentifier> identifiers(static_cast<uint32>(count));
+
+	for(uint64 i = 0;i < count;i++)
+	{
+		result->GetNextRow(mTreeIdentifierBinding,(void*)&identifiers[static_cast<uint32>(i)]);
+	}
+
+	result->ResetRowIndex();
+
+	for(uint64 i = 0;i < count;i++)
+	{
+		const ItemIdentifier& identifier = identifiers[static_cast<uint32>(i)];
+
+		Item* item = _createItem(result,identifier);
+
+		// below an item we dont take content of
+		if(item->getParentId() != rootId && parents.find(item->getParentId()) == parents.end())
+		{
+			delete(item);
+			continue;
+		}
+
+		items.insert(std::make_pair(item->getId(),static_cast<Object*>(item)));
+		loaded.push_back(item);
+
+		uint32 itemDepth = depth + identifier.mLevel;
+
+		if(item->getCapacity() && itemDepth <= containerDepth)
+		{
+			if(identifier.mLevel + 1 < levels)
+				parents.insert(std::make_pair(item->getId(),item));
+			else
+				deferred.push_back(std::make_pair(item,itemDepth + 1));
+		}
+	}
+
+	result->NextResultSet();
+	_buildTreeAttributes(result,&items);
+
+	std::map<uint64,Object*>::iterator it = items.begin();
+
+	while(it != items.end())
+	{
+		(*it).second->setLoadState(LoadState_Loaded);
+		_postProcessAttributes((*it).second);
+		++it;
+	}
+
+	// resource containers in the root or in any of the containers we took content of
+	result->NextResultSet();
+	count = result->getRowCount();
+
+	for(uint64 i = 0;i < count;i++)
+	{
+		ResourceContainer* resourceContainer = gResourceContainerFactory->createResourceContainer(result);
+
+		if(resourceContainer->getParentId() != rootId && parents.find(resourceContainer->getParentId()) == parents.end())
+		{
+			delete(resourceContainer);
+			continue;
+		}
+
+		resourceContainers.insert(std::make_pair(resourceContainer->getId(),static_cast<Object*>(resourceContainer)));
+		loaded.push_back(resourceContainer);
+	}
+
+	result->NextResultSet();
+	_buildTreeAttributes(result,&resourceContainers);
+
+	it = resourceContainers.begin();
+
+	while(it != resourceContainers.end())
+	{
+		(*it).second->setLoadState(LoadState_Loaded);
+		++it;
+	}
+
+	// put everything in place
+	std::vector<Object*> topLevel;
+
+	for(uint32 i = 0;i < loaded.size();i++)
+	{
+		Object* object = loaded[i];
+
+		if(object->getParentId() != rootId)
+		{
+			gWorldManager->addObject(object,true);
+			parents[object->getParentId()]->addObjectSecure(object);
+		}
+		else if(container)
+		{
+			gWorldManager->addObject(object,true);
+			container->addObjectSecure(object);
+		}
+		else
+			topLevel.push_back(object);
+	}
+
+	// containers the tree ended at load their content on their own
+	for(uint32 i = 0;i < deferred.size();i++)
+	{
+		deferred[i].first->setLoadState(LoadState_ContainerContent);
+		_requestContainerTree(NULL,deferred[i].first->getId(),deferred[i].first,asyncContainer->mClient,deferred[i].second);
+	}
+
+	if(container)
+	{
+		container->setLoadState(LoadState_Loaded);
+
+		if(asyncContainer->mOfCallback)
+			asyncContainer->mOfCallback->handleObjectReady(container,asyncContainer->mClient);
+	}
+	else if(asyncContainer->mOfCallback)
+	{
+		for(uint32 i = 0;i < topLevel.size();i++)
+			asyncContainer->mOfCallback->handleObjectReady(topLevel[i],asyncContainer->mClient);
+	}
+}
+
+//=============================================================================
+
+void ItemFactory::_buildTreeAttributes(DatabaseResult* result,std::map<uint64,Object*>* objects)
+{
+	Attribute_QueryContainer	attribute;
+	uint64						count = result->getRowCount();
+
+	for(uint64 i = 0;i < count;i++)
+	{
+		result->GetNextRow(mTreeAttributeBinding,(void*)&attribute);
+
+		std::map<uint64,Object*>::iterator it = objects->find(attribute.mObjectId);
+
+		if(it != objects->end())
+			_addAttribute((*it).second,&attribute);
+	}
+}
+
+//=============================================================================
+
+Item* ItemFactory::_createItem(DatabaseResult* result)
+{
+	ItemIdentifier	itemIdentifier;
 
 	result->GetNextRow(mItemIdentifierBinding,(void*)&itemIdentifier);
 	result->ResetRowIndex();
 
+	return _createItem(result,itemIdentifier);
+}
+
+//=============================================================================
+//creates the item from the next row of the result
+
+Item* ItemFactory::_createItem(DatabaseResult* result,const ItemIdentifier& itemIdentifier)
+{
+	Item*			item;
+
 	switch(itemIdentifier.mFamilyId)
 	{
 		case ItemFamily_TravelTickets:			item	= new TravelTicket();				break;
@@ -351,6 +550,17 @@ void ItemFactory::_setupDatabindings()
 	mItemIdentifierBinding = mDatabase->CreateDataBinding(2);
 	mItemIdentifierBinding->addField(DFT_uint32,offsetof(ItemIdentifier,mFamilyId),4,2);
 	mItemIdentifierBinding->addField(DFT_uint32,offsetof(ItemIdentifier,mTypeId),4,3);
+
+	mTreeIdentifierBinding = mDatabase->CreateDataBinding(3);
+	mTreeIdentifierBinding->addField(DFT_uint32,offsetof(ItemIdentifier,mFamilyId),4,2);
+	mTreeIdentifierBinding->addField(DFT_uint32,offsetof(ItemIdentifier,mTypeId),4,3);
+	mTreeIdentifierBinding->addField(DFT_uint32,offsetof(ItemIdentifier,mLevel),4,27);
+
+	mTreeAttributeBinding = mDatabase->CreateDataBinding(4);
+	mTreeAttributeBinding->addField(DFT_uint64,offsetof(Attribute_QueryContainer,mObjectId),8,0);
+	mTreeAttributeBinding->addField(DFT_bstring,offsetof(Attribute_QueryContainer,mKey),64,1);
+	mTreeAttributeBinding->addField(DFT_bstring,offsetof(Attribute_QueryContainer,mValue),128,2);
+	mTreeAttributeBinding->addField(DFT_uint8,offsetof(Attribute_QueryContainer,mInternal),1,3);
 }
 
 //=============================================================================
@@ -359,6 +569,8 @@ void ItemFactory::_destroyDatabindings()
 {
 	mDatabase->DestroyDataBinding(mItemBinding);
 	mDatabase->DestroyDataBinding(mItemIdentifierBinding);
+	mDatabase->DestroyDataBinding(mTreeIdentifierBinding);
+	mDatabase->DestroyDataBinding(mTreeAttributeBinding);
 }
 
 //=============================================================================
@@ -404,7 +616,7 @@ void ItemFactory::_postProcessAttributes(Object* object)
 				else
 				{
 					item->setAttribute("craft_tool_status","@crafting:tool_status_ready");
-					mDatabase->ExecuteSqlAsync(0,0,"UPDATE item_attributes SET value='@crafting:tool_status_ready' WHERE item_id=%"PRIu64" AND attribute_id=%u",item->getId(),AttrType_CraftToolStatus);
+					gPersistenceManager->setAttribute(PersistTable_ItemAttributes,item->getId(),AttrType_CraftToolStatus,"@crafting:tool_status_ready");
 
 					int8 sql[250];
 					item->addAttribute("craft_tool_time","0");
@@ -33,9 +33,13 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #define		gItemFactory	ItemFactory::getSingletonPtr()
 
+// item levels a container tree query joins down, deeper content gets a query of its own
+#define		ITEM_TREE_LEVELS	8
+
 //=============================================================================
 
 class Item;
+class ItemIdentifier;
 class Database;
 class DataBinding;
 class DispatchClient;
@@ -48,7 +52,7 @@ enum ItemFactoryQuery
 	ItemFactoryQuery_MainData				= 1,
 	ItemFactoryQuery_Attributes				= 2,
 	NonPersistantItemFactoryQuery_MainData	= 3,
-	ItemFactoryQuery_Items					= 4
+	ItemFactoryQuery_ContainerTree			= 4
 };
 
 //=============================================================================
@@ -66,7 +70,10 @@ class ItemFactory : public FactoryBase, public ObjectFactoryCallback
 
 		void					handleDatabaseJobComplete(void* ref,DatabaseResult* result);
 		void					requestObject(ObjectFactoryCallback* ofCallback,uint64 id,uint16 subGroup,uint16 subType,DispatchClient* client);
-		void					requestContainerContent(ObjectFactoryCallback* ofCallback,uint64 id,uint16 subGroup,uint16 subType,DispatchClient* client, uint32 depth = 0);
+
+		// loads all items and resource containers below parentId in one round trip, every object directly below it
+		// is handed to the callback with its content already in place
+		void					requestContainerTree(ObjectFactoryCallback* ofCallback,uint64 parentId,DispatchClient* client);
 
 	private:
 
@@ -74,16 +81,23 @@ class ItemFactory : public FactoryBase, public ObjectFactoryCallback
 
 		void					_postProcessAttributes(Object* object);
 
+		void					_requestContainerTree(ObjectFactoryCallback* ofCallback,uint64 parentId,Item* container,DispatchClient* client,uint32 depth);
+		void					_buildContainerTree(QueryContainerBase* asyncContainer,DatabaseResult* result);
+		void					_buildTreeAttributes(DatabaseResult* result,std::map<uint64,Object*>* objects);
+
 		void					_setupDatabindings();
 		void					_destroyDatabindings();
 
 		Item*					_createItem(DatabaseResult* result);
+		Item*					_createItem(DatabaseResult* result,const ItemIdentifier& itemIdentifier);
 
 		static ItemFactory*		mSingleton;
 		static bool				mInsFlag;
 
 		DataBinding*			mItemIdentifierBinding;
 		DataBinding*			mItemBinding;
+		DataBinding*			mTreeIdentifierBinding;
+		DataBinding*			mTreeAttributeBinding;
 };
 
 //=============================================================================
@@ -97,6 +111,9 @@ class ItemIdentifier
 
 		uint32	mFamilyId;
 		uint32	mTypeId;
+
+		// level below the root of a container tree query
+		uint32	mLevel;
 };
 
 //=============================================================================
@@ -31,7 +31,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "NonPersistentNpcFactory.h"
 #include "NpcManager.h"
 #include "PlayerObject.h"
-#include "QuadTree.h"
+#include "ObjectGrid.h"
 #include "WorldManager.h"
 #include "ZoneTree.h"
 #include "MessageLib/MessageLib.h"
@@ -381,7 +381,7 @@ bool LairObject::getLairTarget(void)
 	uint64 nearestDefenderId = 0;
 
 	// Attack nearest target or the first target found within range or the one doing most damage or random? lol
-	ObjectIDList::iterator defenderIt = this->getDefenders()->begin();
+	ObjectIDList::const_iterator defenderIt = this->getDefenders()->begin();
 
 	while (defenderIt != this->getDefenders()->end())
 	{
@@ -403,7 +403,7 @@ bool LairObject::getLairTarget(void)
 			{
 				// Make peace with this poor fellow.
 				this->makePeaceWithDefender(*defenderIt);
-				defenderIt = this->mDefenders.begin();
+				defenderIt = this->getDefenders()->begin();
 				continue;
 			}
 		}
@@ -426,7 +426,7 @@ void LairObject::makePeaceWithDefendersOutOfRange(void)
 {
 	float maxRange = 65.0;	// Todo: Use a real value.
 
-	ObjectIDList::iterator defenderIt = this->getDefenders()->begin();
+	ObjectIDList::const_iterator defenderIt = this->getDefenders()->begin();
 	while (defenderIt != this->getDefenders()->end())
 	{
 		if (!gWorldManager->objectsInRange(this->getId(), *defenderIt, maxRange))
@@ -297,12 +297,17 @@ void ManufacturingSchematic::setPPAttribute(string key,std::string value)
 		return;
 	}
 
-	(*it).second = value;
+	(*it).second.set(value);
 }
 
 bool ManufacturingSchematic::hasPPAttribute(string key) const
 {
-	if(mPPAttributeMap.find(key.getCrc()) != mPPAttributeMap.end())
+	return(hasPPAttribute(key.getCrc()));
+}
+
+bool ManufacturingSchematic::hasPPAttribute(uint32 keyCrc) const
+{
+	if(mPPAttributeMap.find(keyCrc) != mPPAttributeMap.end())
 		return(true);
 
 	return(false);
@@ -310,7 +315,7 @@ bool ManufacturingSchematic::hasPPAttribute(string key) const
 
 void ManufacturingSchematic::addPPAttribute(string key,std::string value)
 {
-	mPPAttributeMap.insert(std::make_pair(key.getCrc(),value));
+	mPPAttributeMap.insert(key.getCrc(),value);
 }
 
 void ManufacturingSchematic::removePPAttribute(string key)
@@ -120,6 +120,7 @@ class ManufacturingSchematic : public Item
 		void						setPPAttribute(string key,std::string value);
 		void						addPPAttribute(string key,std::string value);
 		bool						hasPPAttribute(string key) const;
+		bool						hasPPAttribute(uint32 keyCrc) const;
 		void						removePPAttribute(string key);
 
 		CustomizationList*			getCustomizationList(){return &mCustomizationList;}
@@ -264,14 +265,12 @@ T	ManufacturingSchematic::getPPAttribute(string key) const
 
 	if(it != mPPAttributeMap.end())
 	{
-		try
-		{
-			return(boost::lexical_cast<T>((*it).second));
-		}
-		catch(boost::bad_lexical_cast &)
-		{
-			gLogger->log(LogManager::DEBUG,"ManufacturingSchematic::getPPAttribute: cast failed (%s)",key.getAnsi());
-		}
+		T value = T();
+
+		if((*it).second.get(&value))
+			return(value);
+
+		gLogger->log(LogManager::DEBUG,"ManufacturingSchematic::getPPAttribute: cast failed (%s)",key.getAnsi());
 	}
 	else
 		gLogger->log(LogManager::DEBUG,"ManufacturingSchematic::getPPAttribute: could not find %s",key.getAnsi());
@@ -283,18 +282,16 @@ T	ManufacturingSchematic::getPPAttribute(string key) const
 template<typename T>
 T	ManufacturingSchematic::getPPAttribute(uint32 keyCrc) const
 {
-	AttributeMap::iterator it = mPPAttributeMap.find(keyCrc);
+	AttributeMap::const_iterator it = mPPAttributeMap.find(keyCrc);
 
 	if(it != mPPAttributeMap.end())
 	{
-		try
-		{
-			return(boost::lexical_cast<T>((*it).second));
-		}
-		catch(boost::bad_lexical_cast &)
-		{
-			gLogger->log(LogManager::NOTICE,"ManufacturingSchematic::getPPAttribute: cast failed (%u)",dkeyCrc);
-		}
+		T value = T();
+
+		if((*it).second.get(&value))
+			return(value);
+
+		gLogger->log(LogManager::NOTICE,"ManufacturingSchematic::getPPAttribute: cast failed (%u)",keyCrc);
 	}
 	else
 		gLogger->log(LogManager::NOTICE,"ManufacturingSchematic::getPPAttribute: could not find %u",keyCrc);
@@ -29,6 +29,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Inventory.h"
 #include "MedicManager.h"
 #include "ObjectFactory.h"
+#include "PersistenceManager.h"
 #include "PlayerObject.h"
 #include "WorldManager.h"
 #include "MessageLib/MessageLib.h"
@@ -299,7 +300,7 @@ bool Medicine::ConsumeUse(PlayerObject* playerObject)
 	if(quantity)
 	{
 		this->setAttribute("counter_uses_remaining",boost::lexical_cast<std::string>(quantity));
-		gWorldManager->getDatabase()->ExecuteSqlAsync(0,0,"UPDATE item_attributes SET value='%f' WHERE item_id=%"PRIu64" AND attribute_id=%u",quantity,this->getId(),AttrType_CounterUsesRemaining);
+		gPersistenceManager->setAttribute(PersistTable_ItemAttributes,this->getId(),AttrType_CounterUsesRemaining,boost::lexical_cast<std::string>(quantity));
 
 		//now update the uses display
 		gMessageLib->sendUpdateUses(this,playerObject);
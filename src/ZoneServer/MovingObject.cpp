@@ -30,7 +30,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "MessageLib/MessageLib.h"
 #include "MovingObject.h"
 #include "PlayerObject.h"
-#include "QuadTree.h"
+#include "ObjectGrid.h"
 #include "VehicleController.h"
 #include "WorldManager.h"
 #include "ZoneTree.h"
@@ -29,7 +29,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #define ANH_ZONESERVER_MOVING_OBJECT_H
 
 #include "Object.h"
-//#include "QuadTree.h"
+//#include "ObjectGrid.h"
 
 class Message;
 class DispatchClient;
@@ -247,7 +247,7 @@ void ObjectController::_handlePeace(uint64 targetId,Message* message,ObjectContr
 	if (player)
 	{
 		// player->removeAllDefender();
-		player->mDefenders.clear();
+		player->clearDefenders();
 
 		gMessageLib->sendBaselinesCREO_6(player,player);
 		gMessageLib->sendEndBaselines(player->getPlayerObjId(),player);
@@ -44,7 +44,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "ObjectControllerOpcodes.h"
 #include "ObjectFactory.h"
 #include "PlayerObject.h"
-#include "QuadTree.h"
+#include "ObjectGrid.h"
 #include "ResourceContainer.h"
 #include "ResourceManager.h"
 #include "Shuttle.h"
@@ -68,6 +68,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "DatabaseManager/DatabaseResult.h"
 #include "Common/Message.h"
 #include "Common/MessageFactory.h"
+#include "Utils/crc.h"
 #include "CraftingSession.h"
 
 #include <cassert>
@@ -92,7 +93,7 @@ void ObjectController::_handleBoardTransport(uint64 targetId,Message* message,Ob
 	str.convert(BSTRType_ANSI);
 	str.toLower();
 
-	if((str.getCrc() != BString("transport").getCrc()))
+	if((str.getCrc() != Anh_Utils::crc("transport")))
 	{
 		gMessageLib->sendSystemMessage(playerObject,L"","travel","boarding_what_shuttle");
 		return;
@@ -1169,7 +1170,7 @@ void ObjectController::_handlePurchaseTicket(uint64 targetId,Message* message,Ob
 	if(elements > 4)
 		roundTrip = atoi(dataElements[4].getAnsi());
 
-	if(dataElements[4].getCrc() == BString("single").getCrc())
+	if(dataElements[4].getCrc() == Anh_Utils::crc("single"))
 		roundTrip = 0;
 
 
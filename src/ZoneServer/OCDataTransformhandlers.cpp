@@ -37,7 +37,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "ObjectControllerCommandMap.h"
 #include "PlayerObject.h"
 #include "FactoryObject.h"
-#include "QuadTree.h"
+#include "ObjectGrid.h"
 #include "Tutorial.h"
 #include "WorldConfig.h"
 #include "WorldManager.h"
@@ -45,6 +45,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "ZoneTree.h"
 
 #include "MessageLib/MessageLib.h"
+#include "ConfigManager/ConfigManager.h"
 #include "LogManager/LogManager.h"
 #include "DatabaseManager/Database.h"
 #include "DatabaseManager/DatabaseResult.h"
@@ -54,6 +55,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Utils/clock.h"
 
 #include <cassert>
+#include <cmath>
 
 //=============================================================================
 //
@@ -540,29 +542,19 @@ void ObjectController::_findInRangeObjectsOutside(bool updateAll)
 {
 	PlayerObject*	player			= dynamic_cast<PlayerObject*>(mObject);
 
-	//scale down viewing range when busy
-	float			viewingRange	= _GetMessageHeapLoadViewingRange();
+	//scale down viewing range when busy, we query out to where objects get destroyed again
+	float			viewingRange	= _GetMessageHeapLoadViewingRange() + _getInterestHysteresis();
 
-	// query the rtree for non moving objects/objects in buildings
-	// ObjectSet		inRangeObjects;
-
-	// mSI->getObjectsInRange(player,&inRangeObjects,(ObjType_Player | ObjType_Tangible | ObjType_Creature | ObjType_NPC | ObjType_Building),viewingRange);
-	// Using intersectsWithQuery(..)
-	// NOTE: THIS USEAGE OF intersectsWithQuery(..) MUST BE CHECKED, SINCE IT SEEMS THAT WE GET TO MUCH / TO MANY OBJECTS !!!
-	// mSI->getObjectsInRangeEx(player,&inRangeObjects,(ObjType_Player | ObjType_Tangible | ObjType_Creature | ObjType_NPC | ObjType_Building),viewingRange);
-
-	// Make Set ready,
+	// Make the result buffer ready, it keeps its capacity between queries
 	mInRangeObjects.clear();
-	mObjectSetIt = mInRangeObjects.begin();	// Will point to end of Set
+	mInRangeObjectIndex = 0;
 
 	if(player->getSubZoneId())
 	{
 		if(QTRegion* region = gWorldManager->getQTRegion(player->getSubZoneId()))
 		{
-			Anh_Math::Rectangle qRect = Anh_Math::Rectangle(player->mPosition.x - viewingRange,player->mPosition.z - viewingRange,viewingRange * 2,viewingRange * 2);
-
 			// We need to find moving creatures also...
-			region->mTree->getObjectsInRange(player,&mInRangeObjects,ObjType_Player | ObjType_NPC | ObjType_Creature | ObjType_Lair , &qRect);
+			region->mTree->getObjectsInRange(player,&mInRangeObjects,ObjType_Player | ObjType_NPC | ObjType_Creature | ObjType_Lair,player->mPosition,viewingRange);
 		}
 	}
 
@@ -570,25 +562,144 @@ void ObjectController::_findInRangeObjectsOutside(bool updateAll)
 	{
 
 		// Doing this because we need the players from inside buildings too.
-		mSI->getObjectsInRangeEx(player,&mInRangeObjects,(ObjType_Player | ObjType_NPC | ObjType_Creature), viewingRange);
+		mSI->getObjectsInRange(player,&mInRangeObjects,(ObjType_Player | ObjType_NPC | ObjType_Creature), viewingRange, true);
 
 		// This may be good when we standstill.
 		mSI->getObjectsInRange(player,&mInRangeObjects,(ObjType_Tangible | ObjType_Building | ObjType_Lair | ObjType_Structure), viewingRange);
 
 	}
-	/*
+
+	_finalizeInRangeObjects();
+}
+
+//=========================================================================================
+//
+// objects get created once they are within the viewing range and destroyed once they are
+// farther than the viewing range plus this, so they don't flicker at the border
+//
+
+float ObjectController::_getInterestHysteresis()
+{
+	static const float hysteresis = gConfig->read<float>("InterestHysteresis",16.0f);
+
+	return hysteresis;
+}
+
+//=========================================================================================
+//
+// the world is split into cells of this size, a full update is done when the player crosses into another one
+//
+
+bool ObjectController::_crossedInterestCell(PlayerObject* player)
+{
+	static const float cellSize = gConfig->read<float>("InterestCellSize",32.0f);
+
+	const glm::vec3& last = player->getLastUpdatePosition();
+
+	return((floor(player->mPosition.x / cellSize) != floor(last.x / cellSize)) || (floor(player->mPosition.z / cellSize) != floor(last.z / cellSize)));
+}
+
+//=========================================================================================
+//
+// compares the sorted query results with the players known objects in a single pass
+// entering objects are the ones within viewing range we don't know yet
+// leaving objects are the known ones which are not within viewing range plus hysteresis anymore,
+// we only collect them after queries including the static objects
+//
+
+void ObjectController::_computeInterestDeltas(bool collectLeaving)
+{
+	PlayerObject*		player			= dynamic_cast<PlayerObject*>(mObject);
+	ObjectSet*			knownObjects	= player->getKnownObjects();
+	ObjectSet::iterator	knownIt			= knownObjects->begin();
+	std::less<Object*>	before;
+
+	float				enterRange		= _GetMessageHeapLoadViewingRange();
+	float				enterRangeSq	= enterRange * enterRange;
+
+	mEnteringObjects.clear();
+	mEnteringObjectIndex = 0;
+
+	if (collectLeaving)
+	{
+		mLeavingObjects.clear();
+		mLeavingObjectIndex = 0;
+	}
+
+	ObjectVector::iterator it = mInRangeObjects.begin();
+
+	while (it != mInRangeObjects.end())
+	{
+		Object*	object	= (*it);
+		bool	known;
+
+		if (object->getType() == ObjType_Player)
+		{
+			known = player->checkKnownPlayer(dynamic_cast<PlayerObject*>(object));
+		}
+		else
+		{
+			// both are ordered by address, everything we pass on the known side is not in range anymore
+			while ((knownIt != knownObjects->end()) && before(*knownIt,object))
+			{
+				if (collectLeaving)
+				{
+					mLeavingObjects.push_back((*knownIt)->getId());
+				}
+				++knownIt;
+			}
+
+			known = ((knownIt != knownObjects->end()) && ((*knownIt) == object));
+
+			if (known)
+			{
+				++knownIt;
+			}
+		}
+
+		// objects in cells came with their building, everything else has to be within the viewing range
+		if (!known)
+		{
+			float dx = object->mPosition.x - player->mPosition.x;
+			float dz = object->mPosition.z - player->mPosition.z;
+
+			if (object->getParentId() || (object->getType() == ObjType_Building) || (dx * dx + dz * dz <= enterRangeSq))
+			{
+				mEnteringObjects.push_back(object->getId());
+			}
+		}
+
+		++it;
+	}
+
+	if (!collectLeaving)
 	{
-		// This may be good when we are moving around outside.
-		mSI->getObjectsInRange(player,&mInRangeObjects,(ObjType_Player | ObjType_NPC | ObjType_Creature | ObjType_Tangible | ObjType_Building), viewingRange);
+		return;
 	}
-	*/
 
-	// Update the iterator to start of Set.
-	mObjectSetIt = mInRangeObjects.begin();
+	while (knownIt != knownObjects->end())
+	{
+		mLeavingObjects.push_back((*knownIt)->getId());
+		++knownIt;
+	}
+
+	PlayerObjectSet*			knownPlayers	= player->getKnownPlayers();
+	PlayerObjectSet::iterator	playerIt		= knownPlayers->begin();
+
+	while (playerIt != knownPlayers->end())
+	{
+		if (!std::binary_search(mInRangeObjects.begin(),mInRangeObjects.end(),static_cast<Object*>(*playerIt)))
+		{
+			mLeavingObjects.push_back((*playerIt)->getId());
+		}
+		++playerIt;
+	}
 }
 
 //=========================================================================================
 //
+// send creates for the entering objects, a batch per call
+//
 
 bool ObjectController::_updateInRangeObjectsOutside()
 {
@@ -598,16 +709,12 @@ bool ObjectController::_updateInRangeObjectsOutside()
 	uint32 updatedObjects = 0;
 	const uint32 objectSendLimit = 50;
 
-	while ((mObjectSetIt != mInRangeObjects.end()) && (updatedObjects < objectSendLimit))
+	while ((mEnteringObjectIndex < mEnteringObjects.size()) && (updatedObjects < objectSendLimit))
 	{
-		//BEWARE Object is at this time possibly not valid anymore!
-		//this actually causes a lot of crashes!!!!
+		// the object may be gone since we computed the deltas
+		Object* object = gWorldManager->getObjectById(mEnteringObjects[mEnteringObjectIndex++]);
 
-		Object* object = dynamic_cast<Object*>(*mObjectSetIt);
-		// Just simplified the code a little. Good find Schmunzel.
-
-		// only add it if its also outside
-		// see if its already observed, if yes, just send a position update out, if its a player
+		// see if its already observed
 		if ((object) && (!player->checkKnownObjects(object)))
 		{
 			// send the according create for the type of object
@@ -617,54 +724,28 @@ bool ObjectController::_updateInRangeObjectsOutside()
 			if (object->getId() > 0x0000000100000000LLU)
 #endif
 			{
-				if (object->getPrivateOwner())
+				// if its an instance, only for its owner
+				if ((!object->getPrivateOwner()) || (object->isOwnedBy(player)))
 				{
-					if (object->isOwnedBy(player))
-					{
-						gMessageLib->sendCreateObject(object,player);
-						player->addKnownObjectSafe(object);
-						object->addKnownObjectSafe(player);
+					gMessageLib->sendCreateObject(object,player);
+					player->addKnownObjectSafe(object);
+					object->addKnownObjectSafe(player);
 
-						//If player has a mount make sure add to its known objects
-						//but is the mount even near us ???
-						// does this even matter ?
-
-						if(player->checkIfMountCalled() && player->getMount())
+					//If player has a mount make sure add to its known objects
+					if(player->checkIfMountCalled() && player->getMount())
+					{
+						if(player->getMount()->getId() != object->getId())
 						{
-							if(player->getMount()->getId() != object->getId())
-							{
-								player->getMount()->addKnownObjectSafe(object);
-								object->addKnownObjectSafe(player->getMount());
-							}
+							player->getMount()->addKnownObjectSafe(object);
+							object->addKnownObjectSafe(player->getMount());
 						}
-						updatedObjects++;
 					}
-				}
-				else
-				{
-					//if(!player->checkKnownObjects(object))
-					//{
-						gMessageLib->sendCreateObject(object,player);
-						player->addKnownObjectSafe(object);
-						object->addKnownObjectSafe(player);
-
-						//If player has a mount make sure add to its known objects
-						if(player->checkIfMountCalled() && player->getMount())
-						{
-							if(player->getMount()->getId() != object->getId())
-							{
-								player->getMount()->addKnownObjectSafe(object);
-								object->addKnownObjectSafe(player->getMount());
-							}
-						}
-					//}
 					updatedObjects++;
 				}
 			}
 		}
-		++mObjectSetIt;
 	}
-	return (mObjectSetIt == mInRangeObjects.end());
+	return (mEnteringObjectIndex >= mEnteringObjects.size());
 }
 
 
@@ -679,11 +760,9 @@ void ObjectController::_findInRangeObjectsInside(bool updateAll)
 	CellObject*		playerCell = dynamic_cast<CellObject*>(gWorldManager->getObjectById(player->getParentId()));
 
 
-	// Make Set ready,
+	// Make the result buffer ready, it keeps its capacity between queries
 	mInRangeObjects.clear();
-
-	// Init the iterator.
-	mObjectSetIt = mInRangeObjects.begin();
+	mInRangeObjectIndex = 0;
 
 	// make sure we got a cell
 	if (!playerCell)
@@ -714,10 +793,8 @@ void ObjectController::_findInRangeObjectsInside(bool updateAll)
 		// query the qtree based on the buildings world position
 		if (QTRegion* region = mSI->getQTRegion(building->mPosition.x,building->mPosition.z))
 		{
-			Anh_Math::Rectangle qRect = Anh_Math::Rectangle(building->mPosition.x - viewingRange,building->mPosition.z - viewingRange,viewingRange * 2,viewingRange * 2);
-
 			// We need to find moving creatures outside...
-			region->mTree->getObjectsInRange(player,&mInRangeObjects,ObjType_Player | ObjType_NPC | ObjType_Creature, &qRect);
+			region->mTree->getObjectsInRange(player,&mInRangeObjects,ObjType_Player | ObjType_NPC | ObjType_Creature,building->mPosition,viewingRange);
 		}
 	}
 	else
@@ -733,17 +810,29 @@ void ObjectController::_findInRangeObjectsInside(bool updateAll)
 		// query the qtree based on the buildings world position
 		if (QTRegion* region = mSI->getQTRegion(building->mPosition.x,building->mPosition.z))
 		{
-			Anh_Math::Rectangle qRect = Anh_Math::Rectangle(building->mPosition.x - viewingRange,building->mPosition.z - viewingRange,viewingRange * 2,viewingRange * 2);
-
 			// We need to find moving creatures outside...
-			region->mTree->getObjectsInRange(player,&mInRangeObjects,ObjType_Player | ObjType_NPC | ObjType_Creature,&qRect);
+			region->mTree->getObjectsInRange(player,&mInRangeObjects,ObjType_Player | ObjType_NPC | ObjType_Creature,building->mPosition,viewingRange);
 		}
 	}
-	// Update the iterator to start of Set.
-	mObjectSetIt = mInRangeObjects.begin();
+
+	_finalizeInRangeObjects();
 }
 
 
+//=========================================================================================
+//
+// the queries may report an object more than once, sort the results so they can be
+// walked in order and searched by _destroyOutOfRangeObjects
+//
+
+void ObjectController::_finalizeInRangeObjects()
+{
+	std::sort(mInRangeObjects.begin(),mInRangeObjects.end());
+	mInRangeObjects.erase(std::unique(mInRangeObjects.begin(),mInRangeObjects.end()),mInRangeObjects.end());
+
+	mInRangeObjectIndex = 0;
+}
+
 //=========================================================================================
 //
 // Update the objects observed/known objects when inside
@@ -767,11 +856,10 @@ bool ObjectController::_updateInRangeObjectsInside()
 
 	//what do we do if the object has been deleted in the meantime?
 	//TODO
-	while ((mObjectSetIt != mInRangeObjects.end()) && (updatedObjects < objectSendLimit))
+	while ((mInRangeObjectIndex < mInRangeObjects.size()) && (updatedObjects < objectSendLimit))
 	{
-		// Object* object = (*mObjectSetIt);
 		// Needed since object may be invalid due to the multi-session approach of this function.
-		Object* object = dynamic_cast<Object*>(*mObjectSetIt);
+		Object* object = dynamic_cast<Object*>(mInRangeObjects[mInRangeObjectIndex]);
 
 		// Create objects that are in the same building as we are OR outside near the building.
 		if ((object) && (!player->checkKnownObjects(object)))
@@ -830,39 +918,58 @@ bool ObjectController::_updateInRangeObjectsInside()
 				}
 			}
 		}
-		++mObjectSetIt;
+		++mInRangeObjectIndex;
 	}
-	return (mObjectSetIt == mInRangeObjects.end());
+	return (mInRangeObjectIndex >= mInRangeObjects.size());
 }
 
 //=========================================================================================
 //
-// destroy known objects not in range anymore
-// compares the given list with the players known objects
+// destroy the leaving objects, a batch per call
 //
 
-bool ObjectController::_destroyOutOfRangeObjects(ObjectSet *inRangeObjects)
+bool ObjectController::_destroyOutOfRangeObjects()
 {
 	//TODO: when a container gets out of range
 	//we need to destroy the children, too!!!!!!!
 
-	// iterate our knowns
 	PlayerObject*				player			= dynamic_cast<PlayerObject*>(mObject);
 	ObjectSet*					knownObjects	= player->getKnownObjects();
-	ObjectSet::iterator			objIt			= knownObjects->begin();
 	PlayerObjectSet*			knownPlayers	= player->getKnownPlayers();
-	PlayerObjectSet::iterator	playerIt		= knownPlayers->begin();
 
+	float						leaveRange		= _GetMessageHeapLoadViewingRange() + _getInterestHysteresis();
+	float						leaveRangeSq	= leaveRange * leaveRange;
+
+	// We may want to limit the amount of messages sent in one session.
+	uint32 messageCount = 0;
 	const uint32 objectDestroyLimit = 5000;
 
-	// update players
-	while(playerIt != knownPlayers->end())
+	while ((mLeavingObjectIndex < mLeavingObjects.size()) && (messageCount < objectDestroyLimit))
 	{
-		PlayerObject* playerObject = (*playerIt);
+		// the object may be gone since we computed the deltas
+		Object* object = gWorldManager->getObjectById(mLeavingObjects[mLeavingObjectIndex++]);
+
+		if (!object || !player->checkKnownObjects(object))
+		{
+			continue;
+		}
 
-		// if its not in the current inrange queries result, destroy it
-		if(inRangeObjects->find(playerObject) == inRangeObjects->end())
+		// came back in the meantime
+		if (!object->getParentId())
 		{
+			float dx = object->mPosition.x - player->mPosition.x;
+			float dz = object->mPosition.z - player->mPosition.z;
+
+			if (dx * dx + dz * dz <= leaveRangeSq)
+			{
+				continue;
+			}
+		}
+
+		if (object->getType() == ObjType_Player)
+		{
+			PlayerObject* playerObject = dynamic_cast<PlayerObject*>(object);
+
 			// send a destroy to us
 			gMessageLib->sendDestroyObject(playerObject->getId(),player);
 
@@ -889,110 +996,70 @@ bool ObjectController::_destroyOutOfRangeObjects(ObjectSet *inRangeObjects)
 			}
 
 			// we don't know each other anymore
-			knownPlayers->erase(playerIt++);
+			knownPlayers->erase(playerObject);
 			playerObject->removeKnownObject(player);
 
-
 			continue;
 		}
-		++playerIt;
-	}
 
-	// We may want to limit the amount of messages sent in one session.
-	uint32 messageCount = 0;
-
-	// update objects
-	while(objIt != knownObjects->end())
-	{
-		Object* object = (*objIt);
-
-		// if its not in the current inrange queries result, destroy it
-		if(inRangeObjects->find(object) == inRangeObjects->end())
+		if(object->getType() == ObjType_Structure)
 		{
-
-			if(object->getType() == ObjType_Structure)
+			if(FactoryObject* factory = dynamic_cast<FactoryObject*>(object))
 			{
-				if(FactoryObject* factory = dynamic_cast<FactoryObject*>(object))
-				{
-					//delete the hoppers contents
-					TangibleObject* hopper = dynamic_cast<TangibleObject*>(gWorldManager->getObjectById(factory->getIngredientHopper()));
-					if(hopper)
-					{
-							ObjectIDList*			ol = hopper->getObjects();
-							ObjectIDList::iterator	it = ol->begin();
+				_destroyHopperContent(factory->getIngredientHopper());
+				_destroyHopperContent(factory->getOutputHopper());
+			}
+		}
 
-							while(it != ol->end())
-							{
-								TangibleObject* tO = dynamic_cast<TangibleObject*>(gWorldManager->getObjectById((*it)));
-								if(!tO)
-								{
-									assert(false && "ObjectController::_destroyOutOfRangeObjects WorldManager unable to find TangibleObject instance");
-								}
-
-								tO->removeKnownObject(player);
-								player->removeKnownObject(tO);
-								gMessageLib->sendDestroyObject(tO->getId(),player);
-								it++;
-							}
-					
-							hopper->removeKnownObject(player);
-							player->removeKnownObject(hopper);
-							
-							gMessageLib->sendDestroyObject(hopper->getId(),player);					
-					}
+		// send a destroy to us
+		gMessageLib->sendDestroyObject(object->getId(),player);
 
-					hopper = dynamic_cast<TangibleObject*>(gWorldManager->getObjectById(factory->getOutputHopper()));
-					if(hopper)
-					{
-							ObjectIDList*			ol = hopper->getObjects();
-							ObjectIDList::iterator	it = ol->begin();
+		// we don't know each other anymore
+		knownObjects->erase(object);
+		object->removeKnownObject(player);
 
-							while(it != ol->end())
-							{
-								TangibleObject* tO = dynamic_cast<TangibleObject*>(gWorldManager->getObjectById((*it)));
-								if(!tO)
-								{
-									assert(false && "ObjectController::_destroyOutOfRangeObjects WorldManager unable to find TangibleObject instance");
-								}
-
-								//PlayerObject* player = dynamic_cast<PlayerObject*>(gWorldManager->getObjectById(targetObject->getId()));
-								tO->removeKnownObject(player);
-								player->removeKnownObject(tO);
-								gMessageLib->sendDestroyObject(tO->getId(),player);
-								
-								it++;
-							}
-					
-							hopper->removeKnownObject(player);
-							player->removeKnownObject(hopper);
-							gMessageLib->sendDestroyObject(hopper->getId(),player);					
-					}
+		++messageCount;
+	}
 
-				}
-			}
-			// send a destroy to us
-			gMessageLib->sendDestroyObject(object->getId(),player);
+	return (mLeavingObjectIndex >= mLeavingObjects.size());
+}
 
-			// we don't know each other anymore
-			knownObjects->erase(objIt++);
-			object->removeKnownObject(player);
+//=========================================================================================
+//
+// a factory going out of range takes its hoppers and their contents with it
+//
 
-			if (++messageCount >= objectDestroyLimit)
-			{
-				break;
-			}
-			continue;
-		}
+void ObjectController::_destroyHopperContent(uint64 hopperId)
+{
+	PlayerObject*	player = dynamic_cast<PlayerObject*>(mObject);
+	TangibleObject*	hopper = dynamic_cast<TangibleObject*>(gWorldManager->getObjectById(hopperId));
 
-		++objIt;
+	if(!hopper)
+	{
+		return;
 	}
-	// For test
-	bool allDestroyed = false;
-	if (objIt == knownObjects->end())
+
+	ObjectIDList*			ol = hopper->getObjects();
+	ObjectIDList::iterator	it = ol->begin();
+
+	while(it != ol->end())
 	{
-		allDestroyed = true;
+		TangibleObject* tO = dynamic_cast<TangibleObject*>(gWorldManager->getObjectById((*it)));
+		if(!tO)
+		{
+			assert(false && "ObjectController::_destroyOutOfRangeObjects WorldManager unable to find TangibleObject instance");
+		}
+
+		tO->removeKnownObject(player);
+		player->removeKnownObject(tO);
+		gMessageLib->sendDestroyObject(tO->getId(),player);
+		it++;
 	}
-	return allDestroyed;
+
+	hopper->removeKnownObject(player);
+	player->removeKnownObject(hopper);
+	
+	gMessageLib->sendDestroyObject(hopper->getId(),player);
 }
 
 //=============================================================================
@@ -1086,9 +1153,8 @@ uint64 ObjectController::playerWorldUpdate(bool forcedUpdate)
 			}
 		}
 
-		// Position check for SI-update.
-        OutOfUpdateRange |= !(glm::distance(player->mPosition, player->getLastUpdatePosition()) < 64.0f);
-		//OutOfUpdateRange |= !(player->mPosition.inRange2D(player->getLastUpdatePosition(),64.0f));
+		// Crossed into another interest cell since the last SI-update?
+		OutOfUpdateRange |= _crossedInterestCell(player);
 
 		if (mUpdatingObjects || forcedUpdate || OutOfUpdateRange)
 		{
@@ -1113,12 +1179,14 @@ uint64 ObjectController::playerWorldUpdate(bool forcedUpdate)
 					mDestroyOutOfRangeObjects = true;
 				}
 				_findInRangeObjectsOutside(true);
+				_computeInterestDeltas(mDestroyOutOfRangeObjects);
 			}
 		}
 		else if (!mDestroyOutOfRangeObjects)
 		{
 			// This is the fast update, based on qt.
 			_findInRangeObjectsOutside(false);
+			_computeInterestDeltas(false);
 		}
 
 		// Update some of the objects we found.
@@ -1130,7 +1198,7 @@ uint64 ObjectController::playerWorldUpdate(bool forcedUpdate)
 			if (mDestroyOutOfRangeObjects)
 			{
 				// We are ready to destroy objects out of range.
-				if (_destroyOutOfRangeObjects(&mInRangeObjects))
+				if (_destroyOutOfRangeObjects())
 				{
 					// All objects are now destroyed.
 					mDestroyOutOfRangeObjects = false;
@@ -49,6 +49,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Common/Message.h"
 #include "MessageLib/MessageLib.h"
 #include "LogManager/LogManager.h"
+#include "Utils/crc.h"
 
 //======================================================================================================================
 //
@@ -222,7 +223,7 @@ void ObjectController::_handleTip(uint64 targetId,Message* message,ObjectControl
 	lower.toLower();
 
 	//check for banktip
-	if((lower.getCrc() == BString("bank").getCrc())&&(elementCount > 1))
+	if((lower.getCrc() == Anh_Utils::crc("bank"))&&(elementCount > 1))
 	{
 		uint32 amount	= atoi(dataElements[elementCount-2].getAnsi());
 		bool havetarget = false;
@@ -42,6 +42,10 @@ using namespace glm::gtx;
 
 //=============================================================================
 
+uint32 Object::mBaselineVersionCounter = 0;
+
+//=============================================================================
+
 Object::Object()
 : mModel("")
 , mLoadState(LoadState_Loading)
@@ -58,6 +62,8 @@ Object::Object()
     mPosition  = glm::vec3();
 
 	mObjectController.setObject(this);
+
+	invalidateBaselines();
 }
 
 //=============================================================================
@@ -77,6 +83,7 @@ Object::Object(uint64 id,uint64 parentId,string model,ObjectType type)
 {
 	mObjectController.setObject(this);
 
+	invalidateBaselines();
 }
 
 //=============================================================================
@@ -93,6 +100,16 @@ Object::~Object()
 
 //=============================================================================
 
+void Object::invalidateBaselines() const
+{
+	for(uint32 i = 0; i < BaselineCache_Total; i++)
+	{
+		mBaselineVersions[i] = ++mBaselineVersionCounter;
+	}
+}
+
+//=============================================================================
+
 glm::vec3 Object::getWorldPosition() const 
 {
     const Object* root_parent = getRootParent();
@@ -345,7 +362,7 @@ void Object::sendAttributes(PlayerObject* playerObject)
 
 		gMessageFactory->addString(gWorldManager->getAttributeKey((*mapIt).first));
 		value = (*mapIt).second.c_str();
-		if(gWorldManager->getAttributeKey((*mapIt).first).getCrc() == BString("duration").getCrc())
+		if(gWorldManager->getAttributeKey((*mapIt).first).getCrc() == Anh_Utils::crc("duration"))
 		{
 			uint32 time;
 			sscanf(value.getAnsi(),"%u",&time);
@@ -386,7 +403,9 @@ void Object::setAttribute(string key,std::string value)
 		return;
 	}
 
-	(*it).second = value;
+	(*it).second.set(value);
+
+	invalidateBaseline(BaselineCache_TANO_3);
 }
 
 //=========================================================================
@@ -407,7 +426,9 @@ void Object::setAttributeIncDB(string key,std::string value)
 		return;
 	}
 
-	(*it).second = value;
+	(*it).second.set(value);
+
+	invalidateBaseline(BaselineCache_TANO_3);
 
 	uint32 attributeID = gWorldManager->getAttributeId(key.getCrc());
 	if(!attributeID)
@@ -436,8 +457,10 @@ void Object::setAttributeIncDB(string key,std::string value)
 
 void Object::addAttribute(string key,std::string value)
 {
-	mAttributeMap.insert(std::make_pair(key.getCrc(),value));
+	mAttributeMap.insert(key.getCrc(),value);
 	mAttributeOrderList.push_back(key.getCrc());
+
+	invalidateBaseline(BaselineCache_TANO_3);
 }
 
 //=============================================================================
@@ -451,9 +474,11 @@ void Object::addAttributeIncDB(string key,std::string value)
 		return;
 	}
 
-	mAttributeMap.insert(std::make_pair(key.getCrc(),value));
+	mAttributeMap.insert(key.getCrc(),value);
 	mAttributeOrderList.push_back(key.getCrc());
 
+	invalidateBaseline(BaselineCache_TANO_3);
+
 	uint32 attributeID = gWorldManager->getAttributeId(key.getCrc());
 	if(!attributeID)
 	{
@@ -478,7 +503,21 @@ void Object::addAttributeIncDB(string key,std::string value)
 
 bool Object::hasAttribute(string key) const
 {
-	if(mAttributeMap.find(key.getCrc()) != mAttributeMap.end())
+	return(hasAttribute(key.getCrc()));
+}
+
+//=============================================================================
+
+bool Object::hasAttribute(const int8* key) const
+{
+	return(hasAttribute(Anh_Utils::crc(key)));
+}
+
+//=============================================================================
+
+bool Object::hasAttribute(uint32 keyCrc) const
+{
+	if(mAttributeMap.find(keyCrc) != mAttributeMap.end())
 		return(true);
 
 	return(false);
@@ -491,7 +530,10 @@ void Object::removeAttribute(string key)
 	AttributeMap::iterator it = mAttributeMap.find(key.getCrc());
 
 	if(it != mAttributeMap.end())
+	{
 		mAttributeMap.erase(it);
+		invalidateBaseline(BaselineCache_TANO_3);
+	}
 	else
 		gLogger->log(LogManager::DEBUG,"Object::removeAttribute: could not find %s",key.getAnsi());
 }
@@ -516,7 +558,7 @@ void Object::setInternalAttributeIncDB(string key,std::string value)
 		return;
 	}
 
-	(*it).second = value;
+	(*it).second.set(value);
 
 	uint32 attributeID = gWorldManager->getAttributeId(key.getCrc());
 	if(!attributeID)
@@ -549,7 +591,7 @@ void	Object::setInternalAttribute(string key,std::string value)
 		return;
 	}
 
-	(*it).second = value;
+	(*it).second.set(value);
 }
 
 //=============================================================================
@@ -563,7 +605,7 @@ void Object::addInternalAttributeIncDB(string key,std::string value)
 		return;
 	}
 
-	mInternalAttributeMap.insert(std::make_pair(key.getCrc(),value));
+	mInternalAttributeMap.insert(key.getCrc(),value);
 
 	uint32 attributeID = gWorldManager->getAttributeId(key.getCrc());
 	if(!attributeID)
@@ -590,14 +632,28 @@ void Object::addInternalAttributeIncDB(string key,std::string value)
 
 void Object::addInternalAttribute(string key,std::string value)
 {
-	mInternalAttributeMap.insert(std::make_pair(key.getCrc(),value));
+	mInternalAttributeMap.insert(key.getCrc(),value);
 }
 
 //=============================================================================
 
 bool Object::hasInternalAttribute(string key)
 {
-	if(mInternalAttributeMap.find(key.getCrc()) != mInternalAttributeMap.end())
+	return(hasInternalAttribute(key.getCrc()));
+}
+
+//=============================================================================
+
+bool Object::hasInternalAttribute(const int8* key)
+{
+	return(hasInternalAttribute(Anh_Utils::crc(key)));
+}
+
+//=============================================================================
+
+bool Object::hasInternalAttribute(uint32 keyCrc)
+{
+	if(mInternalAttributeMap.find(keyCrc) != mInternalAttributeMap.end())
 		return(true);
 
 	return(false);
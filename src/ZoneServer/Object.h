@@ -32,6 +32,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "RadialMenu.h"
 #include "UICallback.h"
 #include "Object_Enums.h"
+#include "AttributeMap.h"
+#include "Utils/crc.h"
 #include "LogManager/LogManager.h" // @todo: this needs to go.	  where does it need to go ?
 #include "Utils/EventHandler.h"
 #include "Utils/typedefs.h"
@@ -59,7 +61,6 @@ class Object;
 class PlayerObject;
 class CreatureObject;
 
-typedef std::map<uint32,std::string>	AttributeMap;
 typedef std::tr1::shared_ptr<RadialMenu>	RadialMenuPtr;
 // typedef std::vector<uint64>				ObjectIDList;
 typedef std::list<uint64>				ObjectIDList;
@@ -110,7 +111,7 @@ class Object : public UICallback, public Anh_Utils::EventHandler
 		
 		void						setModelString(const string model){ mModel = model; }
 		void						setType(ObjectType type){ mType = type; }
-		void						setTypeOptions(uint32 options){ mTypeOptions = options; }
+		void						setTypeOptions(uint32 options){ mTypeOptions = options; invalidateBaselines(); }
 
 		// Object Observers
 		PlayerObjectSet*			getKnownPlayers() { return &mKnownPlayers; }
@@ -145,6 +146,7 @@ class Object : public UICallback, public Anh_Utils::EventHandler
 		// common attributes, send to the client
 		AttributeMap*				getAttributeMap(){ return &mAttributeMap; }
 		template<typename T> T		getAttribute(string key) const;
+		template<typename T> T		getAttribute(const int8* key) const;
 //		template<typename T> T		getAttribute(std::string) const;
 		template<typename T> T		getAttribute(uint32 keyCrc) const;
 		void						setAttribute(string key,std::string value);
@@ -152,22 +154,35 @@ class Object : public UICallback, public Anh_Utils::EventHandler
 		void						addAttribute(string key,std::string value);
 		void						addAttributeIncDB(string key,std::string value);
 		bool						hasAttribute(string key) const;
+		bool						hasAttribute(const int8* key) const;
+		bool						hasAttribute(uint32 keyCrc) const;
 		void						removeAttribute(string key);
 		AttributeOrderList*			getAttributeOrder(){ return &mAttributeOrderList; }
 
 		// internal attributes, only used server side
 		AttributeMap*				getInternalAttributeMap(){ return &mInternalAttributeMap; }
 		template<typename T> T		getInternalAttribute(string key);
+		template<typename T> T		getInternalAttribute(const int8* key);
+		template<typename T> T		getInternalAttribute(uint32 keyCrc);
 		void						setInternalAttribute(string key,std::string value);
 		void						addInternalAttribute(string key,std::string value);
 		void						setInternalAttributeIncDB(string key,std::string value);
 		void						addInternalAttributeIncDB(string key,std::string value);
 		bool						hasInternalAttribute(string key);
+		bool						hasInternalAttribute(const int8* key);
+		bool						hasInternalAttribute(uint32 keyCrc);
 		void						removeInternalAttribute(string key);
 
 		// subzone this is used by spawnregions - get it out there and put this in movingObject
 		uint32						getSubZoneId() const { return mSubZoneId; }
-		void						setSubZoneId(uint32 id){ mSubZoneId = id; }
+		void						setSubZoneId(uint32 id){ mSubZoneId = id; invalidateBaselines(); }
+
+		// Cached baselines (see MessageLib/BaselineCache.h) are only sent as long as they were built at the current version.
+		// Anything that changes what goes into a baseline has to invalidate it, deltas do so in MessageLib.
+		// Versions are unique over all objects, so a cached baseline never matches a new object that got the same id.
+		uint32						getBaselineVersion(BaselineCacheSlot slot) const { return mBaselineVersions[slot]; }
+		void						invalidateBaseline(BaselineCacheSlot slot) const { mBaselineVersions[slot] = ++mBaselineVersionCounter; }
+		void						invalidateBaselines() const;
 
 		//===========================================================================
 		// equip management
@@ -310,6 +325,9 @@ class Object : public UICallback, public Anh_Utils::EventHandler
 	private:
 		glm::vec3		        mLastUpdatePosition;	// Position where SI was updated.
 
+		mutable uint32			mBaselineVersions[BaselineCache_Total];
+		static uint32			mBaselineVersionCounter;
+
 };
 
 //=============================================================================
@@ -321,85 +339,79 @@ T	Object::getAttribute(string key) const
 
 	if(it != mAttributeMap.end())
 	{
-		try
-		{
-			return(boost::lexical_cast<T>((*it).second));
-		}
-		catch(boost::bad_lexical_cast &)
-		{
-			gLogger->log(LogManager::INFORMATION, "Object::getAttribute: cast failed (%s)", key.getAnsi());
-		}
+		T value = T();
+
+		if((*it).second.get(&value))
+			return(value);
+
+		gLogger->log(LogManager::INFORMATION, "Object::getAttribute: cast failed (%s)", key.getAnsi());
 	}
 	else
 		gLogger->log(LogManager::INFORMATION, "Object::getAttribute: could not find %s", key.getAnsi());
 
 	return(T());
 }
+
 //=============================================================================
+// literal keys get hashed without a temporary string
+
+template<typename T>
+T	Object::getAttribute(const int8* key) const
+{
+	AttributeMap::const_iterator it = mAttributeMap.find(Anh_Utils::crc(key));
+
+	if(it != mAttributeMap.end())
+	{
+		T value = T();
+
+		if((*it).second.get(&value))
+			return(value);
+
+		gLogger->log(LogManager::INFORMATION, "Object::getAttribute: cast failed (%s)", key);
+	}
+	else
+		gLogger->log(LogManager::INFORMATION, "Object::getAttribute: could not find %s", key);
+
+	return(T());
+}
 
-//template<typename T>
-//T	Object::getAttribute(std::string key) const
-//{
-//	AttributeMap::const_iterator it = mAttributeMap.find(key.getCrc());
-//
-//	if(it != mAttributeMap.end())
-//	{
-//		try
-//		{
-//			return(boost::lexical_cast<T>((*it).second));
-//		}
-//		catch(boost::bad_lexical_cast &)
-//		{
-//			gLogger->log(LogManager::INFORMATION, "Object::getAttribute: cast failed (%s)", key.getAnsi());
-//		}
-//	}
-//	else
-//		gLogger->log(LogManager::INFORMATION, "Object::getAttribute: could not find %s", key.getAnsi());
-//
-//	return(T());
-//}
 //=============================================================================
 
 template<typename T>
 T	Object::getAttribute(uint32 keyCrc) const
 {
-	AttributeMap::iterator it = mAttributeMap.find(keyCrc);
+	AttributeMap::const_iterator it = mAttributeMap.find(keyCrc);
 
 	if(it != mAttributeMap.end())
 	{
-		try
-		{
-			return(boost::lexical_cast<T>((*it).second));
-		}
-		catch(boost::bad_lexical_cast &)
-		{
-			gLogger->log(LogManager::DEBUG,"Object::getAttribute: cast failed (%s)",keyCrc);
-		}
+		T value = T();
+
+		if((*it).second.get(&value))
+			return(value);
+
+		gLogger->log(LogManager::DEBUG,"Object::getAttribute: cast failed (%u)",keyCrc);
 	}
 	else
-		gLogger->log(LogManager::DEBUG,"Object::getAttribute: could not find %s",keyCrc);
+		gLogger->log(LogManager::DEBUG,"Object::getAttribute: could not find %u",keyCrc);
 
 	return(T());
 }
 
-
 //=============================================================================
 
 template<typename T>
 T	Object::getInternalAttribute(string key)
 {
-	AttributeMap::iterator it = mInternalAttributeMap.find(key.getCrc());
+	AttributeMap::const_iterator it = mInternalAttributeMap.find(key.getCrc());
 
 	if(it != mInternalAttributeMap.end())
 	{
-		try
-		{
-			return(boost::lexical_cast<T>((*it).second));
-		}
-		catch(boost::bad_lexical_cast &)
-		{
-			gLogger->log(LogManager::DEBUG,"Object::getInternalAttribute: cast failed (%s)",key.getAnsi());
-		}
+		T value = T();
+
+		if((*it).second.get(&value))
+			return(value);
+
+		gLogger->log(LogManager::DEBUG,"Object::getInternalAttribute: cast failed (%s)",key.getAnsi());
 	}
 	else
 		gLogger->log(LogManager::DEBUG,"Object::getInternalAttribute: could not find %s",key.getAnsi());
@@ -409,5 +421,49 @@ T	Object::getInternalAttribute(string key)
 
 //=============================================================================
 
+template<typename T>
+T	Object::getInternalAttribute(const int8* key)
+{
+	AttributeMap::const_iterator it = mInternalAttributeMap.find(Anh_Utils::crc(key));
+
+	if(it != mInternalAttributeMap.end())
+	{
+		T value = T();
+
+		if((*it).second.get(&value))
+			return(value);
+
+		gLogger->log(LogManager::DEBUG,"Object::getInternalAttribute: cast failed (%s)",key);
+	}
+	else
+		gLogger->log(LogManager::DEBUG,"Object::getInternalAttribute: could not find %s",key);
+
+	return(T());
+}
+
+//=============================================================================
+
+template<typename T>
+T	Object::getInternalAttribute(uint32 keyCrc)
+{
+	AttributeMap::const_iterator it = mInternalAttributeMap.find(keyCrc);
+
+	if(it != mInternalAttributeMap.end())
+	{
+		T value = T();
+
+		if((*it).second.get(&value))
+			return(value);
+
+		gLogger->log(LogManager::DEBUG,"Object::getInternalAttribute: cast failed (%u)",keyCrc);
+	}
+	else
+		gLogger->log(LogManager::DEBUG,"Object::getInternalAttribute: could not find %u",keyCrc);
+
+	return(T());
+}
+
+//=============================================================================
+
 #endif
 
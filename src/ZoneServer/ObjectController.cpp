@@ -62,6 +62,9 @@ ObjectController::ObjectController()
 : mCmdMsgPool(sizeof(ObjControllerCommandMessage))
 , mDBAsyncContainerPool(sizeof(ObjControllerAsyncContainer))
 , mEventPool(sizeof(ObjControllerEvent))
+, mInRangeObjectIndex(0)
+, mEnteringObjectIndex(0)
+, mLeavingObjectIndex(0)
 , mDatabase(gWorldManager->getDatabase())
 , mObject(NULL)
 , mCommandQueueProcessTimeLimit(5)
@@ -90,6 +93,9 @@ ObjectController::ObjectController(Object* object)
 : mCmdMsgPool(sizeof(ObjControllerCommandMessage))
 , mDBAsyncContainerPool(sizeof(ObjControllerAsyncContainer))
 , mEventPool(sizeof(ObjControllerEvent))
+, mInRangeObjectIndex(0)
+, mEnteringObjectIndex(0)
+, mLeavingObjectIndex(0)
 , mDatabase(gWorldManager->getDatabase())
 , mObject(object)
 , mCommandQueueProcessTimeLimit(5)
@@ -66,6 +66,7 @@ class ArtisanHeightmapAsyncContainer;
 class StructureHeightmapAsyncContainer;
 
 typedef std::set<Object*>				ObjectSet;
+typedef std::vector<Object*>			ObjectVector;
 
 typedef std::vector<EnqueueValidator*>	EnqueueValidators;
 typedef std::vector<ProcessValidator*>	ProcessValidators;
@@ -241,8 +242,8 @@ class ObjectController : public DatabaseCallback, public ObjectFactoryCallback,
 		// Auto attack
 		void					enqueueAutoAttack(uint64 targetId);
 
-		ObjectSet*				getInRangeObjects(){return(&mInRangeObjects);}
-		ObjectSet::iterator		getInRangeObjectsIterator(){return mObjectSetIt;}
+		ObjectVector*			getInRangeObjects(){return(&mInRangeObjects);}
+		uint32					getInRangeObjectIndex(){return mInRangeObjectIndex;}
 
 	private:
 
@@ -707,10 +708,15 @@ class ObjectController : public DatabaseCallback, public ObjectFactoryCallback,
 		// spatial object updates
 		float	_GetMessageHeapLoadViewingRange();
 		void	_findInRangeObjectsOutside(bool updateAll);
+		void	_computeInterestDeltas(bool collectLeaving);
+		bool	_crossedInterestCell(PlayerObject* player);
+		float	_getInterestHysteresis();
 		bool	_updateInRangeObjectsOutside();
 		void	_findInRangeObjectsInside(bool updateAll);
 		bool	_updateInRangeObjectsInside();
-		bool	_destroyOutOfRangeObjects(ObjectSet* inRangeObjects);
+		bool	_destroyOutOfRangeObjects();
+		void	_destroyHopperContent(uint64 hopperId);
+		void	_finalizeInRangeObjects();
 
 
 		// ham
@@ -723,8 +729,12 @@ class ObjectController : public DatabaseCallback, public ObjectFactoryCallback,
 
 		CommandQueue				mCommandQueue;
 		EventQueue					mEventQueue;
-		ObjectSet						mInRangeObjects;
-		ObjectSet::iterator mObjectSetIt;
+		ObjectVector				mInRangeObjects;		// reused between queries, sorted by _finalizeInRangeObjects
+		uint32						mInRangeObjectIndex;
+		std::vector<uint64>			mEnteringObjects;		// ids of objects to create, sent in batches by _updateInRangeObjectsOutside
+		uint32						mEnteringObjectIndex;
+		std::vector<uint64>			mLeavingObjects;		// ids of known objects to destroy, sent in batches by _destroyOutOfRangeObjects
+		uint32						mLeavingObjectIndex;
 
 		EnqueueValidators	mEnqueueValidators;
 		ProcessValidators	mProcessValidators;
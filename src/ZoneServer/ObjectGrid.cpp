@@ -0,0 +1,248 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#include "ObjectGrid.h"
+#include "Object.h"
+#include "LogManager/LogManager.h"
+#include "MathLib/Rectangle.h"
+#include "MathLib/Circle.h"
+
+#include <cassert>
+
+//======================================================================================================================
+//
+// collects the entries the grid hands out, skipping the querying object and types not asked for
+//
+
+namespace
+{
+	void addResult(ObjectSet* resultSet, Object* object)
+	{
+		resultSet->insert(object);
+	}
+
+	void addResult(ObjectVector* results, Object* object)
+	{
+		results->push_back(object);
+	}
+
+	template<class Container>
+	class ObjectCollector
+	{
+		public:
+
+			ObjectCollector(const Object* const object, Container* results, uint32 typeMask)
+				: mObject(object),mResults(results),mTypeMask(typeMask){}
+
+			void operator()(const Anh_Utils::spatial_grid<Object>::Entry& entry)
+			{
+				Object* object = entry.item;
+
+				if(object != mObject && ((object->getType() & mTypeMask) == static_cast<uint32>(object->getType())))
+				{
+					addResult(mResults,object);
+				}
+			}
+
+		private:
+
+			const Object*	mObject;
+			Container*		mResults;
+			uint32			mTypeMask;
+	};
+
+	template<class Container>
+	void visitShape(const Anh_Utils::spatial_grid<Object>& grid, Anh_Math::Shape* shape, ObjectCollector<Container>& collector)
+	{
+		// rectangular
+		if(Anh_Math::Rectangle* rectangle = dynamic_cast<Anh_Math::Rectangle*>(shape))
+		{
+			const glm::vec3& rectPos = rectangle->getPosition();
+
+			grid.visitRectangle(rectPos.x,rectPos.z,rectangle->getWidth(),rectangle->getHeight(),collector);
+		}
+		// circle
+		else if(Anh_Math::Circle* circle = dynamic_cast<Anh_Math::Circle*>(shape))
+		{
+			const glm::vec3& center = circle->getPosition();
+
+			grid.visitRange(center.x,center.z,circle->getRadius(),collector);
+		}
+	}
+}
+
+//======================================================================================================================
+//
+// Constructor
+//
+
+ObjectGrid::ObjectGrid(float lowX,float lowZ,float width,float height,float cellSize) :
+mGrid(lowX,lowZ,width,height,cellSize)
+{
+}
+
+//======================================================================================================================
+//
+// Deconstructor
+//
+
+ObjectGrid::~ObjectGrid()
+{
+}
+
+//======================================================================================================================
+//
+// insert an object
+//
+
+int32 ObjectGrid::addObject(Object* object)
+{
+	// Validate input. Should be interesting to see.
+	assert(object && "ObjectGrid::addObject this method does not accept NULL objects");
+	assert(object->getId() && "ObjectGrid::addObject this method requires an object with a valid id");
+
+	if(!mGrid.insert(object->getId(),object,object->mPosition.x,object->mPosition.z))
+	{
+		gLogger->log(LogManager::DEBUG,"ObjectGrid::addObject: INSERTED OBJECT already exist = %"PRIu64"",  object->getId());
+		return(2);
+	}
+
+	return(1);
+}
+
+//======================================================================================================================
+//
+// removes an object
+//
+
+int32 ObjectGrid::removeObject(Object* object)
+{
+	// Validate input. Should be interesting to see.
+	assert(object && "ObjectGrid::removeObject this method does not accept NULL objects");
+	assert(object->getId() && "ObjectGrid::removeObject this method requires an object with a valid id");
+
+	if(!mGrid.remove(object->getId()))
+	{
+		gLogger->log(LogManager::DEBUG,"ObjectGrid::removeObject ERROR FAILED to REMOVE object with id = %"PRIu64"",  object->getId());
+		return(2);
+	}
+
+	return(1);
+}
+
+//======================================================================================================================
+//
+// update an objects position, objects we don't hold yet get added
+//
+
+int32 ObjectGrid::updateObject(Object* object, const glm::vec3& newPosition)
+{
+	// Validate input. Should be interesting to see.
+	assert(object && "ObjectGrid::updateObject this method does not accept NULL objects");
+	assert(object->getId() && "ObjectGrid::updateObject this method requires an object with a valid id");
+
+	object->mPosition = newPosition;
+
+	if(!mGrid.update(object->getId(),newPosition.x,newPosition.z))
+	{
+		mGrid.insert(object->getId(),object,newPosition.x,newPosition.z);
+	}
+
+	return(0);
+}
+
+//======================================================================================================================
+//
+// gather all objects of the given types inside the shape
+//
+
+void ObjectGrid::getObjectsInRange(Object* object,ObjectSet* resultSet,uint32 typeMask,Anh_Math::Shape* shape)
+{
+	ObjectCollector<ObjectSet> collector(object,resultSet,typeMask);
+
+	visitShape(mGrid,shape,collector);
+}
+
+//======================================================================================================================
+//
+// used by camps to get all contained objects, the grid only hands out contained objects anyway
+//
+
+void ObjectGrid::getObjectsInRangeContains(Object* object,ObjectSet* resultSet,uint32 typeMask,Anh_Math::Shape* shape)
+{
+	getObjectsInRange(object,resultSet,typeMask,shape);
+}
+
+//======================================================================================================================
+//
+// gather all objects of the given types within range of center into a caller owned vector
+//
+
+void ObjectGrid::getObjectsInRange(const Object* const object,ObjectVector* results,uint32 typeMask,const glm::vec3& center,float range)
+{
+	ObjectCollector<ObjectVector> collector(object,results,typeMask);
+
+	mGrid.visitRange(center.x,center.z,range,collector);
+}
+
+//======================================================================================================================
+//
+// checks if an object lies inside a given shape
+//
+
+bool ObjectGrid::ObjectContained(Anh_Math::Shape* shape, Object* object)
+{
+	// rectangular
+	if(Anh_Math::Rectangle* rectangle = dynamic_cast<Anh_Math::Rectangle*>(shape))
+	{
+		const glm::vec3& rectPos = rectangle->getPosition();
+
+		// check intersection
+		if(rectPos.x > object->mPosition.x   || rectPos.x + rectangle->getWidth()  < object->mPosition.x
+		|| rectPos.z > object->mPosition.z  || rectPos.z + rectangle->getHeight() < object->mPosition.z)
+		{
+			return(false);
+		}
+
+		return(true);
+	}
+	// circle
+	else if(Anh_Math::Circle* circle = dynamic_cast<Anh_Math::Circle*>(shape))
+	{
+		const glm::vec3& center = circle->getPosition();
+
+		float dx = object->mPosition.x - center.x;
+		float dz = object->mPosition.z - center.z;
+
+		return(dx * dx + dz * dz <= circle->getRadius() * circle->getRadius());
+	}
+
+	return(false);
+}
+
+//======================================================================================================================
+
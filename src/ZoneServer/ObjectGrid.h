@@ -25,54 +25,55 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 ---------------------------------------------------------------------------------------
 */
 
-#ifndef	ANH_ZONESERVER_QUADTREE_H
-#define	ANH_ZONESERVER_QUADTREE_H
+#ifndef	ANH_ZONESERVER_OBJECTGRID_H
+#define	ANH_ZONESERVER_OBJECTGRID_H
 
-#include "MathLib/Rectangle.h"
 #include "Utils/typedefs.h"
-#include <map>
+#include "Utils/SpatialGrid.h"
 #include <set>
+#include <vector>
 #include <glm/glm.hpp>
 
 class Object;
 
 namespace Anh_Math
 {
-    class Space;
+    class Shape;
 }
 
-typedef std::map<uint64,Object*> StdObjectMap;
 typedef std::set<Object*> ObjectSet;
+typedef std::vector<Object*> ObjectVector;
 
 //======================================================================================================================
+//
+// holds the moving objects (players, npcs, vehicles) of a QTRegion
+// static objects stay in the ZoneTree
+//
 
-class QuadTreeNode : public Anh_Math::Rectangle
+class ObjectGrid
 {
 	public:
 
-		QuadTreeNode(float lowX,float lowZ,float width,float height);
-		virtual ~QuadTreeNode();
+		ObjectGrid(float lowX,float lowZ,float width,float height,float cellSize);
+		~ObjectGrid();
 
 		int32	addObject(Object* object);
 		int32	removeObject(Object* object);
 		int32	updateObject(Object* object, const glm::vec3& newPosition);
 
-		bool	checkBounds(Object* object);
-		bool	intersects(Anh_Math::Shape* shape);
 		bool	ObjectContained(Anh_Math::Shape* shape, Object* object);
 		void	getObjectsInRange(Object* object,ObjectSet* resultSet,uint32 typeMask,Anh_Math::Shape* shape);
 		void	getObjectsInRangeContains(Object* object,ObjectSet* resultSet,uint32 typeMask,Anh_Math::Shape* shape);
-		
-		void	subDivide();
+		void	getObjectsInRange(const Object* const object,ObjectVector* results,uint32 typeMask,const glm::vec3& center,float range);
 
-	protected:
+		uint32	getObjectCount() const { return mGrid.size(); }
 
-		QuadTreeNode**	mSubNodes;
-		StdObjectMap	mObjects;
+	private:
+
+		Anh_Utils::spatial_grid<Object>	mGrid;
 };
 
 //======================================================================================================================
 
 #endif
 
-
@@ -109,6 +109,22 @@ enum EquipSlot
 	EquipSlot_Wrists				= 2097152
 };
 
+//=============================================================================
+//
+// the baselines MessageLib caches per object, every slot is versioned on its own
+//
+
+enum BaselineCacheSlot
+{
+	BaselineCache_CREO_3			= 0,
+	BaselineCache_CREO_6			= 1,
+	BaselineCache_PLAY_3			= 2,
+	BaselineCache_TANO_3			= 3,
+	BaselineCache_TANO_6			= 4,
+
+	BaselineCache_Total				= 5
+};
+
 //=============================================================================
 
 #endif
@@ -0,0 +1,294 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+#include "PersistenceManager.h"
+
+#include "ConfigManager/ConfigManager.h"
+#include "DatabaseManager/Database.h"
+#include "DatabaseManager/DatabaseResult.h"
+#include "LogManager/LogManager.h"
+#include "Utils/clock.h"
+
+#include <cstdio>
+
+//======================================================================================================================
+
+bool				PersistenceManager::mInsFlag    = false;
+PersistenceManager*	PersistenceManager::mSingleton  = NULL;
+
+//======================================================================================================================
+
+struct PersistTableInfo
+{
+	const int8*	mTable;
+	const int8*	mIdColumn;
+};
+
+static const PersistTableInfo persistTables[PersistTable_Count] =
+{
+	{ "item_attributes",		"item_id" },
+	{ "structure_attributes",	"structure_id" }
+};
+
+// the reference of an async batch
+struct PersistBatch
+{
+	uint64	mStartTime;
+	uint32	mRows;
+};
+
+//======================================================================================================================
+
+PersistenceManager* PersistenceManager::Init(Database* database)
+{
+	if(!mInsFlag)
+	{
+		mSingleton	= new PersistenceManager(database);
+		mInsFlag	= true;
+
+		return mSingleton;
+	}
+	else
+		return mSingleton;
+}
+
+//======================================================================================================================
+
+PersistenceManager::PersistenceManager(Database* database) :
+mDatabase(database),
+mLastFlushLatency(0),
+mMaxFlushLatency(0),
+mTotalFlushLatency(0),
+mFieldsMarked(0),
+mFieldsWritten(0),
+mBatchesWritten(0),
+mBatchesInFlight(0),
+mPendingFields(0)
+{
+	mFlushInterval	= gConfig->read<int>("PersistFlushInterval",5000);
+	mLastFlush		= gClock->getLocalTime();
+	mLastStatistics	= mLastFlush;
+}
+
+//======================================================================================================================
+
+PersistenceManager::~PersistenceManager()
+{
+	mInsFlag = false;
+	mSingleton = NULL;
+}
+
+//======================================================================================================================
+//
+// a field marked again before the flush only keeps its latest value
+//
+
+void PersistenceManager::setAttribute(PersistTable table,uint64 objectId,uint32 attributeId,const std::string& value)
+{
+	if(value.length() > PERSIST_MAX_VALUE)
+	{
+		gLogger->log(LogManager::NOTICE,"PersistenceManager::setAttribute: value of attribute %u on %"PRIu64" too long, not saved",attributeId,objectId);
+		return;
+	}
+
+	std::pair<PersistFieldMap::iterator,bool> result = mDirtyFields[table].insert(std::make_pair(PersistKey(objectId,attributeId),value));
+
+	if(result.second)
+	{
+		mPendingFields++;
+	}
+	else
+	{
+		result.first->second = value;
+	}
+
+	mFieldsMarked++;
+}
+
+//======================================================================================================================
+
+void PersistenceManager::Process()
+{
+	uint64 now = gClock->getLocalTime();
+
+	if(now - mLastFlush >= mFlushInterval)
+	{
+		flush();
+	}
+
+	if(now - mLastStatistics >= PERSIST_STATS_INTERVAL)
+	{
+		mLastStatistics = now;
+		logStatistics();
+	}
+}
+
+//======================================================================================================================
+
+void PersistenceManager::flush(bool synchronous)
+{
+	mLastFlush = gClock->getLocalTime();
+
+	// batches still queued may hold older values, the synchronous ones wait behind them on the same key
+	bool waitForQueued = synchronous && mBatchesInFlight;
+
+	for(uint32 table = 0; table < PersistTable_Count; table++)
+	{
+		if(waitForQueued && mDirtyFields[table].empty())
+		{
+			mDatabase->DestroyResult(mDatabase->ExecuteSynchSqlOrdered(table + 1,"DO 0"));
+			continue;
+		}
+
+		_flushTable(table,synchronous);
+	}
+}
+
+//======================================================================================================================
+//
+// one UPDATE per batch of rows, the CASE picks the value per row, rows of the listed objects
+// we didnt touch keep their value
+//
+
+void PersistenceManager::_flushTable(uint32 table,bool synchronous)
+{
+	PersistFieldMap&	fields		= mDirtyFields[table];
+	const int8*			tableName	= persistTables[table].mTable;
+	const int8*			idColumn	= persistTables[table].mIdColumn;
+
+	if(fields.empty())
+		return;
+
+	// sized so the statement stays below the 8k of a database job
+	int8	cases[6144];
+	int8	ids[PERSIST_BATCH_ROWS * 21 + 1];
+	int8	attributes[PERSIST_BATCH_ROWS * 11 + 1];
+	int8	value[PERSIST_MAX_VALUE * 2 + 1];
+	int8	sql[8192];
+
+	uint32	casesLength			= 0;
+	uint32	idsLength			= 0;
+	uint32	attributesLength	= 0;
+	uint32	rows				= 0;
+
+	PersistFieldMap::iterator it = fields.begin();
+
+	while(it != fields.end())
+	{
+		mDatabase->Escape_String(value,it->second.c_str(),(uint32)it->second.length());
+
+		casesLength			+= sprintf(&cases[casesLength]," WHEN %s=%"PRIu64" AND attribute_id=%u THEN '%s'",idColumn,it->first.first,it->first.second,value);
+		idsLength			+= sprintf(&ids[idsLength],"%s%"PRIu64"",rows ? "," : "",it->first.first);
+		attributesLength	+= sprintf(&attributes[attributesLength],"%s%u",rows ? "," : "",it->first.second);
+
+		rows++;
+		++it;
+
+		// leave room for another row with the longest value
+		if(rows == PERSIST_BATCH_ROWS || casesLength > 4000 || it == fields.end())
+		{
+			sprintf(sql,"UPDATE %s SET value=CASE%s ELSE value END WHERE %s IN (%s) AND attribute_id IN (%s)",tableName,cases,idColumn,ids,attributes);
+
+			_sendBatch(table,sql,rows,synchronous);
+
+			casesLength			= 0;
+			idsLength			= 0;
+			attributesLength	= 0;
+			rows				= 0;
+		}
+	}
+
+	mPendingFields -= (uint32)fields.size();
+	fields.clear();
+}
+
+//======================================================================================================================
+//
+// batches of a table are keyed, so a later flush cant overtake an earlier one
+//
+
+void PersistenceManager::_sendBatch(uint32 table,const int8* sql,uint32 rows,bool synchronous)
+{
+	mFieldsWritten += rows;
+	mBatchesWritten++;
+
+	if(synchronous)
+	{
+		uint64 start = gClock->getLocalTime();
+
+		if(DatabaseResult* result = mDatabase->ExecuteSynchSqlOrdered(table + 1,"%s",sql))
+			mDatabase->DestroyResult(result);
+
+		mLastFlushLatency = gClock->getLocalTime() - start;
+		mTotalFlushLatency += mLastFlushLatency;
+
+		if(mLastFlushLatency > mMaxFlushLatency)
+			mMaxFlushLatency = mLastFlushLatency;
+
+		return;
+	}
+
+	PersistBatch* batch = new PersistBatch();
+	batch->mStartTime	= gClock->getLocalTime();
+	batch->mRows		= rows;
+
+	mBatchesInFlight++;
+
+	mDatabase->ExecuteSqlAsyncOrdered(table + 1,this,batch,"%s",sql);
+}
+
+//======================================================================================================================
+
+void PersistenceManager::handleDatabaseJobComplete(void* ref,DatabaseResult* result)
+{
+	PersistBatch* batch = reinterpret_cast<PersistBatch*>(ref);
+
+	mLastFlushLatency = gClock->getLocalTime() - batch->mStartTime;
+	mTotalFlushLatency += mLastFlushLatency;
+
+	if(mLastFlushLatency > mMaxFlushLatency)
+		mMaxFlushLatency = mLastFlushLatency;
+
+	mBatchesInFlight--;
+
+	delete(batch);
+}
+
+//======================================================================================================================
+
+void PersistenceManager::logStatistics()
+{
+	if(!mBatchesWritten)
+		return;
+
+	gLogger->log(LogManager::INFORMATION,"PersistenceManager: %"PRIu64" fields marked, %"PRIu64" written in %u batches, %u pending, %u batches in flight",
+		mFieldsMarked,mFieldsWritten,mBatchesWritten,mPendingFields,mBatchesInFlight);
+
+	gLogger->log(LogManager::INFORMATION,"PersistenceManager: flush latency last %"PRIu64"ms, avg %"PRIu64"ms, max %"PRIu64"ms",
+		mLastFlushLatency,mTotalFlushLatency / mBatchesWritten,mMaxFlushLatency);
+}
+
+//======================================================================================================================
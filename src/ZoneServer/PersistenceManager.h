@@ -0,0 +1,128 @@
+/*
+---------------------------------------------------------------------------------------
+This source file is part of SWG:ANH (Star Wars Galaxies - A New Hope - Server Emulator)
+
+For more information, visit http://www.swganh.com
+
+Copyright (c) 2006 - 2010 The SWG:ANH Team
+---------------------------------------------------------------------------------------
+Use of this source code is governed by the GPL v3 license that can be found
+in the COPYING file or at http://www.gnu.org/licenses/gpl-3.0.html
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public
+License as published by the Free Software Foundation; either
+version 2.1 of the License, or (at your option) any later version.
+
+This library is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public
+License along with this library; if not, write to the Free Software
+Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+---------------------------------------------------------------------------------------
+*/
+
+#ifndef ANH_ZONESERVER_PERSISTENCEMANAGER_H
+#define ANH_ZONESERVER_PERSISTENCEMANAGER_H
+
+#include "DatabaseManager/DatabaseCallback.h"
+#include "Utils/typedefs.h"
+
+#include <map>
+#include <string>
+
+#define	gPersistenceManager	PersistenceManager::getSingletonPtr()
+
+// rows per UPDATE, the statement has to fit a database job
+#define PERSIST_BATCH_ROWS			50
+#define PERSIST_MAX_VALUE			1024
+#define PERSIST_STATS_INTERVAL		300000
+
+//======================================================================================================================
+
+class Database;
+class DatabaseResult;
+
+//======================================================================================================================
+//
+// the attribute tables we write behind, rows are (object id, attribute id, value)
+//
+
+enum PersistTable
+{
+	PersistTable_ItemAttributes			= 0,
+	PersistTable_StructureAttributes	= 1,
+
+	PersistTable_Count					= 2
+};
+
+typedef std::pair<uint64,uint32>					PersistKey;
+typedef std::map<PersistKey,std::string>			PersistFieldMap;
+
+//======================================================================================================================
+//
+// Objects mark their changed attributes dirty here instead of sending an UPDATE each.
+// Every flush interval the dirty fields get coalesced, only the last value of a field is written,
+// and go out as multi row UPDATEs. Logouts force a flush, shutdown flushes synchronously.
+// A synchronous flush returns once every batch queued before it is written too.
+//
+
+class PersistenceManager : public DatabaseCallback
+{
+	public:
+
+		static PersistenceManager*	Init(Database* database);
+		static PersistenceManager*	getSingletonPtr() { return mSingleton; }
+
+		~PersistenceManager();
+
+		void			setAttribute(PersistTable table,uint64 objectId,uint32 attributeId,const std::string& value);
+
+		void			Process();
+		void			flush(bool synchronous = false);
+
+		void			handleDatabaseJobComplete(void* ref,DatabaseResult* result);
+
+		// queue depth and flush latency
+		uint32			getPendingFields(){ return mPendingFields; }
+		uint32			getBatchesInFlight(){ return mBatchesInFlight; }
+		uint64			getLastFlushLatency(){ return mLastFlushLatency; }
+		uint64			getMaxFlushLatency(){ return mMaxFlushLatency; }
+		uint64			getFieldsWritten(){ return mFieldsWritten; }
+		uint64			getFieldsMarked(){ return mFieldsMarked; }
+
+		void			logStatistics();
+
+	private:
+
+		PersistenceManager(Database* database);
+
+		void			_flushTable(uint32 table,bool synchronous);
+		void			_sendBatch(uint32 table,const int8* sql,uint32 rows,bool synchronous);
+
+		static PersistenceManager*	mSingleton;
+		static bool					mInsFlag;
+
+		Database*					mDatabase;
+		PersistFieldMap				mDirtyFields[PersistTable_Count];
+
+		uint64						mFlushInterval;
+		uint64						mLastFlush;
+		uint64						mLastStatistics;
+
+		uint64						mLastFlushLatency;
+		uint64						mMaxFlushLatency;
+		uint64						mTotalFlushLatency;
+		uint64						mFieldsMarked;
+		uint64						mFieldsWritten;
+		uint32						mBatchesWritten;
+		uint32						mBatchesInFlight;
+		uint32						mPendingFields;
+};
+
+//======================================================================================================================
+
+#endif //ANH_ZONESERVER_PERSISTENCEMANAGER_H
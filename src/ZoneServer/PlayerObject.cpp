@@ -40,7 +40,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "GroupManager.h"
 #include "GroupObject.h"
 #include "Inventory.h"
-#include "QuadTree.h"
+#include "PersistenceManager.h"
+#include "ObjectGrid.h"
 
 #include "SampleEvent.h"
 #include "SchematicGroup.h"
@@ -238,9 +239,9 @@ PlayerObject::~PlayerObject()
 	
 
 	// update defender lists
-	ObjectIDList::iterator defenderIt = mDefenders.begin();
+	ObjectIDList::const_iterator defenderIt = getDefenders()->begin();
 
-	while (defenderIt != mDefenders.end())
+	while (defenderIt != getDefenders()->end())
 	{
 		if (CreatureObject* defenderCreature = dynamic_cast<CreatureObject*>(gWorldManager->getObjectById((*defenderIt))))
 		{
@@ -1745,7 +1746,7 @@ void PlayerObject::clone(uint64 parentId, const glm::quat& dir, const glm::vec3&
 					{
 						// Remove insurance.
 						tangibleObject->setInternalAttribute("insured","0");
-						gWorldManager->getDatabase()->ExecuteSqlAsync(NULL,NULL,"UPDATE item_attributes SET value=0 WHERE item_id=%"PRIu64" AND attribute_id=%u",tangibleObject->getId(), 1270);
+						gPersistenceManager->setAttribute(PersistTable_ItemAttributes,tangibleObject->getId(),1270,"0");
 
 						tangibleObject->setTypeOptions(tangibleObject->getTypeOptions() & ~((uint32)4));
 
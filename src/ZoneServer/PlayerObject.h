@@ -103,7 +103,7 @@ class PlayerObject : public CreatureObject
 		void				setClientTickCount(uint32 tickCount){ mClientTickCount = tickCount; }
 
 		string				getTitle() const { return mTitle; }
-		void				setTitle(const string title){ mTitle = title; }
+		void				setTitle(const string title){ mTitle = title; invalidateBaseline(BaselineCache_PLAY_3); }
 
 		uint64				getPlayerObjId(){ return mPlayerObjId; }
 		void				setPlayerObjId(uint64 id){ mPlayerObjId = id; }
@@ -156,18 +156,18 @@ class PlayerObject : public CreatureObject
 
 		// Charsheet
 		uint32				getPlayerMatch(uint8 num){ return mPlayerMatch[num]; }
-		void				setPlayerMatch(uint8 num,uint32 match){ mPlayerMatch[num] = match; }
+		void				setPlayerMatch(uint8 num,uint32 match){ mPlayerMatch[num] = match; invalidateBaseline(BaselineCache_PLAY_3); }
 
 		uint8				getCsrTag(){ return mCsrTag; }
 		void				setCsrTag(uint8 csrTag){ mCsrTag = csrTag; }
 
-		void				togglePlayerFlagOn(uint32 flag){ mPlayerFlags = mPlayerFlags | flag; }
-		void				togglePlayerFlagOff(uint32 flag){ mPlayerFlags = mPlayerFlags & ~flag; }
-		void				togglePlayerFlag(uint32 flag){ mPlayerFlags = mPlayerFlags ^ flag; }
+		void				togglePlayerFlagOn(uint32 flag){ mPlayerFlags = mPlayerFlags | flag; invalidateBaseline(BaselineCache_PLAY_3); }
+		void				togglePlayerFlagOff(uint32 flag){ mPlayerFlags = mPlayerFlags & ~flag; invalidateBaseline(BaselineCache_PLAY_3); }
+		void				togglePlayerFlag(uint32 flag){ mPlayerFlags = mPlayerFlags ^ flag; invalidateBaseline(BaselineCache_PLAY_3); }
 		bool				checkPlayerFlag(uint32 flag){ return((mPlayerFlags & flag) == flag); }
 		bool				checkPlayerFlags(uint64 flags){ return((mPlayerFlags & flags) == flags); }
 		uint32				getPlayerFlags() const { return mPlayerFlags; }
-		void				setPlayerFlags(uint32 flags){ mPlayerFlags = flags; }
+		void				setPlayerFlags(uint32 flags){ mPlayerFlags = flags; invalidateBaseline(BaselineCache_PLAY_3); }
 
 		void				togglePlayerCustomFlagOn(uint32 flag){ mPlayerCustomFlags = mPlayerCustomFlags | flag; }
 		void				togglePlayerCustomFlagOff(uint32 flag){ mPlayerCustomFlags = mPlayerCustomFlags & ~flag; }
@@ -188,7 +188,7 @@ class PlayerObject : public CreatureObject
 		string				getMarriage(){ return mMarriage; }
 
 		uint32				getBornyear(){ return mBornyear; }
-		void				setBornyear(uint32 bornyear){ mBornyear = bornyear; }
+		void				setBornyear(uint32 bornyear){ mBornyear = bornyear; invalidateBaseline(BaselineCache_PLAY_3); }
 
 		int8				getBindPlanet(){ return mBindPlanet; }
 		void				setBindPlanet(int8 planetId){ mBindPlanet = planetId; }
@@ -47,6 +47,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "DatabaseManager/DataBinding.h"
 
 #include "Utils/utils.h"
+#include "Utils/crc.h"
 
 //=============================================================================
 
@@ -98,347 +99,300 @@ void PlayerObjectFactory::handleDatabaseJobComplete(void* ref,DatabaseResult* re
 	{
 		case POFQuery_MainPlayerData:
 		{
-
 			PlayerObject* playerObject = _createPlayer(result);
 
 			playerObject->setClient(asyncContainer->mClient);
-			QueryContainerBase* asContainer = new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(asyncContainer->mOfCallback,POFQuery_Skills,asyncContainer->mClient);
-			asContainer->mObject = playerObject;
 
-			mDatabase->ExecuteSqlAsync(this,asContainer,"SELECT skill_id FROM character_skills WHERE character_id=%"PRIu64"",playerObject->getId());
-		}
-		break;
+			// the lists came along in the same round trip, one result set each, in the order of requestObject
+			result->NextResultSet();
+			_loadSkills(playerObject,result);
 
-		case POFQuery_Skills:
-		{
-			PlayerObject* playerObject = dynamic_cast<PlayerObject	*>(asyncContainer->mObject);
-			uint32 skillId;
+			result->NextResultSet();
+			_loadBadges(playerObject,result);
 
-			DataBinding* binding = mDatabase->CreateDataBinding(1);
-			binding->addField(DFT_uint32,0,4);
+			result->NextResultSet();
+			_loadFactions(playerObject,result);
 
-			uint64 count = result->getRowCount();
+			result->NextResultSet();
+			_loadNameList(result,&playerObject->mFriendsList);
 
-			for(uint64 i = 0;i < count;i++)
-			{
-				result->GetNextRow(binding,&skillId);
-				playerObject->mSkills.push_back(gSkillManager->getSkillById(skillId));
-			}
+			result->NextResultSet();
+			_loadNameList(result,&playerObject->mIgnoreList);
 
-			mDatabase->DestroyDataBinding(binding);
+			result->NextResultSet();
+			_loadDenyService(playerObject,result);
 
-			playerObject->prepareSkillMods();
-			playerObject->prepareSkillCommands();
-			playerObject->prepareSchematicIds();
+			result->NextResultSet();
+			_loadHoloEmotes(playerObject,result);
 
-			playerObject->mSkillCmdUpdateCounter = playerObject->getSkillCommands()->size();
-			playerObject->mSkillModUpdateCounter = playerObject->getSkillMods()->size();
+			result->NextResultSet();
+			_loadCloningFacility(playerObject,result);
 
-			QueryContainerBase* asContainer = new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(asyncContainer->mOfCallback,POFQuery_Badges,asyncContainer->mClient);
-			asContainer->mObject = playerObject;
+			result->NextResultSet();
+			_loadLots(playerObject,result);
 
-			mDatabase->ExecuteSqlAsync(this,asContainer,"SELECT badge_id FROM character_badges WHERE character_id=%"PRIu64"",playerObject->getId());
-		}
-		break;
+			result->NextResultSet();
+			_loadXp(playerObject,result);
 
-		case POFQuery_Badges:
-		{
-			PlayerObject* playerObject = dynamic_cast<PlayerObject*>(asyncContainer->mObject);
-			uint32 badgeId;
-
-			DataBinding* binding = mDatabase->CreateDataBinding(1);
-			binding->addField(DFT_uint32,0,4);
-
-			uint64 count = result->getRowCount();
-
-			for(uint64 i = 0;i < count;i++)
-			{
-				result->GetNextRow(binding,&badgeId);
-				playerObject->mBadgeList.push_back(badgeId);
-			}
-
-			mDatabase->DestroyDataBinding(binding);
-
-			QueryContainerBase* asContainer = new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(asyncContainer->mOfCallback,POFQuery_Factions,asyncContainer->mClient);
-			asContainer->mObject = playerObject;
-
-			mDatabase->ExecuteSqlAsync(this,asContainer,"SELECT faction_id,value FROM character_faction WHERE character_id=%"PRIu64" ORDER BY faction_id",playerObject->getId());
-		}
-		break;
-
-		case POFQuery_Factions:
-		{
-			PlayerObject*	playerObject = dynamic_cast<PlayerObject*>(asyncContainer->mObject);
-			XpContainer		factionCont;
-
-			DataBinding* binding = mDatabase->CreateDataBinding(2);
-			binding->addField(DFT_uint32,offsetof(XpContainer,mId),4,0);
-			binding->addField(DFT_int32,offsetof(XpContainer,mValue),4,1);
-
-			uint64 count = result->getRowCount();
-
-			for(uint64 i = 0;i < count;i++)
-			{
-				result->GetNextRow(binding,&factionCont);
-				playerObject->mFactionList.push_back(std::make_pair(factionCont.mId,factionCont.mValue));
-			}
-
-			mDatabase->DestroyDataBinding(binding);
+			// store us for later lookup
+			InLoadingContainer* ilc = new(mILCPool.ordered_malloc()) InLoadingContainer(playerObject,asyncContainer->mOfCallback,asyncContainer->mClient,2);
+			ilc->mLoadCounter = 2;
 
-			// query friendslist
-			QueryContainerBase* asContainer = new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(asyncContainer->mOfCallback,POFQuery_Friends,asyncContainer->mClient);
-			asContainer->mObject = playerObject;
+			mObjectLoadMap.insert(std::make_pair(playerObject->getId(),ilc));
 
-			mDatabase->ExecuteSqlAsync(this,asContainer,"SELECT characters.firstname FROM chat_friendlist "
-														"INNER JOIN characters ON (chat_friendlist.friend_id = characters.id) "
-														"WHERE (chat_friendlist.character_id = %"PRIu64")",playerObject->getId());
+			// request inventory
+			mInventoryFactory->requestObject(this,playerObject->mId + 1,TanGroup_Inventory,TanType_CharInventory,asyncContainer->mClient);
 		}
 		break;
 
-		case POFQuery_Friends:
+		case POFQuery_EquippedItems:
 		{
 			PlayerObject* playerObject = dynamic_cast<PlayerObject*>(asyncContainer->mObject);
-			string name;
 
+			InLoadingContainer*	mIlc = _getObject(playerObject->getId());
+
+			uint64 id;
 			DataBinding* binding = mDatabase->CreateDataBinding(1);
-			binding->addField(DFT_bstring,0,64);
+			binding->addField(DFT_uint64,0,8);
 
 			uint64 count = result->getRowCount();
+			mIlc->mLoadCounter += static_cast<uint32>(count);
 
 			for(uint64 i = 0;i < count;i++)
 			{
-				result->GetNextRow(binding,&name);
-				name.toLower();
-				playerObject->mFriendsList.insert(std::make_pair(name.getCrc(),name.getAnsi()));
-			}
+				result->GetNextRow(binding,&id);
+				gTangibleFactory->requestObject(this,id,TanGroup_Item,0,asyncContainer->mClient);
 
+			}
 			mDatabase->DestroyDataBinding(binding);
 
-			// check online friends
-
-			// query ignorelist
-			QueryContainerBase* asContainer = new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(asyncContainer->mOfCallback,POFQuery_Ignores,asyncContainer->mClient);
-			asContainer->mObject = playerObject;
-
-			mDatabase->ExecuteSqlAsync(this,asContainer,"SELECT characters.firstname FROM chat_ignorelist "
-														"INNER JOIN characters ON (chat_ignorelist.ignore_id = characters.id) "
-														"WHERE (chat_ignorelist.character_id = %"PRIu64")",playerObject->getId());
+			// get the datapad here to avoid a race condition
+			// request datapad
+			mDatapadFactory->requestObject(this,playerObject->mId + 3,TanGroup_Datapad,TanType_CharacterDatapad,asyncContainer->mClient);
 		}
 		break;
 
-		case POFQuery_DenyService:
+		default:
 		{
-			PlayerObject* playerObject = dynamic_cast<PlayerObject*>(asyncContainer->mObject);
-			uint64 id;
-
-			DataBinding* binding = mDatabase->CreateDataBinding(1);
-			binding->addField(DFT_uint64,0,8);
+			break;
+		}
+	}
 
-			uint64 count = result->getRowCount();
+	mQueryContainerPool.free(asyncContainer);
+}
 
-			for(uint64 i = 0;i < count;i++)
-			{
-				result->GetNextRow(binding,&id);
-				playerObject->mDenyAudienceList.push_back(id);
-			}
+//=============================================================================
 
-			mDatabase->DestroyDataBinding(binding);
+void PlayerObjectFactory::_loadSkills(PlayerObject* playerObject,DatabaseResult* result)
+{
+	uint32 skillId;
 
+	DataBinding* binding = mDatabase->CreateDataBinding(1);
+	binding->addField(DFT_uint32,0,4);
 
-			// query ignorelist
-			QueryContainerBase* asContainer = new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(asyncContainer->mOfCallback,POFQuery_HoloEmotes,asyncContainer->mClient);
-			asContainer->mObject = playerObject;
+	uint64 count = result->getRowCount();
 
-			mDatabase->ExecuteSqlAsync(this,asContainer,"SELECT  emote_id, charges FROM character_holoemotes WHERE character_id = %I64u",playerObject->getId());
-		}
-		break;
+	for(uint64 i = 0;i < count;i++)
+	{
+		result->GetNextRow(binding,&skillId);
+		playerObject->mSkills.push_back(gSkillManager->getSkillById(skillId));
+	}
 
-		case POFQuery_HoloEmotes:
-		{
-			PlayerObject*	playerObject = dynamic_cast<PlayerObject*>(asyncContainer->mObject);
+	mDatabase->DestroyDataBinding(binding);
 
+	playerObject->prepareSkillMods();
+	playerObject->prepareSkillCommands();
+	playerObject->prepareSchematicIds();
 
-			DataBinding* binding = mDatabase->CreateDataBinding(2);
-			binding->addField(DFT_uint32,offsetof(PlayerObject,mHoloEmote),4,0);
-			binding->addField(DFT_int32,offsetof(PlayerObject,mHoloCharge),4,1);
+	playerObject->mSkillCmdUpdateCounter = playerObject->getSkillCommands()->size();
+	playerObject->mSkillModUpdateCounter = playerObject->getSkillMods()->size();
+}
 
-			uint64 count = result->getRowCount();
+//=============================================================================
 
-			if(count ==1)
-			{
-				result->GetNextRow(binding,playerObject);
-			}
+void PlayerObjectFactory::_loadBadges(PlayerObject* playerObject,DatabaseResult* result)
+{
+	uint32 badgeId;
 
-			mDatabase->DestroyDataBinding(binding);
-		}
-		break;
+	DataBinding* binding = mDatabase->CreateDataBinding(1);
+	binding->addField(DFT_uint32,0,4);
 
-		case POFQuery_Ignores:
-		{
-			PlayerObject* playerObject = dynamic_cast<PlayerObject*>(asyncContainer->mObject);
-			string name;
+	uint64 count = result->getRowCount();
 
-			DataBinding* binding = mDatabase->CreateDataBinding(1);
-			binding->addField(DFT_bstring,0,64);
+	for(uint64 i = 0;i < count;i++)
+	{
+		result->GetNextRow(binding,&badgeId);
+		playerObject->mBadgeList.push_back(badgeId);
+	}
 
-			uint64 count = result->getRowCount();
+	mDatabase->DestroyDataBinding(binding);
+}
 
-			for(uint64 i = 0;i < count;i++)
-			{
-				result->GetNextRow(binding,&name);
-				name.toLower();
-				playerObject->mIgnoreList.insert(std::make_pair(name.getCrc(),name.getAnsi()));
-			}
+//=============================================================================
 
-			mDatabase->DestroyDataBinding(binding);
+void PlayerObjectFactory::_loadFactions(PlayerObject* playerObject,DatabaseResult* result)
+{
+	XpContainer factionCont;
 
-			QueryContainerBase* asContainer = new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(asyncContainer->mOfCallback,POFQuery_XP,asyncContainer->mClient);
-			asContainer->mObject = playerObject;
+	DataBinding* binding = mDatabase->CreateDataBinding(2);
+	binding->addField(DFT_uint32,offsetof(XpContainer,mId),4,0);
+	binding->addField(DFT_int32,offsetof(XpContainer,mValue),4,1);
 
-			mDatabase->ExecuteSqlAsync(this,asContainer,"SELECT xp_id,value FROM character_xp WHERE character_id=%"PRIu64"",playerObject->getId());
+	uint64 count = result->getRowCount();
 
-			QueryContainerBase* outcastContainer = new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(asyncContainer->mOfCallback,POFQuery_DenyService,asyncContainer->mClient);
-			outcastContainer->mObject = playerObject;
+	for(uint64 i = 0;i < count;i++)
+	{
+		result->GetNextRow(binding,&factionCont);
+		playerObject->mFactionList.push_back(std::make_pair(factionCont.mId,factionCont.mValue));
+	}
 
-			mDatabase->ExecuteSqlAsync(this,outcastContainer,"SELECT outcast_id FROM entertainer_deny_service WHERE entertainer_id=%"PRIu64"",playerObject->getId());
+	mDatabase->DestroyDataBinding(binding);
+}
 
-			QueryContainerBase* cloneDestIdContainer = new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(asyncContainer->mOfCallback,POFQuery_PreDefCloningFacility,asyncContainer->mClient);
-			cloneDestIdContainer->mObject = playerObject;
+//=============================================================================
+//
+// friends and ignores, lowercase names keyed by their crc
+//
 
-			mDatabase->ExecuteSqlAsync(this,cloneDestIdContainer,"SELECT spawn_facility_id, x, y, z, planet_id FROM character_clone WHERE character_id=%"PRIu64"",playerObject->getId());
+void PlayerObjectFactory::_loadNameList(DatabaseResult* result,std::map<uint32,BString>* nameList)
+{
+	string name;
 
-			QueryContainerBase* LotsContainer = new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(asyncContainer->mOfCallback,POFQuery_Lots,asyncContainer->mClient);
-			LotsContainer->mObject = playerObject;
+	DataBinding* binding = mDatabase->CreateDataBinding(1);
+	binding->addField(DFT_bstring,0,64);
 
-			mDatabase->ExecuteSqlAsync(this,LotsContainer,"SELECT sf_getLotCount(%I64u)",playerObject->getId());
-		}
-		break;
+	uint64 count = result->getRowCount();
 
-		case POFQuery_XP:
-		{
-			PlayerObject*	playerObject = dynamic_cast<PlayerObject*>(asyncContainer->mObject);
-			XpContainer		xpCont;
+	for(uint64 i = 0;i < count;i++)
+	{
+		result->GetNextRow(binding,&name);
+		name.toLower();
+		nameList->insert(std::make_pair(name.getCrc(),name.getAnsi()));
+	}
 
-			DataBinding* binding = mDatabase->CreateDataBinding(2);
-			binding->addField(DFT_uint32,offsetof(XpContainer,mId),4,0);
-			binding->addField(DFT_int32,offsetof(XpContainer,mValue),4,1);
+	mDatabase->DestroyDataBinding(binding);
+}
 
-			uint64 count = result->getRowCount();
+//=============================================================================
 
-			for(uint64 i = 0;i < count;i++)
-			{
-				result->GetNextRow(binding,&xpCont);
-				playerObject->mXpList.push_back(std::make_pair(xpCont.mId,xpCont.mValue));
-			}
-			// Initiate all XP caps and optionally any missing skills.
-			// Skills that require Jedi or JTL will not be included if player do not have the prerequisites.
-			gSkillManager->initExperience(playerObject);
+void PlayerObjectFactory::_loadDenyService(PlayerObject* playerObject,DatabaseResult* result)
+{
+	uint64 id;
 
-			playerObject->mXpUpdateCounter = static_cast<uint32>(count);
+	DataBinding* binding = mDatabase->CreateDataBinding(1);
+	binding->addField(DFT_uint64,0,8);
 
-			mDatabase->DestroyDataBinding(binding);
+	uint64 count = result->getRowCount();
 
-			// store us for later lookup
-			InLoadingContainer* ilc = new(mILCPool.ordered_malloc()) InLoadingContainer(playerObject,asyncContainer->mOfCallback,asyncContainer->mClient,2);
-			ilc->mLoadCounter = 2;
+	for(uint64 i = 0;i < count;i++)
+	{
+		result->GetNextRow(binding,&id);
+		playerObject->mDenyAudienceList.push_back(id);
+	}
 
-			mObjectLoadMap.insert(std::make_pair(playerObject->getId(),ilc));
+	mDatabase->DestroyDataBinding(binding);
+}
 
-			// request inventory
-			mInventoryFactory->requestObject(this,playerObject->mId + 1,TanGroup_Inventory,TanType_CharInventory,asyncContainer->mClient);
+//=============================================================================
 
-		}
-		break;
+void PlayerObjectFactory::_loadHoloEmotes(PlayerObject* playerObject,DatabaseResult* result)
+{
+	DataBinding* binding = mDatabase->CreateDataBinding(2);
+	binding->addField(DFT_uint32,offsetof(PlayerObject,mHoloEmote),4,0);
+	binding->addField(DFT_int32,offsetof(PlayerObject,mHoloCharge),4,1);
 
-		case POFQuery_EquippedItems:
-		{
-			PlayerObject* playerObject = dynamic_cast<PlayerObject*>(asyncContainer->mObject);
+	uint64 count = result->getRowCount();
 
-			InLoadingContainer*	mIlc = _getObject(playerObject->getId());
+	if(count ==1)
+	{
+		result->GetNextRow(binding,playerObject);
+	}
 
-			uint64 id;
-			DataBinding* binding = mDatabase->CreateDataBinding(1);
-			binding->addField(DFT_uint64,0,8);
+	mDatabase->DestroyDataBinding(binding);
+}
 
-			uint64 count = result->getRowCount();
-			mIlc->mLoadCounter += static_cast<uint32>(count);
+//=============================================================================
+//
+// the id of the pre defined cloning facility, if any
+//
 
-			for(uint64 i = 0;i < count;i++)
-			{
-				result->GetNextRow(binding,&id);
-				gTangibleFactory->requestObject(this,id,TanGroup_Item,0,asyncContainer->mClient);
+void PlayerObjectFactory::_loadCloningFacility(PlayerObject* playerObject,DatabaseResult* result)
+{
+	DataBinding* binding = mDatabase->CreateDataBinding(5);
+	binding->addField(DFT_uint64,offsetof(PlayerObject,mPreDesignatedCloningFacilityId),8,0);
+	binding->addField(DFT_float,offsetof(PlayerObject,mBindCoords.x),4,1);
+	binding->addField(DFT_float,offsetof(PlayerObject,mBindCoords.y),4,2);
+	binding->addField(DFT_float,offsetof(PlayerObject,mBindCoords.z),4,3);
+	binding->addField(DFT_uint8,offsetof(PlayerObject,mBindPlanet),1,4);
 
-			}
-			mDatabase->DestroyDataBinding(binding);
+	uint64 count = result->getRowCount();
 
-			// get the datapad here to avoid a race condition
-			// request datapad
-			mDatapadFactory->requestObject(this,playerObject->mId + 3,TanGroup_Datapad,TanType_CharacterDatapad,asyncContainer->mClient);
-		}
-		break;
+	if (count == 1)
+	{
+		result->GetNextRow(binding,playerObject);
+	}
+	else
+	{
+		playerObject->mPreDesignatedCloningFacilityId = 0;
+	}
 
-		// Get the id of the pre defined cloning facility, if any.
-		case POFQuery_PreDefCloningFacility:
-		{
-			PlayerObject* playerObject = dynamic_cast<PlayerObject*>(asyncContainer->mObject);
+	mDatabase->DestroyDataBinding(binding);
+}
 
-			DataBinding* binding = mDatabase->CreateDataBinding(5);
-			binding->addField(DFT_uint64,offsetof(PlayerObject,mPreDesignatedCloningFacilityId),8,0);
-			binding->addField(DFT_float,offsetof(PlayerObject,mBindCoords.x),4,1);
-			binding->addField(DFT_float,offsetof(PlayerObject,mBindCoords.y),4,2);
-			binding->addField(DFT_float,offsetof(PlayerObject,mBindCoords.z),4,3);
-			binding->addField(DFT_uint8,offsetof(PlayerObject,mBindPlanet),1,4);
+//=============================================================================
 
-			uint64 count = result->getRowCount();
+void PlayerObjectFactory::_loadLots(PlayerObject* playerObject,DatabaseResult* result)
+{
+	uint32 lotCount;
+	DataBinding* binding = mDatabase->CreateDataBinding(1);
+	binding->addField(DFT_uint32,0,4);
 
-			if (count == 1)
-			{
-				result->GetNextRow(binding,playerObject);
-			}
-			else
-			{
-				playerObject->mPreDesignatedCloningFacilityId = 0;
-			}
+	uint64 count = result->getRowCount();
+	if(!count)
+	{
+		gLogger->log(LogManager::DEBUG,"PlayerObjectFactory: sf_getLotCount did not return a value");
+		//now we have a problem ...
+		mDatabase->DestroyDataBinding(binding);
+		return;
+	}
 
-			mDatabase->DestroyDataBinding(binding);
-		}
-		break;
+	result->GetNextRow(binding,&lotCount);
+	uint32 maxLots = gWorldConfig->getConfiguration<uint32>("Player_Max_Lots",(uint32)10);
 
-		case POFQuery_Lots:
-		{
-			PlayerObject* playerObject = dynamic_cast<PlayerObject*>(asyncContainer->mObject);
+	maxLots -= static_cast<uint8>(lotCount);
+	playerObject->setLots((uint8)maxLots);
+	gLogger->log(LogManager::DEBUG,"PlayerObjectFactory: %I64u has %u lots remaining",playerObject->getId(),maxLots);
 
-			uint32 lotCount;
-			DataBinding* binding = mDatabase->CreateDataBinding(1);
-			binding->addField(DFT_uint32,0,4);
+	mDatabase->DestroyDataBinding(binding);
+}
 
-			uint64 count = result->getRowCount();
-			if(!count)
-			{
-				gLogger->log(LogManager::DEBUG,"PlayerObjectFactory: sf_getLotCount did not return a value");
-				//now we have a problem ...
-				mDatabase->DestroyDataBinding(binding);
-				break;
-			}
+//=============================================================================
+//
+// needs the skills, which come first
+//
 
-			result->GetNextRow(binding,&lotCount);
-			uint32 maxLots = gWorldConfig->getConfiguration<uint32>("Player_Max_Lots",(uint32)10);
+void PlayerObjectFactory::_loadXp(PlayerObject* playerObject,DatabaseResult* result)
+{
+	XpContainer xpCont;
 
-			maxLots -= static_cast<uint8>(lotCount);
-			playerObject->setLots((uint8)maxLots);
-			gLogger->log(LogManager::DEBUG,"PlayerObjectFactory: %I64u has %u lots remaining",playerObject->getId(),maxLots);
+	DataBinding* binding = mDatabase->CreateDataBinding(2);
+	binding->addField(DFT_uint32,offsetof(XpContainer,mId),4,0);
+	binding->addField(DFT_int32,offsetof(XpContainer,mValue),4,1);
 
-			mDatabase->DestroyDataBinding(binding);
-		}
-		break;
+	uint64 count = result->getRowCount();
 
-		default:
-		{
-			break;
-		}
+	for(uint64 i = 0;i < count;i++)
+	{
+		result->GetNextRow(binding,&xpCont);
+		playerObject->mXpList.push_back(std::make_pair(xpCont.mId,xpCont.mValue));
 	}
+	// Initiate all XP caps and optionally any missing skills.
+	// Skills that require Jedi or JTL will not be included if player do not have the prerequisites.
+	gSkillManager->initExperience(playerObject);
 
-	mQueryContainerPool.free(asyncContainer);
+	playerObject->mXpUpdateCounter = static_cast<uint32>(count);
+
+	mDatabase->DestroyDataBinding(binding);
 }
 
 //=============================================================================
@@ -447,8 +401,8 @@ void PlayerObjectFactory::requestObject(ObjectFactoryCallback* ofCallback,uint64
 {
 	QueryContainerBase* asyncContainer = new(mQueryContainerPool.ordered_malloc()) QueryContainerBase(ofCallback,POFQuery_MainPlayerData,client);
 
-	int8 sql[8152];
-	sprintf(sql,"SELECT characters.id,characters.parent_Id,characters.account_id,characters.oX,characters.oY,characters.oZ,characters.oW,"//7
+	int8 sql[8192];
+	int32 len = sprintf(sql,"SELECT characters.id,characters.parent_Id,characters.account_id,characters.oX,characters.oY,characters.oZ,characters.oW,"//7
 		"characters.x,characters.y,characters.z,character_appearance.base_model_string,"//11
 		"characters.firstname,characters.lastname,character_appearance.hair,character_appearance.hair1,character_appearance.hair2,race.name,"//17
 		"character_appearance.`00FF`,character_appearance.`01FF`,character_appearance.`02FF`,character_appearance.`03FF`,character_appearance.`04FF`,"	  //22
@@ -504,7 +458,27 @@ void PlayerObjectFactory::requestObject(ObjectFactoryCallback* ofCallback,uint64
 
 		" (characters.id = %"PRIu64");",id + 4,id);
 
-	mDatabase->ExecuteSqlAsync(this,asyncContainer,sql);
+	// everything else we need before the inventory, in the same round trip. during a login storm
+	// this saves a dozen jobs and callbacks per character. keep the order in sync with handleDatabaseJobComplete
+	sprintf(sql + len,
+		"SELECT skill_id FROM character_skills WHERE character_id=%"PRIu64";"
+		"SELECT badge_id FROM character_badges WHERE character_id=%"PRIu64";"
+		"SELECT faction_id,value FROM character_faction WHERE character_id=%"PRIu64" ORDER BY faction_id;"
+		"SELECT characters.firstname FROM chat_friendlist"
+		" INNER JOIN characters ON (chat_friendlist.friend_id = characters.id)"
+		" WHERE (chat_friendlist.character_id = %"PRIu64");"
+		"SELECT characters.firstname FROM chat_ignorelist"
+		" INNER JOIN characters ON (chat_ignorelist.ignore_id = characters.id)"
+		" WHERE (chat_ignorelist.character_id = %"PRIu64");"
+		"SELECT outcast_id FROM entertainer_deny_service WHERE entertainer_id=%"PRIu64";"
+		"SELECT emote_id, charges FROM character_holoemotes WHERE character_id=%"PRIu64";"
+		"SELECT spawn_facility_id, x, y, z, planet_id FROM character_clone WHERE character_id=%"PRIu64";"
+		"SELECT sf_getLotCount(%"PRIu64");"
+		"SELECT xp_id,value FROM character_xp WHERE character_id=%"PRIu64";",
+		id,id,id,id,id,id,id,id,id,id);
+
+	// a multi result, the worker keeps its connection for us until we are done reading
+	mDatabase->ExecuteProcedureAsync(this,asyncContainer,"%s",sql);
 }
 
 //=============================================================================
@@ -533,7 +507,7 @@ PlayerObject* PlayerObjectFactory::_createPlayer(DatabaseResult* result)
 	//male or female ?
 	BStringVector				dataElements;
 	playerObject->mModel.split(dataElements,'_');
-	playerObject->setGender(dataElements[1].getCrc() == BString("female.iff").getCrc());
+	playerObject->setGender(dataElements[1].getCrc() == Anh_Utils::crc("female.iff"));
 
 	// player object
 	int8 tmpModel[128];
@@ -31,6 +31,10 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "FactoryBase.h"
 #include "ObjectFactoryCallback.h"
 
+#include "Utils/bstring.h"
+
+#include <map>
+
 #define 	gPlayerObjectFactory	PlayerObjectFactory::getSingletonPtr()
 
 //=============================================================================
@@ -48,19 +52,9 @@ class XPContainer;
 enum POFQuery
 {
 	POFQuery_MainPlayerData			= 1,
-	POFQuery_Skills					= 2,
-	POFQuery_XP						= 3,
 	POFQuery_Inventory				= 4,
 	POFQuery_Datapad				= 5,
-	POFQuery_Badges					= 6,
-	POFQuery_Factions				= 7,
-	POFQuery_Friends				= 8,
-	POFQuery_Ignores				= 9,
-	POFQuery_DenyService			= 10,
-	POFQuery_HoloEmotes				= 11,
-	POFQuery_EquippedItems			= 12,
-	POFQuery_PreDefCloningFacility	= 13,
-	POFQuery_Lots					= 14
+	POFQuery_EquippedItems			= 12
 };
 
 //=============================================================================
@@ -89,6 +83,17 @@ class PlayerObjectFactory : public FactoryBase, public ObjectFactoryCallback
 
 		PlayerObject*	_createPlayer(DatabaseResult* result);
 
+		// one per result set of the batched character query
+		void			_loadSkills(PlayerObject* playerObject,DatabaseResult* result);
+		void			_loadBadges(PlayerObject* playerObject,DatabaseResult* result);
+		void			_loadFactions(PlayerObject* playerObject,DatabaseResult* result);
+		void			_loadNameList(DatabaseResult* result,std::map<uint32,BString>* nameList);
+		void			_loadDenyService(PlayerObject* playerObject,DatabaseResult* result);
+		void			_loadHoloEmotes(PlayerObject* playerObject,DatabaseResult* result);
+		void			_loadCloningFacility(PlayerObject* playerObject,DatabaseResult* result);
+		void			_loadLots(PlayerObject* playerObject,DatabaseResult* result);
+		void			_loadXp(PlayerObject* playerObject,DatabaseResult* result);
+
 		static PlayerObjectFactory*		mSingleton;
 		static bool						mInsFlag;
 
@@ -27,6 +27,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 */
 
 #include "PlayerStructure.h"
+#include "PersistenceManager.h"
 #include "PlayerObject.h"
 #include "Inventory.h"
 #include "CellObject.h"
@@ -244,7 +245,7 @@ void PlayerStructure::handleUIEvent(string strCharacterCash, string strHarvester
 				gStructureManager->deductPower(player,harvesterPowerDelta);
 				this->setCurrentPower(getCurrentPower()+harvesterPowerDelta);
 
-				gWorldManager->getDatabase()->ExecuteSqlAsync(0,0,"UPDATE structure_attributes SET value='%u' WHERE structure_id=%"PRIu64" AND attribute_id=384",getCurrentPower(),this->getId());
+				gPersistenceManager->setAttribute(PersistTable_StructureAttributes,this->getId(),384,boost::lexical_cast<std::string>(getCurrentPower()));
 		}
 		break;
 
@@ -338,7 +339,7 @@ void PlayerStructure::handleUIEvent(string strCharacterCash, string strHarvester
 
 			}
 
-			gWorldManager->getDatabase()->ExecuteSqlAsync(0,0,"UPDATE structure_attributes SET value='%u' WHERE structure_id=%"PRIu64" AND attribute_id=382",maintenance,this->getId());
+			gPersistenceManager->setAttribute(PersistTable_StructureAttributes,this->getId(),382,boost::lexical_cast<std::string>(maintenance));
 			
 			this->setCurrentMaintenance(maintenance);
 
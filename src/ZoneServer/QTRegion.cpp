@@ -26,7 +26,8 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 */
 
 #include "QTRegion.h"
-#include "QuadTree.h"
+#include "ObjectGrid.h"
+#include "ConfigManager/ConfigManager.h"
 
 
 //=============================================================================
@@ -55,12 +56,13 @@ QTRegion::~QTRegion()
 
 //=============================================================================
 //
-// setup the qtree
+// setup the grid for the moving objects, cells default to the viewing range,
+// so a range query touches at most 3x3 cells
 //
 
 void QTRegion::initTree()
 {
-	mTree = new QuadTree(mPosition.x,mPosition.z,mWidth,mHeight,mQTDepth);
+	mTree = new ObjectGrid(mPosition.x,mPosition.z,mWidth,mHeight,gConfig->read<float>("ZoneGridCellSize",128.0f));
 }
 
 //==============================================================================
@@ -30,7 +30,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "RegionObject.h"
 
-class QuadTree;
+class ObjectGrid;
 
 //=============================================================================
 
@@ -46,11 +46,11 @@ class QTRegion : public RegionObject
 		void		initTree();
 		bool		checkPlayerPosition(float x, float y);
 
-		QuadTree*	mTree;
+		ObjectGrid*	mTree;
 
 	private:
 
-		uint8		mQTDepth;
+		uint8		mQTDepth;	// loaded with the region, the grid is sized by ZoneGridCellSize instead
 		
 };
 
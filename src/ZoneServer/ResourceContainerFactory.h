@@ -62,6 +62,9 @@ class ResourceContainerFactory : public FactoryBase
 		void			handleDatabaseJobComplete(void* ref,DatabaseResult* result);
 		void			requestObject(ObjectFactoryCallback* ofCallback,uint64 id,uint16 subGroup,uint16 subType,DispatchClient* client);
 
+		// a container from the next row of a resource_containers.* result, its attributes are up to the caller
+		ResourceContainer*	createResourceContainer(DatabaseResult* result){ return _createResourceContainer(result); }
+
 	private:
 
 		ResourceContainerFactory(Database* database);
@@ -512,6 +512,8 @@ void SchematicManager::handleDatabaseJobComplete(void* ref,DatabaseResult* resul
 				craftAttribute = new CraftAttribute();
 
 				result->GetNextRow(binding,craftAttribute);
+				craftAttribute->mAttributeKeyCrc = craftAttribute->mAttributeKey.getCrc();
+
 				if((schematic == NULL) || (schematic->getId() != craftAttribute->getSchemWeightBatch()))
 				{
 					schematic = getSchematicByWeightID(craftAttribute->getSchemWeightBatch());
@@ -30,6 +30,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "TravelMapHandler.h"
 #include "WorldManager.h"
 #include "MessageLib/MessageLib.h"
+#include "Utils/crc.h"
 
 
 //=============================================================================
@@ -79,7 +80,7 @@ bool Shuttle::availableInPort(void)
 		port = collector->getPortDescriptor();
 	}
 
-	return ((mShuttleState == ShuttleState_InPort) || (port.getCrc() == BString("Theed Spaceport").getCrc()));
+	return ((mShuttleState == ShuttleState_InPort) || (port.getCrc() == Anh_Utils::crc("Theed Spaceport")));
 }
 
 //=============================================================================
@@ -28,6 +28,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "SurveyTool.h"
 #include "ObjectControllerOpcodes.h"
 #include "ObjectFactory.h"
+#include "PersistenceManager.h"
 #include "PlayerObject.h"
 #include "ResourceCategory.h"
 #include "ResourceManager.h"
@@ -201,8 +202,8 @@ void SurveyTool::handleUIEvent(uint32 action,int32 element,string inputStr,UIWin
 		setInternalAttribute("survey_range",boost::lexical_cast<std::string>(range));
 		setInternalAttribute("survey_points",boost::lexical_cast<std::string>(points));
 
-		gWorldManager->getDatabase()->ExecuteSqlAsync(NULL,NULL,"UPDATE item_attributes SET value=%u WHERE item_id=%"PRIu64" AND attribute_id=6",range,mId);
-		gWorldManager->getDatabase()->ExecuteSqlAsync(NULL,NULL,"UPDATE item_attributes SET value=%u WHERE item_id=%"PRIu64" AND attribute_id=7",points,mId);
+		gPersistenceManager->setAttribute(PersistTable_ItemAttributes,mId,6,boost::lexical_cast<std::string>(range));
+		gPersistenceManager->setAttribute(PersistTable_ItemAttributes,mId,7,boost::lexical_cast<std::string>(points));
 
 
 	}
@@ -83,6 +83,8 @@ void TangibleObject::initTimer(int32 count,int32 interval,uint64 startTime)
 	mTimer				= count;
 	mTimerInterval		= interval;
 	mLastTimerUpdate	= startTime;
+
+	invalidateBaseline(BaselineCache_TANO_3);
 }
 
 //=============================================================================
@@ -93,6 +95,8 @@ bool TangibleObject::updateTimer(uint64 callTime)
 	{
 		mTimer -= (int32)(mTimerInterval / 1000);
 
+		invalidateBaseline(BaselineCache_TANO_3);
+
 		if(mTimer < 0)
 			mTimer = 0;
 
@@ -189,6 +193,8 @@ void TangibleObject::buildTanoCustomization(uint8 len)
 void TangibleObject::setCustomNameIncDB(const int8* name)
 {
 	mCustomName = name; 
+	invalidateBaseline(BaselineCache_TANO_3);
+
 	int8 sql[1024],restStr[128],*sqlPointer;
 	sprintf(sql,"UPDATE items SET customName='");
 		sqlPointer = sql + strlen(sql);
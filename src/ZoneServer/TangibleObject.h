@@ -50,9 +50,9 @@ class TangibleObject :	public ObjectContainer
 
 		virtual void		upDateFactoryVolume(string amount){;}
 		string				getName() const { return mName; }
-		void				setName(const int8* name){ mName = name; }
+		void				setName(const int8* name){ mName = name; invalidateBaselines(); }
 		string				getNameFile() const { return mNameFile; }
-		void				setNameFile(const int8* file){ mNameFile = file; }
+		void				setNameFile(const int8* file){ mNameFile = file; invalidateBaselines(); }
 		string				getDetailFile(){ return mDetailFile; }
 		void				setDetailFile(const int8* file){ mDetailFile = file; }
 		string				getColorStr(){ return mColorStr; }
@@ -63,19 +63,19 @@ class TangibleObject :	public ObjectContainer
 		virtual void		setParentIdIncDB(uint64 parentId);
 
 		string				getCustomizationStr() const { return mCustomizationStr; }
-		void				setCustomizationStr(const uint8* custStr){ mCustomizationStr = (int8*)custStr; }
+		void				setCustomizationStr(const uint8* custStr){ mCustomizationStr = (int8*)custStr; invalidateBaselines(); }
 		void				setCustomization(uint8 index, uint16 val, uint8 length = 73){ mCustomization[index] = val;buildTanoCustomization(length); }
 		uint16*				getCustomization(){ return &mCustomization[0]; }
 		uint16				getCustomization(uint8 index){ return mCustomization[index]; }
 		void				buildTanoCustomization(uint8 len);
 
 		string				getUnknownStr1() const { return mUnknownStr1; }
-		void				setUnknownStr1(const int8* unknownStr){ mUnknownStr1 = unknownStr; }
+		void				setUnknownStr1(const int8* unknownStr){ mUnknownStr1 = unknownStr; invalidateBaselines(); }
 		string				getUnknownStr2() const { return mUnknownStr2; }
-		void				setUnknownStr2(const int8* unknownStr){ mUnknownStr2 = unknownStr; }
+		void				setUnknownStr2(const int8* unknownStr){ mUnknownStr2 = unknownStr; invalidateBaselines(); }
 		
 		string				getCustomName() const { return mCustomName; }
-		void				setCustomName(const int8* name){ mCustomName = name; }
+		void				setCustomName(const int8* name){ mCustomName = name; invalidateBaselines(); }
 		void				setCustomNameIncDB(const int8* name);
 
 		TangibleGroup		getTangibleGroup() const{ return mTanGroup; }
@@ -84,9 +84,9 @@ class TangibleObject :	public ObjectContainer
 		void				setTangibleType(TangibleType type){ mTanType = type; }
 
 		uint32				getMaxCondition() const { return mMaxCondition; }
-		void				setMaxCondition(uint32 maxCondition){ mMaxCondition = maxCondition; }
+		void				setMaxCondition(uint32 maxCondition){ mMaxCondition = maxCondition; invalidateBaselines(); }
 		uint32				getDamage() const { return mDamage; }
-		void				setDamage(uint32 damage){ mDamage = damage; }
+		void				setDamage(uint32 damage){ mDamage = damage; invalidateBaselines(); }
 
 		virtual uint32		getCategoryBazaar(){ return 0; }
 		string				getBazaarTang(){ return getModelString(); }
@@ -97,10 +97,10 @@ class TangibleObject :	public ObjectContainer
 		void				initTimer(int32 count,int32 interval,uint64 startTime);
 		bool				updateTimer(uint64 callTime);
 		int32				getTimer() const { return mTimer; }
-		void				setTimer(int32 timer){ mTimer = timer; }
+		void				setTimer(int32 timer){ mTimer = timer; invalidateBaselines(); }
 
 		bool				getStatic()const { return mStatic; }
-		void				setStatic(bool isStatic){ mStatic = isStatic; }
+		void				setStatic(bool isStatic){ mStatic = isStatic; invalidateBaselines(); }
 	protected:
 
 		string				mCustomizationStr;
@@ -53,6 +53,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "Utils/utils.h"
 #include "Utils/rand.h"
+#include "Utils/crc.h"
 
 bool				TravelMapHandler::mInsFlag    = false;
 TravelMapHandler*	TravelMapHandler::mSingleton  = NULL;
@@ -633,7 +634,7 @@ void TravelMapHandler::useTicket(PlayerObject* playerObject, TravelTicket* ticke
 	TicketCollector* collector = dynamic_cast<TicketCollector*>(gWorldManager->getObjectById(shuttle->getCollectorId()));
 	string port = collector->getPortDescriptor();
 
-	if(port.getCrc() == BString("Theed Starport").getCrc())
+	if(port.getCrc() == Anh_Utils::crc("Theed Starport"))
 	{
 		shuttle->setShuttleState(ShuttleState_InPort);
 	}
@@ -45,6 +45,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "MissionManager.h"
 #include "NpcManager.h"
 #include "NPCObject.h"
+#include "PersistenceManager.h"
 #include "PlayerStructure.h"
 #include "ResourceCollectionManager.h"
 #include "ResourceManager.h"
@@ -61,7 +62,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Inventory.h"
 #include "MissionObject.h"
 #include "ObjectFactory.h"
-#include "QuadTree.h"
+#include "ObjectGrid.h"
 #include "Shuttle.h"
 #include "ForageManager.h"
 #include "FireworkManager.h"
@@ -70,6 +71,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "DatabaseManager/Database.h"
 #include "DatabaseManager/DataBinding.h"
 #include "DatabaseManager/DatabaseResult.h"
+#include "DatabaseManager/StatementParameters.h"
 #include "MessageLib/MessageLib.h"
 #include "ScriptEngine/ScriptEngine.h"
 #include "ScriptEngine/ScriptSupport.h"
@@ -118,6 +120,14 @@ WorldManager::WorldManager(uint32 zoneId,ZoneServer* zoneServer,Database* databa
 		mDebug = false;
 	}
 
+	// the player save runs for every player every few minutes, prepare it once
+	mSavePositionStatement = mDatabase->RegisterStatement("UPDATE characters SET parent_id=?,oX=?,oY=?,oZ=?,oW=?,x=?,y=?,z=?,planet_id=?,jedistate=? WHERE id=?");
+
+	mSaveAttributesStatement = mDatabase->RegisterStatement("UPDATE character_attributes SET health_current=?,action_current=?,mind_current=?"
+		",health_wounds=?,strength_wounds=?,constitution_wounds=?,action_wounds=?,quickness_wounds=?"
+		",stamina_wounds=?,mind_wounds=?,focus_wounds=?,willpower_wounds=?,battlefatigue=?,posture=?,moodId=?,title=?"
+		",character_flags=?,states=?,language=?,new_player_exemptions=? WHERE character_id=?");
+
 	// load planet names and terrain files so we can start heightmap loading
 	mDatabase->ExecuteSqlAsync(this,new(mWM_DB_AsyncPool.ordered_malloc()) WMAsyncContainer(WMQuery_PlanetNamesAndFiles),"SELECT * FROM planet ORDER BY planet_id;");
 	
@@ -659,10 +669,10 @@ bool WorldManager::_handleCraftToolTimers(uint64 callTime,void* ref)
 
 				it = mBusyCraftTools.erase(it);
 				tool->setAttribute("craft_tool_status","@crafting:tool_status_ready");
-				mDatabase->ExecuteSqlAsync(0,0,"UPDATE item_attributes SET value='@crafting:tool_status_ready' WHERE item_id=%"PRIu64" AND attribute_id=18",tool->getId());
+				gPersistenceManager->setAttribute(PersistTable_ItemAttributes,tool->getId(),AttrType_CraftToolStatus,"@crafting:tool_status_ready");
 
 				tool->setAttribute("craft_tool_time",boost::lexical_cast<std::string>(tool->getTimer()));
-				gWorldManager->getDatabase()->ExecuteSqlAsync(0,0,"UPDATE item_attributes SET value='%i' WHERE item_id=%"PRIu64" AND attribute_id=%u",tool->getId(),tool->getTimer(),AttrType_CraftToolTime);
+				gPersistenceManager->setAttribute(PersistTable_ItemAttributes,tool->getId(),AttrType_CraftToolTime,boost::lexical_cast<std::string>(tool->getTimer()));
 
 				continue;
 			}
@@ -671,7 +681,9 @@ bool WorldManager::_handleCraftToolTimers(uint64 callTime,void* ref)
 
 			tool->setAttribute("craft_tool_time",boost::lexical_cast<std::string>(tool->getTimer()));
 			//gLogger->log(LogManager::DEBUG,"timer : %i",tool->getTimer());
-			gWorldManager->getDatabase()->ExecuteSqlAsync(0,0,"UPDATE item_attributes SET value='%i' WHERE item_id=%"PRIu64" AND attribute_id=%u",tool->getId(),tool->getTimer(),AttrType_CraftToolTime);
+
+			// marked every second, written once per flush
+			gPersistenceManager->setAttribute(PersistTable_ItemAttributes,tool->getId(),AttrType_CraftToolTime,boost::lexical_cast<std::string>(tool->getTimer()));
 		}
 
 		++it;
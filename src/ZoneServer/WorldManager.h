@@ -241,6 +241,9 @@ class WorldManager : public ObjectFactoryCallback, public DatabaseCallback, publ
 		// saves a player synched to the database
 		void					savePlayerSync(uint32 accId,bool remove);
 
+		// first step of the async save, the callback continues with the attributes
+		void					savePlayerPositionAsync(PlayerObject* playerObject, DatabaseCallback* callback, void* ref);
+
 		// find a player, returns NULL if not found
 		PlayerObject*			getPlayerByAccId(uint32 accId);
 
@@ -488,6 +491,10 @@ class WorldManager : public ObjectFactoryCallback, public DatabaseCallback, publ
 		uint64						mTick;
 		uint32						mTotalObjectCount;
 		uint32						mZoneId;
+
+		// registered statements of the player save
+		uint32						mSavePositionStatement;
+		uint32						mSaveAttributesStatement;
 		
 		bool						mDebug;
 };
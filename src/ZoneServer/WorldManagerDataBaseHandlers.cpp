@@ -38,6 +38,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "DatabaseManager/Database.h"
 #include "DatabaseManager/DataBinding.h"
 #include "DatabaseManager/DatabaseResult.h"
+#include "DatabaseManager/StatementParameters.h"
 #include "ScriptEngine/ScriptEngine.h"
 #include "ScriptEngine/ScriptSupport.h"
 #include "Heightmap.h"
@@ -669,17 +670,31 @@ void WorldManager::handleDatabaseJobComplete(void* ref,DatabaseResult* result)
 					asyncContainer2->clContainer	= asyncContainer->clContainer;
 					asyncContainer2->mLogout		= asyncContainer->mLogout;
 
-					mDatabase->ExecuteSqlAsync(this,asyncContainer2,"UPDATE character_attributes SET health_current=%u,action_current=%u,mind_current=%u"
-						",health_wounds=%u,strength_wounds=%u,constitution_wounds=%u,action_wounds=%u,quickness_wounds=%u"
-						",stamina_wounds=%u,mind_wounds=%u,focus_wounds=%u,willpower_wounds=%u,battlefatigue=%u,posture=%u,moodId=%u,title=\'%s\'"
-						",character_flags=%u,states=%"PRIu64",language=%u,new_player_exemptions=%u WHERE character_id=%"PRIu64""
-						,ham->mHealth.getCurrentHitPoints() - ham->mHealth.getModifier(),
-						ham->mAction.getCurrentHitPoints() - ham->mAction.getModifier(),
-						ham->mMind.getCurrentHitPoints() - ham->mMind.getModifier()
-						,ham->mHealth.getWounds(),ham->mStrength.getWounds()
-						,ham->mConstitution.getWounds(),ham->mAction.getWounds(),ham->mQuickness.getWounds(),ham->mStamina.getWounds(),ham->mMind.getWounds()
-						,ham->mFocus.getWounds(),ham->mWillpower.getWounds(),ham->getBattleFatigue(),playerObject->getPosture(),playerObject->getMoodId(),playerObject->getTitle().getAnsi()
-						,playerObject->getPlayerFlags(),playerObject->getState(),playerObject->getLanguage(),playerObject->getNewPlayerExemptions(),playerObject->getId());
+					StatementParameters params;
+
+					params.addUint32(ham->mHealth.getCurrentHitPoints() - ham->mHealth.getModifier());
+					params.addUint32(ham->mAction.getCurrentHitPoints() - ham->mAction.getModifier());
+					params.addUint32(ham->mMind.getCurrentHitPoints() - ham->mMind.getModifier());
+					params.addUint32(ham->mHealth.getWounds());
+					params.addUint32(ham->mStrength.getWounds());
+					params.addUint32(ham->mConstitution.getWounds());
+					params.addUint32(ham->mAction.getWounds());
+					params.addUint32(ham->mQuickness.getWounds());
+					params.addUint32(ham->mStamina.getWounds());
+					params.addUint32(ham->mMind.getWounds());
+					params.addUint32(ham->mFocus.getWounds());
+					params.addUint32(ham->mWillpower.getWounds());
+					params.addUint32(ham->getBattleFatigue());
+					params.addUint32(playerObject->getPosture());
+					params.addUint32(playerObject->getMoodId());
+					params.addString(playerObject->getTitle().getAnsi());
+					params.addUint32(playerObject->getPlayerFlags());
+					params.addUint64(playerObject->getState());
+					params.addUint32(playerObject->getLanguage());
+					params.addUint32(playerObject->getNewPlayerExemptions());
+					params.addUint64(playerObject->getId());
+
+					mDatabase->ExecuteStatementAsyncOrdered(playerObject->getId(),this,asyncContainer2,mSaveAttributesStatement,&params);
 				}
 				break;
 
@@ -716,7 +731,7 @@ void WorldManager::handleDatabaseJobComplete(void* ref,DatabaseResult* result)
 						const glm::vec3& destination = asyncContainer->clContainer->destination;
 
 						//in this case we retain the asynccontainer and let it be destroyed by the clientlogin handler
-						mDatabase->ExecuteSqlAsync(asyncContainer->clContainer->dbCallback,asyncContainer->clContainer,"UPDATE characters SET parent_id=0,x='%f', y='%f', z='%f', planet_id='%u' WHERE id='%I64u';", destination.x, destination.y, destination.z, asyncContainer->clContainer->planet, asyncContainer->clContainer->player->getId());
+						mDatabase->ExecuteSqlAsyncOrdered(asyncContainer->clContainer->player->getId(),asyncContainer->clContainer->dbCallback,asyncContainer->clContainer,"UPDATE characters SET parent_id=0,x='%f', y='%f', z='%f', planet_id='%u' WHERE id='%I64u';", destination.x, destination.y, destination.z, asyncContainer->clContainer->planet, asyncContainer->clContainer->player->getId());
 					}
 				}
 				break;
@@ -65,7 +65,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Inventory.h"
 #include "MissionObject.h"
 #include "ObjectFactory.h"
-#include "QuadTree.h"
+#include "ObjectGrid.h"
 #include "Shuttle.h"
 #include "TicketCollector.h"
 #include "ConfigManager/ConfigManager.h"
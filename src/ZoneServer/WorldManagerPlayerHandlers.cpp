@@ -26,6 +26,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 */
 
 #include "MountObject.h"
+#include "PersistenceManager.h"
 #include "PlayerObject.h"
 #include "WorldManager.h"
 #include "AdminManager.h"
@@ -64,13 +65,14 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "Inventory.h"
 #include "MissionObject.h"
 #include "ObjectFactory.h"
-#include "QuadTree.h"
+#include "ObjectGrid.h"
 #include "Shuttle.h"
 #include "TicketCollector.h"
 #include "ConfigManager/ConfigManager.h"
 #include "DatabaseManager/Database.h"
 #include "DatabaseManager/DataBinding.h"
 #include "DatabaseManager/DatabaseResult.h"
+#include "DatabaseManager/StatementParameters.h"
 #include "MessageLib/MessageLib.h"
 #include "ScriptEngine/ScriptEngine.h"
 #include "ScriptEngine/ScriptSupport.h"
@@ -141,6 +143,9 @@ void WorldManager::savePlayer(uint32 accId,bool remove, WMLogOut mLogout, Charac
 {
 	PlayerObject* playerObject			= getPlayerByAccId(accId);
 
+	// the players items may have dirty attributes, get them written before the character is gone
+	gPersistenceManager->flush();
+
 	// WMQuery_SavePlayer_Position is the query handler called by the buffmanager when all the buffcallbacks are finished
 	// we prepare the asynccontainer here already
 	WMAsyncContainer* asyncContainer	= new(mWM_DB_AsyncPool.ordered_malloc()) WMAsyncContainer(WMQuery_SavePlayer_Position);
@@ -163,15 +168,36 @@ void WorldManager::savePlayer(uint32 accId,bool remove, WMLogOut mLogout, Charac
 	{
 
 		// position save will be called by the buff callback if there is any buff
-		mDatabase->ExecuteSqlAsync(this,asyncContainer,"UPDATE characters SET parent_id=%"PRIu64",oX=%f,oY=%f,oZ=%f,oW=%f,x=%f,y=%f,z=%f,planet_id=%u,jedistate=%u WHERE id=%"PRIu64"",playerObject->getParentId()
-							,playerObject->mDirection.x,playerObject->mDirection.y,playerObject->mDirection.z,playerObject->mDirection.w
-							,playerObject->mPosition.x,playerObject->mPosition.y,playerObject->mPosition.z
-							,mZoneId,playerObject->getJediState(),playerObject->getId());
+		savePlayerPositionAsync(playerObject,this,asyncContainer);
 	}
 
 
 }
 
+//======================================================================================================================
+//
+// keyed by the character, so a later save of the same character cant overtake this one
+//
+
+void WorldManager::savePlayerPositionAsync(PlayerObject* playerObject, DatabaseCallback* callback, void* ref)
+{
+	StatementParameters params;
+
+	params.addUint64(playerObject->getParentId());
+	params.addFloat(playerObject->mDirection.x);
+	params.addFloat(playerObject->mDirection.y);
+	params.addFloat(playerObject->mDirection.z);
+	params.addFloat(playerObject->mDirection.w);
+	params.addFloat(playerObject->mPosition.x);
+	params.addFloat(playerObject->mPosition.y);
+	params.addFloat(playerObject->mPosition.z);
+	params.addUint32(mZoneId);
+	params.addUint32(playerObject->getJediState());
+	params.addUint64(playerObject->getId());
+
+	mDatabase->ExecuteStatementAsyncOrdered(playerObject->getId(),callback,ref,mSavePositionStatement,&params);
+}
+
 //======================================================================================================================
 
 void WorldManager::savePlayerSync(uint32 accId,bool remove)
@@ -179,6 +205,8 @@ void WorldManager::savePlayerSync(uint32 accId,bool remove)
 	PlayerObject* playerObject = getPlayerByAccId(accId);
 	Ham* ham = playerObject->getHam();
 
+	gPersistenceManager->flush(true);
+
 	mDatabase->DestroyResult(mDatabase->ExecuteSynchSql("UPDATE characters SET parent_id=%"PRIu64",oX=%f,oY=%f,oZ=%f,oW=%f,x=%f,y=%f,z=%f,planet_id=%u WHERE id=%"PRIu64"",playerObject->getParentId()
 						,playerObject->mDirection.x,playerObject->mDirection.y,playerObject->mDirection.z,playerObject->mDirection.w
 						,playerObject->mPosition.x,playerObject->mPosition.y,playerObject->mPosition.z
@@ -43,6 +43,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 #include "ObjectControllerCommandMap.h"
 #include "ObjectControllerDispatch.h"
 #include "ObjectFactory.h"
+#include "PersistenceManager.h"
 #include "ScoutManager.h"
 #include "SkillManager.h"
 #include "StructureManager.h"
@@ -153,6 +154,9 @@ mDatabase(0)
 	//structuremanager callback functions 
 	StructureManagerCommandMapClass::Init();
 
+	// before anything gets loaded, objects mark their changes dirty right away
+	PersistenceManager::Init(mDatabase);
+
 	WorldManager::Init(zoneId,this,mDatabase);
 
 	// Init the non persistent factories. For now we take them one-by-one here, until we have a collection of them.
@@ -208,6 +212,13 @@ ZoneServer::~ZoneServer(void)
 	AdminManager::deleteManager();
 
 	gWorldManager->Shutdown();	// Should be closed before script engine and script support, due to halting of scripts.
+
+	// write out whatever is still dirty, queued async jobs dont survive the database shutting down.
+	// the flush waits for the queued batches, their completions go away with the database, so we delete
+	// the persistence manager after it
+	gPersistenceManager->flush(true);
+	gPersistenceManager->logStatistics();
+
 	gScriptEngine->shutdown();
 	ScriptSupport::Instance()->destroyInstance();
 
@@ -229,6 +240,7 @@ ZoneServer::~ZoneServer(void)
 	delete mNetworkManager;
 
 	delete mDatabaseManager;
+	delete gPersistenceManager;
 
 	delete gSkillManager->getSingletonPtr();
 	delete gMedicManager->getSingletonPtr();
@@ -264,6 +276,7 @@ void ZoneServer::Process(void)
 	// Process our game modules
 	mObjectControllerDispatch->Process();
 	gWorldManager->Process();
+	gPersistenceManager->Process();
 	gScriptEngine->process();
 	mMessageDispatch->Process();
 
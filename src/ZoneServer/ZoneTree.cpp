@@ -30,6 +30,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 #include "ObjectContainer.h"
 #include "CellObject.h"
+#include "RegionObject.h"
 #include "WorldManager.h"
 
 
@@ -537,6 +538,176 @@ void ZoneTree::getObjectsInRange(const Object* const object,ObjectSet* resultSet
 	}
 }
 
+//=============================================================================
+//
+// same queries as above, but results are appended to a flat vector the caller keeps around,
+// ids are resolved and filtered while the tree is traversed and everything is checked against the query circle
+// the vector may contain duplicates when several queries are collected into it
+//
+
+void ZoneTree::getObjectsInRange(const Object* const object,ObjectVector* results,uint32 objTypes,float range, bool cellContent)
+{
+	double plow[2],phigh[2];
+
+	// we in world space, outside -> inside , outside -> outside checking
+	if(!object->getParentId())
+	{
+		plow[0] = object->mPosition.x - range;
+		plow[1] = object->mPosition.z - range;
+		phigh[0] = object->mPosition.x + range;
+		phigh[1] = object->mPosition.z + range;
+
+		Region r = Region(plow,phigh,2);
+		ObjectRangeVisitor vis(object,results,objTypes,object->mPosition.x,object->mPosition.z,range,true,cellContent);
+
+		mTree->intersectsWithQuery(r,vis);
+
+		return;
+	}
+
+	// we inside a building, inside -> outside, inside -> inside checking
+	// need to query based on buildings world position
+	CellObject* cell = dynamic_cast<CellObject*>(gWorldManager->getObjectById(object->getParentId()));
+
+	if(!cell)
+	{
+		gLogger->log(LogManager::WARNING,"SI could not find cell %"PRIu64"",object->getParentId());
+		return;
+	}
+
+	BuildingObject* buildingObject = dynamic_cast<BuildingObject*>(gWorldManager->getObjectById(cell->getParentId()));
+
+	if(!buildingObject)
+	{
+		gLogger->log(LogManager::WARNING,"SI could not find building %"PRIu64"",cell->getParentId());
+		return;
+	}
+
+	// we always want to see at least 32m outside the building
+	float queryRange = std::max(buildingObject->getWidth(),buildingObject->getHeight()) + 32;
+
+	if(range > queryRange)
+	{
+		queryRange = range;
+	}
+
+	plow[0] = buildingObject->mPosition.x - queryRange;
+	plow[1] = buildingObject->mPosition.z - queryRange;
+	phigh[0] = buildingObject->mPosition.x + queryRange;
+	phigh[1] = buildingObject->mPosition.z + queryRange;
+
+	Region r = Region(plow,phigh,2);
+	ObjectRangeVisitor vis(object,results,objTypes,buildingObject->mPosition.x,buildingObject->mPosition.z,queryRange,false,true);
+
+	mTree->intersectsWithQuery(r,vis);
+}
+
+//=============================================================================
+
+void ObjectRangeVisitor::visitData(const SpatialIndex::IData& d)
+{
+	Object* tmpObject = gWorldManager->getObjectById(d.getIdentifier());
+
+	// check if its us and the object still exists
+	if(!tmpObject || tmpObject == mObject)
+	{
+		return;
+	}
+
+	// only objects in the same parent (world)
+	if(mWorldOnly && tmpObject->getParentId())
+	{
+		return;
+	}
+
+	ObjectType		tmpType		= tmpObject->getType();
+	BuildingObject*	building	= NULL;
+	float			width		= 0.0f;
+	float			height		= 0.0f;
+
+	// buildings and regions are indexed with their extents, everything else as a point
+	if(tmpType == ObjType_Building)
+	{
+		if((building = dynamic_cast<BuildingObject*>(tmpObject)) != NULL)
+		{
+			width	= building->getWidth();
+			height	= building->getHeight();
+		}
+	}
+	else if(tmpType == ObjType_Region)
+	{
+		if(RegionObject* region = dynamic_cast<RegionObject*>(tmpObject))
+		{
+			width	= region->getWidth();
+			height	= region->getHeight();
+		}
+	}
+
+	if(!_inRange(tmpObject,width,height))
+	{
+		return;
+	}
+
+	if((tmpType & mObjTypes) == static_cast<uint32>(tmpType))
+	{
+		mResults->push_back(tmpObject);
+	}
+
+	// if its a building, add objects of queried types it contains
+	if(building && mCellContent)
+	{
+		_addCellContent(building);
+	}
+}
+
+//=============================================================================
+//
+// checks the objects extent against the query circle
+//
+
+bool ObjectRangeVisitor::_inRange(Object* object,float width,float height) const
+{
+	// distance from the center to the closest point of the objects extent
+	float dx = fabs(object->mPosition.x - mCenterX) - width;
+	float dz = fabs(object->mPosition.z - mCenterZ) - height;
+
+	if(dx < 0.0f)
+		dx = 0.0f;
+
+	if(dz < 0.0f)
+		dz = 0.0f;
+
+	return(dx * dx + dz * dz <= mRangeSquared);
+}
+
+//=============================================================================
+
+void ObjectRangeVisitor::_addCellContent(BuildingObject* building)
+{
+	CellObjectList*				cells	= building->getCellList();
+	CellObjectList::iterator	cellIt	= cells->begin();
+
+	while(cellIt != cells->end())
+	{
+		ObjectIDList*			cellObjects = (*cellIt)->getObjects();
+		ObjectIDList::iterator	childIt		= cellObjects->begin();
+
+		while(childIt != cellObjects->end())
+		{
+			Object* cellChild = gWorldManager->getObjectById(*childIt);
+
+			if(cellChild && cellChild != mObject && ((cellChild->getType() & mObjTypes) == static_cast<uint32>(cellChild->getType())))
+			{
+				mResults->push_back(cellChild);
+			}
+
+			++childIt;
+		}
+
+		++cellIt;
+	}
+}
+
 //=============================================================================
 
 void ZoneTree::RemovePoint(int64 objId,double x,double z)
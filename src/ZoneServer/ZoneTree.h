@@ -37,6 +37,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
 
 class Object;
 class QTRegion;
+class BuildingObject;
 
 typedef std::vector<int64>		ObjectIdList;
 typedef std::list<Object*>	ObjectList;
@@ -62,6 +63,38 @@ class MyVisitor : public SpatialIndex::IVisitor
 		ObjectIdList*	mvObjList;
 };
 
+//======================================================================================================================
+//
+// resolves the ids as the tree hands them out and writes the objects of the queried types,
+// which lie within range of the query center, straight into a caller owned vector
+//
+
+class ObjectRangeVisitor : public SpatialIndex::IVisitor
+{
+	public:
+
+		ObjectRangeVisitor(const Object* const object, ObjectVector* results, uint32 objTypes, float centerX, float centerZ, float range, bool worldOnly, bool cellContent)
+			: mObject(object),mResults(results),mObjTypes(objTypes),mCenterX(centerX),mCenterZ(centerZ),mRangeSquared(range * range),mWorldOnly(worldOnly),mCellContent(cellContent){}
+
+        void visitNode(const SpatialIndex::INode& n){}
+        void visitData(const SpatialIndex::IData& d);
+        void visitData(std::vector<const SpatialIndex::IData*>& v) {}
+
+	private:
+
+		bool			_inRange(Object* object, float width, float height) const;
+		void			_addCellContent(BuildingObject* building);
+
+		const Object*	mObject;
+		ObjectVector*	mResults;
+		uint32			mObjTypes;
+		float			mCenterX;
+		float			mCenterZ;
+		float			mRangeSquared;
+		bool			mWorldOnly;
+		bool			mCellContent;
+};
+
 //======================================================================================================================
 
 class ZoneTree
@@ -83,6 +116,7 @@ class ZoneTree
 		void			RemoveRegion(int64 objId, double xLow, double zLow, double xHigh, double zHigh);
 
 		void			getObjectsInRange(const Object* const object, ObjectSet* resultSet, uint32 objTypes, float range, bool cellContent = false);
+		void			getObjectsInRange(const Object* const object, ObjectVector* results, uint32 objTypes, float range, bool cellContent = false);
 		void			getObjectsInRangeIntersection(Object* object, ObjectSet* resultSet, uint32 objTypes, float range);
 		void			getObjectsInRangeEx(Object* object, ObjectSet* resultSet, uint32 objTypes, float range);
 		QTRegion*		getQTRegion(double x, double z);
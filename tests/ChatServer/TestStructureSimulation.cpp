@@ -0,0 +1,251 @@
+/*! SWGANH MMOServer - Tests
+ *
+ * @copyright Copyright (c) 2006-2010 The swgANH Team
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "ChatServer/StructureSimulation.h"
+
+namespace
+{
+	StructureSimState harvester(uint64 id,uint64 owner)
+	{
+		StructureSimState state;
+
+		state.mId					= id;
+		state.mOwner				= owner;
+		state.mResourceId			= 500;
+		state.mMaintenanceReserve	= 1000.0f;
+		state.mMaintenancePerHour	= 10.0f;
+		state.mPowerReserve			= 100.0f;
+		state.mPowerPerHour			= 25.0f;
+		state.mExtractionRate		= 3.0f;
+		state.mHopperSize			= 3000.0f;
+		state.mHopperFill			= 0.0f;
+		state.mCondition			= 1000;
+		state.mFlags				= StructureSimFlag_Harvester | StructureSimFlag_Active | StructureSimFlag_ResourceActive;
+
+		return state;
+	}
+
+	StructureSimState house(uint64 id,uint64 owner)
+	{
+		StructureSimState state = harvester(id,owner);
+
+		state.mResourceId		= 0;
+		state.mPowerPerHour		= 0.0f;
+		state.mExtractionRate	= 0.0f;
+		state.mFlags			= 0;
+
+		return state;
+	}
+
+	bool hasEvent(StructureSimulation* simulation,uint64 id,uint32 event)
+	{
+		StructureSimEventList* events = simulation->getEvents();
+
+		for(uint32 i = 0; i < events->size(); i++)
+		{
+			if((*events)[i].mStructureId == id && (*events)[i].mEvent == event)
+				return true;
+		}
+
+		return false;
+	}
+}
+
+TEST(StructureSimulationTests, HarvestCarriesFractionsOver)
+{
+	StructureSimulation simulation;
+	simulation.addStructure(harvester(1,100));
+	simulation.addStructure(house(2,100));
+
+	StructureSimDeltaList deltas;
+
+	// 3 units a minute, a 10 second pass makes half a unit
+	simulation.harvest(1.0f / 6.0f);
+	simulation.collectHarvested(&deltas);
+
+	EXPECT_TRUE(deltas.empty());
+
+	simulation.harvest(1.0f / 6.0f);
+	simulation.collectHarvested(&deltas);
+
+	ASSERT_EQ(1u, deltas.size());
+	EXPECT_EQ(1u, deltas[0].mId);
+	EXPECT_EQ(500u, deltas[0].mKey);
+	EXPECT_EQ(1u, deltas[0].mAmount);
+	EXPECT_FLOAT_EQ(0.0f, simulation.getHopperFill(1));
+}
+
+TEST(StructureSimulationTests, FractionsSurviveAReload)
+{
+	StructureSimulation simulation;
+	simulation.addStructure(harvester(1,100));
+	simulation.addStructure(harvester(2,100));
+
+	StructureSimDeltaList deltas;
+
+	simulation.harvest(1.0f / 6.0f);
+	simulation.collectHarvested(&deltas);
+
+	EXPECT_TRUE(deltas.empty());
+
+	// the tables only have the whole units, the second harvester switched its resource meanwhile
+	StructureSimState switched = harvester(2,100);
+	switched.mResourceId = 600;
+
+	simulation.clear();
+	simulation.addStructure(harvester(1,100));
+	simulation.addStructure(switched);
+
+	EXPECT_FLOAT_EQ(0.5f, simulation.getHopperFill(0));
+	EXPECT_FLOAT_EQ(0.0f, simulation.getHopperFill(1));
+
+	simulation.harvest(1.0f / 6.0f);
+	simulation.collectHarvested(&deltas);
+
+	ASSERT_EQ(1u, deltas.size());
+	EXPECT_EQ(1u, deltas[0].mId);
+	EXPECT_EQ(1u, deltas[0].mAmount);
+
+	// a reload without the structure drops what it had pending
+	simulation.clear();
+	simulation.clear();
+	simulation.addStructure(harvester(2,100));
+
+	EXPECT_FLOAT_EQ(0.0f, simulation.getHopperFill(0));
+}
+
+TEST(StructureSimulationTests, FullHopperShutsTheHarvesterDown)
+{
+	StructureSimulation simulation;
+
+	StructureSimState state = harvester(1,100);
+	state.mHopperFill = 2990.0f;
+	simulation.addStructure(state);
+
+	simulation.harvest(60.0f);
+
+	EXPECT_FLOAT_EQ(3000.0f, simulation.getHopperFill(0));
+	EXPECT_FALSE(simulation.isRunning(0));
+	EXPECT_TRUE(hasEvent(&simulation,1,StructureSimEvent_HopperFull));
+
+	StructureSimEventList deactivated;
+	simulation.collectDeactivated(&deactivated);
+
+	ASSERT_EQ(1u, deactivated.size());
+	EXPECT_EQ(1u, deactivated[0].mStructureId);
+	EXPECT_EQ(static_cast<uint32>(StructureSimEvent_HopperFull), deactivated[0].mEvent);
+
+	// nothing more goes in
+	StructureSimDeltaList deltas;
+	simulation.collectHarvested(&deltas);
+	deltas.clear();
+
+	simulation.harvest(60.0f);
+	simulation.collectHarvested(&deltas);
+
+	EXPECT_TRUE(deltas.empty());
+}
+
+TEST(StructureSimulationTests, InactiveResourceShutsDownOnLoad)
+{
+	StructureSimulation simulation;
+
+	StructureSimState state = harvester(1,100);
+	state.mFlags &= ~StructureSimFlag_ResourceActive;
+	simulation.addStructure(state);
+
+	EXPECT_FALSE(simulation.isRunning(0));
+	EXPECT_TRUE(hasEvent(&simulation,1,StructureSimEvent_ResourceInactive));
+}
+
+TEST(StructureSimulationTests, EmptyPowerReserveShutsTheHarvesterDown)
+{
+	StructureSimulation simulation;
+	simulation.addStructure(harvester(1,100));
+
+	simulation.usePower(3.0f);
+
+	EXPECT_FLOAT_EQ(25.0f, simulation.getPowerReserve(0));
+	EXPECT_TRUE(simulation.isRunning(0));
+
+	simulation.usePower(2.0f);
+
+	EXPECT_FLOAT_EQ(0.0f, simulation.getPowerReserve(0));
+	EXPECT_FALSE(simulation.isRunning(0));
+	EXPECT_TRUE(hasEvent(&simulation,1,StructureSimEvent_OutOfPower));
+
+	StructureSimDeltaList deltas;
+	simulation.collectPowerUsed(&deltas);
+
+	ASSERT_EQ(1u, deltas.size());
+	EXPECT_EQ(100u, deltas[0].mAmount);
+}
+
+TEST(StructureSimulationTests, ArrearsArePaidByTheBankOrTheCondition)
+{
+	StructureSimulation simulation;
+
+	StructureSimState rich = house(1,100);
+	rich.mMaintenanceReserve = 50.0f;
+
+	StructureSimState poor = house(2,200);
+	poor.mMaintenanceReserve = 0.0f;
+
+	StructureSimState ruined = harvester(3,200);
+	ruined.mMaintenanceReserve	= 0.0f;
+	ruined.mCondition			= 30;
+
+	simulation.addStructure(rich);
+	simulation.addStructure(poor);
+	simulation.addStructure(ruined);
+
+	simulation.useMaintenance(10.0f);
+
+	EXPECT_TRUE(simulation.hasArrears());
+	EXPECT_FLOAT_EQ(0.0f, simulation.getMaintenanceReserve(0));
+
+	OwnerCreditMap credits;
+	credits[100] = 60;
+	credits[200] = 5;
+
+	simulation.settleMaintenance(&credits);
+
+	EXPECT_FALSE(simulation.hasArrears());
+	EXPECT_EQ(10u, credits[100]);
+	EXPECT_EQ(5u, credits[200]);
+
+	EXPECT_EQ(1000, simulation.getCondition(0));
+	EXPECT_EQ(900, simulation.getCondition(1));
+	EXPECT_EQ(0, simulation.getCondition(2));
+	EXPECT_FALSE(simulation.isRunning(2));
+
+	EXPECT_TRUE(hasEvent(&simulation,1,StructureSimEvent_MaintenanceFromBank));
+	EXPECT_TRUE(hasEvent(&simulation,2,StructureSimEvent_Damaged));
+	EXPECT_TRUE(hasEvent(&simulation,3,StructureSimEvent_Condemned));
+
+	StructureSimDeltaList deltas;
+	simulation.collectBankDebits(&deltas);
+
+	ASSERT_EQ(1u, deltas.size());
+	EXPECT_EQ(100u, deltas[0].mId);
+	EXPECT_EQ(50u, deltas[0].mAmount);
+
+	deltas.clear();
+	simulation.collectMaintenanceUsed(&deltas);
+
+	ASSERT_EQ(1u, deltas.size());
+	EXPECT_EQ(50u, deltas[0].mAmount);
+
+	deltas.clear();
+	simulation.collectConditionLost(&deltas);
+
+	ASSERT_EQ(2u, deltas.size());
+	EXPECT_EQ(100u, deltas[0].mAmount);
+	EXPECT_EQ(30u, deltas[1].mAmount);
+}
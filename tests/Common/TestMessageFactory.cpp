@@ -0,0 +1,232 @@
+/*! SWGANH MMOServer - Tests
+ *
+ * @copyright Copyright (c) 2006-2010 The swgANH Team
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "Common/Message.h"
+#include "Common/MessageFactory.h"
+#include "LogManager/LogManager.h"
+#include "Utils/clock.h"
+
+namespace
+{
+	// the factory logs and timestamps through these singletons
+	void initSingletons()
+	{
+		if(!Anh_Utils::Clock::getSingleton())
+			Anh_Utils::Clock::Init();
+
+		if(!LogManager::getSingleton())
+			LogManager::Init();
+	}
+
+	Message* buildMessage(MessageFactory* factory, uint32 size, uint8 fill)
+	{
+		factory->StartMessage();
+
+		for(uint32 i = 0; i < size; i++)
+		{
+			factory->addUint8(fill);
+		}
+
+		return factory->EndMessage();
+	}
+
+	void releaseAll(std::vector<Message*>* messages)
+	{
+		for(uint32 i = 0; i < messages->size(); i++)
+		{
+			(*messages)[i]->setPendingDelete(true);
+		}
+	}
+}
+
+TEST(MessageFactoryTests, MessagesKeepTheirPayload)
+{
+	initSingletons();
+
+	MessageFactory factory(1024 * 1024);
+
+	Message* small = buildMessage(&factory, 10, 0x11);
+	Message* medium = buildMessage(&factory, 700, 0x22);
+	Message* large = buildMessage(&factory, 20000, 0x33);
+
+	ASSERT_EQ(10, small->getSize());
+	ASSERT_EQ(700, medium->getSize());
+	ASSERT_EQ(20000, large->getSize());
+
+	for(uint32 i = 0; i < 20000; i++)
+	{
+		EXPECT_EQ(0x33, (uint8)large->getData()[i]);
+	}
+
+	EXPECT_EQ(0x11, small->getUint8());
+	EXPECT_EQ(0x22, medium->getUint8());
+	EXPECT_EQ(1u, factory.getLargeMessages());
+
+	small->setPendingDelete(true);
+	medium->setPendingDelete(true);
+	large->setPendingDelete(true);
+}
+
+TEST(MessageFactoryTests, LongLivedMessageDoesNotBlockReclamation)
+{
+	initSingletons();
+
+	MessageFactory factory(1024 * 1024);
+
+	// our 32 byte class
+	Message* stuck = buildMessage(&factory, 16, 0);
+
+	// way more than the heap holds at once, only possible if everything behind the stuck message gets reused
+	for(uint32 round = 0; round < 100; round++)
+	{
+		std::vector<Message*> messages;
+
+		for(uint32 i = 0; i < 200; i++)
+		{
+			messages.push_back(buildMessage(&factory, 16 + (i % 400), (uint8)i));
+		}
+
+		releaseAll(&messages);
+	}
+
+	factory.Process();
+
+	EXPECT_EQ(0u, factory.getOverflowPages());
+	EXPECT_EQ(1u, factory.getSizeClassBlocksInUse(0));
+	EXPECT_LT(factory.getHeapsize(), 10.0f);
+
+	for(uint32 i = 1; i < MESSAGE_SIZE_CLASSES; i++)
+	{
+		EXPECT_EQ(0u, factory.getSizeClassBlocksInUse(i));
+	}
+
+	stuck->setPendingDelete(true);
+	factory.Process();
+
+	EXPECT_EQ(0u, factory.getSizeClassBlocksInUse(0));
+	EXPECT_EQ(0u, factory.getPagesInUse());
+}
+
+TEST(MessageFactoryTests, SharedPayloadLivesUntilLastRelease)
+{
+	initSingletons();
+
+	MessageFactory factory(1024 * 1024);
+
+	Message* owner = buildMessage(&factory, 100, 0x44);
+	Message* share1 = factory.ShareMessage(owner);
+	Message* share2 = factory.ShareMessage(share1);
+
+	EXPECT_EQ(owner->getData(), share2->getData());
+
+	owner->setPendingDelete(true);
+	share1->setPendingDelete(true);
+	factory.Process();
+
+	// the owner's block is still around for the last share
+	EXPECT_EQ(2u, factory.getSizeClassBlocksInUse(0) + factory.getSizeClassBlocksInUse(2));
+	EXPECT_EQ(0x44, (uint8)share2->getData()[99]);
+
+	share2->setPendingDelete(true);
+	factory.Process();
+
+	EXPECT_EQ(0u, factory.getPagesInUse());
+}
+
+TEST(MessageFactoryTests, PinnedMessageLivesUntilReleased)
+{
+	initSingletons();
+
+	MessageFactory factory(1024 * 1024);
+
+	Message* pinned = factory.PinMessage(buildMessage(&factory, 100, 0x66));
+
+	// moved out of the heap, it doesn't count towards its usage
+	EXPECT_EQ(0u, factory.getPagesInUse());
+	EXPECT_EQ(1u, factory.getPinnedMessages());
+	EXPECT_EQ(0.0f, factory.getHeapsize());
+	EXPECT_EQ(0x66, (uint8)pinned->getData()[99]);
+
+	Message* share = factory.ShareMessage(pinned);
+
+	// live messages created and freed around the pinned one
+	for(uint32 i = 0; i < 100; i++)
+	{
+		buildMessage(&factory, 16 + i, (uint8)i)->setPendingDelete(true);
+	}
+
+	factory.Process();
+
+	pinned->setPendingDelete(true);
+	factory.Process();
+
+	EXPECT_EQ(0x66, (uint8)share->getData()[99]);
+
+	share->setPendingDelete(true);
+	factory.Process();
+
+	EXPECT_EQ(0u, factory.getPagesInUse());
+	EXPECT_EQ(0u, factory.getPinnedMessages());
+	EXPECT_EQ(0u, factory.getPinnedBytes());
+}
+
+TEST(MessageFactoryTests, HeapExhaustionFallsBackToOverflowPages)
+{
+	initSingletons();
+
+	// a single page
+	MessageFactory factory(MESSAGE_SLAB_PAGE_SIZE);
+	std::vector<Message*> messages;
+
+	for(uint32 i = 0; i < 100; i++)
+	{
+		messages.push_back(buildMessage(&factory, 2000, 0x55));
+	}
+
+	EXPECT_GT(factory.getOverflowPages(), 0u);
+	EXPECT_GT(factory.getHeapsize(), 100.0f);
+
+	releaseAll(&messages);
+	factory.Process();
+
+	EXPECT_EQ(0u, factory.getOverflowPages());
+	EXPECT_EQ(0u, factory.getPagesInUse());
+}
+
+TEST(MessageFactoryTests, MessagesReleasedOnOtherThreadsGetReclaimed)
+{
+	initSingletons();
+
+	MessageFactory factory(4 * 1024 * 1024);
+
+	std::vector<Message*> messages[4];
+
+	for(uint32 t = 0; t < 4; t++)
+	{
+		for(uint32 i = 0; i < 5000; i++)
+		{
+			messages[t].push_back(buildMessage(&factory, i % 300, (uint8)t));
+		}
+	}
+
+	boost::thread_group threads;
+
+	for(uint32 t = 0; t < 4; t++)
+	{
+		threads.create_thread(boost::bind(&releaseAll, &messages[t]));
+	}
+
+	threads.join_all();
+	factory.Process();
+
+	EXPECT_EQ(0u, factory.getPagesInUse());
+}
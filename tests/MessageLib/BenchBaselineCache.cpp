@@ -0,0 +1,263 @@
+/*! SWGANH MMOServer - Tests
+ *
+ * @copyright Copyright (c) 2006-2010 The swgANH Team
+ *
+ * A crowd of observers walking into view of the same npcs, every observer needs the creature baselines of every npc.
+ * Builds them per observer the way MessageLib did (name to unicode, customization, the type 6 body copied behind its
+ * header) and compares that with handing out shares through BaselineCache, with a share of the npcs changing between rounds.
+ * Not part of make check, build it with make baseline_cache_bench.
+ */
+
+#include <cstdio>
+#include <vector>
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+#include "Common/Message.h"
+#include "Common/MessageFactory.h"
+#include "LogManager/LogManager.h"
+#include "MessageLib/BaselineCache.h"
+#include "Utils/clock.h"
+
+namespace
+{
+	const uint32	kObservers		= 500;
+	const uint32	kNpcs			= 200;
+	const uint32	kRounds			= 10;
+	const uint32	kChangedPerMil	= 100;	// npcs changing between two rounds, combat, posture, mood..
+
+	struct Npc
+	{
+		uint64	id;
+		string	firstName;
+		string	lastName;
+		string	customization;
+		uint32	version;
+		uint32	ham[9];
+	};
+
+	Message* buildCreo3(MessageFactory* factory, const Npc& npc)
+	{
+		string firstName	= npc.firstName.getAnsi();
+		string lastName		= npc.lastName.getAnsi();
+		string fullName;
+
+		fullName << firstName.getAnsi();
+		fullName << " ";
+		fullName << lastName.getAnsi();
+		fullName.convert(BSTRType_Unicode16);
+
+		factory->StartMessage();
+		factory->addUint32(0x68A75F0C);
+		factory->addUint64(npc.id);
+		factory->addUint32(0x4352454F);
+		factory->addUint8(3);
+		factory->addUint32(119 + (fullName.getLength() << 1) + npc.customization.getLength());
+		factory->addUint16(12);
+		factory->addUint32(16256);
+		factory->addString("species");
+		factory->addUint32(0);
+		factory->addString("human_male");
+		factory->addString(fullName);
+		factory->addUint32(1);
+		factory->addString(npc.customization);
+		factory->addUint64(0);
+		factory->addUint32(0x80);
+		factory->addUint32(0);
+		factory->addUint32(0);
+		factory->addUint32(1000);
+		factory->addUint8(1);
+		factory->addUint8(0);
+		factory->addUint8(0);
+		factory->addUint64(0);
+		factory->addFloat(1.0f);
+		factory->addUint32(0);
+		factory->addUint64(0);
+		factory->addUint32(9);
+		factory->addUint32(9);
+
+		for(uint32 i = 0; i < 9; i++)
+		{
+			factory->addUint32(npc.ham[i] / 10);
+		}
+
+		return factory->EndMessage();
+	}
+
+	Message* buildCreo6(MessageFactory* factory, const Npc& npc)
+	{
+		factory->StartMessage();
+		factory->addUint16(22);
+		factory->addUint32(0);
+		factory->addUint32(0);
+		factory->addUint32(0);
+		factory->addUint16(10);
+		factory->addString("");
+		factory->addString("neutral");
+		factory->addUint64(0);
+		factory->addUint64(0);
+		factory->addUint64(0);
+		factory->addUint64(0);
+		factory->addUint32(0);
+		factory->addUint64(0);
+		factory->addUint8(74);
+		factory->addUint32(0);
+		factory->addUint32(0);
+
+		for(uint32 bar = 0; bar < 2; bar++)
+		{
+			factory->addUint32(9);
+			factory->addUint32(9);
+
+			for(uint32 i = 0; i < 9; i++)
+			{
+				factory->addUint32(npc.ham[i]);
+			}
+		}
+
+		// a few worn items
+		factory->addUint32(4);
+		factory->addUint32(0);
+
+		for(uint32 i = 0; i < 4; i++)
+		{
+			factory->addString(npc.customization);
+			factory->addUint32(4);
+			factory->addUint64(npc.id + i + 1);
+			factory->addUint32(0x12345678);
+		}
+
+		factory->addUint16(0);
+		factory->addUint8(0);
+
+		Message* data = factory->EndMessage();
+
+		factory->StartMessage();
+		factory->addUint32(0x68A75F0C);
+		factory->addUint64(npc.id);
+		factory->addUint32(0x4352454F);
+		factory->addUint8(6);
+		factory->addUint32(data->getSize());
+		factory->addData(data->getData(), data->getSize());
+		data->setPendingDelete(true);
+
+		return factory->EndMessage();
+	}
+
+	void createNpcs(std::vector<Npc>* npcs)
+	{
+		npcs->resize(kNpcs);
+
+		for(uint32 i = 0; i < kNpcs; i++)
+		{
+			Npc& npc = (*npcs)[i];
+
+			npc.id				= 10000 + i * 16;
+			npc.firstName		= "Ferrous";
+			npc.lastName		= "Mosrec";
+			npc.customization	= "\x01\x21\x01\x40\x02\x19\x03\x7f\x04\x42\x05\x23\x06\x10\x07\x33\x08\x64\x09\x11\x0a\x72\x0b\x03\x0c\x44\x0d\x22\x0e\x0f\x0f\x31\x10\x16\xff\x03";
+			npc.version			= i;
+
+			for(uint32 bar = 0; bar < 9; bar++)
+			{
+				npc.ham[bar] = 1000 + bar * 50;
+			}
+		}
+	}
+
+	// every observer gets both baselines of every npc, sending releases them as the session would
+	double run(MessageFactory* factory, BaselineCache* cache, std::vector<Npc>* npcs)
+	{
+		std::vector<Message*> sent;
+		sent.reserve(kNpcs * 2);
+
+		uint32 nextVersion = kNpcs;
+
+		boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+
+		for(uint32 round = 0; round < kRounds; round++)
+		{
+			for(uint32 observer = 0; observer < kObservers; observer++)
+			{
+				for(uint32 i = 0; i < kNpcs; i++)
+				{
+					const Npc& npc = (*npcs)[i];
+
+					if(!cache)
+					{
+						sent.push_back(buildCreo3(factory, npc));
+						sent.push_back(buildCreo6(factory, npc));
+						continue;
+					}
+
+					Message* creo3 = cache->getBaseline(npc.id, 0, npc.version);
+					if(!creo3)
+						creo3 = cache->storeBaseline(npc.id, 0, npc.version, buildCreo3(factory, npc));
+
+					Message* creo6 = cache->getBaseline(npc.id, 1, npc.version);
+					if(!creo6)
+						creo6 = cache->storeBaseline(npc.id, 1, npc.version, buildCreo6(factory, npc));
+
+					sent.push_back(creo3);
+					sent.push_back(creo6);
+				}
+
+				for(uint32 i = 0; i < sent.size(); i++)
+				{
+					sent[i]->setPendingDelete(true);
+				}
+
+				sent.clear();
+				factory->Process();
+			}
+
+			for(uint32 i = 0; i < kNpcs; i++)
+			{
+				if((i * 1000 / kNpcs) % 1000 < kChangedPerMil)
+				{
+					(*npcs)[i].version = ++nextVersion;
+					(*npcs)[i].ham[0]--;
+				}
+			}
+		}
+
+		double seconds = (double)(boost::posix_time::microsec_clock::universal_time() - start).total_microseconds() / 1000000.0;
+
+		return (double)kRounds * kObservers * kNpcs / seconds;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	Anh_Utils::Clock::Init();
+	LogManager::Init();
+
+	std::vector<Npc> npcs;
+
+	printf("%u observers, %u npcs, %u rounds, %u of 1000 npcs change between rounds\n", kObservers, kNpcs, kRounds, kChangedPerMil);
+	printf("mode       creates/s  hits        misses\n");
+
+	{
+		MessageFactory factory(64 * 1024 * 1024);
+		createNpcs(&npcs);
+
+		double rate = run(&factory, NULL, &npcs);
+
+		printf("built    %11.0f\n", rate);
+	}
+
+	{
+		MessageFactory factory(64 * 1024 * 1024);
+		BaselineCache cache(&factory, 8192, 4194304);
+		createNpcs(&npcs);
+
+		double rate = run(&factory, &cache, &npcs);
+
+		printf("cached   %11.0f  %10llu  %6llu\n", rate, (unsigned long long)cache.getHits(), (unsigned long long)cache.getMisses());
+
+		cache.clear();
+		factory.Process();
+	}
+
+	return 0;
+}
@@ -0,0 +1,191 @@
+/*! SWGANH MMOServer - Tests
+ *
+ * @copyright Copyright (c) 2006-2010 The swgANH Team
+ */
+
+#include <gtest/gtest.h>
+
+#include "Common/Message.h"
+#include "Common/MessageFactory.h"
+#include "LogManager/LogManager.h"
+#include "MessageLib/BaselineCache.h"
+#include "Utils/clock.h"
+
+namespace
+{
+	// the factory logs and timestamps through these singletons
+	void initSingletons()
+	{
+		if(!Anh_Utils::Clock::getSingleton())
+			Anh_Utils::Clock::Init();
+
+		if(!LogManager::getSingleton())
+			LogManager::Init();
+	}
+
+	Message* buildBaseline(MessageFactory* factory, uint32 size, uint8 fill)
+	{
+		factory->StartMessage();
+
+		for(uint32 i = 0; i < size; i++)
+		{
+			factory->addUint8(fill);
+		}
+
+		return factory->EndMessage();
+	}
+
+	// what a caller does with the message it got to send
+	void send(Message* message)
+	{
+		message->setPendingDelete(true);
+	}
+}
+
+TEST(BaselineCacheTests, CachedBaselineIsSharedAtItsVersion)
+{
+	initSingletons();
+
+	MessageFactory factory(1024 * 1024);
+	BaselineCache cache(&factory, 16, 65536);
+
+	EXPECT_TRUE(cache.getBaseline(1, 0, 1) == NULL);
+
+	send(cache.storeBaseline(1, 0, 1, buildBaseline(&factory, 100, 0x11)));
+
+	Message* share = cache.getBaseline(1, 0, 1);
+
+	ASSERT_TRUE(share != NULL);
+	EXPECT_EQ(0x11, (uint8)share->getData()[99]);
+	EXPECT_EQ(1u, cache.getHits());
+	EXPECT_EQ(1u, cache.getMisses());
+
+	send(share);
+	cache.clear();
+	factory.Process();
+
+	EXPECT_EQ(0u, factory.getPinnedMessages());
+}
+
+TEST(BaselineCacheTests, VersionMismatchEvicts)
+{
+	initSingletons();
+
+	MessageFactory factory(1024 * 1024);
+	BaselineCache cache(&factory, 16, 65536);
+
+	send(cache.storeBaseline(1, 0, 1, buildBaseline(&factory, 100, 0x11)));
+
+	EXPECT_TRUE(cache.getBaseline(1, 0, 2) == NULL);
+	EXPECT_EQ(0u, cache.getSize());
+	EXPECT_EQ(0u, cache.getBytes());
+
+	factory.Process();
+
+	EXPECT_EQ(0u, factory.getPinnedMessages());
+}
+
+TEST(BaselineCacheTests, LeastRecentlyUsedIsEvicted)
+{
+	initSingletons();
+
+	MessageFactory factory(1024 * 1024);
+	BaselineCache cache(&factory, 2, 65536);
+
+	send(cache.storeBaseline(1, 0, 1, buildBaseline(&factory, 100, 0x11)));
+	send(cache.storeBaseline(2, 0, 1, buildBaseline(&factory, 100, 0x22)));
+
+	// 1 becomes the most recently used
+	send(cache.getBaseline(1, 0, 1));
+
+	send(cache.storeBaseline(3, 0, 1, buildBaseline(&factory, 100, 0x33)));
+
+	EXPECT_EQ(2u, cache.getSize());
+	EXPECT_TRUE(cache.getBaseline(2, 0, 1) == NULL);
+
+	Message* first = cache.getBaseline(1, 0, 1);
+	Message* third = cache.getBaseline(3, 0, 1);
+
+	ASSERT_TRUE(first != NULL);
+	ASSERT_TRUE(third != NULL);
+
+	send(first);
+	send(third);
+	cache.clear();
+	factory.Process();
+
+	EXPECT_EQ(0u, factory.getPinnedMessages());
+}
+
+TEST(BaselineCacheTests, BytesBoundTheCache)
+{
+	initSingletons();
+
+	MessageFactory factory(1024 * 1024);
+	BaselineCache cache(&factory, 16, 250);
+
+	send(cache.storeBaseline(1, 0, 1, buildBaseline(&factory, 100, 0x11)));
+	send(cache.storeBaseline(2, 0, 1, buildBaseline(&factory, 100, 0x22)));
+	send(cache.storeBaseline(3, 0, 1, buildBaseline(&factory, 100, 0x33)));
+
+	EXPECT_EQ(2u, cache.getSize());
+	EXPECT_EQ(200u, cache.getBytes());
+	EXPECT_TRUE(cache.getBaseline(1, 0, 1) == NULL);
+
+	// too big to be cached at all, sent as built
+	Message* baseline = buildBaseline(&factory, 300, 0x44);
+
+	EXPECT_EQ(baseline, cache.storeBaseline(4, 0, 1, baseline));
+	EXPECT_EQ(2u, cache.getSize());
+
+	send(baseline);
+	cache.clear();
+	factory.Process();
+
+	EXPECT_EQ(0u, factory.getPinnedMessages());
+	EXPECT_EQ(0u, factory.getPagesInUse());
+}
+
+TEST(BaselineCacheTests, CachedBaselinesStayOutOfTheHeap)
+{
+	initSingletons();
+
+	MessageFactory factory(1024 * 1024);
+	BaselineCache cache(&factory, 16, 65536);
+
+	for(uint32 i = 0; i < 10; i++)
+	{
+		send(cache.storeBaseline(i + 1, 0, 1, buildBaseline(&factory, 1000, (uint8)i)));
+	}
+
+	factory.Process();
+
+	EXPECT_EQ(10u, factory.getPinnedMessages());
+	EXPECT_EQ(0u, factory.getPagesInUse());
+	EXPECT_EQ(0.0f, factory.getHeapsize());
+
+	cache.clear();
+	factory.Process();
+
+	EXPECT_EQ(0u, factory.getPinnedMessages());
+}
+
+TEST(BaselineCacheTests, CapacityZeroCachesNothing)
+{
+	initSingletons();
+
+	MessageFactory factory(1024 * 1024);
+	BaselineCache cache(&factory, 0, 65536);
+
+	Message* baseline = buildBaseline(&factory, 100, 0x11);
+
+	EXPECT_EQ(baseline, cache.storeBaseline(1, 0, 1, baseline));
+	EXPECT_EQ(0u, cache.getSize());
+	EXPECT_TRUE(cache.getBaseline(1, 0, 1) == NULL);
+	EXPECT_EQ(0u, factory.getPinnedMessages());
+
+	send(baseline);
+	factory.Process();
+
+	EXPECT_EQ(0u, factory.getPagesInUse());
+}
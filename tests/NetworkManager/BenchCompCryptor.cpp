@@ -0,0 +1,85 @@
+/*! SWGANH MMOServer - Tests
+ *
+ * @copyright Copyright (c) 2006-2010 The swgANH Team
+ *
+ * Microbenchmark for the per packet CompCryptor work (crc, encrypt, decrypt) over the
+ * packet sizes the server actually sends. Not part of make check, build it with
+ * make compcryptor_bench.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+#include "NetworkManager/CompCryptor.h"
+
+namespace
+{
+	const uint32 kPacketSizes[] = { 16, 32, 64, 128, 256, 496 };
+	const uint32 kBytesPerRun   = 64 * 1024 * 1024;
+
+	uint64 now()
+	{
+		static const boost::posix_time::ptime epoch = boost::posix_time::microsec_clock::universal_time();
+
+		return (boost::posix_time::microsec_clock::universal_time() - epoch).total_microseconds();
+	}
+
+	void report(const char* name, uint32 size, uint32 iterations, uint64 elapsed)
+	{
+		if(!elapsed)
+		{
+			elapsed = 1;
+		}
+
+		printf("%-8s %4u bytes  %8.1f ns/packet  %8.1f MB/s\n", name, size,
+			(double)elapsed * 1000.0 / iterations,
+			(double)size * iterations / (double)elapsed);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	CompCryptor cryptor;
+	std::vector<int8> buffer(512);
+
+	for(size_t i = 0; i < buffer.size(); i++)
+	{
+		buffer[i] = (int8)(rand() & 0xFF);
+	}
+
+	// keeps the crc results alive
+	volatile uint32 sink = 0;
+
+	for(uint32 s = 0; s < sizeof(kPacketSizes) / sizeof(kPacketSizes[0]); s++)
+	{
+		uint32 size = kPacketSizes[s];
+		uint32 iterations = kBytesPerRun / size;
+		uint64 start;
+
+		start = now();
+		for(uint32 i = 0; i < iterations; i++)
+		{
+			sink ^= cryptor.GenerateCRC(&buffer[0], size, i);
+		}
+		report("crc", size, iterations, now() - start);
+
+		start = now();
+		for(uint32 i = 0; i < iterations; i++)
+		{
+			cryptor.Encrypt(&buffer[0], size, i);
+		}
+		report("encrypt", size, iterations, now() - start);
+
+		start = now();
+		for(uint32 i = 0; i < iterations; i++)
+		{
+			cryptor.Decrypt(&buffer[0], size, i);
+		}
+		report("decrypt", size, iterations, now() - start);
+	}
+
+	return sink == 0xFFFFFFFF;
+}
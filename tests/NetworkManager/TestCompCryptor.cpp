@@ -0,0 +1,204 @@
+/*! SWGANH MMOServer - Tests
+ *
+ * @copyright Copyright (c) 2006-2010 The swgANH Team
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "NetworkManager/CompCryptor.h"
+
+// The byte at a time implementation CompCryptor used before the slicing-by-8 crc and the
+// reworked cipher loops. The wire format must not change, so these are the reference.
+namespace
+{
+	uint32 referenceCRC(const uint32* table, int8* data, uint32 len, uint32 seed)
+	{
+		uint32 newCRC = 0, index = 0;
+
+		newCRC = table[(~seed) & 0xFF];
+		newCRC ^= 0x00FFFFFF;
+		index = (seed >> 8) ^ newCRC;
+		newCRC = (newCRC >> 8) & 0x00FFFFFF;
+		newCRC ^= table[index & 0xFF];
+		index = (seed >> 16) ^ newCRC;
+		newCRC = (newCRC >> 8) & 0x00FFFFFF;
+		newCRC ^= table[index & 0xFF];
+		index = (seed >> 24) ^ newCRC;
+		newCRC = (newCRC >> 8) &0x00FFFFFF;
+		newCRC ^= table[index & 0xFF];
+
+		for(uint32 i = 0; i < len; i++ )
+		{
+			index = (data[i]) ^ newCRC;
+			newCRC = (newCRC >> 8) & 0x00FFFFFF;
+			newCRC ^= table[index & 0xFF];
+		}
+
+		return ~newCRC;
+	}
+
+	void referenceEncrypt(int8* data, uint32 len, uint32 seed)
+	{
+		uint32 blockCount = (len / 4);
+		uint32 byteCount = (len % 4);
+
+		for(uint32 count = 0; count < blockCount; count++)
+		{
+			uint32 block;
+			memcpy(&block, data + count * 4, 4);
+			block ^= seed;
+			memcpy(data + count * 4, &block, 4);
+			seed = block;
+		}
+
+		for(uint32 count = blockCount * 4; count < blockCount * 4 + byteCount; count++)
+		{
+			data[count] ^= seed;
+		}
+	}
+
+	void referenceDecrypt(int8* data, uint32 len, uint32 seed)
+	{
+		uint32 blockCount = (len / 4);
+		uint32 byteCount = (len % 4);
+
+		for(uint32 count = 0; count < blockCount; count++)
+		{
+			uint32 block, tempSeed;
+			memcpy(&block, data + count * 4, 4);
+			tempSeed = block;
+			block ^= seed;
+			memcpy(data + count * 4, &block, 4);
+			seed = tempSeed;
+		}
+
+		for(uint32 count = blockCount * 4; count < blockCount * 4 + byteCount; count++)
+		{
+			data[count] ^= seed;
+		}
+	}
+
+	// the table is private, rebuild the standard reflected crc32 table
+	void buildTable(uint32* table)
+	{
+		for(uint32 i = 0; i < 256; i++)
+		{
+			uint32 crc = i;
+
+			for(uint32 bit = 0; bit < 8; bit++)
+			{
+				crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : (crc >> 1);
+			}
+
+			table[i] = crc;
+		}
+	}
+
+	void fillRandom(std::vector<int8>& buffer)
+	{
+		for(size_t i = 0; i < buffer.size(); i++)
+		{
+			buffer[i] = (int8)(rand() & 0xFF);
+		}
+	}
+}
+
+TEST(CompCryptorTests, CrcMatchesReferenceForAllLengthsAndOffsets)
+{
+	CompCryptor cryptor;
+	uint32 table[256];
+	buildTable(table);
+
+	srand(4711);
+	std::vector<int8> buffer(600);
+	fillRandom(buffer);
+
+	// every length up to a max size packet, at every alignment
+	for(uint32 offset = 0; offset < 8; offset++)
+	{
+		for(uint32 len = 0; len + offset <= buffer.size(); len++)
+		{
+			uint32 seed = (uint32)rand() ^ ((uint32)rand() << 16);
+
+			ASSERT_EQ(referenceCRC(table, &buffer[offset], len, seed), cryptor.GenerateCRC(&buffer[offset], len, seed)) << "len " << len << " offset " << offset;
+		}
+	}
+}
+
+TEST(CompCryptorTests, CrcOfKnownVectorIsStable)
+{
+	CompCryptor cryptor;
+	int8 data[] = "123456789";
+
+	uint32 table[256];
+	buildTable(table);
+
+	EXPECT_EQ(referenceCRC(table, data, 9, 0xDEADBEEF), cryptor.GenerateCRC(data, 9, 0xDEADBEEF));
+	EXPECT_EQ(referenceCRC(table, data, 9, 0), cryptor.GenerateCRC(data, 9, 0));
+}
+
+TEST(CompCryptorTests, EncryptMatchesReference)
+{
+	CompCryptor cryptor;
+
+	srand(815);
+	std::vector<int8> buffer(600);
+
+	for(uint32 offset = 0; offset < 4; offset++)
+	{
+		for(uint32 len = 0; len + offset <= buffer.size(); len++)
+		{
+			fillRandom(buffer);
+			std::vector<int8> expected(buffer);
+			uint32 seed = (uint32)rand() ^ ((uint32)rand() << 16);
+
+			referenceEncrypt(&expected[offset], len, seed);
+			cryptor.Encrypt(&buffer[offset], len, seed);
+
+			ASSERT_TRUE(expected == buffer) << "len " << len << " offset " << offset;
+		}
+	}
+}
+
+TEST(CompCryptorTests, DecryptMatchesReference)
+{
+	CompCryptor cryptor;
+
+	srand(1337);
+	std::vector<int8> buffer(600);
+
+	for(uint32 offset = 0; offset < 4; offset++)
+	{
+		for(uint32 len = 0; len + offset <= buffer.size(); len++)
+		{
+			fillRandom(buffer);
+			std::vector<int8> expected(buffer);
+			uint32 seed = (uint32)rand() ^ ((uint32)rand() << 16);
+
+			referenceDecrypt(&expected[offset], len, seed);
+			cryptor.Decrypt(&buffer[offset], len, seed);
+
+			ASSERT_TRUE(expected == buffer) << "len " << len << " offset " << offset;
+		}
+	}
+}
+
+TEST(CompCryptorTests, DecryptReversesEncrypt)
+{
+	CompCryptor cryptor;
+
+	srand(42);
+	std::vector<int8> buffer(496);
+	fillRandom(buffer);
+	std::vector<int8> original(buffer);
+
+	cryptor.Encrypt(&buffer[0], (uint32)buffer.size(), 0x12345678);
+	EXPECT_FALSE(original == buffer);
+
+	cryptor.Decrypt(&buffer[0], (uint32)buffer.size(), 0x12345678);
+	EXPECT_TRUE(original == buffer);
+}
@@ -0,0 +1,167 @@
+/*! SWGANH MMOServer - Tests
+ *
+ * @copyright Copyright (c) 2006-2010 The swgANH Team
+ *
+ * Handles chat room messages the way ChatManager does: sender, room path and text read into strings, the room path
+ * lowered and hashed for the channel lookup, the sender converted to unicode for the reply and a few settings looked
+ * up by literal key. Counts heap allocations per handled message, once with the keys hashed through temporary strings
+ * and once hashed from the literal, for names that fit the inline buffer and for ones that don't.
+ * Not part of make check, build it with make bstring_bench.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <new>
+#include <vector>
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+#include "Common/Message.h"
+#include "Common/MessageFactory.h"
+#include "LogManager/LogManager.h"
+#include "Utils/clock.h"
+#include "Utils/crc.h"
+
+namespace
+{
+	const uint32	kMessages	= 2000;
+	const uint32	kRounds		= 200;
+
+	uint64			gAllocations = 0;
+
+	typedef std::map<uint32,uint32> ChannelMap;
+
+	Message* buildChatMessage(MessageFactory* factory, const char* sender, const char* room, const wchar_t* text)
+	{
+		factory->StartMessage();
+		factory->addUint32(0x20E4DBE3);
+		factory->addString(sender);
+		factory->addString(room);
+		factory->addString(text);
+		factory->addUint32(0);
+		return factory->EndMessage();
+	}
+
+	uint32 handleChatMessage(Message* message, const ChannelMap& channels, bool literalKeys)
+	{
+		string sender;
+		string room;
+		string text;
+		uint32 opcode;
+
+		message->ResetIndex();
+		message->getUint32(opcode);
+		message->getStringAnsi(sender);
+		message->getStringAnsi(room);
+		message->getStringUnicode16(text);
+
+		string lowerRoom = room;
+		lowerRoom.toLower();
+
+		ChannelMap::const_iterator it = channels.find(lowerRoom.getCrc());
+		uint32 result = (it != channels.end()) ? it->second : 0;
+
+		if(literalKeys)
+		{
+			result ^= Anh_Utils::crc("chat_flood_limit");
+			result ^= Anh_Utils::crc("chat_moderated");
+			result ^= Anh_Utils::crc("chat_private");
+		}
+		else
+		{
+			result ^= BString("chat_flood_limit").getCrc();
+			result ^= BString("chat_moderated").getCrc();
+			result ^= BString("chat_private").getCrc();
+		}
+
+		sender.convert(BSTRType_Unicode16);
+
+		return result + sender.getLength() + text.getLength();
+	}
+
+	void run(const char* mode, const std::vector<Message*>& messages, const ChannelMap& channels, bool literalKeys)
+	{
+		uint32 result = 0;
+		uint64 allocations = gAllocations;
+
+		boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+
+		for(uint32 round = 0; round < kRounds; round++)
+		{
+			for(uint32 i = 0; i < messages.size(); i++)
+			{
+				result += handleChatMessage(messages[i], channels, literalKeys);
+			}
+		}
+
+		double ns = (double)(boost::posix_time::microsec_clock::universal_time() - start).total_microseconds() * 1000.0;
+		double handled = (double)kRounds * messages.size();
+
+		printf("%-22s %8.2f  %8.1f  (%u)\n", mode, (double)(gAllocations - allocations) / handled, ns / handled, result & 0xff);
+	}
+}
+
+void* operator new(std::size_t size)
+{
+	gAllocations++;
+
+	if(void* p = malloc(size ? size : 1))
+		return p;
+
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void operator delete(void* p) throw()
+{
+	free(p);
+}
+
+void operator delete[](void* p) throw()
+{
+	free(p);
+}
+
+int main(int argc, char *argv[])
+{
+	Anh_Utils::Clock::Init();
+	LogManager::Init();
+
+	MessageFactory factory(16 * 1024 * 1024);
+
+	ChannelMap channels;
+	channels[Anh_Utils::crc("swg.bria.chat.general")]	= 1;
+	channels[Anh_Utils::crc("swg.bria.tatooine.mos eisley.planet")] = 2;
+
+	std::vector<Message*> shortNames;
+	std::vector<Message*> longNames;
+
+	for(uint32 i = 0; i < kMessages; i++)
+	{
+		shortNames.push_back(buildChatMessage(&factory, "Ferrous", "SWG.bria.Chat.general", L"anyone selling a crafting kit?"));
+		longNames.push_back(buildChatMessage(&factory, "Ferrous Mosrec of the Mos Eisley Militia", "SWG.bria.Tatooine.Mos Eisley.planet", L"anyone selling a crafting kit?"));
+	}
+
+	printf("%u messages, %u rounds\n", kMessages, kRounds);
+	printf("mode                   allocs/msg  ns/msg\n");
+
+	run("short, temporary keys", shortNames, channels, false);
+	run("short, literal keys", shortNames, channels, true);
+	run("long, temporary keys", longNames, channels, false);
+	run("long, literal keys", longNames, channels, true);
+
+	for(uint32 i = 0; i < kMessages; i++)
+	{
+		shortNames[i]->setPendingDelete(true);
+		longNames[i]->setPendingDelete(true);
+	}
+
+	factory.Process();
+
+	return 0;
+}
@@ -0,0 +1,118 @@
+/*! SWGANH MMOServer - Tests
+ *
+ * @copyright Copyright (c) 2006-2010 The swgANH Team
+ *
+ * Contention benchmark of Anh_Utils::concurrent_queue against the recursive_mutex / std::deque queue it replaced.
+ * Not part of make check, build it with make concurrent_queue_bench.
+ */
+
+#include <cstdio>
+#include <deque>
+
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/thread/recursive_mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "Utils/concurrent_queue.h"
+
+namespace
+{
+	const uint32 kItemsPerProducer = 1000000;
+
+	// the queue as it was before, empty() left out as it didnt compile
+	template<class T>
+	class locked_queue
+	{
+		public:
+
+			void push(const T& item)
+			{
+				boost::recursive_mutex::scoped_lock lk(mMutex);
+				mContainer.push_back(item);
+			}
+
+			T pop()
+			{
+				boost::recursive_mutex::scoped_lock lk(mMutex);
+				T item = mContainer.front();
+				mContainer.pop_front();
+				return(item);
+			}
+
+			size_t size()
+			{
+				boost::recursive_mutex::scoped_lock lk(mMutex);
+				return(mContainer.size());
+			}
+
+		private:
+
+			std::deque<T>			mContainer;
+			boost::recursive_mutex	mMutex;
+	};
+
+	template<class Queue>
+	void produce(Queue* queue)
+	{
+		for(uint32 i = 1; i <= kItemsPerProducer; i++)
+		{
+			queue->push(i);
+		}
+	}
+
+	// the way the server polls its queues: size, then pop that many
+	template<class Queue>
+	void consume(Queue* queue, uint32 total)
+	{
+		uint32 popped = 0;
+
+		while(popped < total)
+		{
+			uint32 count = (uint32)queue->size();
+
+			while(count--)
+			{
+				queue->pop();
+				popped++;
+			}
+		}
+	}
+
+	template<class Queue>
+	double run(uint32 producerCount)
+	{
+		Queue queue;
+
+		boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+
+		boost::thread_group producers;
+
+		for(uint32 p = 0; p < producerCount; p++)
+		{
+			producers.create_thread(boost::bind(&produce<Queue>, &queue));
+		}
+
+		consume(&queue, producerCount * kItemsPerProducer);
+		producers.join_all();
+
+		uint64 elapsed = (boost::posix_time::microsec_clock::universal_time() - start).total_microseconds();
+
+		return((double)elapsed * 1000.0 / (producerCount * kItemsPerProducer));
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	printf("producers  locked_queue ns/item  concurrent_queue ns/item\n");
+
+	for(uint32 producers = 1; producers <= 8; producers *= 2)
+	{
+		double locked		= run<locked_queue<uint32> >(producers);
+		double lockfree		= run<Anh_Utils::concurrent_queue<uint32> >(producers);
+
+		printf("%9u  %20.1f  %24.1f\n", producers, locked, lockfree);
+	}
+
+	return 0;
+}
@@ -0,0 +1,123 @@
+/*! SWGANH MMOServer - Tests
+ *
+ * @copyright Copyright (c) 2006-2010 The swgANH Team
+ */
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include "Utils/typedefs.h"
+#include "Utils/bstring.h"
+#include "Utils/crc.h"
+
+namespace
+{
+	// keys used all over the zone, these have to hash exactly like they did through BString
+	const char* kKeys[] =
+	{
+		"",
+		"a",
+		"cat_wpn_damage.wpn_damage_min",
+		"cat_wpn_damage.wpn_damage_max",
+		"travel_ticket_cost",
+		"object/tangible/travel/travel_ticket/base/shared_base_travel_ticket.iff",
+		"ExamineMe",
+	};
+}
+
+TEST(CrcTests, LiteralCrcMatchesBStringCrc)
+{
+	for(uint32 i = 0; i < sizeof(kKeys) / sizeof(kKeys[0]); i++)
+	{
+		BString key(kKeys[i]);
+
+		EXPECT_EQ(key.getCrc(), Anh_Utils::crc(kKeys[i])) << kKeys[i];
+		EXPECT_EQ(key.getCrc(), Anh_Utils::crc(kKeys[i], static_cast<uint32>(strlen(kKeys[i])))) << kKeys[i];
+		EXPECT_EQ(key.getCrc(), BString::CRC(const_cast<char*>(kKeys[i]))) << kKeys[i];
+	}
+}
+
+TEST(CrcTests, LiteralCrcIsKnownValue)
+{
+	// the crc the client uses for object templates, any change to table or polynomial shows up here
+	EXPECT_EQ(0x0u, Anh_Utils::crc(""));
+	EXPECT_EQ(0x19939b6bu, Anh_Utils::crc("a"));
+	EXPECT_EQ(0xfc891918u, Anh_Utils::crc("123456789"));
+}
+
+TEST(CrcTests, HighCharactersHashAsUnsigned)
+{
+	const char data[] = "\xe4\xf6\xfc";
+
+	EXPECT_EQ(Anh_Utils::crc(data), Anh_Utils::crc(data, 3));
+	EXPECT_EQ(BString(data).getCrc(), Anh_Utils::crc(data));
+}
+
+#if defined(__GXX_EXPERIMENTAL_CXX0X__) && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 6))
+TEST(CrcTests, LiteralCrcIsComputedByTheCompiler)
+{
+	static_assert(Anh_Utils::crc("123456789") == 0xfc891918u, "crc of a literal has to be a constant expression");
+}
+#endif
+
+TEST(BStringTests, ShortStringsStayInline)
+{
+	BString shortString("short");
+	BString copy(shortString);
+
+	EXPECT_EQ(BSTRING_INLINE_SIZE, shortString.getAllocated());
+	EXPECT_EQ(BSTRING_INLINE_SIZE, copy.getAllocated());
+	EXPECT_STREQ("short", copy.getAnsi());
+	EXPECT_NE(shortString.getAnsi(), copy.getAnsi());
+}
+
+TEST(BStringTests, LongStringsGrowOutOfTheInlineBuffer)
+{
+	BString growing("0123456789");
+
+	for(uint32 i = 0; i < 10; i++)
+	{
+		growing << "0123456789";
+	}
+
+	EXPECT_EQ(110, growing.getLength());
+	EXPECT_GT(growing.getAllocated(), static_cast<uint32>(BSTRING_INLINE_SIZE));
+	EXPECT_EQ(0, strncmp(growing.getAnsi() + 100, "0123456789", 11));
+
+	// assigning something short keeps the heap buffer, assigning back copies in place
+	BString shortString("short");
+	shortString = growing;
+	growing = "tiny";
+
+	EXPECT_STREQ("tiny", growing.getAnsi());
+	EXPECT_EQ(110, shortString.getLength());
+	EXPECT_EQ(0, strncmp(shortString.getAnsi() + 100, "0123456789", 11));
+
+	shortString = shortString;
+	EXPECT_EQ(110, shortString.getLength());
+}
+
+TEST(BStringTests, ConvertKeepsShortStringsInline)
+{
+	BString name("Han");
+
+	name.convert(BSTRType_Unicode16);
+
+	EXPECT_EQ(BSTRType_Unicode16, name.getType());
+	EXPECT_EQ(3, name.getLength());
+	EXPECT_EQ(BSTRING_INLINE_SIZE, name.getAllocated());
+
+	name.convert(BSTRType_ANSI);
+
+	EXPECT_STREQ("Han", name.getAnsi());
+	EXPECT_EQ(BSTRING_INLINE_SIZE, name.getAllocated());
+
+	BString longName("a name that does not fit into the inline buffer");
+
+	longName.convert(BSTRType_Unicode16);
+	EXPECT_GT(longName.getAllocated(), static_cast<uint32>(BSTRING_INLINE_SIZE));
+
+	longName.convert(BSTRType_ANSI);
+	EXPECT_STREQ("a name that does not fit into the inline buffer", longName.getAnsi());
+}
@@ -0,0 +1,189 @@
+/*! SWGANH MMOServer - Tests
+ *
+ * @copyright Copyright (c) 2006-2010 The swgANH Team
+ */
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include <boost/bind.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "Utils/concurrent_queue.h"
+
+// Items are (producer << 24) | sequence, sequence starts at 1 so no item is 0 (which pop returns when empty).
+namespace
+{
+	const uint32 kItemsPerProducer = 200000;
+
+	// a small ring so the overflow path gets hammered as well
+	typedef Anh_Utils::concurrent_queue<uint32, 64> SmallQueue;
+
+	void produce(SmallQueue* queue, uint32 producer)
+	{
+		for(uint32 i = 1; i <= kItemsPerProducer; i++)
+		{
+			queue->push((producer << 24) | i);
+		}
+	}
+
+	void consume(SmallQueue* queue, volatile uint32* remaining, std::vector<uint32>* seen)
+	{
+		uint32 batch[16];
+
+		while(Anh_Utils::atomicLoad(remaining))
+		{
+			uint32 count = queue->pop_batch(batch, 16);
+
+			for(uint32 i = 0; i < count; i++)
+			{
+				seen->push_back(batch[i]);
+			}
+
+			if(count)
+			{
+				Anh_Utils::atomicAdd(remaining, (uint32)-(int32)count);
+			}
+		}
+	}
+}
+
+TEST(ConcurrentQueueTests, PopOnEmptyQueueReturnsDefault)
+{
+	Anh_Utils::concurrent_queue<uint32, 8> queue;
+	uint32 item = 42;
+
+	EXPECT_TRUE(queue.empty());
+	EXPECT_EQ(0u, queue.pop());
+	EXPECT_FALSE(queue.try_pop(item));
+	EXPECT_EQ(42u, item);
+}
+
+TEST(ConcurrentQueueTests, KeepsFifoOrderThroughOverflow)
+{
+	Anh_Utils::concurrent_queue<uint32, 8> queue;
+
+	for(uint32 i = 1; i <= 100; i++)
+	{
+		queue.push(i);
+	}
+
+	EXPECT_EQ(100u, queue.size());
+	EXPECT_EQ(1u, queue.front());
+
+	for(uint32 i = 1; i <= 100; i++)
+	{
+		ASSERT_EQ(i, queue.pop());
+	}
+
+	EXPECT_TRUE(queue.empty());
+}
+
+TEST(ConcurrentQueueTests, BatchPopStopsWhenEmpty)
+{
+	Anh_Utils::concurrent_queue<uint32, 16> queue;
+	uint32 items[32];
+
+	for(uint32 i = 1; i <= 20; i++)
+	{
+		queue.push(i);
+	}
+
+	EXPECT_EQ(10u, queue.pop_batch(items, 10));
+	EXPECT_EQ(10u, queue.pop_batch(items, 32));
+	EXPECT_EQ(11u, items[0]);
+	EXPECT_EQ(20u, items[9]);
+	EXPECT_EQ(0u, queue.pop_batch(items, 32));
+}
+
+TEST(ConcurrentQueueTests, ManyProducersSingleConsumerKeepsPerProducerOrder)
+{
+	const uint32 producerCount = 4;
+
+	SmallQueue			queue;
+	volatile uint32		remaining = producerCount * kItemsPerProducer;
+	std::vector<uint32>	seen;
+
+	seen.reserve(producerCount * kItemsPerProducer);
+
+	boost::thread_group producers;
+
+	for(uint32 p = 0; p < producerCount; p++)
+	{
+		producers.create_thread(boost::bind(&produce, &queue, p));
+	}
+
+	consume(&queue, &remaining, &seen);
+	producers.join_all();
+
+	ASSERT_EQ(producerCount * kItemsPerProducer, seen.size());
+	EXPECT_TRUE(queue.empty());
+
+	std::vector<uint32> last(producerCount, 0);
+
+	for(size_t i = 0; i < seen.size(); i++)
+	{
+		uint32 producer	= seen[i] >> 24;
+		uint32 sequence	= seen[i] & 0xFFFFFF;
+
+		ASSERT_LT(producer, producerCount);
+		ASSERT_EQ(last[producer] + 1, sequence) << "producer " << producer;
+
+		last[producer] = sequence;
+	}
+}
+
+TEST(ConcurrentQueueTests, ManyProducersManyConsumersDeliverEveryItemOnce)
+{
+	const uint32 producerCount = 4;
+	const uint32 consumerCount = 4;
+
+	SmallQueue							queue;
+	volatile uint32						remaining = producerCount * kItemsPerProducer;
+	std::vector<std::vector<uint32> >	seen(consumerCount);
+
+	boost::thread_group threads;
+
+	for(uint32 c = 0; c < consumerCount; c++)
+	{
+		threads.create_thread(boost::bind(&consume, &queue, &remaining, &seen[c]));
+	}
+
+	for(uint32 p = 0; p < producerCount; p++)
+	{
+		threads.create_thread(boost::bind(&produce, &queue, p));
+	}
+
+	threads.join_all();
+
+	std::vector<uint8> delivered(producerCount * kItemsPerProducer, 0);
+
+	for(uint32 c = 0; c < consumerCount; c++)
+	{
+		uint32 last[producerCount] = { 0 };
+
+		for(size_t i = 0; i < seen[c].size(); i++)
+		{
+			uint32 producer	= seen[c][i] >> 24;
+			uint32 sequence	= seen[c][i] & 0xFFFFFF;
+
+			ASSERT_LT(producer, producerCount);
+			ASSERT_GE(sequence, 1u);
+			ASSERT_LE(sequence, kItemsPerProducer);
+
+			// every consumer still sees the items of one producer in order
+			ASSERT_LT(last[producer], sequence);
+			last[producer] = sequence;
+
+			uint8& flag = delivered[producer * kItemsPerProducer + sequence - 1];
+			ASSERT_EQ(0, flag) << "item delivered twice";
+			flag = 1;
+		}
+	}
+
+	for(size_t i = 0; i < delivered.size(); i++)
+	{
+		ASSERT_EQ(1, delivered[i]) << "item " << i << " lost";
+	}
+}
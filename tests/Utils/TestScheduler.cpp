@@ -0,0 +1,108 @@
+/*! SWGANH MMOServer - Tests
+ *
+ * @copyright Copyright (c) 2006-2010 The swgANH Team
+ */
+
+#include <gtest/gtest.h>
+
+#include "Utils/Scheduler.h"
+
+// Drives the wheel with made up times instead of the clock, so a wrap of timeGetTime can be simulated.
+namespace
+{
+	class TestableScheduler : public Anh_Utils::Scheduler
+	{
+		public:
+
+			void	advance(uint64 currentTime){ _advance(currentTime); }
+			uint64	getWheelTime(){ return mWheelTime; }
+	};
+
+	class Counter
+	{
+		public:
+
+			Counter() : mCalls(0){}
+
+			bool call(uint64 callTime, void* ref)
+			{
+				mCalls++;
+				return false;
+			}
+
+			uint32 mCalls;
+	};
+}
+
+class SchedulerTest : public testing::Test
+{
+	protected:
+
+		virtual void SetUp()
+		{
+			Anh_Utils::Clock::Init();
+		}
+};
+
+TEST_F(SchedulerTest, RunsTaskOnceItIsDue)
+{
+	TestableScheduler scheduler;
+	Counter counter;
+
+	scheduler.addTask(fastdelegate::MakeDelegate(&counter,&Counter::call),1,1000,NULL);
+	uint64 start = scheduler.getWheelTime();
+
+	scheduler.advance(start + 500);
+	scheduler.runTask();
+	EXPECT_EQ(0u, counter.mCalls);
+
+	scheduler.advance(start + 2000);
+	scheduler.runTask();
+	EXPECT_EQ(1u, counter.mCalls);
+	EXPECT_EQ(0u, scheduler.getTaskCount());
+}
+
+TEST_F(SchedulerTest, KeepsPendingTasksWhenTheClockWraps)
+{
+	TestableScheduler scheduler;
+	Counter counter;
+
+	scheduler.addTask(fastdelegate::MakeDelegate(&counter,&Counter::call),1,1000,NULL);
+	uint64 start = scheduler.getWheelTime();
+
+	scheduler.advance(start + 500);
+
+	// the clock jumped back to 100ms, the task has roughly 500ms left
+	scheduler.advance(100);
+	EXPECT_EQ(100u, scheduler.getWheelTime());
+	scheduler.runTask();
+	EXPECT_EQ(0u, counter.mCalls);
+
+	scheduler.advance(100 + 400);
+	scheduler.runTask();
+	EXPECT_EQ(0u, counter.mCalls);
+
+	scheduler.advance(100 + 1000);
+	scheduler.runTask();
+	EXPECT_EQ(1u, counter.mCalls);
+}
+
+TEST_F(SchedulerTest, RebasesTasksBeyondTheLowestLevel)
+{
+	TestableScheduler scheduler;
+	Counter counter;
+
+	scheduler.addTask(fastdelegate::MakeDelegate(&counter,&Counter::call),1,100000,NULL);
+	uint64 start = scheduler.getWheelTime();
+
+	scheduler.advance(start + 10000);
+	scheduler.advance(5);
+
+	scheduler.advance(5 + 80000);
+	scheduler.runTask();
+	EXPECT_EQ(0u, counter.mCalls);
+
+	scheduler.advance(5 + 100000);
+	scheduler.runTask();
+	EXPECT_EQ(1u, counter.mCalls);
+}
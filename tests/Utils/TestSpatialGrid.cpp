@@ -0,0 +1,186 @@
+/*! SWGANH MMOServer - Tests
+ *
+ * @copyright Copyright (c) 2006-2010 The swgANH Team
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include "Utils/SpatialGrid.h"
+
+namespace
+{
+	struct Item
+	{
+		uint64	id;
+		float	x;
+		float	z;
+	};
+
+	typedef Anh_Utils::spatial_grid<Item> ItemGrid;
+
+	class Collector
+	{
+		public:
+
+			explicit Collector(std::vector<uint64>* ids) : mIds(ids){}
+
+			void operator()(const ItemGrid::Entry& entry)
+			{
+				mIds->push_back(entry.id);
+			}
+
+		private:
+
+			std::vector<uint64>* mIds;
+	};
+
+	std::vector<uint64> queryGrid(const ItemGrid& grid, float x, float z, float range)
+	{
+		std::vector<uint64> ids;
+		Collector collector(&ids);
+
+		grid.visitRange(x, z, range, collector);
+		std::sort(ids.begin(), ids.end());
+
+		return ids;
+	}
+
+	std::vector<uint64> queryBruteForce(const std::vector<Item>& items, float x, float z, float range)
+	{
+		std::vector<uint64> ids;
+
+		for(uint32 i = 0; i < items.size(); i++)
+		{
+			float dx = items[i].x - x;
+			float dz = items[i].z - z;
+
+			if(dx * dx + dz * dz <= range * range)
+			{
+				ids.push_back(items[i].id);
+			}
+		}
+
+		std::sort(ids.begin(), ids.end());
+
+		return ids;
+	}
+
+	float randomCoord(float low, float width)
+	{
+		return low + width * ((float)rand() / (float)RAND_MAX);
+	}
+}
+
+TEST(SpatialGridTests, RangeQueryIsExact)
+{
+	ItemGrid grid(-1000.0f, -1000.0f, 2000.0f, 2000.0f, 128.0f);
+
+	Item a = { 1, 10.0f, 10.0f };
+	Item b = { 2, 100.0f, 100.0f };		// inside the bounding square of a 120m query, but ~141m away
+	Item c = { 3, -50.0f, 60.0f };
+
+	grid.insert(a.id, &a, a.x, a.z);
+	grid.insert(b.id, &b, b.x, b.z);
+	grid.insert(c.id, &c, c.x, c.z);
+
+	std::vector<uint64> ids = queryGrid(grid, 0.0f, 0.0f, 120.0f);
+
+	ASSERT_EQ(2u, ids.size());
+	EXPECT_EQ(1u, ids[0]);
+	EXPECT_EQ(3u, ids[1]);
+}
+
+TEST(SpatialGridTests, InsertingTwiceFails)
+{
+	ItemGrid grid(0.0f, 0.0f, 1000.0f, 1000.0f, 100.0f);
+	Item a = { 1, 10.0f, 10.0f };
+
+	EXPECT_TRUE(grid.insert(a.id, &a, a.x, a.z));
+	EXPECT_FALSE(grid.insert(a.id, &a, a.x, a.z));
+	EXPECT_EQ(1u, grid.size());
+
+	EXPECT_TRUE(grid.remove(a.id));
+	EXPECT_FALSE(grid.remove(a.id));
+	EXPECT_FALSE(grid.update(a.id, 20.0f, 20.0f));
+	EXPECT_EQ(0u, grid.size());
+}
+
+TEST(SpatialGridTests, PositionsOutsideTheAreaAreKept)
+{
+	ItemGrid grid(0.0f, 0.0f, 1000.0f, 1000.0f, 100.0f);
+	Item a = { 1, -50.0f, 2000.0f };
+
+	grid.insert(a.id, &a, a.x, a.z);
+
+	EXPECT_EQ(1u, queryGrid(grid, -50.0f, 2000.0f, 1.0f).size());
+	EXPECT_EQ(0u, queryGrid(grid, 0.0f, 1000.0f, 100.0f).size());
+}
+
+TEST(SpatialGridTests, RandomMovementMatchesBruteForce)
+{
+	srand(42);
+
+	ItemGrid grid(-2048.0f, -2048.0f, 4096.0f, 4096.0f, 128.0f);
+	std::vector<Item> items(2000);
+
+	for(uint32 i = 0; i < items.size(); i++)
+	{
+		items[i].id	= i + 1;
+		items[i].x	= randomCoord(-2048.0f, 4096.0f);
+		items[i].z	= randomCoord(-2048.0f, 4096.0f);
+
+		grid.insert(items[i].id, &items[i], items[i].x, items[i].z);
+	}
+
+	for(uint32 step = 0; step < 50; step++)
+	{
+		// move everyone, some of them far enough to change cells
+		for(uint32 i = 0; i < items.size(); i++)
+		{
+			items[i].x += randomCoord(-40.0f, 80.0f);
+			items[i].z += randomCoord(-40.0f, 80.0f);
+
+			ASSERT_TRUE(grid.update(items[i].id, items[i].x, items[i].z));
+		}
+
+		// drop and re-add a few to exercise the swap on removal
+		for(uint32 i = step; i < items.size(); i += 97)
+		{
+			ASSERT_TRUE(grid.remove(items[i].id));
+			ASSERT_TRUE(grid.insert(items[i].id, &items[i], items[i].x, items[i].z));
+		}
+
+		for(uint32 q = 0; q < 10; q++)
+		{
+			float x = randomCoord(-2048.0f, 4096.0f);
+			float z = randomCoord(-2048.0f, 4096.0f);
+
+			ASSERT_EQ(queryBruteForce(items, x, z, 128.0f), queryGrid(grid, x, z, 128.0f));
+		}
+	}
+
+	EXPECT_EQ(items.size(), grid.size());
+}
+
+TEST(SpatialGridTests, RectangleQueryReturnsContainedEntries)
+{
+	ItemGrid grid(0.0f, 0.0f, 1000.0f, 1000.0f, 100.0f);
+
+	Item a = { 1, 150.0f, 150.0f };
+	Item b = { 2, 250.0f, 150.0f };
+
+	grid.insert(a.id, &a, a.x, a.z);
+	grid.insert(b.id, &b, b.x, b.z);
+
+	std::vector<uint64> ids;
+	Collector collector(&ids);
+
+	grid.visitRectangle(100.0f, 100.0f, 100.0f, 100.0f, collector);
+
+	ASSERT_EQ(1u, ids.size());
+	EXPECT_EQ(1u, ids[0]);
+}
@@ -0,0 +1,281 @@
+/*! SWGANH MMOServer - Tests
+ *
+ * @copyright Copyright (c) 2006-2010 The swgANH Team
+ *
+ * Replays a recorded movement trace through the libspatialindex R*-tree, the way ZoneTree keeps points
+ * (delete + insert per move, square query filtered to the circle), and through Anh_Utils::spatial_grid.
+ * Not part of make check, build it with make spatial_grid_bench.
+ */
+
+#include <cstdio>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+#include <SpatialIndex.h>
+
+#include "Utils/SpatialGrid.h"
+
+namespace
+{
+	const float		kPlanetLow		= -8192.0f;
+	const float		kPlanetSize		= 16384.0f;
+	const float		kViewingRange	= 128.0f;
+	const uint32	kTicks			= 60;
+
+	struct Item
+	{
+		uint64	id;
+		float	x;
+		float	z;
+	};
+
+	// positions of every entity for every tick, entities drift towards a waypoint and pick a new one on arrival
+	struct Recording
+	{
+		uint32				entities;
+		std::vector<Item>	frames;		// kTicks * entities
+
+		const Item& at(uint32 tick, uint32 entity) const { return frames[tick * entities + entity]; }
+	};
+
+	float randomCoord(float low, float width)
+	{
+		return low + width * ((float)rand() / (float)RAND_MAX);
+	}
+
+	void record(Recording* recording, uint32 entities)
+	{
+		recording->entities = entities;
+		recording->frames.resize(kTicks * entities);
+
+		std::vector<Item> targets(entities);
+		std::vector<Item> current(entities);
+
+		for(uint32 i = 0; i < entities; i++)
+		{
+			// keep them clustered around a few towns, as players are
+			float townX = -6000.0f + 3000.0f * (i % 5);
+			float townZ = -6000.0f + 3000.0f * ((i / 5) % 5);
+
+			current[i].id	= i + 1;
+			current[i].x	= townX + randomCoord(-600.0f, 1200.0f);
+			current[i].z	= townZ + randomCoord(-600.0f, 1200.0f);
+			targets[i]		= current[i];
+		}
+
+		for(uint32 tick = 0; tick < kTicks; tick++)
+		{
+			for(uint32 i = 0; i < entities; i++)
+			{
+				float dx = targets[i].x - current[i].x;
+				float dz = targets[i].z - current[i].z;
+
+				if(dx * dx + dz * dz < 36.0f)
+				{
+					targets[i].x = current[i].x + randomCoord(-300.0f, 600.0f);
+					targets[i].z = current[i].z + randomCoord(-300.0f, 600.0f);
+				}
+				else
+				{
+					// running speed, one tick is a position update
+					float scale = 6.0f / sqrt(dx * dx + dz * dz);
+
+					current[i].x += dx * scale;
+					current[i].z += dz * scale;
+				}
+
+				recording->frames[tick * entities + i] = current[i];
+			}
+		}
+	}
+
+	double elapsedNs(const boost::posix_time::ptime& start)
+	{
+		return (double)(boost::posix_time::microsec_clock::universal_time() - start).total_microseconds() * 1000.0;
+	}
+
+	//======================================================================================================================
+
+	class RTreeVisitor : public SpatialIndex::IVisitor
+	{
+		public:
+
+			explicit RTreeVisitor(std::vector<int64>* ids) : mIds(ids){}
+
+			void visitNode(const SpatialIndex::INode& n){}
+			void visitData(const SpatialIndex::IData& d){ mIds->push_back(d.getIdentifier()); }
+			void visitData(std::vector<const SpatialIndex::IData*>& v){}
+
+		private:
+
+			std::vector<int64>* mIds;
+	};
+
+	uint64 replayRTree(const Recording& recording, double* moveNs, double* queryNs)
+	{
+		SpatialIndex::IStorageManager*			storage	= SpatialIndex::StorageManager::createNewMemoryStorageManager();
+		SpatialIndex::StorageManager::IBuffer*	buffer	= SpatialIndex::StorageManager::createNewRandomEvictionsBuffer(*storage, 200, false);
+		SpatialIndex::id_type					indexId;
+		SpatialIndex::ISpatialIndex*			tree	= SpatialIndex::RTree::createNewRTree(*buffer, 0.7, 100, 100, 2, SpatialIndex::RTree::RV_RSTAR, indexId);
+
+		double coords[2];
+
+		for(uint32 i = 0; i < recording.entities; i++)
+		{
+			coords[0] = recording.at(0, i).x;
+			coords[1] = recording.at(0, i).z;
+
+			tree->insertData(0, 0, SpatialIndex::Point(coords, 2), recording.at(0, i).id);
+		}
+
+		std::vector<Item>	positions(recording.frames.begin(), recording.frames.begin() + recording.entities);
+		uint64				found = 0;
+
+		*moveNs		= 0.0;
+		*queryNs	= 0.0;
+
+		for(uint32 tick = 1; tick < kTicks; tick++)
+		{
+			boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+
+			for(uint32 i = 0; i < recording.entities; i++)
+			{
+				const Item& next = recording.at(tick, i);
+
+				coords[0] = positions[i].x;
+				coords[1] = positions[i].z;
+				tree->deleteData(SpatialIndex::Point(coords, 2), next.id);
+
+				coords[0] = next.x;
+				coords[1] = next.z;
+				tree->insertData(0, 0, SpatialIndex::Point(coords, 2), next.id);
+
+				positions[i] = next;
+			}
+
+			*moveNs += elapsedNs(start);
+			start = boost::posix_time::microsec_clock::universal_time();
+
+			// every tenth entity is a player looking around
+			for(uint32 i = 0; i < recording.entities; i += 10)
+			{
+				std::vector<int64> ids;
+				ids.reserve(100);
+
+				double low[2]	= { positions[i].x - kViewingRange, positions[i].z - kViewingRange };
+				double high[2]	= { positions[i].x + kViewingRange, positions[i].z + kViewingRange };
+
+				RTreeVisitor visitor(&ids);
+				tree->intersectsWithQuery(SpatialIndex::Region(low, high, 2), visitor);
+
+				for(uint32 j = 0; j < ids.size(); j++)
+				{
+					const Item& other = positions[ids[j] - 1];
+
+					float dx = other.x - positions[i].x;
+					float dz = other.z - positions[i].z;
+
+					if(dx * dx + dz * dz <= kViewingRange * kViewingRange)
+					{
+						found++;
+					}
+				}
+			}
+
+			*queryNs += elapsedNs(start);
+		}
+
+		*moveNs		/= (double)(kTicks - 1) * recording.entities;
+		*queryNs	/= (double)(kTicks - 1) * (recording.entities / 10);
+
+		delete tree;
+		delete buffer;
+		delete storage;
+
+		return found;
+	}
+
+	//======================================================================================================================
+
+	class GridCounter
+	{
+		public:
+
+			GridCounter() : mFound(0){}
+
+			void operator()(const Anh_Utils::spatial_grid<Item>::Entry& entry){ mFound++; }
+
+			uint64 mFound;
+	};
+
+	uint64 replayGrid(const Recording& recording, double* moveNs, double* queryNs)
+	{
+		Anh_Utils::spatial_grid<Item> grid(kPlanetLow, kPlanetLow, kPlanetSize, kPlanetSize, kViewingRange);
+
+		std::vector<Item> positions(recording.frames.begin(), recording.frames.begin() + recording.entities);
+
+		for(uint32 i = 0; i < recording.entities; i++)
+		{
+			grid.insert(positions[i].id, &positions[i], positions[i].x, positions[i].z);
+		}
+
+		GridCounter counter;
+
+		*moveNs		= 0.0;
+		*queryNs	= 0.0;
+
+		for(uint32 tick = 1; tick < kTicks; tick++)
+		{
+			boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+
+			for(uint32 i = 0; i < recording.entities; i++)
+			{
+				const Item& next = recording.at(tick, i);
+
+				grid.update(next.id, next.x, next.z);
+				positions[i] = next;
+			}
+
+			*moveNs += elapsedNs(start);
+			start = boost::posix_time::microsec_clock::universal_time();
+
+			for(uint32 i = 0; i < recording.entities; i += 10)
+			{
+				grid.visitRange(positions[i].x, positions[i].z, kViewingRange, counter);
+			}
+
+			*queryNs += elapsedNs(start);
+		}
+
+		*moveNs		/= (double)(kTicks - 1) * recording.entities;
+		*queryNs	/= (double)(kTicks - 1) * (recording.entities / 10);
+
+		return counter.mFound;
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	srand(1234);
+
+	printf("entities  rtree move ns  rtree query ns  grid move ns  grid query ns\n");
+
+	for(uint32 entities = 2000; entities <= 10000; entities += 2000)
+	{
+		Recording recording;
+		record(&recording, entities);
+
+		double rtreeMove, rtreeQuery, gridMove, gridQuery;
+
+		uint64 rtreeFound	= replayRTree(recording, &rtreeMove, &rtreeQuery);
+		uint64 gridFound	= replayGrid(recording, &gridMove, &gridQuery);
+
+		printf("%8u  %13.1f  %14.1f  %12.1f  %13.1f%s\n", entities, rtreeMove, rtreeQuery, gridMove, gridQuery,
+			(rtreeFound == gridFound) ? "" : "  RESULTS DIFFER");
+	}
+
+	return 0;
+}
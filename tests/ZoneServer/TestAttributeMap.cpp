@@ -0,0 +1,106 @@
+/*! SWGANH MMOServer - Tests
+ *
+ * @copyright Copyright (c) 2006-2010 The swgANH Team
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "ZoneServer/AttributeMap.h"
+#include "Utils/bstring.h"
+
+TEST(AttributeMapTests, NumbersAreParsedOnce)
+{
+	AttributeValue whole("250");
+	AttributeValue decimal("0.75");
+	AttributeValue text("@crafting:tool_status_ready");
+
+	EXPECT_EQ(AttributeValue_Integer, whole.getType());
+	EXPECT_EQ(AttributeValue_Float, decimal.getType());
+	EXPECT_EQ(AttributeValue_String, text.getType());
+
+	int32 intValue = 0;
+	float floatValue = 0.0f;
+
+	EXPECT_TRUE(whole.get(&intValue));
+	EXPECT_EQ(250, intValue);
+
+	EXPECT_TRUE(whole.get(&floatValue));
+	EXPECT_FLOAT_EQ(250.0f, floatValue);
+
+	EXPECT_TRUE(decimal.get(&floatValue));
+	EXPECT_FLOAT_EQ(0.75f, floatValue);
+}
+
+TEST(AttributeMapTests, ReadsFailWhereLexicalCastWould)
+{
+	int32 intValue = 0;
+	uint16 smallValue = 0;
+	bool flag = false;
+
+	// no whole number, out of range and not a number at all
+	EXPECT_FALSE(AttributeValue("12.5").get(&intValue));
+	EXPECT_FALSE(AttributeValue("70000").get(&smallValue));
+	EXPECT_FALSE(AttributeValue("abc").get(&intValue));
+
+	// bools only take 0 and 1
+	EXPECT_TRUE(AttributeValue("1").get(&flag));
+	EXPECT_TRUE(flag);
+	EXPECT_FALSE(AttributeValue("2").get(&flag));
+
+	// anything but plain decimals stays text
+	EXPECT_EQ(AttributeValue_String, AttributeValue("0x10").getType());
+	EXPECT_EQ(AttributeValue_String, AttributeValue(" 5").getType());
+	EXPECT_EQ(AttributeValue_String, AttributeValue("inf").getType());
+	EXPECT_EQ(AttributeValue_String, AttributeValue("").getType());
+}
+
+TEST(AttributeMapTests, TextIsKeptAsStored)
+{
+	AttributeValue decimal("12.50");
+
+	std::string text;
+	BString bText;
+
+	EXPECT_TRUE(decimal.get(&text));
+	EXPECT_EQ("12.50", text);
+
+	EXPECT_TRUE(decimal.get(&bText));
+	EXPECT_STREQ("12.50", bText.getAnsi());
+
+	decimal.set("@obj_attr_n:none");
+	EXPECT_EQ(AttributeValue_String, decimal.getType());
+	EXPECT_STREQ("@obj_attr_n:none", decimal.c_str());
+}
+
+TEST(AttributeMapTests, FlatMapBehavesLikeMap)
+{
+	AttributeMap attributes;
+
+	EXPECT_TRUE(attributes.insert(BString("stacksize").getCrc(), "20").second);
+	EXPECT_TRUE(attributes.insert(BString("serial").getCrc(), "(ab12cd)").second);
+	EXPECT_TRUE(attributes.insert(BString("condition").getCrc(), "100/100").second);
+
+	// an existing key is left alone
+	EXPECT_FALSE(attributes.insert(BString("stacksize").getCrc(), "30").second);
+	EXPECT_EQ(3u, attributes.size());
+
+	AttributeMap::iterator it = attributes.find(BString("stacksize").getCrc());
+	ASSERT_TRUE(it != attributes.end());
+	EXPECT_STREQ("20", (*it).second.c_str());
+
+	// sorted by key crc
+	uint32 lastCrc = 0;
+
+	for(it = attributes.begin(); it != attributes.end(); ++it)
+	{
+		EXPECT_LT(lastCrc, (*it).first);
+		lastCrc = (*it).first;
+	}
+
+	attributes.erase(attributes.find(BString("serial").getCrc()));
+
+	EXPECT_TRUE(attributes.find(BString("serial").getCrc()) == attributes.end());
+	EXPECT_EQ(2u, attributes.size());
+}